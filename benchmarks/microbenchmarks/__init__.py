@@ -1,17 +1,39 @@
 from .atomic_ops import AtomicOpsPlan
 from .fill import FillPlan
+from .histogram import HistogramPlan
 from .math_opts import MathOpsPlan
 from .matrix_ops import MatrixOpsPlan
 from .memcpy import MemcpyPlan
+from .mesh_local import MeshLocalPlan
+from .mesh_patcher import MeshPatcherPlan
+from .morton import MortonPlan
+from .pinning import PinningPlan
+from .quant_array import QuantArrayPlan
+from .random_numbers import RandomPlan
 from .saxpy import SaxpyPlan
+from .simd import SimdPlan
+from .sort import SortPlan
 from .stencil2d import Stencil2DPlan
+from .strength_reduction import StrengthReductionPlan
+from .tiling import TilingPlan
 
 benchmark_plan_list = [
     AtomicOpsPlan,
     FillPlan,
+    HistogramPlan,
     MathOpsPlan,
     MatrixOpsPlan,
     MemcpyPlan,
+    MeshLocalPlan,
+    MeshPatcherPlan,
+    MortonPlan,
+    PinningPlan,
+    QuantArrayPlan,
+    RandomPlan,
     SaxpyPlan,
+    SimdPlan,
+    SortPlan,
     Stencil2DPlan,
+    StrengthReductionPlan,
+    TilingPlan,
 ]
@@ -114,3 +114,88 @@ class AtomicOps(BenchmarkItem):
             return False
         else:
             return True
+
+
+class SimdWidth(BenchmarkItem):
+    name = "simd_width"
+
+    # Number of 32-bit lanes the CPU backend vectorizes loops to.
+    def __init__(self):
+        self._items = {"scalar": 1, "avx2": 8, "avx512": 16}
+
+    @staticmethod
+    def init_options(width: int):
+        return {"simd_width": width, "max_vector_width": width}
+
+
+class ThreadAffinity(BenchmarkItem):
+    name = "thread_affinity"
+
+    # Pinning policy of the CPU thread pool.
+    def __init__(self):
+        self._items = {"unpinned": "none", "compact": "compact", "scatter": "scatter"}
+
+    @staticmethod
+    def init_options(policy: str):
+        return {"cpu_thread_affinity": policy}
+
+
+class MeshBlockLocal(BenchmarkItem):
+    name = "mesh_block_local"
+
+    # Whether mesh attributes are cached per patch (shared memory on CUDA,
+    # a thread-local buffer on CPU).
+    def __init__(self):
+        self._items = {"mesh_bls_off": False, "mesh_bls_on": True}
+
+    @staticmethod
+    def init_options(enabled: bool):
+        return {"make_mesh_block_local": enabled}
+
+
+class NumThreads(BenchmarkItem):
+    name = "num_threads"
+
+    # Number of CPU threads.
+    def __init__(self):
+        self._items = {"threads_1": 1, "threads_4": 4, "threads_16": 16, "threads_64": 64}
+
+    @staticmethod
+    def init_options(num_threads: int):
+        return {"cpu_max_num_threads": num_threads}
+
+
+class ThreadLocalArray(BenchmarkItem):
+    name = "thread_local_array"
+
+    # Whether small fields reduced into get a private copy per CPU thread.
+    def __init__(self):
+        self._items = {"global_atomics": 0, "privatized": 64 * 1024}
+
+    @staticmethod
+    def init_options(max_bytes: int):
+        return {"thread_local_array_max_bytes": max_bytes}
+
+
+class RandomGenerator(BenchmarkItem):
+    name = "rng"
+
+    # Per-thread xorshift states, or the counter-based Philox generator.
+    def __init__(self):
+        self._items = {"stateful": False, "philox": True}
+
+    @staticmethod
+    def init_options(counter_based: bool):
+        return {"counter_based_rng": counter_based}
+
+
+class StrengthReduction(BenchmarkItem):
+    name = "strength_reduction"
+
+    # Whether the divisions of the loop indices are replaced by counters.
+    def __init__(self):
+        self._items = {"divisions": False, "counters": True}
+
+    @staticmethod
+    def init_options(enabled: bool):
+        return {"strength_reduction": enabled}
@@ -1,6 +1,16 @@
 import itertools
 
-from microbenchmarks._items import AtomicOps, DataType
+from microbenchmarks._items import (
+    AtomicOps,
+    DataType,
+    MeshBlockLocal,
+    NumThreads,
+    RandomGenerator,
+    SimdWidth,
+    StrengthReduction,
+    ThreadAffinity,
+    ThreadLocalArray,
+)
 from microbenchmarks._metric import MetricType
 from microbenchmarks._utils import get_ti_arch, tags2name
 
@@ -48,7 +58,7 @@ class BenchmarkPlan:
     def run(self):
         for case, plan in self.plan.items():
             tag_list = plan["tags"]
-            MetricType.init_taichi(self.arch, tag_list)
+            MetricType.init_taichi(self.arch, tag_list, **self._get_init_options(tag_list))
             _ms = self.funcs.get_func(tag_list)(self.arch, self.basic_repeat_times, **self._get_kwargs(tag_list))
             plan["result"] = _ms
             print(f"{tag_list}={_ms}")
@@ -63,6 +73,25 @@ class BenchmarkPlan:
             kwargs[item.name] = item.impl(tag) if impl == True else tag
         return kwargs
 
+    def _get_init_options(self, tags):
+        options = {}
+        kwargs = self._get_kwargs(tags)
+        if SimdWidth.name in kwargs:
+            options.update(SimdWidth.init_options(kwargs[SimdWidth.name]))
+        if ThreadAffinity.name in kwargs:
+            options.update(ThreadAffinity.init_options(kwargs[ThreadAffinity.name]))
+        if MeshBlockLocal.name in kwargs:
+            options.update(MeshBlockLocal.init_options(kwargs[MeshBlockLocal.name]))
+        if NumThreads.name in kwargs:
+            options.update(NumThreads.init_options(kwargs[NumThreads.name]))
+        if ThreadLocalArray.name in kwargs:
+            options.update(ThreadLocalArray.init_options(kwargs[ThreadLocalArray.name]))
+        if RandomGenerator.name in kwargs:
+            options.update(RandomGenerator.init_options(kwargs[RandomGenerator.name]))
+        if StrengthReduction.name in kwargs:
+            options.update(StrengthReduction.init_options(kwargs[StrengthReduction.name]))
+        return options
+
     def _remove_conflict_items(self):
         remove_list = []
         # logical_atomic with float_type
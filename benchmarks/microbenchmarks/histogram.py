@@ -0,0 +1,79 @@
+from microbenchmarks._items import BenchmarkItem, NumThreads, ThreadLocalArray
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import scaled_repeat_times
+
+import taichi as ti
+
+num_samples = 4 * 1024 * 1024
+
+
+def histogram(arch, repeat, kernel, num_threads, thread_local_array, num_bins, get_metric):
+    repeat = scaled_repeat_times(arch, num_samples * 4, repeat)
+    x = ti.field(ti.f32, shape=num_samples)
+    hist = ti.field(ti.i32, shape=num_bins)
+
+    @ti.kernel
+    def init():
+        for i in x:
+            x[i] = ti.random()
+
+    @ti.kernel
+    def count():
+        for i in x:
+            hist[ti.min(ti.cast(x[i] * num_bins, ti.i32), num_bins - 1)] += 1
+
+    init()
+    return get_metric(repeat, count)
+
+
+def p2g(arch, repeat, kernel, num_threads, thread_local_array, num_bins, get_metric):
+    # A coarse 2D grid with |num_bins| cells, scattered to with a 2x2 kernel.
+    repeat = scaled_repeat_times(arch, num_samples * 8, repeat)
+    n = int(num_bins**0.5)
+    pos = ti.Vector.field(2, ti.f32, shape=num_samples)
+    grid = ti.field(ti.f32, shape=(n, n))
+
+    @ti.kernel
+    def init():
+        for p in pos:
+            pos[p] = [ti.random(), ti.random()]
+
+    @ti.kernel
+    def scatter():
+        for p in pos:
+            x = pos[p] * (n - 1)
+            base = ti.cast(x, ti.i32)
+            fx = x - base
+            for offset in ti.static(ti.grouped(ti.ndrange(2, 2))):
+                w = (1 - offset[0] + (2 * offset[0] - 1) * fx[0]) * (1 - offset[1] + (2 * offset[1] - 1) * fx[1])
+                grid[ti.min(base + offset, n - 1)] += w
+
+    init()
+    return get_metric(repeat, scatter)
+
+
+class HistogramKernel(BenchmarkItem):
+    name = "kernel"
+
+    def __init__(self):
+        self._items = {"histogram": None, "p2g": None}
+
+
+class NumBins(BenchmarkItem):
+    name = "num_bins"
+
+    def __init__(self):
+        self._items = {"bins_64": 64, "bins_1024": 1024}
+
+
+class HistogramPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("histogram", arch, basic_repeat_times=10)
+        self.create_plan(HistogramKernel(), NumThreads(), ThreadLocalArray(), NumBins(), MetricType())
+        # Both only apply to the CPU backend.
+        if arch != "x64":
+            for tag in ["threads_1", "threads_4", "threads_16", "privatized"]:
+                self.remove_cases_with_tags([tag])
+        self.add_func(["histogram"], histogram)
+        self.add_func(["p2g"], p2g)
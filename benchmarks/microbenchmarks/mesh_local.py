@@ -0,0 +1,107 @@
+import numpy as np
+from microbenchmarks._items import BenchmarkItem, MeshBlockLocal
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import scaled_repeat_times
+
+import taichi as ti
+
+# Splits a unit cube into 6 tetrahedra sharing its main diagonal.
+cube_tets = np.array(
+    [
+        (0, 1, 3, 7),
+        (0, 1, 5, 7),
+        (0, 2, 3, 7),
+        (0, 2, 6, 7),
+        (0, 4, 5, 7),
+        (0, 4, 6, 7),
+    ]
+)
+
+
+def tet_grid(n):
+    """Returns the tetrahedra and vertex positions of an n*n*n grid of cubes."""
+    i, j, k = np.meshgrid(np.arange(n + 1), np.arange(n + 1), np.arange(n + 1), indexing="ij")
+    positions = np.stack([i, j, k], axis=-1).reshape(-1, 3).astype(np.float32) / n
+    vert_id = lambda i, j, k: (i * (n + 1) + j) * (n + 1) + k
+    i, j, k = [a.reshape(-1, 1) for a in np.meshgrid(np.arange(n), np.arange(n), np.arange(n), indexing="ij")]
+    corners = np.concatenate([vert_id(i + (c >> 2), j + (c >> 1 & 1), k + (c & 1)) for c in range(8)], axis=1)
+    cells = corners[:, cube_tets].reshape(-1, 4)
+    return cells, positions
+
+
+def load_tet_grid(n, relations):
+    """Builds a patched tetrahedral mesh of an n*n*n grid of cubes."""
+    cells, positions = tet_grid(n)
+    return ti.Mesh._create_instance(ti.Mesh.build_meta(cells, positions, relations))
+
+
+def mass_spring(arch, repeat, workload, mesh_block_local, grid_size, get_metric):
+    mesh = load_tet_grid(grid_size, ["EV"])
+    repeat = scaled_repeat_times(arch, 1, repeat)
+    mesh.verts.place({"x": ti.math.vec3, "f": ti.math.vec3}, reorder=True)
+    mesh.edges.place({"rest_len": ti.f32})
+    mesh.verts.x.from_numpy(mesh.get_position_as_numpy())
+
+    @ti.kernel
+    def init_rest_len():
+        for e in mesh.edges:
+            e.rest_len = (e.verts[0].x - e.verts[1].x).norm()
+
+    @ti.kernel
+    def spring_forces():
+        if ti.static(mesh_block_local):
+            ti.mesh_local(mesh.verts.x, mesh.verts.f)
+        for e in mesh.edges:
+            d = e.verts[0].x - e.verts[1].x
+            f = -100.0 * (d.norm() - e.rest_len) * d.normalized()
+            e.verts[0].f += f
+            e.verts[1].f -= f
+
+    init_rest_len()
+    return get_metric(repeat, spring_forces)
+
+
+def fem_volume(arch, repeat, workload, mesh_block_local, grid_size, get_metric):
+    mesh = load_tet_grid(grid_size, ["CV"])
+    repeat = scaled_repeat_times(arch, 1, repeat)
+    mesh.verts.place({"x": ti.math.vec3, "m": ti.f32}, reorder=True)
+    mesh.verts.x.from_numpy(mesh.get_position_as_numpy())
+
+    @ti.kernel
+    def lumped_mass():
+        if ti.static(mesh_block_local):
+            ti.mesh_local(mesh.verts.x, mesh.verts.m)
+        for c in mesh.cells:
+            x0 = c.verts[0].x
+            D = ti.Matrix.cols([c.verts[i].x - x0 for i in ti.static(range(1, 4))])
+            m = ti.abs(D.determinant()) / 24.0
+            for i in ti.static(range(4)):
+                c.verts[i].m += m
+
+    return get_metric(repeat, lumped_mass)
+
+
+class Workload(BenchmarkItem):
+    name = "workload"
+
+    def __init__(self):
+        self._items = {"mass_spring": None, "fem_volume": None}
+
+
+class GridSize(BenchmarkItem):
+    name = "grid_size"
+
+    def __init__(self):
+        self._items = {"grid_16": 16, "grid_64": 64}
+
+
+class MeshLocalPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("mesh_local", arch, basic_repeat_times=10)
+        self.create_plan(Workload(), MeshBlockLocal(), GridSize(), MetricType())
+        # MeshTaichi is only supported on the CPU and CUDA backends.
+        if arch not in ["x64", "cuda"]:
+            self.remove_cases_with_tags(["mesh_local"])
+        self.add_func(["mass_spring"], mass_spring)
+        self.add_func(["fem_volume"], fem_volume)
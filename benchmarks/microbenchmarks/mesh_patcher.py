@@ -0,0 +1,55 @@
+from microbenchmarks._items import BenchmarkItem
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks.mesh_local import tet_grid
+
+import taichi as ti
+
+
+def load_mesh(arch, repeat, reorder, relations, grid_size, get_metric):
+    cells, positions = tet_grid(grid_size)
+
+    def func():
+        # Patching on the host, then uploading the metadata fields.
+        ti.Mesh.build_meta(cells, positions, relations, reorder=reorder)
+
+    return get_metric(repeat, func)
+
+
+class Reorder(BenchmarkItem):
+    name = "reorder"
+
+    def __init__(self):
+        self._items = {"rcm": "rcm", "sfc": "sfc"}
+
+
+class Relations(BenchmarkItem):
+    name = "relations"
+
+    def __init__(self):
+        self._items = {
+            "rel_cv": ["CV"],
+            "rel_fem": ["CV", "VC", "VV", "EV"],
+        }
+
+
+class GridSize(BenchmarkItem):
+    name = "grid_size"
+
+    def __init__(self):
+        # Up to 1.5M tetrahedra.
+        self._items = {"grid_32": 32, "grid_64": 64}
+
+
+class MeshPatcherPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("mesh_patcher", arch, basic_repeat_times=1)
+        # The load time is spent on the host, there is no kernel time to report.
+        metric = MetricType()
+        metric.remove(["kernel_elapsed_time_ms"])
+        self.create_plan(Reorder(), Relations(), GridSize(), metric)
+        # MeshTaichi is only supported on the CPU and CUDA backends.
+        if arch not in ["x64", "cuda"]:
+            self.remove_cases_with_tags(["mesh_patcher"])
+        self.add_func(["rcm"], load_mesh)
+        self.add_func(["sfc"], load_mesh)
@@ -0,0 +1,56 @@
+from microbenchmarks._items import BenchmarkItem, DataType
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, fill_random, scaled_repeat_times, size2tag
+
+import taichi as ti
+
+stencil_3d = [(0, 0, 0), (-1, 0, 0), (1, 0, 0), (0, -1, 0), (0, 1, 0), (0, 0, -1), (0, 0, 1)]
+
+
+def stencil_3d_layout(arch, repeat, layout, dtype, grid_size, get_metric):
+    n = grid_size
+    repeat = scaled_repeat_times(arch, n**3 * dtype_size(dtype), repeat)
+    y = ti.field(dtype)
+    x = ti.field(dtype)
+    ti.root.dense(ti.ijk, n).morton(layout).place(y)
+    ti.root.dense(ti.ijk, n).morton(layout).place(x)
+
+    @ti.kernel
+    def stencil(y: ti.template(), x: ti.template()):
+        # Struct-for, so that the cells are visited in storage order.
+        for I in ti.grouped(y):
+            if 0 < I[0] < n - 1 and 0 < I[1] < n - 1 and 0 < I[2] < n - 1:
+                s = ti.cast(0.0, dtype)
+                for offset in ti.static(stencil_3d):
+                    s = s + x[I + ti.Vector(offset)]
+                y[I] = s * ti.cast(1.0 / 7.0, dtype)
+
+    fill_random(x, dtype, ti.field)
+    return get_metric(repeat, stencil, y, x)
+
+
+class Layout(BenchmarkItem):
+    name = "layout"
+
+    def __init__(self):
+        self._items = {"row_major": False, "morton": True}
+
+
+class GridSize(BenchmarkItem):
+    name = "grid_size"
+
+    def __init__(self):
+        self._items = {}
+        for n in [16, 64, 256]:  # [16KB,1MB,64MB] per f32 field
+            self._items[size2tag(n**3 * 4)] = n
+
+
+class MortonPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("morton", arch, basic_repeat_times=10)
+        dtype = DataType()
+        dtype.remove_integer()
+        self.create_plan(Layout(), dtype, GridSize(), MetricType())
+        self.add_func(["row_major"], stencil_3d_layout)
+        self.add_func(["morton"], stencil_3d_layout)
@@ -0,0 +1,49 @@
+from microbenchmarks._items import BenchmarkItem, DataSize, DataType, ThreadAffinity
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, fill_random, scaled_repeat_times
+
+import taichi as ti
+
+
+def jacobi_sweeps(arch, repeat, sweeps, thread_affinity, dtype, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    n = int((dsize // dtype_size(dtype) // 2) ** 0.5)
+    x = ti.ndarray(dtype, (n, n))
+    y = ti.ndarray(dtype, (n, n))
+
+    @ti.kernel
+    def sweep(y: ti.types.ndarray(), x: ti.types.ndarray()):
+        for i, j in ti.ndrange((1, n - 1), (1, n - 1)):
+            y[i, j] = (x[i - 1, j] + x[i + 1, j] + x[i, j - 1] + x[i, j + 1]) * ti.cast(0.25, dtype)
+
+    def func():
+        # Consecutive launches over the same index ranges, which is where
+        # keeping each range on the same core pays off.
+        for _ in range(sweeps // 2):
+            sweep(y, x)
+            sweep(x, y)
+
+    fill_random(x, dtype, ti.ndarray)
+    return get_metric(repeat, func)
+
+
+class Sweeps(BenchmarkItem):
+    name = "sweeps"
+
+    def __init__(self):
+        self._items = {"sweeps_10": 10, "sweeps_100": 100}
+
+
+class PinningPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("pinning", arch, basic_repeat_times=1)
+        dtype = DataType()
+        dtype.remove(["i32", "i64", "f64"])
+        self.create_plan(Sweeps(), ThreadAffinity(), dtype, DataSize(), MetricType())
+        # Thread affinity only applies to the CPU backend.
+        if arch != "x64":
+            self.remove_cases_with_tags(["compact"])
+            self.remove_cases_with_tags(["scatter"])
+        self.add_func(["sweeps_10"], jacobi_sweeps)
+        self.add_func(["sweeps_100"], jacobi_sweeps)
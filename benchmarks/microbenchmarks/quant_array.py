@@ -0,0 +1,83 @@
+from microbenchmarks._items import BenchmarkItem, DataSize
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import scaled_repeat_times
+
+import taichi as ti
+
+
+def place_field(element_type, num_elements):
+    # Elements per 32-bit word, or None for a plain f32 field.
+    dtype, num_per_word = element_type
+    x = ti.field(dtype)
+    if num_per_word is None:
+        ti.root.dense(ti.i, num_elements).place(x)
+    else:
+        ti.root.dense(ti.i, num_elements // num_per_word).quant_array(ti.i, num_per_word, max_num_bits=32).place(x)
+    return x
+
+
+def quant_array_fill(arch, repeat, kernel, element_type, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    # The same number of elements for all the types, that of the f32 field.
+    num_elements = dsize // 4
+    x = place_field(element_type, num_elements)
+
+    @ti.kernel
+    def fill():
+        for i in range(num_elements):
+            x[i] = i % 64
+
+    return get_metric(repeat, fill)
+
+
+def quant_array_saxpy(arch, repeat, kernel, element_type, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements = dsize // 4 // 3  # z=x+y
+    x = place_field(element_type, num_elements)
+    y = place_field(element_type, num_elements)
+    z = place_field(element_type, num_elements)
+
+    @ti.kernel
+    def init():
+        for i in range(num_elements):
+            x[i] = i % 3
+            y[i] = i % 5
+
+    @ti.kernel
+    def saxpy():
+        for i in range(num_elements):
+            z[i] = 2 * x[i] + y[i]
+
+    init()
+    return get_metric(repeat, saxpy)
+
+
+class ElementType(BenchmarkItem):
+    name = "element_type"
+
+    def __init__(self):
+        self._items = {
+            "f32": (ti.f32, None),
+            "quant_int8": (ti.types.quant.int(8), 4),
+            "quant_fixed16": (ti.types.quant.fixed(bits=16, max_value=64), 2),
+        }
+
+
+class QuantArrayKernel(BenchmarkItem):
+    name = "kernel"
+
+    def __init__(self):
+        self._items = {"fill": None, "saxpy": None}
+
+
+class QuantArrayPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("quant_array", arch, basic_repeat_times=10)
+        self.create_plan(QuantArrayKernel(), ElementType(), DataSize(), MetricType())
+        # Quantized types are only supported by the LLVM backends.
+        if arch not in ["x64", "cuda"]:
+            self.remove_cases_with_tags(["quant_int8"])
+            self.remove_cases_with_tags(["quant_fixed16"])
+        self.add_func(["fill"], quant_array_fill)
+        self.add_func(["saxpy"], quant_array_saxpy)
@@ -0,0 +1,36 @@
+from microbenchmarks._items import DataSize, DataType, NumThreads, RandomGenerator
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, scaled_repeat_times
+
+import taichi as ti
+
+
+def random_fill(arch, repeat, rng, dtype, num_threads, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements = dsize // dtype_size(dtype)
+    x = ti.field(dtype, shape=num_elements)
+
+    @ti.kernel
+    def fill():
+        for i in x:
+            x[i] = ti.random(dtype)
+
+    return get_metric(repeat, fill)
+
+
+class RandomPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("random", arch, basic_repeat_times=10)
+        dtype = DataType()
+        dtype.remove(["i64"])
+        self.create_plan(RandomGenerator(), dtype, NumThreads(), DataSize(), MetricType())
+        # The counter-based generator is only implemented on the LLVM backends,
+        # and the thread counts only apply to the CPU backend.
+        if arch not in ["x64", "cuda"]:
+            self.remove_cases_with_tags(["philox"])
+        if arch != "x64":
+            for tag in ["threads_1", "threads_4", "threads_16"]:
+                self.remove_cases_with_tags([tag])
+        self.add_func(["stateful"], random_fill)
+        self.add_func(["philox"], random_fill)
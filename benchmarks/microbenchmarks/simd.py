@@ -0,0 +1,55 @@
+from microbenchmarks._items import BenchmarkItem, DataSize, DataType, SimdWidth
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, fill_random, scaled_repeat_times
+
+import taichi as ti
+
+
+def simd_elementwise(arch, repeat, kernel, simd_width, dtype, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements = dsize // dtype_size(dtype) // 2
+    x = ti.ndarray(dtype, num_elements)
+    y = ti.ndarray(dtype, num_elements)
+
+    @ti.kernel
+    def elementwise(y: ti.types.ndarray(), x: ti.types.ndarray()):
+        for i in range(x.shape[0]):
+            y[i] = x[i] * ti.cast(2.0, dtype) + y[i]
+
+    fill_random(x, dtype, ti.ndarray)
+    return get_metric(repeat, elementwise, y, x)
+
+
+def simd_stencil(arch, repeat, kernel, simd_width, dtype, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements = dsize // dtype_size(dtype) // 2
+    x = ti.ndarray(dtype, num_elements)
+    y = ti.ndarray(dtype, num_elements)
+
+    @ti.kernel
+    def stencil(y: ti.types.ndarray(), x: ti.types.ndarray()):
+        for i in range(1, x.shape[0] - 1):
+            y[i] = (x[i - 1] + x[i] + x[i + 1]) / ti.cast(3.0, dtype)
+
+    fill_random(x, dtype, ti.ndarray)
+    return get_metric(repeat, stencil, y, x)
+
+
+class SimdKernel(BenchmarkItem):
+    name = "kernel"
+
+    def __init__(self):
+        self._items = {"elementwise": None, "stencil": None}
+
+
+class SimdPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("simd", arch, basic_repeat_times=10)
+        self.create_plan(SimdKernel(), SimdWidth(), DataType(), DataSize(), MetricType())
+        # simd_width only applies to the CPU backend.
+        if arch != "x64":
+            self.remove_cases_with_tags(["avx2"])
+            self.remove_cases_with_tags(["avx512"])
+        self.add_func(["elementwise"], simd_elementwise)
+        self.add_func(["stencil"], simd_stencil)
@@ -0,0 +1,72 @@
+from microbenchmarks._items import BenchmarkItem, DataType
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import fill_random
+
+import taichi as ti
+from taichi.algorithms._algorithms import _odd_even_merge_sort
+
+
+def sort_default(arch, repeat, sort_impl, dtype, num_keys, get_metric):
+    keys = ti.field(dtype, num_keys)
+    values = ti.field(ti.i32, num_keys)
+    src = ti.field(dtype, num_keys)
+    fill_random(src, dtype, ti.field)
+
+    @ti.kernel
+    def reset(keys: ti.template(), values: ti.template(), src: ti.template()):
+        for i in keys:
+            keys[i] = src[i]
+            values[i] = i
+
+    if sort_impl == "numpy":
+        src_np = src.to_numpy()
+
+        def func():
+            src_np.argsort(kind="stable")
+
+    else:
+
+        def func():
+            # Sorting a sorted array is a special case, so every run starts
+            # from the same random keys.
+            reset(keys, values, src)
+            sort_impl(keys, values)
+
+    return get_metric(repeat, func)
+
+
+class SortImpl(BenchmarkItem):
+    name = "sort_impl"
+
+    def __init__(self):
+        self._items = {
+            "parallel_sort": ti.algorithms.parallel_sort,
+            "odd_even_merge_sort": _odd_even_merge_sort,
+            "numpy": "numpy",
+        }
+
+
+class NumKeys(BenchmarkItem):
+    name = "num_keys"
+
+    def __init__(self):
+        self._items = {"1M": 2**20, "10M": 10 * 2**20, "100M": 100 * 2**20}
+
+
+class SortPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("sort", arch, basic_repeat_times=1)
+        dtype = DataType()
+        dtype.remove(["i64", "f64"])
+        metric = MetricType()
+        metric.remove(["kernel_elapsed_time_ms"])
+        self.create_plan(SortImpl(), dtype, NumKeys(), metric)
+        # parallel_sort only differs from odd_even_merge_sort on CPU.
+        if arch != "x64":
+            self.remove_cases_with_tags(["parallel_sort"])
+        # Takes minutes.
+        self.remove_cases_with_tags(["odd_even_merge_sort", "100M"])
+        self.add_func(["parallel_sort"], sort_default)
+        self.add_func(["odd_even_merge_sort"], sort_default)
+        self.add_func(["numpy"], sort_default)
@@ -0,0 +1,39 @@
+from microbenchmarks._items import Container, DataSize, DataType, StrengthReduction
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, scaled_repeat_times
+
+import taichi as ti
+
+
+def stream_3d(arch, repeat, strength_reduction, container, dtype, dsize, get_metric):
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements = dsize // dtype_size(dtype) // 2
+    # Extents that are not powers of two, so that computing the coordinates from the loop index takes divisions:
+    # by constants for the demoted struct-fors over fields, by the runtime extents for the ndarrays.
+    shape = (num_elements // (24 * 40), 24, 40)
+
+    y = container(dtype, shape=shape)
+    x = container(dtype, shape=shape)
+
+    @ti.kernel
+    def scale_field(y: ti.template(), x: ti.template()):
+        for i, j, k in x:
+            y[i, j, k] = x[i, j, k] * 2
+
+    @ti.kernel
+    def scale_array(y: ti.types.ndarray(ndim=3), x: ti.types.ndarray(ndim=3)):
+        for i, j, k in x:
+            y[i, j, k] = x[i, j, k] * 2
+
+    x.fill(1)
+    func = scale_field if container == ti.field else scale_array
+    return get_metric(repeat, func, y, x)
+
+
+class StrengthReductionPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("strength_reduction", arch, basic_repeat_times=10)
+        self.create_plan(StrengthReduction(), Container(), DataType(), DataSize(), MetricType())
+        self.add_func(["divisions"], stream_3d)
+        self.add_func(["counters"], stream_3d)
@@ -0,0 +1,53 @@
+from microbenchmarks._items import BenchmarkItem, Container, DataType
+from microbenchmarks._metric import MetricType
+from microbenchmarks._plan import BenchmarkPlan
+from microbenchmarks._utils import dtype_size, fill_random, scaled_repeat_times
+from microbenchmarks.stencil2d import DataSize2D
+
+import taichi as ti
+
+
+def tiled_stencil_2d(arch, repeat, tile, container, dtype, dsize_2d, get_metric):
+    dsize = dsize_2d[0] * dsize_2d[1]
+    repeat = scaled_repeat_times(arch, dsize, repeat)
+    num_elements_2d = (dsize_2d[0] // dtype_size(dtype), dsize_2d[1] // 2)
+
+    y = container(dtype, shape=num_elements_2d)
+    x = container(dtype, shape=num_elements_2d)
+
+    @ti.kernel
+    def laplace_field(y: ti.template(), x: ti.template()):
+        ti.loop_config(tile=tile)
+        for i, j in ti.ndrange((1, x.shape[0] - 1), (1, x.shape[1] - 1)):
+            y[i, j] = 4 * x[i, j] - x[i - 1, j] - x[i + 1, j] - x[i, j - 1] - x[i, j + 1]
+
+    @ti.kernel
+    def laplace_array(y: ti.types.ndarray(), x: ti.types.ndarray()):
+        ti.loop_config(tile=tile)
+        for i, j in ti.ndrange((1, x.shape[0] - 1), (1, x.shape[1] - 1)):
+            y[i, j] = 4 * x[i, j] - x[i - 1, j] - x[i + 1, j] - x[i, j - 1] - x[i, j + 1]
+
+    fill_random(x, dtype, container)
+    func = laplace_field if container == ti.field else laplace_array
+    return get_metric(repeat, func, y, x)
+
+
+class LoopTiling(BenchmarkItem):
+    name = "tile"
+
+    # Tile sizes of the 2D ndrange loop, see ti.loop_config(tile=...).
+    def __init__(self):
+        self._items = {"untiled": None, "tile_auto": True, "tile_16x64": (16, 64)}
+
+
+class TilingPlan(BenchmarkPlan):
+    def __init__(self, arch: str):
+        super().__init__("tiling", arch, basic_repeat_times=10)
+        dtype = DataType()
+        dtype.remove_integer()
+        self.create_plan(LoopTiling(), Container(), dtype, DataSize2D(), MetricType())
+        # Loop tiling only applies to the CPU backends.
+        if arch not in ["x64", "arm64"]:
+            self.remove_cases_with_tags(["tile_auto"])
+            self.remove_cases_with_tags(["tile_16x64"])
+        self.add_func(["tiling"], tiled_stencil_2d)
@@ -11,6 +11,7 @@ class MicroBenchmark:
         "cuda": {"enable": True},
         "vulkan": {"enable": False},
         "opengl": {"enable": False},
+        "x64": {"enable": False},
     }
 
     def __init__(self):
@@ -857,6 +857,83 @@ DEFINE_DATA_TYPE_ENUM(uint64_t, U64);
 DEFINE_DATA_TYPE_ENUM(int64_t, I64);
 #undef DEFINE_DATA_TYPE_ENUM
 
+class KernelArgs {
+ protected:
+  TiRuntime runtime_{TI_NULL_HANDLE};
+  TiKernelArgs kernel_args_{TI_NULL_HANDLE};
+  bool should_destroy_{false};
+
+ public:
+  constexpr bool is_valid() const {
+    return kernel_args_ != nullptr;
+  }
+  inline void destroy() {
+    if (should_destroy_) {
+      ti_destroy_kernel_args(kernel_args_);
+      kernel_args_ = TI_NULL_HANDLE;
+      should_destroy_ = false;
+    }
+  }
+
+  KernelArgs() {
+  }
+  KernelArgs(const KernelArgs &) = delete;
+  KernelArgs(KernelArgs &&b)
+      : runtime_(detail::move_handle(b.runtime_)),
+        kernel_args_(detail::move_handle(b.kernel_args_)),
+        should_destroy_(detail::exchange(b.should_destroy_, false)) {
+  }
+  KernelArgs(TiRuntime runtime, TiKernelArgs kernel_args, bool should_destroy)
+      : runtime_(runtime),
+        kernel_args_(kernel_args),
+        should_destroy_(should_destroy) {
+  }
+  ~KernelArgs() {
+    destroy();
+  }
+
+  KernelArgs &operator=(const KernelArgs &) = delete;
+  KernelArgs &operator=(KernelArgs &&b) {
+    destroy();
+    runtime_ = detail::move_handle(b.runtime_);
+    kernel_args_ = detail::move_handle(b.kernel_args_);
+    should_destroy_ = detail::exchange(b.should_destroy_, false);
+    return *this;
+  }
+
+  void update(uint32_t arg_index, const TiArgument &arg) const {
+    ti_update_kernel_arg(kernel_args_, arg_index, &arg);
+  }
+  template <typename T>
+  void update(uint32_t arg_index, const std::vector<T> &v) const {
+    TiArgument arg{};
+    arg.type = TI_ARGUMENT_TYPE_TENSOR;
+    std::memcpy(arg.value.tensor.contents.data.x32, v.data(),
+                v.size() * sizeof(T));
+    arg.value.tensor.contents.length = v.size();
+    arg.value.tensor.type = DataTypeToEnum<T>::value;
+    update(arg_index, arg);
+  }
+  template <typename T>
+  void update(uint32_t arg_index, const T &value) const {
+    TiArgument arg{};
+    ArgumentEntry entry(&arg);
+    entry = value;
+    update(arg_index, arg);
+  }
+
+  void launch() const {
+    ti_launch_kernel_with_args(runtime_, kernel_args_);
+  }
+
+  constexpr TiKernelArgs kernel_args() const {
+    return kernel_args_;
+  }
+  constexpr operator TiKernelArgs() const {  // NOLINT
+    return kernel_args_;
+  }
+};
+
 class Kernel {
  protected:
   TiRuntime runtime_{TI_NULL_HANDLE};
@@ -932,6 +1009,21 @@ class Kernel {
     launch(arguments.size(), arguments.data());
   }
 
+  KernelArgs create_args() const {
+    TiKernelArgs kernel_args = ti_create_kernel_args(runtime_, kernel_);
+    return KernelArgs(runtime_, kernel_args, true);
+  }
+
+  // Describes a launch with the currently pushed arguments, to be submitted
+  // with `Runtime::launch_kernels`. The arguments must outlive the launch.
+  TiKernelLaunch launch_desc() const {
+    TiKernelLaunch out{};
+    out.kernel = kernel_;
+    out.arg_count = args_.size();
+    out.args = args_.data();
+    return out;
+  }
+
   constexpr TiKernel kernel() const {
     return kernel_;
   }
@@ -1356,6 +1448,14 @@ class Runtime {
     ti_transition_image(runtime_, image, layout);
   }
 
+  void launch_kernels(uint32_t launch_count,
+                      const TiKernelLaunch *launches) const {
+    ti_launch_kernels(runtime_, launch_count, launches);
+  }
+  void launch_kernels(const std::vector<TiKernelLaunch> &launches) const {
+    launch_kernels(launches.size(), launches.data());
+  }
+
   void flush() const {
     ti_flush(runtime_);
   }
@@ -313,6 +313,12 @@ typedef struct TiKernel_t *TiKernel;
 // target in a predefined order.
 typedef struct TiComputeGraph_t *TiComputeGraph;
 
+// Handle `TiKernelArgs` (1.7.0)
+//
+// Arguments of a Taichi kernel encoded in the layout expected by the kernel.
+// It can be updated in place and launched many times.
+typedef struct TiKernelArgs_t *TiKernelArgs;
+
 // Enumeration `TiError` (1.4.0)
 //
 // Errors reported by the Taichi C-API.
@@ -874,6 +880,19 @@ typedef struct TiNamedArgument {
   TiArgument argument;
 } TiNamedArgument;
 
+// Structure `TiKernelLaunch` (1.7.0)
+//
+// A kernel invocation in a batch submitted by
+// [`ti_launch_kernels`](#function-ti_launch_kernels).
+typedef struct TiKernelLaunch {
+  // Kernel to launch.
+  TiKernel kernel;
+  // Number of arguments in `args`.
+  uint32_t arg_count;
+  // Arguments of the kernel, in the same order as in the source code.
+  const TiArgument *args;
+} TiKernelLaunch;
+
 // Function `ti_get_version` (1.4.0)
 //
 // Get the current taichi version. It has the same value as `TI_C_API_VERSION`
@@ -1046,6 +1065,51 @@ TI_DLL_EXPORT void TI_API_CALL ti_launch_kernel(TiRuntime runtime,
                                                 uint32_t arg_count,
                                                 const TiArgument *args);
 
+// Function `ti_launch_kernels` (Device Command) (1.7.0)
+//
+// Launches a batch of Taichi kernels in order. Every launch in the batch is
+// validated before any of them is launched, so a batch with an invalid launch
+// has no effect. The kernels are recorded into the same device command list.
+// Prefer this over repeated calls to
+// [`ti_launch_kernel`](#function-ti_launch_kernel) when many small kernels are
+// dispatched together.
+TI_DLL_EXPORT void TI_API_CALL
+ti_launch_kernels(TiRuntime runtime,
+                  uint32_t launch_count,
+                  const TiKernelLaunch *launches);
+
+// Function `ti_create_kernel_args` (1.7.0)
+//
+// Creates an argument set for a kernel. Every argument *must* be set with
+// [`ti_update_kernel_arg`](#function-ti_update_kernel_arg) before the first
+// launch. Returns [`TI_NULL_HANDLE`](#definition-ti_null_handle) on failure.
+TI_DLL_EXPORT TiKernelArgs TI_API_CALL ti_create_kernel_args(TiRuntime runtime,
+                                                             TiKernel kernel);
+
+// Function `ti_destroy_kernel_args` (1.7.0)
+//
+// Destroys an argument set. Launches that used it and are still pending are
+// not affected.
+TI_DLL_EXPORT void TI_API_CALL
+ti_destroy_kernel_args(TiKernelArgs kernel_args);
+
+// Function `ti_update_kernel_arg` (1.7.0)
+//
+// Validates an argument and encodes it into an argument set. The other
+// arguments keep their values.
+TI_DLL_EXPORT void TI_API_CALL ti_update_kernel_arg(TiKernelArgs kernel_args,
+                                                    uint32_t arg_index,
+                                                    const TiArgument *arg);
+
+// Function `ti_launch_kernel_with_args` (Device Command) (1.7.0)
+//
+// Launches the kernel of an argument set with its current arguments. The
+// arguments are not decoded again, so this is cheaper than
+// [`ti_launch_kernel`](#function-ti_launch_kernel) for kernels launched
+// repeatedly with mostly unchanged arguments.
+TI_DLL_EXPORT void TI_API_CALL
+ti_launch_kernel_with_args(TiRuntime runtime, TiKernelArgs kernel_args);
+
 // Function `ti_launch_compute_graph` (Device Command) (1.4.0)
 //
 // Launches a Taichi compute graph with provided named arguments. The named
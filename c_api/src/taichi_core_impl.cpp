@@ -140,6 +140,16 @@ AotModule::AotModule(Runtime &runtime,
     : runtime_(&runtime), aot_module_(std::move(aot_module)) {
 }
 
+KernelArgs::KernelArgs(Runtime &runtime, taichi::lang::aot::Kernel *kernel)
+    : runtime(runtime), kernel(kernel), builder(kernel) {
+  size_t arg_count = kernel->get_arg_layout().args.size();
+  devallocs.resize(arg_count);
+  devalloc_types.resize(
+      arg_count, taichi::lang::LaunchContextBuilder::DevAllocType::kNone);
+  is_set.resize(arg_count, false);
+  unset_count = arg_count;
+}
+
 taichi::lang::aot::Kernel *AotModule::get_kernel(const std::string &name) {
   return aot_module_->get_kernel(name);
 }
@@ -825,6 +835,310 @@ void ti_launch_kernel(TiRuntime runtime,
   TI_CAPI_TRY_CATCH_END();
 }
 
+namespace {
+
+using taichi::lang::ArgBufferLayout;
+
+// Checks that `arg` can be encoded into the argument slot `entry`. On failure
+// the last error is set with `name` as the offending argument.
+bool check_kernel_arg(const TiArgument &arg,
+                      const ArgBufferLayout::Entry &entry,
+                      const std::string &name) {
+  bool matches = false;
+  switch (arg.type) {
+    case TI_ARGUMENT_TYPE_I32:
+    case TI_ARGUMENT_TYPE_F32: {
+      matches = entry.kind == ArgBufferLayout::Kind::kScalar &&
+                entry.size == sizeof(uint32_t);
+      break;
+    }
+    case TI_ARGUMENT_TYPE_SCALAR: {
+      const TiDataType dtype = arg.value.scalar.type;
+      if (dtype != TI_DATA_TYPE_I16 && dtype != TI_DATA_TYPE_U16 &&
+          dtype != TI_DATA_TYPE_F16) {
+        ti_set_last_error(TI_ERROR_ARGUMENT_OUT_OF_RANGE,
+                          (name + ".value.scalar.type").c_str());
+        return false;
+      }
+      matches = entry.kind == ArgBufferLayout::Kind::kScalar &&
+                (dtype == TI_DATA_TYPE_F16 || entry.size == sizeof(uint16_t));
+      break;
+    }
+    case TI_ARGUMENT_TYPE_NDARRAY: {
+      if (arg.value.ndarray.memory == TI_NULL_HANDLE) {
+        ti_set_last_error(TI_ERROR_ARGUMENT_NULL,
+                          (name + ".value.ndarray.memory").c_str());
+        return false;
+      }
+      if (arg.value.ndarray.shape.dim_count > entry.shape_offsets.size()) {
+        ti_set_last_error(TI_ERROR_ARGUMENT_OUT_OF_RANGE,
+                          (name + ".value.ndarray.shape.dim_count").c_str());
+        return false;
+      }
+      matches = entry.kind == ArgBufferLayout::Kind::kArray;
+      break;
+    }
+    case TI_ARGUMENT_TYPE_TEXTURE: {
+      if (arg.value.texture.image == TI_NULL_HANDLE) {
+        ti_set_last_error(TI_ERROR_ARGUMENT_NULL,
+                          (name + ".value.texture.image").c_str());
+        return false;
+      }
+      matches = entry.kind == ArgBufferLayout::Kind::kArray;
+      break;
+    }
+    case TI_ARGUMENT_TYPE_TENSOR: {
+      const TiDataType dtype = arg.value.tensor.type;
+      size_t elem_size = 0;
+      if (dtype == TI_DATA_TYPE_I16 || dtype == TI_DATA_TYPE_U16 ||
+          dtype == TI_DATA_TYPE_F16) {
+        elem_size = sizeof(uint16_t);
+      } else if (dtype == TI_DATA_TYPE_I32 || dtype == TI_DATA_TYPE_U32 ||
+                 dtype == TI_DATA_TYPE_F32) {
+        elem_size = sizeof(uint32_t);
+      } else {
+        ti_set_last_error(TI_ERROR_NOT_SUPPORTED,
+                          (name + ".value.tensor.type").c_str());
+        return false;
+      }
+      matches = entry.kind == ArgBufferLayout::Kind::kTensor &&
+                arg.value.tensor.contents.length * elem_size <= entry.size;
+      break;
+    }
+    default: {
+      ti_set_last_error(TI_ERROR_ARGUMENT_OUT_OF_RANGE,
+                        (name + ".type").c_str());
+      return false;
+    }
+  }
+  if (!matches) {
+    ti_set_last_error(TI_ERROR_INVALID_ARGUMENT, name.c_str());
+  }
+  return matches;
+}
+
+// Whether the argument refers to a device allocation, which must outlive the
+// launches it is encoded for.
+bool is_devalloc_arg(const TiArgument &arg) {
+  return arg.type == TI_ARGUMENT_TYPE_NDARRAY ||
+         arg.type == TI_ARGUMENT_TYPE_TEXTURE;
+}
+
+// Encodes an argument that passed `check_kernel_arg`. `devalloc` is the
+// storage of the `DeviceAllocation` for ndarray and texture arguments.
+void encode_kernel_arg(Runtime &runtime,
+                       taichi::lang::LaunchContextBuilder &builder,
+                       int arg_id,
+                       const ArgBufferLayout::Entry &entry,
+                       const TiArgument &arg,
+                       taichi::lang::DeviceAllocation *devalloc) {
+  switch (arg.type) {
+    case TI_ARGUMENT_TYPE_I32: {
+      builder.set_arg_with_layout(arg_id, entry, &arg.value.i32,
+                                  sizeof(arg.value.i32));
+      break;
+    }
+    case TI_ARGUMENT_TYPE_F32: {
+      builder.set_arg_with_layout(arg_id, entry, &arg.value.f32,
+                                  sizeof(arg.value.f32));
+      break;
+    }
+    case TI_ARGUMENT_TYPE_SCALAR: {
+      if (arg.value.scalar.type == TI_DATA_TYPE_F16) {
+        float arg_val;
+        std::memcpy(&arg_val, &arg.value.scalar.value.x32, sizeof(arg_val));
+        // FIXME: temporary workaround for f16
+        builder.set_arg_float(arg_id, arg_val);
+      } else {
+        builder.set_arg_with_layout(arg_id, entry, &arg.value.scalar.value.x16,
+                                    sizeof(arg.value.scalar.value.x16));
+      }
+      break;
+    }
+    case TI_ARGUMENT_TYPE_NDARRAY: {
+      const TiNdArray &ndarray = arg.value.ndarray;
+      *devalloc = devmem2devalloc(runtime, ndarray.memory);
+      builder.set_arg_ndarray_with_layout(arg_id, entry, (intptr_t)devalloc,
+                                          (const int *)ndarray.shape.dims,
+                                          ndarray.shape.dim_count);
+      break;
+    }
+    case TI_ARGUMENT_TYPE_TEXTURE: {
+      *devalloc = devimg2devalloc(runtime, arg.value.texture.image);
+      int width = arg.value.texture.extent.width;
+      int height = arg.value.texture.extent.height;
+      int depth = arg.value.texture.extent.depth;
+      builder.set_arg_rw_texture_impl(arg_id, (intptr_t)devalloc,
+                                      {width, height, depth});
+      break;
+    }
+    case TI_ARGUMENT_TYPE_TENSOR: {
+      const auto &tensor = arg.value.tensor;
+      size_t elem_size = (tensor.type == TI_DATA_TYPE_I16 ||
+                          tensor.type == TI_DATA_TYPE_U16 ||
+                          tensor.type == TI_DATA_TYPE_F16)
+                             ? sizeof(uint16_t)
+                             : sizeof(uint32_t);
+      builder.set_arg_with_layout(arg_id, entry, tensor.contents.data.x8,
+                                  tensor.contents.length * elem_size);
+      break;
+    }
+    default: {
+      TI_NOT_IMPLEMENTED;
+    }
+  }
+}
+
+}  // namespace
+
+void ti_launch_kernels(TiRuntime runtime,
+                       uint32_t launch_count,
+                       const TiKernelLaunch *launches) {
+  TI_CAPI_TRY_CATCH_BEGIN();
+  TI_CAPI_ARGUMENT_NULL(runtime);
+  if (launch_count > 0) {
+    TI_CAPI_ARGUMENT_NULL(launches);
+  }
+
+  Runtime &runtime2 = *((Runtime *)runtime);
+
+  // Validate the whole batch first so that an invalid launch in the middle
+  // doesn't leave the batch partially submitted.
+  size_t devalloc_count = 0;
+  for (uint32_t i = 0; i < launch_count; ++i) {
+    const TiKernelLaunch &launch = launches[i];
+    const std::string name = "launches[" + std::to_string(i) + "]";
+    if (launch.kernel == TI_NULL_HANDLE) {
+      ti_set_last_error(TI_ERROR_ARGUMENT_NULL, (name + ".kernel").c_str());
+      return;
+    }
+    if (launch.arg_count > 0 && launch.args == nullptr) {
+      ti_set_last_error(TI_ERROR_ARGUMENT_NULL, (name + ".args").c_str());
+      return;
+    }
+    const ArgBufferLayout &layout =
+        ((taichi::lang::aot::Kernel *)launch.kernel)->get_arg_layout();
+    if (launch.arg_count != layout.args.size()) {
+      ti_set_last_error(TI_ERROR_ARGUMENT_OUT_OF_RANGE,
+                        (name + ".arg_count").c_str());
+      return;
+    }
+    for (uint32_t j = 0; j < launch.arg_count; ++j) {
+      if (!check_kernel_arg(launch.args[j], layout.args[j],
+                            name + ".args[" + std::to_string(j) + "]")) {
+        return;
+      }
+      if (is_devalloc_arg(launch.args[j])) {
+        ++devalloc_count;
+      }
+    }
+  }
+
+  // Encode every launch with the cached layouts. The device allocations are
+  // referred to by the backends until the kernels are launched, so the
+  // storage is reserved upfront to keep their addresses stable.
+  std::vector<taichi::lang::DeviceAllocation> devallocs;
+  devallocs.reserve(devalloc_count);
+  std::vector<taichi::lang::LaunchContextBuilder> builders;
+  builders.reserve(launch_count);
+  for (uint32_t i = 0; i < launch_count; ++i) {
+    const TiKernelLaunch &launch = launches[i];
+    auto ti_kernel = (taichi::lang::aot::Kernel *)launch.kernel;
+    const ArgBufferLayout &layout = ti_kernel->get_arg_layout();
+    builders.emplace_back(ti_kernel);
+    for (uint32_t j = 0; j < launch.arg_count; ++j) {
+      taichi::lang::DeviceAllocation *devalloc = nullptr;
+      if (is_devalloc_arg(launch.args[j])) {
+        devalloc = &devallocs.emplace_back();
+      }
+      encode_kernel_arg(runtime2, builders.back(), j, layout.args[j],
+                        launch.args[j], devalloc);
+    }
+  }
+
+  for (uint32_t i = 0; i < launch_count; ++i) {
+    ((taichi::lang::aot::Kernel *)launches[i].kernel)->launch(builders[i]);
+  }
+  TI_CAPI_TRY_CATCH_END();
+}
+
+TiKernelArgs ti_create_kernel_args(TiRuntime runtime, TiKernel kernel) {
+  TiKernelArgs out = TI_NULL_HANDLE;
+  TI_CAPI_TRY_CATCH_BEGIN();
+  TI_CAPI_ARGUMENT_NULL_RV(runtime);
+  TI_CAPI_ARGUMENT_NULL_RV(kernel);
+
+  out = (TiKernelArgs) new KernelArgs(*(Runtime *)runtime,
+                                      (taichi::lang::aot::Kernel *)kernel);
+  TI_CAPI_TRY_CATCH_END();
+  return out;
+}
+
+void ti_destroy_kernel_args(TiKernelArgs kernel_args) {
+  TI_CAPI_TRY_CATCH_BEGIN();
+  TI_CAPI_ARGUMENT_NULL(kernel_args);
+
+  delete (KernelArgs *)kernel_args;
+  TI_CAPI_TRY_CATCH_END();
+}
+
+void ti_update_kernel_arg(TiKernelArgs kernel_args,
+                          uint32_t arg_index,
+                          const TiArgument *arg) {
+  TI_CAPI_TRY_CATCH_BEGIN();
+  TI_CAPI_ARGUMENT_NULL(kernel_args);
+  TI_CAPI_ARGUMENT_NULL(arg);
+
+  KernelArgs &kernel_args2 = *(KernelArgs *)kernel_args;
+  const ArgBufferLayout &layout = kernel_args2.kernel->get_arg_layout();
+  if (arg_index >= layout.args.size()) {
+    ti_set_last_error(TI_ERROR_ARGUMENT_OUT_OF_RANGE, "arg_index");
+    return;
+  }
+  const ArgBufferLayout::Entry &entry = layout.args[arg_index];
+  if (!check_kernel_arg(*arg, entry, "arg")) {
+    return;
+  }
+  encode_kernel_arg(kernel_args2.runtime, kernel_args2.builder, arg_index,
+                    entry, *arg, &kernel_args2.devallocs[arg_index]);
+  kernel_args2.devalloc_types[arg_index] =
+      kernel_args2.builder.device_allocation_type[arg_index];
+  if (!kernel_args2.is_set[arg_index]) {
+    kernel_args2.is_set[arg_index] = true;
+    --kernel_args2.unset_count;
+  }
+  TI_CAPI_TRY_CATCH_END();
+}
+
+void ti_launch_kernel_with_args(TiRuntime runtime, TiKernelArgs kernel_args) {
+  TI_CAPI_TRY_CATCH_BEGIN();
+  TI_CAPI_ARGUMENT_NULL(runtime);
+  TI_CAPI_ARGUMENT_NULL(kernel_args);
+
+  KernelArgs &kernel_args2 = *(KernelArgs *)kernel_args;
+  TI_CAPI_INVALID_ARGUMENT(&kernel_args2.runtime != (Runtime *)runtime);
+  if (kernel_args2.unset_count > 0) {
+    for (uint32_t i = 0; i < kernel_args2.is_set.size(); ++i) {
+      if (!kernel_args2.is_set[i]) {
+        ti_set_last_error(
+            TI_ERROR_INVALID_ARGUMENT,
+            ("kernel_args.args[" + std::to_string(i) + "]").c_str());
+        return;
+      }
+    }
+  }
+
+  // Backends may rewrite the allocation type of the arguments while
+  // launching, e.g. the CPU launcher replaces device allocations with raw
+  // pointers in place. Restore what was encoded so every launch starts from
+  // the same state.
+  std::copy(kernel_args2.devalloc_types.begin(),
+            kernel_args2.devalloc_types.end(),
+            kernel_args2.builder.device_allocation_type);
+  kernel_args2.kernel->launch(kernel_args2.builder);
+  TI_CAPI_TRY_CATCH_END();
+}
+
 void ti_launch_compute_graph(TiRuntime runtime,
                              TiComputeGraph compute_graph,
                              uint32_t arg_count,
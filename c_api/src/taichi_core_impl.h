@@ -197,6 +197,23 @@ class AotModule {
   Runtime &runtime();
 };
 
+// Arguments of a kernel kept encoded in its argument buffer, so that repeated
+// launches only re-encode the arguments that changed.
+class KernelArgs {
+ public:
+  KernelArgs(Runtime &runtime, taichi::lang::aot::Kernel *kernel);
+
+  Runtime &runtime;
+  taichi::lang::aot::Kernel *const kernel;
+  taichi::lang::LaunchContextBuilder builder;
+  // Storage of the `DeviceAllocation` of each ndarray or texture argument.
+  // Sized once so that the pointers encoded in `builder` stay valid.
+  std::vector<taichi::lang::DeviceAllocation> devallocs;
+  std::vector<taichi::lang::LaunchContextBuilder::DevAllocType> devalloc_types;
+  std::vector<bool> is_set;
+  size_t unset_count;
+};
+
 namespace {
 
 template <typename THandle>
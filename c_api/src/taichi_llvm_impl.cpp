@@ -122,7 +122,9 @@ TiAotModule LlvmRuntime::load_aot_module(const char *module_path) {
 void LlvmRuntime::buffer_copy(const taichi::lang::DevicePtr &dst,
                               const taichi::lang::DevicePtr &src,
                               size_t size) {
-  TI_NOT_IMPLEMENTED;
+  // Copies are serialized with the kernels launched before them.
+  executor_->synchronize();
+  taichi::lang::Device::memcpy_direct(dst, src, size);
 }
 
 void LlvmRuntime::flush() {
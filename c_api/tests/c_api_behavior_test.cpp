@@ -380,6 +380,7 @@ TEST_F(CapiTest, TestBehaviorCopyMemoryDTD) {
     }
   };
   inner(TI_ARCH_VULKAN);
+  inner(TI_ARCH_X64);
 }
 
 TEST_F(CapiTest, TestBehaviorLoadAOTModuleVulkan) {
@@ -0,0 +1,272 @@
+#include <chrono>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "c_api_test_utils.h"
+#include "taichi/cpp/taichi.hpp"
+#include "c_api/tests/gtest_fixture.h"
+
+namespace {
+
+// Arguments of `run(base: int, arr: ndarray, v: vec3 i32)` in
+// kernel_aot_test1.py, which sets `arr[i] = base + i + v[0]`.
+std::vector<TiArgument> make_run_args(int32_t base,
+                                      const ti::NdArray<int32_t> &arr,
+                                      int32_t v0) {
+  std::vector<TiArgument> args(3);
+  args[0].type = TI_ARGUMENT_TYPE_I32;
+  args[0].value.i32 = base;
+  args[1].type = TI_ARGUMENT_TYPE_NDARRAY;
+  args[1].value.ndarray = arr.ndarray();
+  args[2].type = TI_ARGUMENT_TYPE_TENSOR;
+  args[2].value.tensor.type = TI_DATA_TYPE_I32;
+  args[2].value.tensor.contents.length = 3;
+  args[2].value.tensor.contents.data.x32[0] = v0;
+  args[2].value.tensor.contents.data.x32[1] = 0;
+  args[2].value.tensor.contents.data.x32[2] = 0;
+  return args;
+}
+
+void check_run_result(ti::NdArray<int32_t> &arr, int32_t expected_base) {
+  const int32_t *data = reinterpret_cast<const int32_t *>(arr.map());
+  for (int i = 0; i < arr.elem_count(); ++i) {
+    EXPECT_EQ(data[i], expected_base + i);
+  }
+  arr.unmap();
+}
+
+void launch_kernels_test(TiArch arch) {
+  const uint32_t kArrLen = 32;
+  const uint32_t kNumLaunches = 4;
+
+  const auto folder_dir = getenv("TAICHI_AOT_FOLDER_PATH");
+
+  ti::Runtime runtime(arch);
+  ti::AotModule aot_mod = runtime.load_aot_module(folder_dir);
+  ti::Kernel k_run = aot_mod.get_kernel("run");
+
+  std::vector<ti::NdArray<int32_t>> arrs;
+  std::vector<std::vector<TiArgument>> args;
+  std::vector<TiKernelLaunch> launches;
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    arrs.emplace_back(
+        runtime.allocate_ndarray<int32_t>({kArrLen}, {1}, true));
+  }
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    args.emplace_back(make_run_args(i * 100, arrs[i], i));
+  }
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    TiKernelLaunch launch{};
+    launch.kernel = k_run;
+    launch.arg_count = args[i].size();
+    launch.args = args[i].data();
+    launches.emplace_back(launch);
+  }
+
+  runtime.launch_kernels(launches);
+  runtime.wait();
+  capi::utils::check_runtime_error(runtime);
+
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    check_run_result(arrs[i], i * 100 + i);
+  }
+
+  // An invalid launch fails the whole batch, including the launches before
+  // it.
+  std::vector<TiArgument> updated_args = make_run_args(1000, arrs[0], 0);
+  launches[0].args = updated_args.data();
+  launches[1].arg_count = 2;
+  runtime.launch_kernels(launches);
+  ti::Error err = ti::get_last_error();
+  EXPECT_EQ(err.error, TI_ERROR_ARGUMENT_OUT_OF_RANGE);
+  EXPECT_NE(err.message.find("launches[1].arg_count"), std::string::npos);
+  ti::set_last_error(TI_ERROR_SUCCESS);
+  runtime.wait();
+  check_run_result(arrs[0], 0);
+
+  // Mismatched argument types are rejected as well.
+  launches[1].arg_count = 3;
+  std::swap(args[1][0], args[1][1]);
+  runtime.launch_kernels(launches);
+  err = ti::get_last_error();
+  EXPECT_EQ(err.error, TI_ERROR_INVALID_ARGUMENT);
+  EXPECT_NE(err.message.find("launches[1].args[0]"), std::string::npos);
+  ti::set_last_error(TI_ERROR_SUCCESS);
+  runtime.wait();
+  check_run_result(arrs[0], 0);
+}
+
+void kernel_args_test(TiArch arch) {
+  const uint32_t kArrLen = 32;
+
+  const auto folder_dir = getenv("TAICHI_AOT_FOLDER_PATH");
+
+  ti::Runtime runtime(arch);
+  ti::AotModule aot_mod = runtime.load_aot_module(folder_dir);
+  ti::Kernel k_run = aot_mod.get_kernel("run");
+  ti::NdArray<int32_t> arr0 =
+      runtime.allocate_ndarray<int32_t>({kArrLen}, {1}, true);
+  ti::NdArray<int32_t> arr1 =
+      runtime.allocate_ndarray<int32_t>({kArrLen}, {1}, true);
+
+  ti::KernelArgs args = k_run.create_args();
+  ASSERT_TRUE(args.is_valid());
+
+  // Launching before every argument is set is an error.
+  args.update(0, 5);
+  args.launch();
+  ti::Error err = ti::get_last_error();
+  EXPECT_EQ(err.error, TI_ERROR_INVALID_ARGUMENT);
+  EXPECT_NE(err.message.find("kernel_args.args[1]"), std::string::npos);
+  ti::set_last_error(TI_ERROR_SUCCESS);
+
+  args.update(1, arr0);
+  args.update(2, std::vector<int32_t>{1, 2, 3});
+  args.launch();
+  runtime.wait();
+  check_run_result(arr0, 5 + 1);
+
+  // Only the updated arguments change, and the encoded ndarray stays valid
+  // across launches.
+  args.update(0, 10);
+  args.launch();
+  runtime.wait();
+  check_run_result(arr0, 10 + 1);
+
+  args.update(1, arr1);
+  args.launch();
+  runtime.wait();
+  check_run_result(arr1, 10 + 1);
+  capi::utils::check_runtime_error(runtime);
+
+  // Invalid updates are rejected and leave the arguments untouched.
+  args.update(3, 0);
+  EXPECT_EQ(ti::get_last_error().error, TI_ERROR_ARGUMENT_OUT_OF_RANGE);
+  ti::set_last_error(TI_ERROR_SUCCESS);
+  args.update(1, 0);
+  EXPECT_EQ(ti::get_last_error().error, TI_ERROR_INVALID_ARGUMENT);
+  ti::set_last_error(TI_ERROR_SUCCESS);
+  args.update(0, 20);
+  args.launch();
+  runtime.wait();
+  check_run_result(arr1, 20 + 1);
+}
+
+// Compares the host-side cost of submitting many small kernels one by one,
+// as a single batch, and from a persistent argument set where only the
+// scalar argument changes between launches.
+void launch_overhead_test(TiArch arch) {
+  const uint32_t kArrLen = 32;
+  const uint32_t kNumLaunches = 1000;
+
+  const auto folder_dir = getenv("TAICHI_AOT_FOLDER_PATH");
+
+  ti::Runtime runtime(arch);
+  ti::AotModule aot_mod = runtime.load_aot_module(folder_dir);
+  ti::Kernel k_run = aot_mod.get_kernel("run");
+  ti::NdArray<int32_t> arr =
+      runtime.allocate_ndarray<int32_t>({kArrLen}, {1}, true);
+
+  std::vector<std::vector<TiArgument>> args;
+  std::vector<TiKernelLaunch> launches;
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    args.emplace_back(make_run_args(i, arr, 0));
+  }
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    TiKernelLaunch launch{};
+    launch.kernel = k_run;
+    launch.arg_count = args[i].size();
+    launch.args = args[i].data();
+    launches.emplace_back(launch);
+  }
+
+  // Warm up so that one-time setup isn't measured.
+  runtime.launch_kernels(launches);
+  runtime.wait();
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (const auto &launch : launches) {
+    ti_launch_kernel(runtime, launch.kernel, launch.arg_count, launch.args);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  runtime.wait();
+  auto t2 = std::chrono::steady_clock::now();
+  runtime.launch_kernels(launches);
+  auto t3 = std::chrono::steady_clock::now();
+  runtime.wait();
+  capi::utils::check_runtime_error(runtime);
+
+  ti::KernelArgs kernel_args = k_run.create_args();
+  for (uint32_t i = 0; i < args[0].size(); ++i) {
+    kernel_args.update(i, args[0][i]);
+  }
+  auto t4 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kNumLaunches; ++i) {
+    kernel_args.update(0, args[i][0]);
+    kernel_args.launch();
+  }
+  auto t5 = std::chrono::steady_clock::now();
+  runtime.wait();
+  capi::utils::check_runtime_error(runtime);
+
+  double single_us =
+      std::chrono::duration<double, std::micro>(t1 - t0).count() /
+      kNumLaunches;
+  double batched_us =
+      std::chrono::duration<double, std::micro>(t3 - t2).count() /
+      kNumLaunches;
+  double persistent_us =
+      std::chrono::duration<double, std::micro>(t5 - t4).count() /
+      kNumLaunches;
+  std::printf(
+      "[launch overhead] ti_launch_kernel: %.3f us/launch, "
+      "ti_launch_kernels: %.3f us/launch, "
+      "ti_launch_kernel_with_args: %.3f us/launch\n",
+      single_us, batched_us, persistent_us);
+  ::testing::Test::RecordProperty("single_launch_us",
+                                  std::to_string(single_us));
+  ::testing::Test::RecordProperty("batched_launch_us",
+                                  std::to_string(batched_us));
+  ::testing::Test::RecordProperty("persistent_args_launch_us",
+                                  std::to_string(persistent_us));
+
+  check_run_result(arr, kNumLaunches - 1);
+}
+
+}  // namespace
+
+TEST_F(CapiTest, LaunchKernelsCpu) {
+  if (ti::is_arch_available(TI_ARCH_X64)) {
+    launch_kernels_test(TI_ARCH_X64);
+  }
+}
+
+TEST_F(CapiTest, LaunchKernelsVulkan) {
+  if (ti::is_arch_available(TI_ARCH_VULKAN)) {
+    launch_kernels_test(TI_ARCH_VULKAN);
+  }
+}
+
+TEST_F(CapiTest, KernelArgsCpu) {
+  if (ti::is_arch_available(TI_ARCH_X64)) {
+    kernel_args_test(TI_ARCH_X64);
+  }
+}
+
+TEST_F(CapiTest, KernelArgsVulkan) {
+  if (ti::is_arch_available(TI_ARCH_VULKAN)) {
+    kernel_args_test(TI_ARCH_VULKAN);
+  }
+}
+
+TEST_F(CapiTest, LaunchOverheadCpu) {
+  if (ti::is_arch_available(TI_ARCH_X64)) {
+    launch_overhead_test(TI_ARCH_X64);
+  }
+}
+
+TEST_F(CapiTest, LaunchOverheadVulkan) {
+  if (ti::is_arch_available(TI_ARCH_VULKAN)) {
+    launch_overhead_test(TI_ARCH_VULKAN);
+  }
+}
@@ -5,14 +5,14 @@ from taichi.lang._ndrange import ndrange
 from taichi.lang.enums import Format
 from taichi.lang.expr import Expr
 from taichi.lang.field import ScalarField
-from taichi.lang.impl import grouped, static, static_assert
+from taichi.lang.impl import call_internal, grouped, static, static_assert
 from taichi.lang.kernel_impl import func, kernel
 from taichi.lang.misc import loop_config
 from taichi.lang.simt import block, warp
-from taichi.lang.snode import deactivate
+from taichi.lang.snode import deactivate, get_addr
 from taichi.types import ndarray_type, texture_type, vector
 from taichi.types.annotations import template
-from taichi.types.primitive_types import f16, f32, f64, i32, u8
+from taichi.types.primitive_types import f16, f32, f64, i32, u8, u32, u64
 
 from taichi.math import vec3
 
@@ -324,6 +324,43 @@ def sort_stage(
                         values[b + values_offset] = temp
 
 
+# Parallel primitives of the LLVM CPU runtime. They take contiguous 1D fields
+# and must be called from the serial part of a kernel.
+@kernel
+def cpu_scan_add_inclusive(arr: template(), length: i32):
+    offset = static(arr.snode.ptr.offset[0] if len(arr.snode.ptr.offset) != 0 else 0)
+    if static(arr.dtype == f32):
+        call_internal("cpu_parallel_scan_add_f32", get_addr(arr, [offset]), length, 0)
+    else:
+        call_internal("cpu_parallel_scan_add_i32", get_addr(arr, [offset]), length, 0)
+
+
+@kernel
+def cpu_radix_sort(
+    keys: template(),
+    keys_tmp: template(),
+    use_values: template(),
+    values: template(),
+    values_tmp: template(),
+    length: i32,
+):
+    keys_offset = static(keys.snode.ptr.offset[0] if len(keys.snode.ptr.offset) != 0 else 0)
+    values_offset = static(values.snode.ptr.offset[0] if len(values.snode.ptr.offset) != 0 else 0)
+    keys_addr = get_addr(keys, [keys_offset])
+    keys_tmp_addr = get_addr(keys_tmp, [0])
+    values_addr = ops.cast(0, u64)
+    values_tmp_addr = ops.cast(0, u64)
+    if static(use_values):
+        values_addr = get_addr(values, [values_offset])
+        values_tmp_addr = get_addr(values_tmp, [0])
+    if static(keys.dtype == f32):
+        call_internal("cpu_parallel_radix_sort_f32", keys_addr, values_addr, keys_tmp_addr, values_tmp_addr, length)
+    elif static(keys.dtype == u32):
+        call_internal("cpu_parallel_radix_sort_u32", keys_addr, values_addr, keys_tmp_addr, values_tmp_addr, length)
+    else:
+        call_internal("cpu_parallel_radix_sort_i32", keys_addr, values_addr, keys_tmp_addr, values_tmp_addr, length)
+
+
 # Parallel Prefix Sum (Scan)
 @func
 def warp_shfl_up_i32(val: template()):
@@ -1,25 +1,95 @@
+import weakref
+
 from taichi._kernels import (
     blit_from_field_to_field,
+    cpu_radix_sort,
+    cpu_scan_add_inclusive,
     scan_add_inclusive,
     sort_stage,
     uniform_add,
     warp_shfl_up_i32,
 )
-from taichi.lang.impl import current_cfg, field
+from taichi._lib import core as _ti_core
+from taichi._snode.fields_builder import FieldsBuilder
+from taichi.lang.impl import axes, current_cfg, field, get_runtime
 from taichi.lang.kernel_impl import data_oriented
-from taichi.lang.misc import cuda, vulkan
+from taichi.lang.misc import arm64, cuda, vulkan, x64
 from taichi.lang.runtime_ops import sync
 from taichi.lang.simt import subgroup
-from taichi.types.primitive_types import i32
+from taichi.types.primitive_types import f32, i32, u32
+
+
+def _is_cpu_primitive_field(f):
+    """Whether `f` can be passed to the parallel primitives of the CPU runtime,
+    i.e. it is a 1D field of 32-bit elements stored contiguously."""
+    if current_cfg().arch not in [x64, arm64]:
+        return False
+    if f.dtype not in [i32, u32, f32] or len(f.shape) != 1:
+        return False
+    dense = f.snode.ptr.parent
+    return (
+        dense.type == _ti_core.SNodeType.dense
+        and dense.get_num_ch() == 1
+        and dense.parent.type == _ti_core.SNodeType.root
+    )
+
+
+# The scratch fields of the CPU radix sort of each runtime, by dtypes, as
+# (capacity, keys_tmp, values_tmp, snode_tree). The fields are only replaced by
+# larger ones when a longer field is sorted, so that sorting again reuses them
+# and the kernel specialized for them.
+_cpu_radix_sort_scratch = weakref.WeakKeyDictionary()
+
+
+def _get_cpu_radix_sort_scratch(N, keys_dtype, values_dtype):
+    scratch = _cpu_radix_sort_scratch.setdefault(get_runtime(), {})
+    key = (keys_dtype, values_dtype)
+    if key not in scratch or scratch[key][0] < N:
+        if key in scratch:
+            # Destroying the tree frees its memory, and the kernels that
+            # accessed it are compiled again.
+            scratch[key][3].destroy()
+        # Grow geometrically to bound the number of reallocations.
+        capacity = 1
+        while capacity < N:
+            capacity *= 2
+        fb = FieldsBuilder()
+        keys_tmp = field(keys_dtype)
+        fb.dense(axes(0), capacity).place(keys_tmp)
+        values_tmp = keys_tmp
+        if values_dtype is not None:
+            values_tmp = field(values_dtype)
+            fb.dense(axes(0), capacity).place(values_tmp)
+        scratch[key] = (capacity, keys_tmp, values_tmp, fb.finalize())
+    return scratch[key][1:3]
+
+
+def _cpu_radix_sort(keys, values):
+    N = keys.shape[0]
+    keys_tmp, values_tmp = _get_cpu_radix_sort_scratch(N, keys.dtype, None if values is None else values.dtype)
+    if values is None:
+        cpu_radix_sort(keys, keys_tmp, False, keys, keys_tmp, N)
+    else:
+        cpu_radix_sort(keys, keys_tmp, True, values, values_tmp, N)
 
 
 def parallel_sort(keys, values=None):
     """Odd-even merge sort
 
+    On CPU, 1D fields of 32-bit keys and values are sorted with the LSD radix
+    sort of the runtime instead.
+
     References:
         https://developer.nvidia.com/gpugems/gpugems2/part-vi-simulation-and-numerical-algorithms/chapter-46-improved-gpu-sorting
         https://en.wikipedia.org/wiki/Batcher_odd%E2%80%93even_mergesort
     """
+    if _is_cpu_primitive_field(keys) and (values is None or _is_cpu_primitive_field(values)):
+        _cpu_radix_sort(keys, values)
+    else:
+        _odd_even_merge_sort(keys, values)
+
+
+def _odd_even_merge_sort(keys, values):
     N = keys.shape[0]
 
     num_stages = 0
@@ -43,6 +113,7 @@ class PrefixSumExecutor:
     """Parallel Prefix Sum (Scan) Helper
 
     Use this helper to perform an inclusive in-place's parallel prefix sum.
+    On CPU, the scan runs on the thread pool of the runtime.
 
     References:
         https://developer.download.nvidia.com/compute/cuda/1.1-Beta/x86_website/projects/scan/doc/scan.pdf
@@ -78,6 +149,15 @@ class PrefixSumExecutor:
         if input_arr.dtype != i32:
             raise RuntimeError("Only ti.i32 type is supported for prefix sum.")
 
+        if current_cfg().arch in [x64, arm64]:
+            if _is_cpu_primitive_field(input_arr):
+                cpu_scan_add_inclusive(input_arr, length)
+            else:
+                blit_from_field_to_field(self.large_arr, input_arr, 0, length)
+                cpu_scan_add_inclusive(self.large_arr, length)
+                blit_from_field_to_field(input_arr, self.large_arr, 0, length)
+            return
+
         if current_cfg().arch == cuda:
             inclusive_add = warp_shfl_up_i32
         elif current_cfg().arch == vulkan:
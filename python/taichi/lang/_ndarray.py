@@ -3,7 +3,13 @@ from taichi._lib import core as _ti_core
 from taichi.lang import impl
 from taichi.lang.enums import Layout
 from taichi.lang.exception import TaichiIndexError
-from taichi.lang.util import cook_dtype, python_scope, to_numpy_type
+from taichi.lang.util import (
+    check_dlpack_export,
+    cook_dtype,
+    get_dlpack_device,
+    python_scope,
+    to_numpy_type,
+)
 from taichi.types import primitive_types
 from taichi.types.ndarray_type import NdarrayTypeMetadata
 from taichi.types.utils import is_real, is_signed
@@ -67,7 +73,7 @@ class Ndarray:
         Args:
             val (Union[int, float]): Value to fill.
         """
-        if impl.current_cfg().arch != _ti_core.Arch.cuda and impl.current_cfg().arch != _ti_core.Arch.x64:
+        if impl.current_cfg().arch not in (_ti_core.Arch.cuda, _ti_core.Arch.x64, _ti_core.Arch.arm64):
             self._fill_by_kernel(val)
         elif _ti_core.is_tensor(self.element_type):
             self._fill_by_kernel(val)
@@ -150,6 +156,29 @@ class Ndarray:
         ext_arr_to_ndarray_matrix(arr, self, layout_is_aos, as_vector)
         impl.get_runtime().sync()
 
+    @python_scope
+    def __dlpack__(self, stream=None, max_version=None, dl_device=None, copy=None):
+        """Exports the ndarray through DLPack without copying.
+
+        The exported tensor keeps the ndarray alive, and writes from either side
+        are visible to the other one.
+
+        Args:
+            stream (int, optional): The stream of the consumer. Kernels launched so far are synchronized instead.
+            max_version (Tuple[int], optional): The highest DLPack version the consumer supports.
+            dl_device (Tuple[int], optional): The device the consumer wants the tensor on.
+            copy (bool, optional): Whether the consumer wants a copy, which is not supported.
+
+        Returns:
+            PyCapsule: The DLPack capsule.
+        """
+        versioned = check_dlpack_export(max_version, dl_device, copy)
+        impl.get_runtime().sync()
+        return _ti_core.ndarray_to_dlpack(impl.get_runtime().prog, self.arr, self, versioned)
+
+    def __dlpack_device__(self):
+        return get_dlpack_device()
+
     @python_scope
     def _get_element_size(self):
         """Returns the size of one element in bytes.
@@ -335,4 +364,39 @@ class NdarrayHostAccess:
         self.setter = setter
 
 
-__all__ = ["Ndarray", "ScalarNdarray"]
+@python_scope
+def from_dlpack(x):
+    """Creates a scalar ndarray sharing the memory of another array through DLPack.
+
+    The array must be contiguous and on the device of the current arch. It is kept
+    alive by the ndarray, and writes from either side are visible to the other one.
+
+    Args:
+        x: An object supporting `__dlpack__`, e.g. a numpy array or a torch tensor, or a DLPack capsule.
+
+    Returns:
+        ScalarNdarray: The ndarray sharing the memory of `x`.
+
+    Example::
+
+        >>> a = np.arange(4, dtype=np.float32)
+        >>> x = ti.from_dlpack(a)
+        >>> x[0] = 5  # a[0] is 5 too
+    """
+    capsule = x
+    if hasattr(x, "__dlpack__"):
+        try:
+            capsule = x.__dlpack__(max_version=(1, 0))
+        except TypeError:
+            capsule = x.__dlpack__()
+    prog = impl.get_runtime().prog
+    ndarray = ScalarNdarray.__new__(ScalarNdarray)
+    Ndarray.__init__(ndarray)
+    ndarray.arr, ndarray._dlpack_owner = _ti_core.ndarray_from_dlpack(prog, capsule)
+    ndarray.dtype = ndarray.arr.dtype
+    ndarray.shape = tuple(ndarray.arr.shape)
+    ndarray.element_type = ndarray.dtype
+    return ndarray
+
+
+__all__ = ["Ndarray", "ScalarNdarray", "from_dlpack"]
@@ -53,6 +53,23 @@ class _Ndrange:
     def grouped(self):
         return GroupedNDRange(self)
 
+    def tile_sizes(self, sizes):
+        """Returns the sizes of the tiles to iterate over this ndrange with. Unless `sizes` are given, a tile spans
+        64 elements along the innermost axis, i.e. whole cache lines, and 4096 elements in total, so that the tiles
+        of a few 32-bit fields together with their halos fit in the L2 cache."""
+        if sizes:
+            if len(sizes) != len(self.dimensions):
+                raise TaichiSyntaxError(
+                    f"The tile sizes {tuple(sizes)} do not match the {len(self.dimensions)}-D ndrange"
+                )
+            return list(sizes)
+        outer = 1 << (6 // (len(self.dimensions) - 1))
+        sizes = [outer] * (len(self.dimensions) - 1) + [64]
+        for i, dim in enumerate(self.dimensions):
+            if isinstance(dim, (int, np.integer)):
+                sizes[i] = max(min(sizes[i], int(dim)), 1)
+        return sizes
+
 
 def ndrange(*args) -> Iterable:
     """Return an immutable iterator object for looping over multi-dimensional indices.
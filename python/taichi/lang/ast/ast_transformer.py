@@ -628,6 +628,7 @@ class ASTTransformer(Builder):
                             ctx.func.arguments[i].name,
                             ctx.arg_features[i][2],
                             ctx.arg_features[i][3],
+                            ctx.arg_features[i][4],
                         ),
                     )
                 elif isinstance(ctx.func.arguments[i].annotation, texture_type.TextureType):
@@ -1134,14 +1135,6 @@ class ASTTransformer(Builder):
     def build_ndrange_for(ctx, node):
         with ctx.variable_scope_guard():
             ndrange_var = impl.expr_init(build_stmt(ctx, node.iter))
-            ndrange_begin = ti_ops.cast(expr.Expr(0), primitive_types.i32)
-            ndrange_end = ti_ops.cast(
-                expr.Expr(impl.subscript(ctx.ast_builder, ndrange_var.acc_dimensions, 0)),
-                primitive_types.i32,
-            )
-            ndrange_loop_var = expr.Expr(ctx.ast_builder.make_id_expr(""))
-            ctx.ast_builder.begin_frontend_range_for(ndrange_loop_var.ptr, ndrange_begin.ptr, ndrange_end.ptr)
-            I = impl.expr_init(ndrange_loop_var)
             targets = ASTTransformer.get_for_loop_targets(node)
             if len(targets) != len(ndrange_var.dimensions):
                 raise TaichiSyntaxError(
@@ -1150,6 +1143,18 @@ class ASTTransformer(Builder):
                     "Please check if the number of arguments of ti.ndrange() is equal to "
                     "the number of the loop variables."
                 )
+            tile_sizes = ctx.ast_builder.get_next_loop_tile_sizes()
+            if tile_sizes is not None and len(targets) >= 2:
+                ASTTransformer.build_tiled_ndrange_for(ctx, node, ndrange_var, ndrange_var.tile_sizes(tile_sizes))
+                return None
+            ndrange_begin = ti_ops.cast(expr.Expr(0), primitive_types.i32)
+            ndrange_end = ti_ops.cast(
+                expr.Expr(impl.subscript(ctx.ast_builder, ndrange_var.acc_dimensions, 0)),
+                primitive_types.i32,
+            )
+            ndrange_loop_var = expr.Expr(ctx.ast_builder.make_id_expr(""))
+            ctx.ast_builder.begin_frontend_range_for(ndrange_loop_var.ptr, ndrange_begin.ptr, ndrange_end.ptr)
+            I = impl.expr_init(ndrange_loop_var)
             for i, target in enumerate(targets):
                 if i + 1 < len(targets):
                     target_tmp = impl.expr_init(I // ndrange_var.acc_dimensions[i + 1])
@@ -1172,6 +1177,54 @@ class ASTTransformer(Builder):
             ctx.ast_builder.end_frontend_range_for()
         return None
 
+    @staticmethod
+    def build_tiled_ndrange_for(ctx, node, ndrange_var, tile_sizes):
+        # The iteration space is padded to whole tiles, and linearized tile by tile so that consecutive iterations
+        # stay within a tile. The padding iterations are skipped. The tile volume becomes the block_dim of the loop,
+        # which only makes the blocks of iterations the CPU threads take whole tiles without
+        # make_cpu_multithreading_loop: that pass splits the loop evenly between the threads instead.
+        targets = ASTTransformer.get_for_loop_targets(node)
+        num_tiles = [(dim + size - 1) // size for dim, size in zip(ndrange_var.dimensions, tile_sizes)]
+        acc_num_tiles = num_tiles.copy()
+        acc_tile_sizes = list(tile_sizes)
+        for i in reversed(range(len(tile_sizes) - 1)):
+            acc_num_tiles[i] = acc_num_tiles[i] * acc_num_tiles[i + 1]
+            acc_tile_sizes[i] = acc_tile_sizes[i] * acc_tile_sizes[i + 1]
+        tile_volume = acc_tile_sizes[0]
+        if ctx.ast_builder.get_next_loop_block_dim() == 0 and tile_volume & (tile_volume - 1) == 0:
+            ctx.ast_builder.block_dim(tile_volume)
+        ndrange_begin = ti_ops.cast(expr.Expr(0), primitive_types.i32)
+        ndrange_end = ti_ops.cast(expr.Expr(acc_num_tiles[0] * tile_volume), primitive_types.i32)
+        ndrange_loop_var = expr.Expr(ctx.ast_builder.make_id_expr(""))
+        ctx.ast_builder.begin_frontend_range_for(ndrange_loop_var.ptr, ndrange_begin.ptr, ndrange_end.ptr)
+        I = impl.expr_init(ndrange_loop_var // tile_volume)
+        J = impl.expr_init(ndrange_loop_var % tile_volume)
+        in_range = None
+        for i, target in enumerate(targets):
+            if i + 1 < len(targets):
+                tile_index = impl.expr_init(I // acc_num_tiles[i + 1])
+                I._assign(I - tile_index * acc_num_tiles[i + 1])
+                tile_offset = impl.expr_init(J // acc_tile_sizes[i + 1])
+                J._assign(J - tile_offset * acc_tile_sizes[i + 1])
+            else:
+                tile_index = I
+                tile_offset = J
+            index = impl.expr_init(tile_index * tile_sizes[i] + tile_offset)
+            dim = ndrange_var.dimensions[i]
+            if not isinstance(dim, (int, np.integer)) or dim % tile_sizes[i] != 0:
+                in_range = index < dim if in_range is None else in_range & (index < dim)
+            ctx.create_variable(target, impl.expr_init(index + ndrange_var.bounds[i][0]))
+        if in_range is None:
+            build_stmts(ctx, node.body)
+        else:
+            impl.begin_frontend_if(ctx.ast_builder, in_range)
+            ctx.ast_builder.begin_frontend_if_true()
+            build_stmts(ctx, node.body)
+            ctx.ast_builder.pop_scope()
+            ctx.ast_builder.begin_frontend_if_false()
+            ctx.ast_builder.pop_scope()
+        ctx.ast_builder.end_frontend_range_for()
+
     @staticmethod
     def build_grouped_ndrange_for(ctx, node):
         with ctx.variable_scope_guard():
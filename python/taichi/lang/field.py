@@ -4,6 +4,8 @@ from taichi._logging import warn
 from taichi.lang import impl
 from taichi.lang.exception import TaichiSyntaxError
 from taichi.lang.util import (
+    check_dlpack_export,
+    get_dlpack_device,
     in_python_scope,
     python_scope,
     to_numpy_type,
@@ -138,6 +140,33 @@ class Field:
         """
         raise NotImplementedError()
 
+    @python_scope
+    def _to_dlpack(self, element_shape, max_version, dl_device, copy):
+        """Exports `self` through DLPack without copying.
+
+        Only fields whose members are all the places of a dense SNode directly
+        under the root can be exported, and the exported tensor is read-only.
+        It is only valid while the SNode tree of the field is alive.
+
+        Args:
+            element_shape (List[int]): The shape of each element.
+            max_version (Tuple[int], optional): The highest DLPack version the consumer supports.
+            dl_device (Tuple[int], optional): The device the consumer wants the tensor on.
+            copy (bool, optional): Whether the consumer wants a copy, which is not supported.
+
+        Returns:
+            PyCapsule: The DLPack capsule.
+        """
+        versioned = check_dlpack_export(max_version, dl_device, copy)
+        runtime = impl.get_runtime()
+        runtime.materialize()
+        runtime.sync()
+        members = [var.ptr.snode() for var in self.vars]
+        return _ti_core.field_to_dlpack(runtime.prog, members, element_shape, self, versioned)
+
+    def __dlpack_device__(self):
+        return get_dlpack_device()
+
     @python_scope
     def to_torch(self, device=None):
         """Converts `self` to a torch tensor.
@@ -308,6 +337,10 @@ class ScalarField(Field):
         taichi.lang.runtime_ops.sync()
         return arr
 
+    def __dlpack__(self, stream=None, max_version=None, dl_device=None, copy=None):
+        """Exports this field through DLPack without copying, see `Field._to_dlpack`."""
+        return self._to_dlpack([], max_version, dl_device, copy)
+
     @python_scope
     def to_torch(self, device=None):
         """Converts this field to a `torch.tensor`."""
@@ -332,6 +332,25 @@ class Func:
             self.arguments.append(KernelArgument(annotation, param.name, param.default))
 
 
+def _specialize_ndarray_shape(shape, shape_specialization):
+    """Gets the extents of the array axes a kernel is specialized on, -1 for the axes left generic.
+
+    Args:
+        shape (Tuple[int]): The shape of the array, excluding the element shape.
+        shape_specialization (str): "none", "innermost" or "all", see `ndarray_shape_specialization` of `ti.init()`.
+
+    Returns:
+        Tuple[int]: The specialized shape, empty if the kernel takes arrays of any shape.
+    """
+    if shape_specialization == "none" or not shape:
+        return ()
+    if shape_specialization == "innermost":
+        return (-1,) * (len(shape) - 1) + (shape[-1],)
+    if shape_specialization == "all":
+        return tuple(shape)
+    raise ValueError(f"Invalid ndarray_shape_specialization: {shape_specialization}")
+
+
 class TaichiCallableTemplateMapper:
     def __init__(self, arguments, template_slot_locations):
         self.arguments = arguments
@@ -340,7 +359,7 @@ class TaichiCallableTemplateMapper:
         self.mapping = {}
 
     @staticmethod
-    def extract_arg(arg, anno):
+    def extract_arg(arg, anno, shape_specialization="none"):
         if isinstance(anno, template):
             if isinstance(arg, taichi.lang.snode.SNode):
                 return arg.ptr
@@ -392,7 +411,8 @@ class TaichiCallableTemplateMapper:
             if isinstance(arg, taichi.lang._ndarray.Ndarray):
                 anno.check_matched(arg.get_type())
                 needs_grad = (arg.grad is not None) if anno.needs_grad is None else anno.needs_grad
-                return arg.element_type, len(arg.shape), needs_grad, anno.boundary
+                specialized_shape = _specialize_ndarray_shape(tuple(arg.shape), shape_specialization)
+                return arg.element_type, len(arg.shape), needs_grad, anno.boundary, specialized_shape
             # external arrays
             shape = getattr(arg, "shape", None)
             if shape is None:
@@ -439,23 +459,25 @@ class TaichiCallableTemplateMapper:
                 if len(element_shape) != 0
                 else arg.dtype
             )
-            return element_type, len(shape) - len(element_shape), needs_grad, anno.boundary
+            ndim = len(shape) - len(element_shape)
+            specialized_shape = _specialize_ndarray_shape(shape[:ndim], shape_specialization)
+            return element_type, ndim, needs_grad, anno.boundary, specialized_shape
         if isinstance(anno, sparse_matrix_builder):
             return arg.dtype
         # Use '#' as a placeholder because other kinds of arguments are not involved in template instantiation
         return "#"
 
-    def extract(self, args):
+    def extract(self, args, shape_specialization="none"):
         extracted = []
         for arg, kernel_arg in zip(args, self.arguments):
-            extracted.append(self.extract_arg(arg, kernel_arg.annotation))
+            extracted.append(self.extract_arg(arg, kernel_arg.annotation, shape_specialization))
         return tuple(extracted)
 
-    def lookup(self, args):
+    def lookup(self, args, shape_specialization="none"):
         if len(args) != self.num_args:
             raise TypeError(f"{self.num_args} argument(s) needed but {len(args)} provided.")
 
-        key = self.extract(args)
+        key = self.extract(args, shape_specialization)
         if key not in self.mapping:
             count = len(self.mapping)
             self.mapping[key] = count
@@ -842,8 +864,8 @@ class Kernel:
             return launch_ctx.get_struct_ret_float(index)
         raise TaichiRuntimeTypeError(f"Invalid return type on index={index}")
 
-    def ensure_compiled(self, *args):
-        instance_id, arg_features = self.mapper.lookup(args)
+    def ensure_compiled(self, *args, shape_specialization="none"):
+        instance_id, arg_features = self.mapper.lookup(args, shape_specialization)
         key = (self.func, instance_id, self.autodiff_mode)
         self.materialize(key=key, args=args, arg_features=arg_features)
         return key
@@ -877,7 +899,8 @@ class Kernel:
         if self.autodiff_mode != AutodiffMode.NONE and impl.current_cfg().opt_level == 0:
             _logging.warn("""opt_level = 1 is enforced to enable gradient computation.""")
             impl.current_cfg().opt_level = 1
-        key = self.ensure_compiled(*args)
+        # Kernels compiled ahead of time for graphs and AOT modules stay generic.
+        key = self.ensure_compiled(*args, shape_specialization=impl.current_cfg().ndarray_shape_specialization)
         kernel_cpp = self.compiled_kernels[key]
         return self.launch_kernel(kernel_cpp, *args)
 
@@ -1236,6 +1236,14 @@ class MatrixField(Field):
 
             field_fill_taichi_scope(self, val)
 
+    def __dlpack__(self, stream=None, max_version=None, dl_device=None, copy=None):
+        """Exports this field through DLPack without copying, see `Field._to_dlpack`.
+
+        The elements have the shape of `to_numpy()`, i.e. vector fields have 1D elements.
+        """
+        element_shape = [self.n] if self.m == 1 else [self.n, self.m]
+        return self._to_dlpack(element_shape, max_version, dl_device, copy)
+
     @python_scope
     def to_numpy(self, keep_dims=False, dtype=None):
         """Converts the field instance to a NumPy array.
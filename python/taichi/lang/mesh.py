@@ -551,6 +551,47 @@ class Mesh:
     def generate_meta(data):
         return MeshMetadata(data)
 
+    @staticmethod
+    def build_meta(cells, positions=None, relations=(), patch_size=256, reorder="rcm", num_threads=0):
+        """Partitions a mesh into patches and builds its metadata in-process.
+
+        Args:
+            cells (numpy.ndarray): The vertex indices of each triangle (shape `(n, 3)`)
+                or tetrahedron (shape `(n, 4)`).
+            positions (numpy.ndarray, optional): The vertex positions, of shape `(num_verts, 3)`.
+                Required by the "sfc" reordering.
+            relations (Iterable[str]): The relations to build, e.g. `["CV", "VV"]`.
+            patch_size (int): The number of triangles or tetrahedra per patch.
+            reorder (str): "rcm" for the reverse Cuthill-McKee ordering of the elements,
+                or "sfc" for the Morton order of their centroids.
+            num_threads (int): The number of host threads, 0 for all of them.
+
+        Returns:
+            The :class:`MeshMetadata` to create the mesh with.
+        """
+        cells = np.ascontiguousarray(cells, dtype=np.int32)
+        if cells.ndim != 2 or cells.shape[1] not in (3, 4):
+            raise ValueError(f"Expected triangles or tetrahedra, got cells of shape {cells.shape}")
+        topology = _ti_core.MeshTopology.Triangle if cells.shape[1] == 3 else _ti_core.MeshTopology.Tetrahedron
+        if positions is None:
+            num_verts = int(cells.max()) + 1 if cells.size else 0
+            positions = np.zeros((0, 3), dtype=np.float32)
+        else:
+            positions = np.ascontiguousarray(positions, dtype=np.float32).reshape(-1, 3)
+            num_verts = positions.shape[0]
+        data = _ti_core.build_patched_mesh(
+            topology,
+            cells,
+            num_verts,
+            positions,
+            [getattr(_ti_core.MeshRelationType, r) for r in relations],
+            patch_size,
+            reorder,
+            num_threads,
+        )
+        data["attrs"] = {"x": positions}
+        return MeshMetadata(data)
+
 
 def _TriMesh():
     """(Deprecated) Create a triangle mesh (a set of vert/edge/face elements, attributes, and connectivity) builder.
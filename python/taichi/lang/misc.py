@@ -345,10 +345,16 @@ def init(
             https://github.com/taichi-dev/taichi/blob/master/taichi/program/compile_config.h.
 
             * ``cpu_max_num_threads`` (int): Sets the number of threads used by the CPU thread pool.
+            * ``cpu_thread_affinity`` (str): Pins the CPU thread pool threads to cores: ``"none"`` (default), ``"compact"`` (fill one NUMA node first), ``"scatter"`` (alternate between NUMA nodes) or a list of CPUs such as ``"0-7,16-23"``.
+            * ``cpu_launch_autotune`` (bool): Tunes the block size and the number of threads of each parallel loop on CPU during its first launches. With ``offline_cache=True``, the results are saved with the offline cache. Default to False.
             * ``debug`` (bool): Enables the debug mode, under which Taichi does a few more things like boundary checks.
+            * ``async_runtime_error_check`` (bool): In debug mode, reports runtime errors such as out-of-bound accesses at the next :func:`taichi.sync` or data transfer instead of when the kernel returns. Default to False.
             * ``print_ir`` (bool): Prints the CHI IR of the Taichi kernels.
             *``offline_cache`` (bool): Enables offline cache of the compiled kernels. Default to True. When this is enabled Taichi will cache compiled kernel on your local disk to accelerate future calls.
             *``random_seed`` (int): Sets the seed of the random generator. The default is 0.
+            *``fuse_range_for_tasks`` (bool): Merges adjacent parallel range-for loops of a kernel over the same range when their iterations are independent. Default to False.
+            *``strength_reduction`` (bool): Replaces the divisions computing the coordinates of ndrange loops and of struct-for loops over dense fields and ndarrays from the loop index with counters, on CPU and in serial loops. Default to False.
+            *``ndarray_shape_specialization`` (str): Compiles kernels for the concrete shapes of their ndarray arguments: ``"none"`` (default), ``"innermost"`` (only the innermost axis) or ``"all"``.
     """
     # Check version for users every 7 days if not disabled by users.
     _version_check.start_version_check_thread()
@@ -602,6 +608,11 @@ def _bit_vectorize():
     get_runtime().compiling_callable.ast_builder().bit_vectorize()
 
 
+def _tile(sizes):
+    """Tile the next ndrange loop with tiles of `sizes`, or of automatically chosen sizes if `sizes` is empty."""
+    get_runtime().compiling_callable.ast_builder().tile(sizes)
+
+
 def loop_config(
     *,
     block_dim=None,
@@ -609,6 +620,7 @@ def loop_config(
     parallelize=None,
     block_dim_adaptive=True,
     bit_vectorize=False,
+    tile=None,
 ):
     """Sets directives for the next loop
 
@@ -618,6 +630,9 @@ def loop_config(
         parallelize (int): The number of threads to use on CPU
         block_dim_adaptive (bool): Whether to allow backends set block_dim adaptively, enabled by default
         bit_vectorize (bool): Whether to enable bit vectorization of struct fors on quant_arrays.
+        tile (Union[bool, Tuple[int]]): Whether to iterate a multi-dimensional `ti.ndrange` loop on CPU tile by tile,
+            to improve the cache reuse of stencils. Pass a tuple with one tile size per dimension, or `True` for tiles
+            of 64 elements along the innermost axis and 4096 elements in total. Ignored on the other backends.
 
     Examples::
 
@@ -655,6 +670,15 @@ def loop_config(
             # 32 bits, instead of 1 bit, will be copied at a time
             for i, j in x:
                 y[i, j] = x[i, j]
+
+        a = ti.field(ti.f32, shape=(4096, 4096))
+        b = ti.field(ti.f32, shape=(4096, 4096))
+        @ti.kernel
+        def laplace():
+            ti.loop_config(tile=(64, 64))
+            # On CPU, each thread iterates over 64x64 tiles instead of whole rows
+            for i, j in ti.ndrange((1, 4095), (1, 4095)):
+                b[i, j] = 4 * a[i, j] - a[i - 1, j] - a[i + 1, j] - a[i, j - 1] - a[i, j + 1]
     """
     if block_dim is not None:
         _block_dim(block_dim)
@@ -670,6 +694,11 @@ def loop_config(
     if bit_vectorize:
         _bit_vectorize()
 
+    if tile is True:
+        _tile([])
+    elif tile:
+        _tile(list(tile))
+
 
 def global_thread_idx():
     """Returns the global thread id of this running thread,
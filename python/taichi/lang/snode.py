@@ -37,6 +37,28 @@ class SNode:
             dimensions = [dimensions] * len(axes)
         return SNode(self.ptr.dense(axes, dimensions, get_traceback()))
 
+    def morton(self, val=True):
+        """Stores the cells of `self` in Morton (Z-curve) order instead of row-major order.
+
+        Neighbouring cells along every axis are then kept close in memory, which
+        helps stencils and other accesses with locality in several dimensions.
+        Only dense SNodes whose shape along every axis is a power of two are
+        supported.
+
+        Args:
+            val (bool): Whether to use the Morton order.
+
+        Returns:
+            The `self` container.
+
+        Example::
+
+            >>> x = ti.field(ti.f32)
+            >>> ti.root.dense(ti.ij, (256, 256)).morton().place(x)
+        """
+        self.ptr.morton(val)
+        return self
+
     def pointer(self, axes, dimensions):
         """Adds a pointer SNode as a child component of `self`.
 
@@ -310,6 +310,31 @@ def cook_dtype(dtype):
     raise ValueError(f"Invalid data type {dtype}")
 
 
+def get_dlpack_device():
+    """Gets the DLPack (device type, device id) of the memory on the current arch."""
+    arch = impl.current_cfg().arch
+    if arch in (_ti_core.Arch.x64, _ti_core.Arch.arm64):
+        return (1, 0)  # kDLCPU
+    if arch == _ti_core.Arch.cuda:
+        return (2, 0)  # kDLCUDA
+    if arch == _ti_core.Arch.amdgpu:
+        return (10, 0)  # kDLROCM
+    raise BufferError(f"DLPack is not supported on arch={arch}")
+
+
+def check_dlpack_export(max_version, dl_device, copy):
+    """Checks the arguments of a `__dlpack__` call.
+
+    Returns:
+        bool: Whether the consumer accepts a versioned capsule.
+    """
+    if copy:
+        raise BufferError("Taichi only exports its memory through DLPack without copying")
+    if dl_device is not None and tuple(dl_device) != get_dlpack_device():
+        raise BufferError(f"Can't export memory on DLPack device {get_dlpack_device()} to {tuple(dl_device)}")
+    return max_version is not None and tuple(max_version) >= (1, 0)
+
+
 def in_taichi_scope():
     return impl.inside_kernel()
 
@@ -183,6 +183,21 @@ achieved_occupancy = CuptiMetric(
     val_format="   {:6.0f} ",
 )
 
+# CPU Metrics, collected by the "perf" toolkit of the CPU backend
+cpu_cycles = CuptiMetric(name="cycles", header="     cycles ", val_format=" {:8.3f} M ", scale=1e-6)
+
+cpu_instructions = CuptiMetric(name="instructions", header="      insts ", val_format=" {:8.3f} M ", scale=1e-6)
+
+cpu_llc_misses = CuptiMetric(name="llc_misses", header="  LLC.miss ", val_format=" {:7.3f} M ", scale=1e-6)
+
+cpu_branch_misses = CuptiMetric(name="branch_misses", header=" branch.miss ", val_format="  {:8.3f} K ", scale=1e-3)
+
+cpu_thread_busy = CuptiMetric(name="thread_busy_ms", header=" thread.busy ", val_format=" {:8.3f} ms ")
+
+cpu_thread_idle = CuptiMetric(name="thread_idle_ms", header=" thread.idle ", val_format=" {:8.3f} ms ")
+
+cpu_thread_busy_max = CuptiMetric(name="thread_busy_max_ms", header="   busy.max ", val_format=" {:7.3f} ms ")
+
 # metric suite: global load & store
 global_access = [
     dram_bytes_sum,
@@ -255,4 +270,18 @@ default_cupti_metrics = [dram_bytes_sum]
 Default to `dram_bytes_sum`.
 """
 
+# Default metrics list of the "perf" toolkit
+default_perf_metrics = [
+    cpu_cycles,
+    cpu_instructions,
+    cpu_llc_misses,
+    cpu_branch_misses,
+    cpu_thread_busy,
+    cpu_thread_idle,
+]
+"""The metrics collected by the "perf" toolkit of the CPU backend by default.
+The hardware counters are summed over all the threads running a task, and the
+thread times are averaged over the thread pool workers.
+"""
+
 __all__ = ["CuptiMetric", "get_predefined_cupti_metrics"]
@@ -2,7 +2,7 @@ from contextlib import contextmanager
 
 from taichi._lib import core as _ti_core
 from taichi.lang import impl
-from taichi.profiler.kernel_metrics import default_cupti_metrics
+from taichi.profiler.kernel_metrics import default_cupti_metrics, default_perf_metrics
 
 
 class StatisticalResult:
@@ -77,6 +77,8 @@ class KernelProfiler:
         status = impl.get_runtime().prog.set_kernel_profiler_toolkit(toolkit_name)
         if status is True:
             self._profiling_toolkit = toolkit_name
+            if toolkit_name == "perf":
+                self.set_metrics(default_perf_metrics)
         else:
             _ti_core.warn(
                 f"Failed to set kernel profiler toolkit ({toolkit_name}) , keep using ({self._profiling_toolkit})."
@@ -124,10 +126,12 @@ class KernelProfiler:
         """For docstring of this function, see :func:`~taichi.profiler.set_kernel_profiler_metrics`."""
         if self._check_not_turned_on_with_warning_message():
             return None
-        self._metric_list = metric_list
+        if metric_list is default_cupti_metrics and self._profiling_toolkit == "perf":
+            metric_list = default_perf_metrics
         metric_name_list = [metric.name for metric in metric_list]
         self.clear_info()
-        impl.get_runtime().prog.reinit_kernel_profiler_with_metrics(metric_name_list)
+        if impl.get_runtime().prog.reinit_kernel_profiler_with_metrics(metric_name_list):
+            self._metric_list = metric_list
 
         return None
 
@@ -449,7 +453,9 @@ def get_kernel_profiler_total_time():
 def set_kernel_profiler_toolkit(toolkit_name="default"):
     """Set the toolkit used by KernelProfiler.
 
-    Currently, we only support toolkits: ``'default'`` and ``'cupti'``.
+    Currently, we only support toolkits: ``'default'``, ``'cupti'`` (CUDA) and ``'perf'`` (CPU on Linux).
+    The ``'perf'`` toolkit collects hardware counters through ``perf_event_open`` and the busy/idle time
+    of the thread pool for each offloaded task, see :data:`~taichi.profiler.kernel_metrics.default_perf_metrics`.
 
     Args:
         toolkit_name (str): string of toolkit name.
@@ -140,6 +140,13 @@ class EvalVisitor : public IRVisitor {
       if (op == BinaryOpType::bit_shr) {
         return static_cast<std::make_unsigned_t<T>>(lhs) >> rhs;
       }
+      if (op == BinaryOpType::bit_or) {
+        return lhs | rhs;
+      }
+      if (op == BinaryOpType::bit_shl) {
+        return static_cast<T>(static_cast<std::make_unsigned_t<T>>(lhs)
+                              << rhs);
+      }
     }
     return std::nullopt;
   }
@@ -57,6 +57,10 @@ static std::vector<std::uint8_t> get_offline_cache_key_of_compile_config(
   if (arch_is_cpu(config.arch)) {
     serializer(config.default_cpu_block_dim);
     serializer(config.cpu_max_num_threads);
+    serializer(config.simd_width);
+    serializer(config.max_vector_width);
+    serializer(config.thread_local_array_max_bytes);
+    serializer(config.cpu_deferred_gc);
   } else if (arch_is_gpu(config.arch)) {
     serializer(config.default_gpu_block_dim);
     serializer(config.gpu_max_reg);
@@ -66,6 +70,9 @@ static std::vector<std::uint8_t> get_offline_cache_key_of_compile_config(
   serializer(config.ad_stack_size);
   serializer(config.default_ad_stack_size);
   serializer(config.random_seed);
+  serializer(config.fuse_range_for_tasks);
+  serializer(config.strength_reduction);
+  serializer(config.counter_based_rng);
   if (config.arch == Arch::opengl || config.arch == Arch::gles) {
     serializer(config.allow_nv_shader_extension);
   }
@@ -0,0 +1,50 @@
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/snode.h"
+#include "taichi/ir/statements.h"
+#include "taichi/program/compile_config.h"
+
+namespace taichi::lang {
+
+namespace irpass::analysis {
+
+int quant_array_word_group_size(Stmt *loop, const CompileConfig &config) {
+  if (!arch_is_cpu(config.arch)) {
+    return 1;
+  }
+  OffloadedStmt *offload = nullptr;
+  if (auto *task = loop->cast<OffloadedStmt>()) {
+    // With multithreaded loops, the task iterates over the threads and the
+    // words are grouped in the loop over the share of each thread instead.
+    if (config.make_cpu_multithreading_loop || task->reversed) {
+      return 1;
+    }
+    offload = task;
+  } else if (auto *range_for = loop->cast<RangeForStmt>()) {
+    // The serial loop over the share of a thread, made by
+    // make_cpu_multithreaded_range_for, runs the original range-for body.
+    auto *parent =
+        range_for->parent ? range_for->parent->parent_stmt() : nullptr;
+    offload = parent ? parent->cast<OffloadedStmt>() : nullptr;
+    if (!config.make_cpu_multithreading_loop || !offload ||
+        !range_for->strictly_serialized || range_for->reversed) {
+      return 1;
+    }
+  } else {
+    return 1;
+  }
+  if (offload->task_type != OffloadedStmt::TaskType::range_for) {
+    return 1;
+  }
+  int group_size = 1;
+  for (auto snode : offload->mem_access_opt.get_snodes_with_flag(
+           SNodeAccessFlag::element_wise)) {
+    // Both are powers of two.
+    group_size = std::max(group_size, (int)snode->num_cells_per_container);
+  }
+  // Avoid unrolling the body too many times.
+  return group_size <= 64 ? group_size : 1;
+}
+
+}  // namespace irpass::analysis
+
+}  // namespace taichi::lang
@@ -5,6 +5,8 @@
 #include "taichi/ir/statements.h"
 #include "taichi/ir/visitors.h"
 
+#include <limits>
+
 namespace taichi::lang {
 
 DiffRange operator+(const DiffRange &a, const DiffRange &b) {
@@ -166,6 +168,155 @@ class FindDirectValueBaseAndOffset : public IRVisitor {
   }
 };
 
+// Interval arithmetic over i32 statements. The loop index of a range-for is
+// bounded by its begin and end, and the index of a struct-for over a leaf
+// container by the extent of the container.
+class ValueRange {
+ public:
+  using Interval = std::pair<int64, int64>;
+
+  static constexpr int64 kMin = std::numeric_limits<int32>::min();
+  static constexpr int64 kMax = std::numeric_limits<int32>::max();
+
+  Interval get(Stmt *stmt) {
+    if (auto it = cache_.find(stmt); it != cache_.end()) {
+      return it->second;
+    }
+    Interval result{kMin, kMax};
+    if (stmt->ret_type->is_primitive(PrimitiveTypeID::i32)) {
+      result = compute(stmt);
+      // The values wrap around on overflow.
+      if (result.first < kMin || result.second > kMax ||
+          result.first > result.second) {
+        result = {kMin, kMax};
+      }
+    }
+    cache_[stmt] = result;
+    return result;
+  }
+
+ private:
+  Interval compute(Stmt *stmt) {
+    if (auto *const_stmt = stmt->cast<ConstStmt>()) {
+      int64 val = const_stmt->val.val_int32();
+      return {val, val};
+    }
+    if (stmt->is<ExternalTensorShapeAlongAxisStmt>()) {
+      return {0, kMax};
+    }
+    if (auto *loop_index = stmt->cast<LoopIndexStmt>()) {
+      if (auto *range_for = loop_index->loop->cast<RangeForStmt>()) {
+        // The body isn't executed if begin >= end.
+        return {get(range_for->begin).first, get(range_for->end).second - 1};
+      }
+      if (auto *struct_for = loop_index->loop->cast<StructForStmt>()) {
+        auto *snode = struct_for->snode;
+        if (struct_for->is_bit_vectorized || snode->ch.empty()) {
+          return {kMin, kMax};
+        }
+        for (auto &ch : snode->ch) {
+          if (ch->type != SNodeType::place) {
+            return {kMin, kMax};
+          }
+        }
+        int64 extent =
+            snode->extractors[loop_index->index].num_elements_from_root;
+        return {0, extent - 1};
+      }
+      return {kMin, kMax};
+    }
+    if (auto *ternary = stmt->cast<TernaryOpStmt>()) {
+      if (ternary->op_type != TernaryOpType::select) {
+        return {kMin, kMax};
+      }
+      auto [a, b] = get(ternary->op2);
+      auto [c, d] = get(ternary->op3);
+      return {std::min(a, c), std::max(b, d)};
+    }
+    auto *binary = stmt->cast<BinaryOpStmt>();
+    if (!binary) {
+      return {kMin, kMax};
+    }
+    auto [a, b] = get(binary->lhs);
+    auto [c, d] = get(binary->rhs);
+    switch (binary->op_type) {
+      case BinaryOpType::add:
+        return {a + c, b + d};
+      case BinaryOpType::sub:
+        if (auto *divisor = remainder_divisor(binary); divisor && a >= 0) {
+          auto [low, high] = get(divisor);
+          if (low >= 0) {
+            return {0, std::min(b, high - 1)};
+          }
+        }
+        return {a - d, b - c};
+      case BinaryOpType::mul:
+        return {std::min({a * c, a * d, b * c, b * d}),
+                std::max({a * c, a * d, b * c, b * d})};
+      case BinaryOpType::min:
+        return {std::min(a, c), std::min(b, d)};
+      case BinaryOpType::max:
+        return {std::max(a, c), std::max(b, d)};
+      case BinaryOpType::div:
+      case BinaryOpType::floordiv:
+        // A zero divisor is undefined behavior, so assume it is positive.
+        if (a >= 0 && c >= 0) {
+          return {a / std::max(d, int64(1)), b / std::max(c, int64(1))};
+        }
+        return {kMin, kMax};
+      case BinaryOpType::mod:
+        if (a >= 0 && c >= 0) {
+          return {b < c ? a : 0, std::min(b, d - 1)};
+        }
+        return {kMin, kMax};
+      case BinaryOpType::bit_and:
+        if (a >= 0 || c >= 0) {
+          return {0, a >= 0 && c >= 0 ? std::min(b, d) : (a >= 0 ? b : d)};
+        }
+        return {kMin, kMax};
+      case BinaryOpType::bit_shr:
+      case BinaryOpType::bit_sar:
+        if (a >= 0 && c == d && c >= 0 && c < 32) {
+          return {a >> c, b >> c};
+        }
+        return {kMin, kMax};
+      case BinaryOpType::bit_shl:
+        if (a >= 0 && c == d && c >= 0 && c < 32) {
+          return {a << c, b << c};
+        }
+        return {kMin, kMax};
+      default:
+        return {kMin, kMax};
+    }
+  }
+
+  // Matches x - x / y * y, the remainder emitted for ndrange loops, and
+  // returns y.
+  static Stmt *remainder_divisor(BinaryOpStmt *stmt) {
+    auto *product = stmt->rhs->cast<BinaryOpStmt>();
+    if (!product || product->op_type != BinaryOpType::mul) {
+      return nullptr;
+    }
+    auto is_quotient = [&](Stmt *quotient, Stmt *divisor) {
+      auto *div = quotient->cast<BinaryOpStmt>();
+      return div &&
+             (div->op_type == BinaryOpType::div ||
+              div->op_type == BinaryOpType::floordiv) &&
+             div->lhs == stmt->lhs &&
+             irpass::analysis::same_value(div->rhs, divisor);
+    };
+    if (is_quotient(product->lhs, product->rhs)) {
+      return product->rhs;
+    }
+    if (is_quotient(product->rhs, product->lhs)) {
+      return product->lhs;
+    }
+    return nullptr;
+  }
+
+  std::unordered_map<Stmt *, Interval> cache_;
+};
+
 }  // namespace
 
 namespace irpass {
@@ -199,6 +350,13 @@ DiffPtrResult value_diff_ptr_index(Stmt *val1, Stmt *val2) {
   return DiffPtrResult::make_certain(std::get<2>(v1) - std::get<2>(v2));
 }
 
+std::optional<std::pair<int64, int64>> value_range(Stmt *stmt) {
+  if (!stmt->ret_type->is_primitive(PrimitiveTypeID::i32)) {
+    return std::nullopt;
+  }
+  return ValueRange().get(stmt);
+}
+
 }  // namespace analysis
 }  // namespace irpass
 }  // namespace taichi::lang
@@ -4,11 +4,119 @@
 #include "taichi/program/texture.h"
 #include "taichi/program/kernel.h"
 
+#include <memory>
 #include <numeric>
 
 namespace taichi::lang {
 namespace aot {
 
+const ArgBufferLayout &Kernel::get_arg_layout() {
+  if (!arg_layout_) {
+    arg_layout_ = std::make_unique<ArgBufferLayout>(args_type);
+  }
+  return *arg_layout_;
+}
+
+namespace {
+
+template <typename T>
+bool intersects(const std::unordered_set<T> &a,
+                const std::unordered_set<T> &b) {
+  const auto &smaller = a.size() < b.size() ? a : b;
+  const auto &larger = a.size() < b.size() ? b : a;
+  for (const auto &x : smaller) {
+    if (larger.count(x)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Memory of a dispatch with ndarray parameters resolved to the bound ndarrays.
+struct ResolvedAccess {
+  bool analyzed{false};
+  bool uses_global_temporaries{false};
+  std::unordered_set<const void *> reads;
+  std::unordered_set<const void *> writes;
+};
+
+ResolvedAccess resolve_access(
+    const CompiledDispatch &dispatch,
+    const std::unordered_map<std::string, IValue> &args) {
+  const auto &access = dispatch.access;
+  ResolvedAccess res;
+  if (!access.analyzed) {
+    return res;
+  }
+  res.uses_global_temporaries = access.uses_global_temporaries;
+  res.reads.insert(access.snode_reads.begin(), access.snode_reads.end());
+  res.writes.insert(access.snode_writes.begin(), access.snode_writes.end());
+  auto resolve = [&](const std::unordered_set<int> &arg_ids,
+                     std::unordered_set<const void *> &out) {
+    for (int arg_id : arg_ids) {
+      if (arg_id >= dispatch.symbolic_args.size()) {
+        return false;
+      }
+      auto found = args.find(dispatch.symbolic_args[arg_id].name);
+      if (found == args.end() || found->second.tag != ArgKind::kNdarray) {
+        return false;
+      }
+      out.insert(reinterpret_cast<const void *>(found->second.val));
+    }
+    return true;
+  };
+  res.analyzed = resolve(access.arr_reads, res.reads) &&
+                 resolve(access.arr_writes, res.writes);
+  return res;
+}
+
+bool conflicts(const ResolvedAccess &a, const ResolvedAccess &b) {
+  if (!a.analyzed || !b.analyzed) {
+    return true;
+  }
+  if (a.uses_global_temporaries && b.uses_global_temporaries) {
+    return true;
+  }
+  return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) ||
+         intersects(a.reads, b.writes);
+}
+
+// Checks whether the graph arguments |names| are bound to ndarrays of the
+// same shape.
+bool have_same_shape(const std::vector<std::string> &names,
+                     const std::unordered_map<std::string, IValue> &args) {
+  const Ndarray *first = nullptr;
+  for (const auto &name : names) {
+    auto found = args.find(name);
+    if (found == args.end() || found->second.tag != ArgKind::kNdarray) {
+      return false;
+    }
+    auto *arr = reinterpret_cast<const Ndarray *>(found->second.val);
+    if (!first) {
+      first = arr;
+    } else if (arr->total_shape() != first->total_shape()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void select_dispatch(const CompiledDispatch &dispatch,
+                     const std::unordered_map<std::string, IValue> &args,
+                     std::vector<const CompiledDispatch *> &selected) {
+  for (const auto &names : dispatch.same_shape_args) {
+    if (!have_same_shape(names, args)) {
+      for (const auto &fallback : dispatch.fallback) {
+        select_dispatch(fallback, args, selected);
+      }
+      return;
+    }
+  }
+  selected.push_back(&dispatch);
+}
+
+}  // namespace
+
 void CompiledGraph::run(
     const std::unordered_map<std::string, IValue> &args) const {
   for (const auto &dispatch : dispatches) {
@@ -23,20 +131,103 @@ void CompiledGraph::run(
 void CompiledGraph::jit_run(
     const CompileConfig &compile_config,
     const std::unordered_map<std::string, IValue> &args) const {
-  for (const auto &dispatch : dispatches) {
-    TI_ASSERT(dispatch.ti_kernel);
-    LaunchContextBuilder launch_ctx(dispatch.ti_kernel);
-    init_runtime_context(dispatch.symbolic_args, args, launch_ctx);
+  auto selected = select_dispatches(args);
+  if (arch_is_cpu(compile_config.arch) &&
+      compile_config.cpu_graph_parallel_dispatch && !compile_config.debug &&
+      !compile_config.kernel_profiler && selected.size() > 1) {
+    TI_ASSERT(selected.front()->ti_kernel);
+    jit_run_parallel(selected.front()->ti_kernel->program, compile_config,
+                     selected, args);
+    return;
+  }
+  for (const auto *dispatch : selected) {
+    TI_ASSERT(dispatch->ti_kernel);
+    LaunchContextBuilder launch_ctx(dispatch->ti_kernel);
+    init_runtime_context(dispatch->symbolic_args, args, launch_ctx);
     // Compile & Run (JIT): The compilation result will be cached, so don't
     // worry that the kernels dispatched by this cgraph will be compiled
     // repeatedly.
-    auto *prog = dispatch.ti_kernel->program;
+    auto *prog = dispatch->ti_kernel->program;
     const auto &compiled_kernel_data = prog->compile_kernel(
-        compile_config, prog->get_device_caps(), *dispatch.ti_kernel);
+        compile_config, prog->get_device_caps(), *dispatch->ti_kernel);
     prog->launch_kernel(compiled_kernel_data, launch_ctx);
   }
 }
 
+std::vector<const CompiledDispatch *> CompiledGraph::select_dispatches(
+    const std::unordered_map<std::string, IValue> &args) const {
+  std::vector<const CompiledDispatch *> selected;
+  selected.reserve(dispatches.size());
+  for (const auto &dispatch : dispatches) {
+    select_dispatch(dispatch, args, selected);
+  }
+  return selected;
+}
+
+// static
+std::vector<std::vector<int>> CompiledGraph::schedule_dispatches(
+    const std::vector<const CompiledDispatch *> &dispatches,
+    const std::unordered_map<std::string, IValue> &args) {
+  std::vector<ResolvedAccess> accesses;
+  accesses.reserve(dispatches.size());
+  for (const auto *dispatch : dispatches) {
+    accesses.push_back(resolve_access(*dispatch, args));
+  }
+
+  // A dispatch goes one level after the latest earlier dispatch it conflicts
+  // with, which preserves every read-after-write, write-after-read and
+  // write-after-write dependency of the sequential order.
+  std::vector<std::vector<int>> levels;
+  std::vector<int> level_of(dispatches.size(), 0);
+  for (int i = 0; i < dispatches.size(); i++) {
+    for (int j = 0; j < i; j++) {
+      if (level_of[j] + 1 > level_of[i] &&
+          conflicts(accesses[i], accesses[j])) {
+        level_of[i] = level_of[j] + 1;
+      }
+    }
+    if (level_of[i] >= levels.size()) {
+      levels.resize(level_of[i] + 1);
+    }
+    levels[level_of[i]].push_back(i);
+  }
+  return levels;
+}
+
+// static
+void CompiledGraph::jit_run_parallel(
+    Program *prog,
+    const CompileConfig &compile_config,
+    const std::vector<const CompiledDispatch *> &dispatches,
+    const std::unordered_map<std::string, IValue> &args) {
+  // Compile everything upfront: compilation is not thread-safe.
+  std::vector<const CompiledKernelData *> compiled_kernels;
+  std::vector<std::unique_ptr<LaunchContextBuilder>> launch_ctxs;
+  // Number the launches in the order of the dispatches, as jit_run does, so
+  // that the random numbers don't depend on the order they run in.
+  uint32 rand_launch_id = prog->reserve_rand_launch_ids(dispatches.size());
+  for (const auto *dispatch : dispatches) {
+    TI_ASSERT(dispatch->ti_kernel);
+    compiled_kernels.push_back(&prog->compile_kernel(
+        compile_config, prog->get_device_caps(), *dispatch->ti_kernel));
+    launch_ctxs.push_back(
+        std::make_unique<LaunchContextBuilder>(dispatch->ti_kernel));
+    init_runtime_context(dispatch->symbolic_args, args, *launch_ctxs.back());
+    launch_ctxs.back()->rand_launch_id = rand_launch_id++;
+  }
+
+  for (const auto &level : schedule_dispatches(dispatches, args)) {
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(level.size());
+    for (int i : level) {
+      tasks.push_back([&, i] {
+        prog->launch_kernel(*compiled_kernels[i], *launch_ctxs[i]);
+      });
+    }
+    prog->run_concurrently(tasks);
+  }
+}
+
 // static
 void CompiledGraph::init_runtime_context(
     const std::vector<Arg> &paramter_list,
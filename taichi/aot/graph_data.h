@@ -1,11 +1,14 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include "taichi/ir/type.h"
 #include "taichi/program/callable.h"
 #include "taichi/aot/module_data.h"
 #include "taichi/program/compile_config.h"
+#include "taichi/program/launch_context_builder.h"
 #define TI_RUNTIME_HOST
 #include "taichi/program/context.h"
 #undef TI_RUNTIME_HOST
@@ -18,6 +21,8 @@ class AotModuleBuilder;
 class Ndarray;
 class Texture;
 class Kernel;
+class SNode;
+class Program;
 
 namespace aot {
 // Currently only scalar, matrix and ndarray are supported.
@@ -146,6 +151,32 @@ class TI_DLL_EXPORT Kernel : public CallableBase {
    * @param ctx Host context
    */
   virtual void launch(LaunchContextBuilder &ctx) = 0;
+
+  /**
+   * @brief Layout of the argument buffer, computed on first use.
+   */
+  const ArgBufferLayout &get_arg_layout();
+
+ private:
+  std::unique_ptr<ArgBufferLayout> arg_layout_{nullptr};
+};
+
+/**
+ * Global memory read and written by a dispatch. Ndarrays are identified by
+ * the index of the kernel parameter, so that graph arguments bound to the same
+ * ndarray are detected at launch time.
+ */
+struct DispatchAccess {
+  // False if the access could not be fully determined, in which case the
+  // dispatch is ordered against every other dispatch in the graph.
+  bool analyzed{false};
+  // The global temporary buffer is shared by all kernels, e.g. for range-for
+  // bounds that are not compile-time constants.
+  bool uses_global_temporaries{false};
+  std::unordered_set<int> arr_reads;
+  std::unordered_set<int> arr_writes;
+  std::unordered_set<const SNode *> snode_reads;
+  std::unordered_set<const SNode *> snode_writes;
 };
 
 struct CompiledDispatch {
@@ -153,6 +184,17 @@ struct CompiledDispatch {
   std::vector<Arg> symbolic_args;
   Kernel *compiled_kernel{nullptr};
   taichi::lang::Kernel *ti_kernel{nullptr};
+  // Only computed for JIT graphs, see
+  // CompileConfig::cpu_graph_parallel_dispatch.
+  DispatchAccess access;
+  // Set for JIT graphs with fused dispatches, see
+  // CompileConfig::graph_kernel_fusion. Each group of graph arguments must be
+  // bound to ndarrays of the same shape for this dispatch to be launched,
+  // otherwise |fallback| is launched in its place.
+  std::vector<std::vector<std::string>> same_shape_args;
+  std::vector<CompiledDispatch> fallback;
+  // Number of loops merged into a preceding loop by the fusion.
+  int num_fused_loops{0};
 
   TI_IO_DEF(kernel_name, symbolic_args);
 };
@@ -168,6 +210,24 @@ struct TI_DLL_EXPORT CompiledGraph {
   TI_IO_DEF(dispatches);
 
  private:
+  // Groups the dispatches into levels. Dispatches within a level don't
+  // conflict with each other, and every dispatch comes after all the earlier
+  // dispatches it conflicts with.
+  static std::vector<std::vector<int>> schedule_dispatches(
+      const std::vector<const CompiledDispatch *> &dispatches,
+      const std::unordered_map<std::string, IValue> &args);
+
+  // Returns the dispatches to launch for |args|, with the dispatches whose
+  // |same_shape_args| don't hold replaced by their fallback.
+  std::vector<const CompiledDispatch *> select_dispatches(
+      const std::unordered_map<std::string, IValue> &args) const;
+
+  static void jit_run_parallel(
+      Program *prog,
+      const CompileConfig &compile_config,
+      const std::vector<const CompiledDispatch *> &dispatches,
+      const std::unordered_map<std::string, IValue> &args);
+
   static void init_runtime_context(
       const std::vector<Arg> &paramter_list,
       const std::unordered_map<std::string, IValue> &args,
@@ -3,6 +3,24 @@
 
 namespace taichi::lang {
 
+namespace {
+
+// Only JIT graphs check the shapes of the ndarrays bound to a fused dispatch,
+// so its fallback is exported in its place.
+void add_unguarded_dispatches(
+    const std::vector<aot::CompiledDispatch> &dispatches,
+    std::vector<aot::CompiledDispatch> &out) {
+  for (const auto &dispatch : dispatches) {
+    if (dispatch.same_shape_args.empty()) {
+      out.push_back(dispatch);
+    } else {
+      add_unguarded_dispatches(dispatch.fallback, out);
+    }
+  }
+}
+
+}  // namespace
+
 void AotModuleBuilder::add(const std::string &identifier, Kernel *kernel) {
   add_per_backend(identifier, kernel);
 }
@@ -55,14 +73,16 @@ void AotModuleBuilder::add_graph(const std::string &name,
   if (graphs_.count(name) != 0) {
     TI_ERROR("Graph {} already exists", name);
   }
+  aot::CompiledGraph exported{{}, graph.args};
+  add_unguarded_dispatches(graph.dispatches, exported.dispatches);
   // Handle adding kernels separately.
   std::unordered_map<std::string, lang::Kernel *> kernels;
-  for (const auto &dispatch : graph.dispatches) {
+  for (const auto &dispatch : exported.dispatches) {
     kernels[dispatch.kernel_name] = dispatch.ti_kernel;
   }
   for (auto &e : kernels) {
     add(e.first, e.second);
   }
-  graphs_[name] = graph;
+  graphs_[name] = std::move(exported);
 }
 }  // namespace taichi::lang
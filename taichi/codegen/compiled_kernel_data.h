@@ -124,6 +124,16 @@ class CompiledKernelData {
     return kernel_launch_handle_;
   }
 
+  // The offline cache key of the kernel, by which the launchers look up the
+  // launch parameters tuned in earlier runs.
+  void set_kernel_key(const std::string &kernel_key) const {
+    kernel_key_ = kernel_key;
+  }
+
+  const std::string &get_kernel_key() const {
+    return kernel_key_;
+  }
+
   static std::unique_ptr<CompiledKernelData> load(std::istream &is, Err *p_err);
 
   static std::string get_err_msg(Err err);
@@ -140,6 +150,7 @@ class CompiledKernelData {
   static std::unique_ptr<CompiledKernelData> create(Arch arch, Err &err);
 
   mutable std::optional<KernelLaunchHandle> kernel_launch_handle_;
+  mutable std::string kernel_key_;
 };
 
 }  // namespace taichi::lang
@@ -11,6 +11,7 @@
 #include "taichi/ir/transforms.h"
 #include "taichi/ir/analysis.h"
 #include "taichi/analysis/offline_cache_util.h"
+#include "taichi/util/bit.h"
 
 #include "llvm/Support/Host.h"
 #include "llvm/MC/TargetRegistry.h"
@@ -48,20 +49,17 @@ class TaskCodeGenCPU : public TaskCodeGenLLVM {
 
     auto *tls_prologue = create_xlogue(stmt->tls_prologue);
 
-    // The loop body
+    // The loop body. It runs a whole block of iterations [begin, end) per
+    // call, so that the loop is visible to LLVM and can be vectorized.
     llvm::Function *body;
     {
       auto guard = get_function_creation_guard(
           {llvm::PointerType::get(get_runtime_type("RuntimeContext"), 0),
            llvm::Type::getInt8PtrTy(*llvm_context),
-           tlctx->get_data_type<int>()});
-
-      auto loop_var = create_entry_block_alloca(PrimitiveType::i32);
-      loop_vars_llvm[stmt].push_back(loop_var);
-      builder->CreateStore(get_arg(2), loop_var);
-      stmt->body->accept(this);
-
+           tlctx->get_data_type<int>(), tlctx->get_data_type<int>()});
+      create_block_range_for_body(stmt, get_arg(2), get_arg(3));
       body = guard.body;
+      set_vector_width_attributes(body);
     }
 
     llvm::Value *epilogue = create_xlogue(stmt->tls_epilogue);
@@ -74,6 +72,268 @@ class TaskCodeGenCPU : public TaskCodeGenLLVM {
          tls_prologue, body, epilogue, tlctx->get_constant(stmt->tls_size));
   }
 
+  void create_block_range_for_body(OffloadedStmt *stmt,
+                                   llvm::Value *block_begin,
+                                   llvm::Value *block_end) {
+    int group_size =
+        irpass::analysis::quant_array_word_group_size(stmt, compile_config);
+    create_block_loop(stmt, stmt->reversed, block_begin, block_end,
+                      group_size);
+  }
+
+  void visit(RangeForStmt *for_stmt) override {
+    int group_size =
+        irpass::analysis::quant_array_word_group_size(for_stmt, compile_config);
+    if (group_size == 1) {
+      TaskCodeGenLLVM::visit(for_stmt);
+      return;
+    }
+    create_block_loop(for_stmt, /*reversed=*/false, llvm_val[for_stmt->begin],
+                      llvm_val[for_stmt->end], group_size);
+  }
+
+  // Emits the loop over [block_begin, block_end) of |loop|, which is either
+  // the offloaded range-for or the serial loop over the share of a thread.
+  void create_block_loop(Stmt *loop,
+                         bool reversed,
+                         llvm::Value *block_begin,
+                         llvm::Value *block_end,
+                         int group_size) {
+    using namespace llvm;
+    auto loop_var = create_entry_block_alloca(PrimitiveType::i32);
+    loop_vars_llvm[loop].push_back(loop_var);
+
+    // The iterations in [skip_begin, skip_end) are run in whole words of the
+    // element-wise quant_arrays first.
+    llvm::Value *skip_begin = nullptr;
+    llvm::Value *skip_end = nullptr;
+    if (group_size > 1 && !reversed) {
+      std::tie(skip_begin, skip_end) = create_quant_array_word_loop(
+          loop, loop_var, block_begin, block_end, group_size);
+    }
+
+    BasicBlock *loop_test =
+        BasicBlock::Create(*llvm_context, "loop_test", func);
+    BasicBlock *loop_body =
+        BasicBlock::Create(*llvm_context, "loop_body", func);
+    BasicBlock *loop_inc = BasicBlock::Create(*llvm_context, "loop_inc", func);
+    BasicBlock *after_loop =
+        BasicBlock::Create(*llvm_context, "after_loop", func);
+
+    auto loop_var_ty = tlctx->get_data_type(PrimitiveType::i32);
+    if (!reversed) {
+      builder->CreateStore(block_begin, loop_var);
+      if (skip_begin) {
+        skip_loop_var(loop_var, skip_begin, skip_end);
+      }
+    } else {
+      builder->CreateStore(
+          builder->CreateSub(block_end, tlctx->get_constant(1)), loop_var);
+    }
+    builder->CreateBr(loop_test);
+
+    builder->SetInsertPoint(loop_test);
+    llvm::Value *cond;
+    if (!reversed) {
+      cond = builder->CreateICmp(CmpInst::Predicate::ICMP_SLT,
+                                 builder->CreateLoad(loop_var_ty, loop_var),
+                                 block_end);
+    } else {
+      cond = builder->CreateICmp(CmpInst::Predicate::ICMP_SGE,
+                                 builder->CreateLoad(loop_var_ty, loop_var),
+                                 block_begin);
+    }
+    builder->CreateCondBr(cond, loop_body, after_loop);
+
+    builder->SetInsertPoint(loop_body);
+    create_block_loop_body(loop, loop_inc);
+
+    builder->SetInsertPoint(loop_inc);
+    create_increment(loop_var, tlctx->get_constant(reversed ? -1 : 1));
+    if (skip_begin) {
+      skip_loop_var(loop_var, skip_begin, skip_end);
+    }
+    auto *latch = builder->CreateBr(loop_test);
+    latch->setMetadata(LLVMContext::MD_loop, get_vectorize_loop_metadata());
+
+    builder->SetInsertPoint(after_loop);
+  }
+
+  void skip_loop_var(llvm::Value *loop_var,
+                     llvm::Value *skip_begin,
+                     llvm::Value *skip_end) {
+    auto i = builder->CreateLoad(tlctx->get_data_type(PrimitiveType::i32),
+                                 loop_var);
+    builder->CreateStore(
+        builder->CreateSelect(builder->CreateICmpEQ(i, skip_begin), skip_end,
+                              i),
+        loop_var);
+  }
+
+  void create_block_loop_body(Stmt *loop, llvm::BasicBlock *reentry) {
+    // The body may be emitted more than once. Forget the loop variables of
+    // the loops emitted before, so that the loop indices of the nested loops
+    // refer to the ones emitted this time.
+    for (auto it = loop_vars_llvm.begin(); it != loop_vars_llvm.end();) {
+      if (it->first != loop && it->first != current_offload) {
+        it = loop_vars_llvm.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (loop == current_offload) {
+      offloaded_loop_reentry = reentry;
+      current_offload->body->accept(this);
+      offloaded_loop_reentry = nullptr;
+    } else {
+      auto saved_loop_reentry = current_loop_reentry;
+      current_loop_reentry = reentry;
+      loop->as<RangeForStmt>()->body->accept(this);
+      current_loop_reentry = saved_loop_reentry;
+    }
+    if (!returned) {
+      builder->CreateBr(reentry);
+    } else {
+      returned = false;
+    }
+  }
+
+  // Runs the aligned groups of |group_size| iterations in the block, each of
+  // them storing whole words of the element-wise quant_arrays: the stores
+  // need no atomics, and once the inner loop is unrolled LLVM can merge them
+  // into one store per word and vectorize the loop over the groups. Loads are
+  // not grouped: each of them still reads the word and extracts its element,
+  // which LLVM can only merge when no store in between may alias the word.
+  // Returns the range of iterations covered.
+  std::pair<llvm::Value *, llvm::Value *> create_quant_array_word_loop(
+      Stmt *loop,
+      llvm::Value *loop_var,
+      llvm::Value *block_begin,
+      llvm::Value *block_end,
+      int group_size) {
+    using namespace llvm;
+    auto i32_ty = tlctx->get_data_type(PrimitiveType::i32);
+    int shift = bit::log2int(group_size);
+
+    // Groups in [max(block_begin, 0), block_end), rounded inwards.
+    auto begin = builder->CreateSelect(
+        builder->CreateICmpSLT(block_begin, tlctx->get_constant(0)),
+        tlctx->get_constant(0), block_begin);
+    auto group_begin = builder->CreateAShr(
+        builder->CreateAdd(begin, tlctx->get_constant(group_size - 1)), shift);
+    auto group_end = builder->CreateAShr(block_end, shift);
+    group_end = builder->CreateSelect(
+        builder->CreateICmpSLT(group_end, group_begin), group_begin,
+        group_end);
+
+    BasicBlock *group_test =
+        BasicBlock::Create(*llvm_context, "group_test", func);
+    BasicBlock *element_test =
+        BasicBlock::Create(*llvm_context, "element_test", func);
+    BasicBlock *element_body =
+        BasicBlock::Create(*llvm_context, "element_body", func);
+    BasicBlock *element_inc =
+        BasicBlock::Create(*llvm_context, "element_inc", func);
+    BasicBlock *group_inc =
+        BasicBlock::Create(*llvm_context, "group_inc", func);
+    BasicBlock *after_groups =
+        BasicBlock::Create(*llvm_context, "after_groups", func);
+
+    auto group_var = create_entry_block_alloca(PrimitiveType::i32);
+    auto element_var = create_entry_block_alloca(PrimitiveType::i32);
+    builder->CreateStore(group_begin, group_var);
+    builder->CreateBr(group_test);
+
+    builder->SetInsertPoint(group_test);
+    auto group = builder->CreateLoad(i32_ty, group_var);
+    builder->CreateStore(tlctx->get_constant(0), element_var);
+    builder->CreateCondBr(builder->CreateICmpSLT(group, group_end),
+                          element_test, after_groups);
+
+    builder->SetInsertPoint(element_test);
+    builder->CreateCondBr(
+        builder->CreateICmpSLT(builder->CreateLoad(i32_ty, element_var),
+                               tlctx->get_constant(group_size)),
+        element_body, group_inc);
+
+    builder->SetInsertPoint(element_body);
+    // An "or" rather than an "add", which lets LLVM tell the word and the
+    // element in the word apart once the inner loop is unrolled.
+    builder->CreateStore(
+        builder->CreateOr(
+            builder->CreateShl(builder->CreateLoad(i32_ty, group_var), shift),
+            builder->CreateLoad(i32_ty, element_var)),
+        loop_var);
+    quant_array_words_owned = true;
+    create_block_loop_body(loop, element_inc);
+    quant_array_words_owned = false;
+
+    builder->SetInsertPoint(element_inc);
+    create_increment(element_var, tlctx->get_constant(1));
+    auto *element_latch = builder->CreateBr(element_test);
+    element_latch->setMetadata(LLVMContext::MD_loop,
+                               get_unroll_loop_metadata());
+
+    builder->SetInsertPoint(group_inc);
+    create_increment(group_var, tlctx->get_constant(1));
+    auto *group_latch = builder->CreateBr(group_test);
+    group_latch->setMetadata(LLVMContext::MD_loop,
+                             get_vectorize_loop_metadata());
+
+    builder->SetInsertPoint(after_groups);
+    return {builder->CreateShl(group_begin, shift),
+            builder->CreateShl(group_end, shift)};
+  }
+
+  llvm::MDNode *get_unroll_loop_metadata() {
+    using namespace llvm;
+    SmallVector<Metadata *, 2> ops;
+    ops.push_back(nullptr);  // Self-reference, filled in below.
+    ops.push_back(MDNode::get(
+        *llvm_context,
+        {MDString::get(*llvm_context, "llvm.loop.unroll.full")}));
+    auto *loop_id = MDNode::getDistinct(*llvm_context, ops);
+    loop_id->replaceOperandWith(0, loop_id);
+    return loop_id;
+  }
+
+  // Number of 32-bit lanes the vectorizers may use, from `simd_width` capped
+  // by `max_vector_width`.
+  int get_vector_lanes() const {
+    return std::max(1, std::min(compile_config.simd_width,
+                                compile_config.max_vector_width));
+  }
+
+  llvm::MDNode *get_vectorize_loop_metadata() {
+    using namespace llvm;
+    SmallVector<Metadata *, 2> ops;
+    ops.push_back(nullptr);  // Self-reference, filled in below.
+    if (get_vector_lanes() > 1) {
+      ops.push_back(MDNode::get(
+          *llvm_context,
+          {MDString::get(*llvm_context, "llvm.loop.vectorize.enable"),
+           ConstantAsMetadata::get(builder->getTrue())}));
+    } else {
+      // A width of one disables the loop vectorizer.
+      ops.push_back(MDNode::get(
+          *llvm_context,
+          {MDString::get(*llvm_context, "llvm.loop.vectorize.width"),
+           ConstantAsMetadata::get(builder->getInt32(1))}));
+    }
+    auto *loop_id = MDNode::getDistinct(*llvm_context, ops);
+    loop_id->replaceOperandWith(0, loop_id);
+    return loop_id;
+  }
+
+  void set_vector_width_attributes(llvm::Function *f) {
+    int lanes = get_vector_lanes();
+    if (lanes > 1) {
+      // Lets the target pick e.g. 512-bit registers on AVX-512 machines,
+      // which LLVM avoids by default.
+      f->addFnAttr("prefer-vector-width", std::to_string(lanes * 32));
+    }
+  }
+
   void create_offload_mesh_for(OffloadedStmt *stmt) override {
     auto *tls_prologue = create_mesh_xlogue(stmt->tls_prologue);
 
@@ -147,6 +407,14 @@ class TaskCodeGenCPU : public TaskCodeGenLLVM {
          tlctx->get_constant(stmt->tls_size));
   }
 
+  // Collects the recycled nodes on the thread pool, the CPU counterpart of the
+  // gc_parallel_0/1/2 tasks on CUDA.
+  void emit_cpu_gc(OffloadedStmt *stmt) {
+    call("cpu_parallel_gc", get_arg(0), tlctx->get_constant(stmt->snode->id),
+         tlctx->get_constant(stmt->num_cpu_threads),
+         tlctx->get_constant(compile_config.cpu_deferred_gc));
+  }
+
   void create_bls_buffer(OffloadedStmt *stmt) {
     auto type = llvm::ArrayType::get(llvm::Type::getInt8Ty(*llvm_context),
                                      stmt->bls_size);
@@ -186,7 +454,7 @@ class TaskCodeGenCPU : public TaskCodeGenLLVM {
     } else if (stmt->task_type == Type::listgen) {
       emit_list_gen(stmt);
     } else if (stmt->task_type == Type::gc) {
-      emit_gc(stmt);
+      emit_cpu_gc(stmt);
     } else {
       TI_NOT_IMPLEMENTED
     }
@@ -195,6 +463,14 @@ class TaskCodeGenCPU : public TaskCodeGenLLVM {
       builder->SetInsertPoint(final_block);
       call("LLVMRuntime_profiler_stop", get_runtime());
     }
+    if (stmt->task_type == Type::range_for ||
+        stmt->task_type == Type::mesh_for ||
+        stmt->task_type == Type::struct_for) {
+      // For the launch autotuner, which tunes the block size and the number
+      // of threads of the parallel loops.
+      current_task->block_dim = stmt->block_dim;
+      current_task->grid_dim = stmt->num_cpu_threads;
+    }
     finalize_offloaded_task_function();
     offloaded_tasks.push_back(*current_task);
     current_task = nullptr;
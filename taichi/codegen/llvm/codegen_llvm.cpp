@@ -149,15 +149,22 @@ void TaskCodeGenLLVM::visit(AllocaStmt *stmt) {
 }
 
 void TaskCodeGenLLVM::visit(RandStmt *stmt) {
-  if (stmt->ret_type->is_primitive(PrimitiveTypeID::f16)) {
-    // Promoting to f32 since there's no rand_f16 support in runtime.cpp.
-    auto val_f32 = call("rand_f32", get_context());
-    llvm_val[stmt] =
-        builder->CreateFPTrunc(val_f32, llvm::Type::getHalfTy(*llvm_context));
+  // Promoting f16 to f32 since there's no rand_f16 support in runtime.cpp.
+  bool is_f16 = stmt->ret_type->is_primitive(PrimitiveTypeID::f16);
+  auto type_name = is_f16 ? "f32" : data_type_name(stmt->ret_type);
+  llvm::Value *val;
+  if (stmt->index) {
+    val = call(fmt::format("philox_rand_{}", type_name), get_context(),
+               tlctx->get_constant(compile_config.random_seed),
+               llvm_val[stmt->index], tlctx->get_constant(stmt->stream),
+               llvm_val[stmt->counter]);
   } else {
-    llvm_val[stmt] = call(
-        fmt::format("rand_{}", data_type_name(stmt->ret_type)), get_context());
+    val = call(fmt::format("rand_{}", type_name), get_context());
+  }
+  if (is_f16) {
+    val = builder->CreateFPTrunc(val, llvm::Type::getHalfTy(*llvm_context));
   }
+  llvm_val[stmt] = val;
 }
 
 void TaskCodeGenLLVM::emit_extra_unary(UnaryOpStmt *stmt) {
@@ -1084,7 +1091,11 @@ void TaskCodeGenLLVM::visit(ContinueStmt *stmt) {
     return false;
   };
   if (stmt_in_off_range_for()) {
-    builder->CreateRetVoid();
+    if (offloaded_loop_reentry != nullptr) {
+      builder->CreateBr(offloaded_loop_reentry);
+    } else {
+      builder->CreateRetVoid();
+    }
   } else {
     TI_ASSERT(current_loop_reentry != nullptr);
     builder->CreateBr(current_loop_reentry);
@@ -1395,18 +1406,19 @@ llvm::Value *TaskCodeGenLLVM::quant_type_atomic(AtomicOpStmt *stmt) {
   }
 
   auto dst_type = stmt->dest->ret_type->as<PointerType>()->get_pointee_type();
+  bool atomic = !owns_quant_array_word(stmt->dest);
   if (auto qit = dst_type->cast<QuantIntType>()) {
     return atomic_add_quant_int(
         llvm_val[stmt->dest],
         tlctx->get_data_type(
             stmt->dest->as<GetChStmt>()->input_snode->physical_type),
-        qit, llvm_val[stmt->val], is_signed(stmt->val->ret_type));
+        qit, llvm_val[stmt->val], is_signed(stmt->val->ret_type), atomic);
   } else if (auto qfxt = dst_type->cast<QuantFixedType>()) {
     return atomic_add_quant_fixed(
         llvm_val[stmt->dest],
         tlctx->get_data_type(
             stmt->dest->as<GetChStmt>()->input_snode->physical_type),
-        qfxt, llvm_val[stmt->val]);
+        qfxt, llvm_val[stmt->val], atomic);
   } else {
     return nullptr;
   }
@@ -1561,6 +1573,16 @@ void TaskCodeGenLLVM::visit(GlobalPtrStmt *stmt) {
   TI_ERROR("Global Ptrs should have been lowered.");
 }
 
+bool TaskCodeGenLLVM::owns_quant_array_word(Stmt *ptr) {
+  if (!quant_array_words_owned) {
+    return false;
+  }
+  auto get_ch = ptr->cast<GetChStmt>();
+  return get_ch && get_ch->input_snode->type == SNodeType::quant_array &&
+         current_offload->mem_access_opt.has_flag(
+             get_ch->input_snode, SNodeAccessFlag::element_wise);
+}
+
 void TaskCodeGenLLVM::visit(GlobalStoreStmt *stmt) {
   TI_ASSERT(llvm_val[stmt->val]);
   TI_ASSERT(llvm_val[stmt->dest]);
@@ -1574,14 +1596,15 @@ void TaskCodeGenLLVM::visit(GlobalStoreStmt *stmt) {
           "BitStructStoreStmt.",
           pointee_type->to_string());
     }
+    bool atomic = !owns_quant_array_word(stmt->dest);
     if (auto qit = pointee_type->cast<QuantIntType>()) {
       store_quant_int(llvm_val[stmt->dest],
                       tlctx->get_data_type(snode->physical_type), qit,
-                      llvm_val[stmt->val], true);
+                      llvm_val[stmt->val], atomic);
     } else if (auto qfxt = pointee_type->cast<QuantFixedType>()) {
       store_quant_fixed(llvm_val[stmt->dest],
                         tlctx->get_data_type(snode->physical_type), qfxt,
-                        llvm_val[stmt->val], true);
+                        llvm_val[stmt->val], atomic);
     } else {
       TI_NOT_IMPLEMENTED;
     }
@@ -1903,7 +1926,17 @@ void TaskCodeGenLLVM::visit(ExternalPtrStmt *stmt) {
   int num_array_args = num_indices - num_element_indices;
   const size_t element_shape_index_offset = num_array_args;
 
+  // The extents the kernel is specialized on are constants.
+  std::vector<int> specialized_shape;
+  if (auto arg_load = stmt->base_ptr->cast<ArgLoadStmt>()) {
+    specialized_shape =
+        current_callable->parameter_list[arg_load->arg_id].shape;
+  }
   for (int i = 0; i < num_array_args; i++) {
+    if (i < (int)specialized_shape.size() && specialized_shape[i] >= 0) {
+      sizes[i] = tlctx->get_constant(specialized_shape[i]);
+      continue;
+    }
     auto raw_arg = builder->CreateGEP(
         struct_type, llvm_val[stmt->base_ptr],
         {tlctx->get_constant(0),
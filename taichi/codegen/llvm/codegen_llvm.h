@@ -46,6 +46,14 @@ class TaskCodeGenLLVM : public IRVisitor, public LLVMModuleBuilder {
   llvm::GlobalVariable *bls_buffer{nullptr};
   // Mainly for supporting continue stmt
   llvm::BasicBlock *current_loop_reentry;
+  // Set when the body of an offloaded range-for iterates over a block of
+  // indices instead of a single one. Continue stmts of the offloaded loop
+  // branch here instead of returning.
+  llvm::BasicBlock *offloaded_loop_reentry{nullptr};
+  // Set while emitting loop iterations that cover whole physical words of the
+  // quant_arrays flagged element_wise, so that nothing else writes to these
+  // words and their elements can be updated without atomics.
+  bool quant_array_words_owned{false};
   // Mainly for supporting break stmt
   llvm::BasicBlock *current_while_after_loop;
   llvm::FunctionType *task_function_type;
@@ -228,13 +236,24 @@ class TaskCodeGenLLVM : public IRVisitor, public LLVMModuleBuilder {
   llvm::Value *atomic_add_quant_fixed(llvm::Value *ptr,
                                       llvm::Type *physical_type,
                                       QuantFixedType *qfxt,
-                                      llvm::Value *value);
+                                      llvm::Value *value,
+                                      bool atomic = true);
 
   llvm::Value *atomic_add_quant_int(llvm::Value *ptr,
                                     llvm::Type *physical_type,
                                     QuantIntType *qit,
                                     llvm::Value *value,
-                                    bool value_is_signed);
+                                    bool value_is_signed,
+                                    bool atomic = true);
+
+  llvm::Value *add_partial_bits(llvm::Value *byte_ptr,
+                                llvm::Type *physical_type,
+                                llvm::Value *bit_offset,
+                                int num_bits,
+                                llvm::Value *value);
+
+  // Whether the element |ptr| points to can be updated without atomics.
+  bool owns_quant_array_word(Stmt *ptr);
 
   llvm::Value *to_quant_fixed(llvm::Value *real, QuantFixedType *qfxt);
 
@@ -270,6 +289,12 @@ class TaskCodeGenLLVM : public IRVisitor, public LLVMModuleBuilder {
                          llvm::Value *value,
                          bool atomic);
 
+  void store_partial_bits(llvm::Value *byte_ptr,
+                          llvm::Type *physical_type,
+                          llvm::Value *bit_offset,
+                          int num_bits,
+                          llvm::Value *value);
+
   void store_masked(llvm::Value *ptr,
                     llvm::Type *ty,
                     uint64 mask,
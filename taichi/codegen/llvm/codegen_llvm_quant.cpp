@@ -19,28 +19,60 @@ llvm::Value *TaskCodeGenLLVM::atomic_add_quant_int(llvm::Value *ptr,
                                                    llvm::Type *physical_type,
                                                    QuantIntType *qit,
                                                    llvm::Value *value,
-                                                   bool value_is_signed) {
+                                                   bool value_is_signed,
+                                                   bool atomic) {
   auto [byte_ptr, bit_offset] = load_bit_ptr(ptr);
+  value = builder->CreateIntCast(value, physical_type, value_is_signed);
+  if (!atomic) {
+    return add_partial_bits(byte_ptr, physical_type, bit_offset,
+                            qit->get_num_bits(), value);
+  }
   return call(fmt::format("atomic_add_partial_bits_b{}",
                           physical_type->getIntegerBitWidth()),
               byte_ptr, bit_offset, tlctx->get_constant(qit->get_num_bits()),
-              builder->CreateIntCast(value, physical_type, value_is_signed));
+              value);
 }
 
 llvm::Value *TaskCodeGenLLVM::atomic_add_quant_fixed(llvm::Value *ptr,
                                                      llvm::Type *physical_type,
                                                      QuantFixedType *qfxt,
-                                                     llvm::Value *value) {
+                                                     llvm::Value *value,
+                                                     bool atomic) {
   auto [byte_ptr, bit_offset] = load_bit_ptr(ptr);
   auto qit = qfxt->get_digits_type()->as<QuantIntType>();
   auto val_store = to_quant_fixed(value, qfxt);
   val_store = builder->CreateSExt(val_store, physical_type);
+  if (!atomic) {
+    return add_partial_bits(byte_ptr, physical_type, bit_offset,
+                            qit->get_num_bits(), val_store);
+  }
   return call(fmt::format("atomic_add_partial_bits_b{}",
                           physical_type->getIntegerBitWidth()),
               byte_ptr, bit_offset, tlctx->get_constant(qit->get_num_bits()),
               val_store);
 }
 
+llvm::Value *TaskCodeGenLLVM::add_partial_bits(llvm::Value *byte_ptr,
+                                               llvm::Type *physical_type,
+                                               llvm::Value *bit_offset,
+                                               int num_bits,
+                                               llvm::Value *value) {
+  // The non-atomic version of atomic_add_partial_bits in the runtime, which
+  // also returns the old physical value.
+  auto offset = builder->CreateIntCast(bit_offset, physical_type, false);
+  auto mask = builder->CreateShl(
+      llvm::ConstantInt::get(physical_type, (~(uint64)0) >> (64 - num_bits)),
+      offset);
+  auto old_value = builder->CreateLoad(physical_type, byte_ptr);
+  auto new_value =
+      builder->CreateAdd(old_value, builder->CreateShl(value, offset));
+  new_value =
+      builder->CreateOr(builder->CreateAnd(old_value, builder->CreateNot(mask)),
+                        builder->CreateAnd(new_value, mask));
+  builder->CreateStore(new_value, byte_ptr);
+  return old_value;
+}
+
 llvm::Value *TaskCodeGenLLVM::to_quant_fixed(llvm::Value *real,
                                              QuantFixedType *qfxt) {
   // Compute int(real * (1.0 / scale) + 0.5)
@@ -72,12 +104,36 @@ void TaskCodeGenLLVM::store_quant_int(llvm::Value *ptr,
                                       llvm::Value *value,
                                       bool atomic) {
   auto [byte_ptr, bit_offset] = load_bit_ptr(ptr);
+  value = builder->CreateIntCast(value, physical_type, false);
+  if (!atomic) {
+    store_partial_bits(byte_ptr, physical_type, bit_offset,
+                       qit->get_num_bits(), value);
+    return;
+  }
   // TODO(type): CUDA only supports atomicCAS on 32- and 64-bit integers.
   // Try to support 8/16-bit physical types.
-  call(fmt::format("{}set_partial_bits_b{}", atomic ? "atomic_" : "",
+  call(fmt::format("atomic_set_partial_bits_b{}",
                    physical_type->getIntegerBitWidth()),
-       byte_ptr, bit_offset, tlctx->get_constant(qit->get_num_bits()),
-       builder->CreateIntCast(value, physical_type, false));
+       byte_ptr, bit_offset, tlctx->get_constant(qit->get_num_bits()), value);
+}
+
+void TaskCodeGenLLVM::store_partial_bits(llvm::Value *byte_ptr,
+                                         llvm::Type *physical_type,
+                                         llvm::Value *bit_offset,
+                                         int num_bits,
+                                         llvm::Value *value) {
+  // Emitted inline instead of calling set_partial_bits in the runtime, so
+  // that LLVM can merge the stores to the elements of the same word.
+  auto offset = builder->CreateIntCast(bit_offset, physical_type, false);
+  auto mask = builder->CreateShl(
+      llvm::ConstantInt::get(physical_type, (~(uint64)0) >> (64 - num_bits)),
+      offset);
+  auto old_value = builder->CreateLoad(physical_type, byte_ptr);
+  auto new_value =
+      builder->CreateOr(builder->CreateAnd(old_value, builder->CreateNot(mask)),
+                        builder->CreateAnd(builder->CreateShl(value, offset),
+                                           mask));
+  builder->CreateStore(new_value, byte_ptr);
 }
 
 void TaskCodeGenLLVM::store_quant_fixed(llvm::Value *ptr,
@@ -68,7 +68,8 @@ void StructCompilerLLVM::generate_types(SNode &snode) {
 
   llvm::Type *body_type = nullptr, *aux_type = nullptr;
   if (type == SNodeType::dense || type == SNodeType::bitmasked) {
-    TI_ASSERT(snode._morton == false);
+    // SNode::morton() only accepts dense SNodes.
+    TI_ASSERT(!snode._morton || type == SNodeType::dense);
     body_type = llvm::ArrayType::get(ch_type, snode.max_num_elements());
     if (type == SNodeType::bitmasked) {
       aux_type = llvm::ArrayType::get(llvm::Type::getInt32Ty(*llvm_ctx_),
@@ -168,9 +169,22 @@ void StructCompilerLLVM::generate_refine_coordinates(SNode *snode) {
   auto outp_coords = args[1];
   auto l = args[2];
 
+  auto morton_bits = snode->_morton ? snode->morton_bits()
+                                    : std::vector<std::pair<int, int>>();
   for (int i = 0; i < taichi_max_num_indices; i++) {
-    auto addition = tlctx_->get_constant(0);
-    if (snode->extractors[i].shape > 1) {
+    llvm::Value *addition = tlctx_->get_constant(0);
+    if (snode->_morton) {
+      // Gather the bits of this axis from the interleaved cell index.
+      for (int j = 0; j < (int)morton_bits.size(); j++) {
+        auto [axis, bit] = morton_bits[j];
+        if (axis != i) {
+          continue;
+        }
+        auto masked = builder.CreateAnd(l, tlctx_->get_constant(1 << j));
+        auto moved = builder.CreateLShr(masked, tlctx_->get_constant(j - bit));
+        addition = builder.CreateOr(addition, moved);
+      }
+    } else if (snode->extractors[i].shape > 1) {
       auto prev = tlctx_->get_constant(snode->extractors[i].acc_shape *
                                        snode->extractors[i].shape);
       auto next = tlctx_->get_constant(snode->extractors[i].acc_shape);
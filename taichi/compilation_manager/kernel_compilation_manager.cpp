@@ -76,9 +76,12 @@ const CompiledKernelData &KernelCompilationManager::load_or_compile(
   const auto kernel_key = make_kernel_key(compile_config, caps, kernel_def);
   auto cached_kernel = try_load_cached_kernel(kernel_def, kernel_key,
                                               compile_config.arch, cache_mode);
-  return cached_kernel ? *cached_kernel
-                       : compile_and_cache_kernel(kernel_key, compile_config,
-                                                  caps, kernel_def);
+  const auto &ckd = cached_kernel
+                        ? *cached_kernel
+                        : compile_and_cache_kernel(kernel_key, compile_config,
+                                                   caps, kernel_def);
+  ckd.set_kernel_key(kernel_key);
+  return ckd;
 }
 
 void KernelCompilationManager::dump() {
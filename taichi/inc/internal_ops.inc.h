@@ -18,6 +18,14 @@ PER_INTERNAL_OP(do_nothing)
 PER_INTERNAL_OP(refresh_counter)
 PER_INTERNAL_OP(test_internal_func_args)
 
+// CPU parallel primitives
+PER_INTERNAL_OP(cpu_parallel_scan_add_i32)
+PER_INTERNAL_OP(cpu_parallel_scan_add_f32)
+PER_INTERNAL_OP(cpu_parallel_compact_32)
+PER_INTERNAL_OP(cpu_parallel_radix_sort_u32)
+PER_INTERNAL_OP(cpu_parallel_radix_sort_i32)
+PER_INTERNAL_OP(cpu_parallel_radix_sort_f32)
+
 // Vulkan
 PER_INTERNAL_OP(workgroupBarrier)
 PER_INTERNAL_OP(workgroupMemoryBarrier)
@@ -198,6 +198,37 @@ struct DiffPtrResult {
  */
 DiffPtrResult value_diff_ptr_index(Stmt *val1, Stmt *val2);
 
+/**
+ * Computes an interval containing every value of an i32 statement, from the
+ * constants it depends on and the bounds of the loops whose indices it
+ * depends on.
+ *
+ * @param stmt
+ *   The statement to analyze.
+ *
+ * @return
+ *   The inclusive bounds [low, high] of the values of |stmt|, which are the
+ *   bounds of i32 if nothing is known, or std::nullopt if |stmt| is not an i32
+ *   statement.
+ */
+std::optional<std::pair<int64, int64>> value_range(Stmt *stmt);
+
+/**
+ * Computes the number of consecutive iterations of a loop that the CPU
+ * codegen runs together, so that they store whole physical words of the
+ * element-wise quant_arrays of the task. The index of such a loop doesn't
+ * advance by one per iteration.
+ *
+ * @param loop
+ *   A range-for task, or the serial loop over the share of a thread made by
+ *   make_cpu_multithreaded_range_for.
+ *
+ * @return
+ *   The number of iterations of a group, or 1 if the iterations run one by
+ *   one.
+ */
+int quant_array_word_group_size(Stmt *loop, const CompileConfig &config);
+
 std::unordered_set<Stmt *> constexpr_prop(
     Block *block,
     std::function<bool(Stmt *)> is_const_seed);
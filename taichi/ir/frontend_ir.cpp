@@ -1537,6 +1537,15 @@ void ASTBuilder::create_assert_stmt(const Expr &cond,
   this->insert(std::move(stmt_unique));
 }
 
+std::optional<std::vector<int>> ASTBuilder::get_next_loop_tile_sizes() const {
+  const auto &config = for_loop_dec_.config;
+  if (!config.tiled || config.strictly_serialized || !arch_is_cpu(arch_) ||
+      stack_.size() != 1) {
+    return std::nullopt;
+  }
+  return config.tile_sizes;
+}
+
 void ASTBuilder::begin_frontend_range_for(const Expr &i,
                                           const Expr &s,
                                           const Expr &e) {
@@ -23,6 +23,10 @@ struct ForLoopConfig {
   MemoryAccessOptions mem_access_opt;
   int block_dim{0};
   bool uniform{false};
+  // Tiling of multi-dimensional ndrange loops, which is lowered in the
+  // frontend. Empty |tile_sizes| lets the frontend pick the sizes.
+  bool tiled{false};
+  std::vector<int> tile_sizes;
 };
 
 #define TI_DEFINE_CLONE_FOR_FRONTEND_IR                \
@@ -931,6 +935,8 @@ class ASTBuilder {
       config.mem_access_opt.clear();
       config.block_dim = 0;
       config.strictly_serialized = false;
+      config.tiled = false;
+      config.tile_sizes.clear();
     }
   };
 
@@ -1055,6 +1061,22 @@ class ASTBuilder {
     for_loop_dec_.config.block_dim = v;
   }
 
+  int get_next_loop_block_dim() const {
+    return for_loop_dec_.config.block_dim;
+  }
+
+  void tile(const std::vector<int> &sizes) {
+    for (auto size : sizes) {
+      TI_ASSERT(size > 0);
+    }
+    for_loop_dec_.config.tiled = true;
+    for_loop_dec_.config.tile_sizes = sizes;
+  }
+
+  // Returns the tile sizes of the next loop, or std::nullopt if it should not
+  // be tiled. Only the parallel outermost loops on CPU are tiled.
+  std::optional<std::vector<int>> get_next_loop_tile_sizes() const;
+
   void insert_snode_access_flag(SNodeAccessFlag v, const Expr &field) {
     for_loop_dec_.config.mem_access_opt.add_flag(field.snode(), v);
   }
@@ -17,6 +17,8 @@ std::string snode_access_flag_name(SNodeAccessFlag type) {
     return "read_only";
   } else if (type == SNodeAccessFlag::mesh_local) {
     return "mesh_local";
+  } else if (type == SNodeAccessFlag::element_wise) {
+    return "element_wise";
   } else {
     TI_ERROR("Undefined SNode AccessType (value={})", int(type));
   }
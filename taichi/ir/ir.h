@@ -33,7 +33,14 @@ class SNode;
 class Kernel;
 struct CompileConfig;
 
-enum class SNodeAccessFlag : int { block_local, read_only, mesh_local };
+// element_wise: every write to the elements of the SNode in a range-for task
+// is at the loop index of the task.
+enum class SNodeAccessFlag : int {
+  block_local,
+  read_only,
+  mesh_local,
+  element_wise
+};
 std::string snode_access_flag_name(SNodeAccessFlag type);
 
 class MemoryAccessOptions {
@@ -0,0 +1,723 @@
+#include "taichi/ir/mesh_patcher.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <thread>
+
+#include "taichi/system/threading.h"
+
+namespace taichi::lang {
+namespace mesh {
+
+namespace {
+
+// Per-element lists of element indices, in compressed form.
+struct ElementLists {
+  std::vector<int> offsets{0};
+  std::vector<int> values;
+
+  int size() const {
+    return (int)offsets.size() - 1;
+  }
+
+  const int *begin(int i) const {
+    return values.data() + offsets[i];
+  }
+
+  const int *end(int i) const {
+    return values.data() + offsets[i + 1];
+  }
+};
+
+// The sorted vertices of an edge or a face, padded with -1.
+using Key = std::array<int, 3>;
+
+// The subsets of |size| vertices of an element with |num_verts| vertices. For
+// a tetrahedron, the edges are (0, 1), (0, 2), (1, 2), (0, 3), (1, 3), (2, 3).
+std::vector<std::vector<int>> sub_simplices(int num_verts, int size) {
+  std::vector<std::vector<int>> subsets;
+  for (int mask = 0; mask < (1 << num_verts); mask++) {
+    std::vector<int> subset;
+    for (int i = 0; i < num_verts; i++) {
+      if (mask & (1 << i)) {
+        subset.push_back(i);
+      }
+    }
+    if ((int)subset.size() == size) {
+      subsets.push_back(subset);
+    }
+  }
+  return subsets;
+}
+
+// Spreads the lower 21 bits of |x| to every third bit.
+uint64 spread_bits(uint64 x) {
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffffull;
+  x = (x | x << 16) & 0x1f0000ff0000ffull;
+  x = (x | x << 8) & 0x100f00f00f00f00full;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+  x = (x | x << 2) & 0x1249249249249249ull;
+  return x;
+}
+
+struct ParallelForContext {
+  const std::function<void(int, int)> *func;
+  int n;
+  int splits;
+};
+
+class MeshPatcher {
+ public:
+  MeshPatcher(MeshTopology topology,
+              const std::vector<int> &elements,
+              int num_verts,
+              const std::vector<float> &positions,
+              const MeshPatcherConfig &config)
+      : top_order_(int(topology) - 1),
+        top_verts_(elements),
+        positions_(positions),
+        config_(config),
+        num_threads_(config.num_threads > 0
+                         ? config.num_threads
+                         : (int)std::max(1u,
+                                         std::thread::hardware_concurrency())),
+        pool_(num_threads_) {
+    num_elements_.fill(0);
+    num_elements_[0] = num_verts;
+    num_elements_[top_order_] = (int)elements.size() / (top_order_ + 1);
+  }
+
+  PatchedMesh run(const std::vector<MeshRelationType> &relations);
+
+ private:
+  // Calls |func(begin, end)| on the thread pool for ranges covering [0, n).
+  void parallel_for(int n, const std::function<void(int, int)> &func) {
+    int splits = std::min(n, num_threads_ * 4);
+    if (splits <= 1) {
+      if (n > 0) {
+        func(0, n);
+      }
+      return;
+    }
+    ParallelForContext ctx{&func, n, splits};
+    pool_.run(splits, num_threads_, &ctx, [](void *p, int, int i) {
+      auto *ctx = (ParallelForContext *)p;
+      (*ctx->func)(int((int64)ctx->n * i / ctx->splits),
+                   int((int64)ctx->n * (i + 1) / ctx->splits));
+    });
+  }
+
+  // Sorts chunks of |v| on the thread pool and merges them.
+  template <typename T>
+  void parallel_sort(std::vector<T> &v) {
+    int chunks = (int)std::min<std::size_t>(num_threads_, v.size() / 4096 + 1);
+    std::vector<std::size_t> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; i++) {
+      bounds[i] = v.size() * i / chunks;
+    }
+    parallel_for(chunks, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        std::sort(v.begin() + bounds[i], v.begin() + bounds[i + 1]);
+      }
+    });
+    for (int width = 1; width < chunks; width *= 2) {
+      parallel_for((chunks + 2 * width - 1) / (2 * width),
+                   [&](int begin, int end) {
+                     for (int i = begin; i < end; i++) {
+                       int lo = i * 2 * width;
+                       int mid = std::min(lo + width, chunks);
+                       int hi = std::min(lo + 2 * width, chunks);
+                       std::inplace_merge(v.begin() + bounds[lo],
+                                          v.begin() + bounds[mid],
+                                          v.begin() + bounds[hi]);
+                     }
+                   });
+    }
+  }
+
+  void verts_of(int order, int i, int *verts) const {
+    if (order == 0) {
+      verts[0] = i;
+    } else if (order == top_order_) {
+      std::copy_n(&top_verts_[i * (top_order_ + 1)], top_order_ + 1, verts);
+    } else {
+      std::copy_n(keys_[order][i].begin(), order + 1, verts);
+    }
+  }
+
+  void enumerate_elements(int order);
+  ElementLists build_down_relation(int from, int to);
+  ElementLists build_up_relation(int from, int to);
+  ElementLists build_same_relation(int order);
+  const ElementLists &relation(int from, int to);
+  std::vector<int> rcm_order();
+  std::vector<int> sfc_order();
+
+  int top_order_;
+  const std::vector<int> &top_verts_;
+  const std::vector<float> &positions_;
+  MeshPatcherConfig config_;
+  int num_threads_;
+  ThreadPool pool_;
+  std::array<int, 4> num_elements_;
+  // The edges and faces, sorted.
+  std::array<std::vector<Key>, 4> keys_;
+  std::map<std::pair<int, int>, ElementLists> relations_;
+};
+
+void MeshPatcher::enumerate_elements(int order) {
+  int n = num_elements_[top_order_];
+  auto subsets = sub_simplices(top_order_ + 1, order + 1);
+  int per_element = (int)subsets.size();
+  std::vector<Key> keys((std::size_t)n * per_element);
+  parallel_for(n, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const int *verts = &top_verts_[i * (top_order_ + 1)];
+      for (int j = 0; j < per_element; j++) {
+        Key key{-1, -1, -1};
+        for (int k = 0; k <= order; k++) {
+          key[k] = verts[subsets[j][k]];
+        }
+        std::sort(key.begin(), key.begin() + order + 1);
+        keys[(std::size_t)i * per_element + j] = key;
+      }
+    }
+  });
+  parallel_sort(keys);
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  TI_ERROR_IF(keys.size() > (std::size_t)std::numeric_limits<int>::max(),
+              "Too many mesh {}", element_type_name(MeshElementType(order)));
+  num_elements_[order] = (int)keys.size();
+  keys_[order] = std::move(keys);
+}
+
+ElementLists MeshPatcher::build_down_relation(int from, int to) {
+  int n = num_elements_[from];
+  auto subsets = sub_simplices(from + 1, to + 1);
+  int per_element = (int)subsets.size();
+  ElementLists lists;
+  lists.offsets.resize(n + 1);
+  for (int i = 0; i <= n; i++) {
+    lists.offsets[i] = i * per_element;
+  }
+  lists.values.resize((std::size_t)n * per_element);
+  const auto &keys = keys_[to];
+  parallel_for(n, [&](int begin, int end) {
+    int verts[4];
+    for (int i = begin; i < end; i++) {
+      verts_of(from, i, verts);
+      for (int j = 0; j < per_element; j++) {
+        int index;
+        if (to == 0) {
+          index = verts[subsets[j][0]];
+        } else {
+          Key key{-1, -1, -1};
+          for (int k = 0; k <= to; k++) {
+            key[k] = verts[subsets[j][k]];
+          }
+          std::sort(key.begin(), key.begin() + to + 1);
+          index = int(std::lower_bound(keys.begin(), keys.end(), key) -
+                      keys.begin());
+        }
+        lists.values[(std::size_t)i * per_element + j] = index;
+      }
+    }
+  });
+  return lists;
+}
+
+ElementLists MeshPatcher::build_up_relation(int from, int to) {
+  const auto &down = relation(to, from);
+  ElementLists lists;
+  lists.offsets.assign(num_elements_[from] + 1, 0);
+  for (int x : down.values) {
+    lists.offsets[x + 1]++;
+  }
+  std::partial_sum(lists.offsets.begin(), lists.offsets.end(),
+                   lists.offsets.begin());
+  lists.values.resize(down.values.size());
+  std::vector<int> heads(lists.offsets.begin(), lists.offsets.end() - 1);
+  for (int i = 0; i < down.size(); i++) {
+    for (auto it = down.begin(i); it != down.end(i); ++it) {
+      lists.values[heads[*it]++] = i;
+    }
+  }
+  return lists;
+}
+
+// Vertices are neighbors if they share an edge, and other elements if they
+// share an element of the next lower order.
+ElementLists MeshPatcher::build_same_relation(int order) {
+  int shared_order = order == 0 ? 1 : order - 1;
+  const auto &to_shared = relation(order, shared_order);
+  const auto &from_shared = relation(shared_order, order);
+  int n = num_elements_[order];
+  auto neighbors_of = [&](int i, std::vector<int> &out) {
+    out.clear();
+    for (auto s = to_shared.begin(i); s != to_shared.end(i); ++s) {
+      for (auto it = from_shared.begin(*s); it != from_shared.end(*s); ++it) {
+        if (*it != i) {
+          out.push_back(*it);
+        }
+      }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+  };
+  ElementLists lists;
+  lists.offsets.assign(n + 1, 0);
+  parallel_for(n, [&](int begin, int end) {
+    std::vector<int> neighbors;
+    for (int i = begin; i < end; i++) {
+      neighbors_of(i, neighbors);
+      lists.offsets[i + 1] = (int)neighbors.size();
+    }
+  });
+  std::partial_sum(lists.offsets.begin(), lists.offsets.end(),
+                   lists.offsets.begin());
+  lists.values.resize(lists.offsets[n]);
+  parallel_for(n, [&](int begin, int end) {
+    std::vector<int> neighbors;
+    for (int i = begin; i < end; i++) {
+      neighbors_of(i, neighbors);
+      std::copy(neighbors.begin(), neighbors.end(),
+                lists.values.begin() + lists.offsets[i]);
+    }
+  });
+  return lists;
+}
+
+// Builds the relations on demand. Must not be called from the thread pool.
+const ElementLists &MeshPatcher::relation(int from, int to) {
+  auto key = std::make_pair(from, to);
+  auto it = relations_.find(key);
+  if (it != relations_.end()) {
+    return it->second;
+  }
+  ElementLists lists;
+  if (from > to) {
+    lists = build_down_relation(from, to);
+  } else if (from < to) {
+    lists = build_up_relation(from, to);
+  } else {
+    lists = build_same_relation(from);
+  }
+  return relations_.emplace(key, std::move(lists)).first->second;
+}
+
+std::vector<int> MeshPatcher::rcm_order() {
+  const auto &adjacent = relation(top_order_, top_order_);
+  int n = num_elements_[top_order_];
+  auto degree = [&](int i) {
+    return adjacent.offsets[i + 1] - adjacent.offsets[i];
+  };
+
+  std::vector<int> by_degree(n);
+  std::iota(by_degree.begin(), by_degree.end(), 0);
+  std::stable_sort(by_degree.begin(), by_degree.end(),
+                   [&](int a, int b) { return degree(a) < degree(b); });
+
+  std::vector<int> visit_id(n, -1);
+  std::vector<int> order;
+  order.reserve(n);
+  std::vector<int> neighbors;
+  // Appends the elements of the connected component of |start| to |out| in
+  // breadth-first order, visiting neighbors by increasing degree.
+  auto bfs = [&](int start, int id, std::vector<int> &out) {
+    std::size_t head = out.size();
+    visit_id[start] = id;
+    out.push_back(start);
+    while (head < out.size()) {
+      int i = out[head++];
+      neighbors.clear();
+      for (auto it = adjacent.begin(i); it != adjacent.end(i); ++it) {
+        if (visit_id[*it] != id) {
+          visit_id[*it] = id;
+          neighbors.push_back(*it);
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end(), [&](int a, int b) {
+        return std::make_pair(degree(a), a) < std::make_pair(degree(b), b);
+      });
+      out.insert(out.end(), neighbors.begin(), neighbors.end());
+    }
+  };
+
+  int num_visits = 0;
+  std::vector<int> component;
+  for (int start : by_degree) {
+    if (visit_id[start] != -1) {
+      continue;
+    }
+    // Start from the last element reached from a minimum degree element,
+    // which approximates a peripheral element of the component.
+    component.clear();
+    bfs(start, num_visits++, component);
+    int peripheral = component.back();
+    bfs(peripheral, num_visits++, order);
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+std::vector<int> MeshPatcher::sfc_order() {
+  TI_ERROR_IF(positions_.size() != (std::size_t)num_elements_[0] * 3,
+              "Space-filling curve reordering requires the vertex positions");
+  int n = num_elements_[top_order_];
+  int num_corners = top_order_ + 1;
+  std::vector<float> centroids((std::size_t)n * 3);
+  parallel_for(n, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      for (int d = 0; d < 3; d++) {
+        float sum = 0;
+        for (int k = 0; k < num_corners; k++) {
+          sum += positions_[top_verts_[i * num_corners + k] * 3 + d];
+        }
+        centroids[i * 3 + d] = sum / num_corners;
+      }
+    }
+  });
+  std::array<float, 3> lower, upper;
+  lower.fill(std::numeric_limits<float>::max());
+  upper.fill(std::numeric_limits<float>::lowest());
+  for (int i = 0; i < n; i++) {
+    for (int d = 0; d < 3; d++) {
+      lower[d] = std::min(lower[d], centroids[i * 3 + d]);
+      upper[d] = std::max(upper[d], centroids[i * 3 + d]);
+    }
+  }
+  std::vector<std::pair<uint64, int>> codes(n);
+  parallel_for(n, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      uint64 code = 0;
+      for (int d = 0; d < 3; d++) {
+        float extent = std::max(upper[d] - lower[d], 1e-20f);
+        auto x = uint64((centroids[i * 3 + d] - lower[d]) / extent * 0x1fffff);
+        code |= spread_bits(x) << d;
+      }
+      codes[i] = {code, i};
+    }
+  });
+  parallel_sort(codes);
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = codes[i].second;
+  }
+  return order;
+}
+
+// The elements of one patch, and its relations.
+struct Patch {
+  // The reordered indices of the ghost elements of each order, sorted.
+  std::array<std::vector<int>, 4> ghosts;
+  std::vector<std::vector<uint16>> values;
+  std::vector<std::vector<uint16>> offsets;
+  // Set if a local index or offset doesn't fit in 16 bits.
+  bool overflow{false};
+};
+
+PatchedMesh MeshPatcher::run(const std::vector<MeshRelationType> &relations) {
+  const int top = top_order_;
+  const int patch_size = config_.patch_size;
+
+  // Only the orders used by the relations are output, along with the vertices
+  // and the top-level elements.
+  std::array<bool, 4> used{}, needed{};
+  used[0] = used[top] = true;
+  for (auto rel : relations) {
+    int from = from_end_element_order(rel);
+    int to = to_end_element_order(rel);
+    used[from] = used[to] = true;
+    // See build_same_relation().
+    if (from == to) {
+      needed[from == 0 ? 1 : from - 1] = true;
+    }
+  }
+  if (config_.reorder == MeshReorderMethod::rcm) {
+    needed[top - 1] = true;
+  }
+  for (int order = 1; order < top; order++) {
+    if (used[order] || needed[order]) {
+      enumerate_elements(order);
+    }
+  }
+  for (auto rel : relations) {
+    relation(from_end_element_order(rel), to_end_element_order(rel));
+  }
+
+  // Cut the ordered top-level elements into patches.
+  auto order = config_.reorder == MeshReorderMethod::rcm ? rcm_order()
+                                                         : sfc_order();
+  const int num_top = num_elements_[top];
+  const int num_patches = std::max(1, (num_top + patch_size - 1) / patch_size);
+
+  // The owner of an element is the first patch containing it, and the owned
+  // elements of a patch are numbered in the order they are first reached from
+  // its top-level elements. The remaining (isolated) elements are owned by the
+  // last patch.
+  std::array<std::vector<int>, 4> g2r, r2g;
+  std::array<std::vector<uint32>, 4> owned_offsets;
+  for (int k = 0; k <= top; k++) {
+    if (!used[k]) {
+      continue;
+    }
+    g2r[k].assign(num_elements_[k], -1);
+    r2g[k].resize(num_elements_[k]);
+    owned_offsets[k].assign(num_patches + 1, 0);
+    int next = 0;
+    auto assign = [&](int g, int p) {
+      if (g2r[k][g] == -1) {
+        g2r[k][g] = next;
+        r2g[k][next++] = g;
+        owned_offsets[k][p + 1]++;
+      }
+    };
+    if (k == top) {
+      for (int i = 0; i < num_top; i++) {
+        assign(order[i], i / patch_size);
+      }
+    } else {
+      const auto &sub = relation(top, k);
+      for (int i = 0; i < num_top; i++) {
+        for (auto it = sub.begin(order[i]); it != sub.end(order[i]); ++it) {
+          assign(*it, i / patch_size);
+        }
+      }
+      for (int g = 0; g < num_elements_[k]; g++) {
+        assign(g, num_patches - 1);
+      }
+    }
+    std::partial_sum(owned_offsets[k].begin(), owned_offsets[k].end(),
+                     owned_offsets[k].begin());
+  }
+
+  std::vector<const ElementLists *> relation_lists;
+  for (auto rel : relations) {
+    relation_lists.push_back(
+        &relation(from_end_element_order(rel), to_end_element_order(rel)));
+  }
+
+  std::vector<Patch> patches(num_patches);
+  parallel_for(num_patches, [&](int begin, int end) {
+    for (int p = begin; p < end; p++) {
+      auto &patch = patches[p];
+      auto &ghosts = patch.ghosts;
+      auto is_owned = [&](int k, int r) {
+        return owned_offsets[k][p] <= (uint32)r &&
+               (uint32)r < owned_offsets[k][p + 1];
+      };
+      auto sort_ghosts = [&](int k) {
+        std::sort(ghosts[k].begin(), ghosts[k].end());
+        ghosts[k].erase(std::unique(ghosts[k].begin(), ghosts[k].end()),
+                        ghosts[k].end());
+      };
+      auto add_ghosts = [&](int rel_id, int r) {
+        int from = from_end_element_order(relations[rel_id]);
+        int to = to_end_element_order(relations[rel_id]);
+        const auto &lists = *relation_lists[rel_id];
+        int g = r2g[from][r];
+        for (auto it = lists.begin(g); it != lists.end(g); ++it) {
+          int target = g2r[to][*it];
+          if (!is_owned(to, target)) {
+            ghosts[to].push_back(target);
+          }
+        }
+      };
+      // The neighbors of the owned elements...
+      for (int i = 0; i < (int)relations.size(); i++) {
+        int from = from_end_element_order(relations[i]);
+        int owned_end = owned_offsets[from][p + 1];
+        for (int r = owned_offsets[from][p]; r < owned_end; r++) {
+          add_ghosts(i, r);
+        }
+      }
+      // ...and the lower order elements of the ghosts, so that the relations
+      // from higher to lower order elements can be resolved for the ghosts
+      // too.
+      for (int k = top; k >= 0; k--) {
+        sort_ghosts(k);
+        for (int i = 0; i < (int)relations.size(); i++) {
+          if (from_end_element_order(relations[i]) == k &&
+              to_end_element_order(relations[i]) < k) {
+            for (int j = 0; j < (int)ghosts[k].size(); j++) {
+              add_ghosts(i, ghosts[k][j]);
+            }
+          }
+        }
+      }
+
+      auto local_index = [&](int k, int r) {
+        if (is_owned(k, r)) {
+          return int(r - owned_offsets[k][p]);
+        }
+        auto it = std::lower_bound(ghosts[k].begin(), ghosts[k].end(), r);
+        TI_ASSERT(it != ghosts[k].end() && *it == r);
+        return int(owned_offsets[k][p + 1] - owned_offsets[k][p]) +
+               int(it - ghosts[k].begin());
+      };
+      auto push = [&](std::vector<uint16> &v, int x) {
+        if (x > std::numeric_limits<uint16>::max()) {
+          patch.overflow = true;
+        }
+        v.push_back(uint16(x));
+      };
+      patch.values.resize(relations.size());
+      patch.offsets.resize(relations.size());
+      for (int i = 0; i < (int)relations.size(); i++) {
+        int from = from_end_element_order(relations[i]);
+        int to = to_end_element_order(relations[i]);
+        const auto &lists = *relation_lists[i];
+        auto &values = patch.values[i];
+        auto push_neighbors = [&](int r) {
+          int g = r2g[from][r];
+          for (auto it = lists.begin(g); it != lists.end(g); ++it) {
+            push(values, local_index(to, g2r[to][*it]));
+          }
+        };
+        int owned_end = owned_offsets[from][p + 1];
+        for (int r = owned_offsets[from][p]; r < owned_end; r++) {
+          if (from <= to) {
+            push(patch.offsets[i], (int)values.size());
+          }
+          push_neighbors(r);
+        }
+        if (from > to) {
+          for (int r : ghosts[from]) {
+            push_neighbors(r);
+          }
+        } else {
+          push(patch.offsets[i], (int)values.size());
+        }
+      }
+      // The local indices of the elements must fit in 16 bits too.
+      for (int k = 0; k <= top; k++) {
+        if (used[k] && owned_offsets[k][p + 1] - owned_offsets[k][p] +
+                               ghosts[k].size() >
+                           std::numeric_limits<uint16>::max() + 1) {
+          patch.overflow = true;
+        }
+      }
+    }
+  });
+
+  for (int p = 0; p < num_patches; p++) {
+    TI_ERROR_IF(patches[p].overflow,
+                "Mesh patch {} has too many elements or relation entries for "
+                "16-bit local indices, try a smaller patch size than {}",
+                p, patch_size);
+  }
+
+  PatchedMesh result;
+  result.num_patches = num_patches;
+  for (int k = 0; k <= top; k++) {
+    if (!used[k]) {
+      continue;
+    }
+    PatchedElement element;
+    element.type = MeshElementType(k);
+    element.num = num_elements_[k];
+    element.owned_offsets = owned_offsets[k];
+    element.total_offsets.assign(num_patches + 1, 0);
+    for (int p = 0; p < num_patches; p++) {
+      uint32 total = owned_offsets[k][p + 1] - owned_offsets[k][p] +
+                     (uint32)patches[p].ghosts[k].size();
+      element.total_offsets[p + 1] = element.total_offsets[p] + total;
+      element.max_num_per_patch =
+          std::max(element.max_num_per_patch, (int)total);
+    }
+    element.l2g_mapping.resize(element.total_offsets[num_patches]);
+    element.l2r_mapping.resize(element.total_offsets[num_patches]);
+    parallel_for(num_patches, [&](int begin, int end) {
+      for (int p = begin; p < end; p++) {
+        uint32 l = element.total_offsets[p];
+        for (uint32 r = owned_offsets[k][p]; r < owned_offsets[k][p + 1];
+             r++, l++) {
+          element.l2r_mapping[l] = r;
+          element.l2g_mapping[l] = r2g[k][r];
+        }
+        for (int r : patches[p].ghosts[k]) {
+          element.l2r_mapping[l] = r;
+          element.l2g_mapping[l++] = r2g[k][r];
+        }
+      }
+    });
+    element.g2r_mapping.assign(g2r[k].begin(), g2r[k].end());
+    result.elements.push_back(std::move(element));
+  }
+
+  for (int i = 0; i < (int)relations.size(); i++) {
+    PatchedRelation rel;
+    rel.type = relations[i];
+    bool dynamic = from_end_element_order(relations[i]) <=
+                   to_end_element_order(relations[i]);
+    for (int p = 0; p < num_patches; p++) {
+      if (dynamic) {
+        rel.patch_offset.push_back((uint32)rel.value.size());
+        rel.offset.insert(rel.offset.end(), patches[p].offsets[i].begin(),
+                          patches[p].offsets[i].end());
+      }
+      rel.value.insert(rel.value.end(), patches[p].values[i].begin(),
+                       patches[p].values[i].end());
+    }
+    result.relations.push_back(std::move(rel));
+  }
+  return result;
+}
+
+}  // namespace
+
+MeshReorderMethod mesh_reorder_method_from_name(const std::string &name) {
+  if (name == "rcm") {
+    return MeshReorderMethod::rcm;
+  } else if (name == "sfc") {
+    return MeshReorderMethod::sfc;
+  } else {
+    TI_ERROR("Unknown mesh reordering method \"{}\", expected rcm or sfc",
+             name);
+  }
+}
+
+PatchedMesh build_patched_mesh(MeshTopology topology,
+                               const std::vector<int> &elements,
+                               int num_verts,
+                               const std::vector<float> &positions,
+                               const std::vector<MeshRelationType> &relations,
+                               const MeshPatcherConfig &config) {
+  TI_AUTO_PROF;
+  const int num_corners = int(topology);
+  const int top_order = num_corners - 1;
+  TI_ERROR_IF(elements.size() % num_corners != 0,
+              "The number of element vertices must be a multiple of {}",
+              num_corners);
+  TI_ERROR_IF(config.patch_size <= 0, "Invalid mesh patch size {}",
+              config.patch_size);
+  TI_ERROR_IF(!positions.empty() &&
+                  positions.size() != (std::size_t)num_verts * 3,
+              "Expected 3 coordinates for each of the {} vertices, got {} "
+              "values",
+              num_verts, positions.size());
+  for (int v : elements) {
+    TI_ERROR_IF(v < 0 || v >= num_verts, "Invalid vertex index {}", v);
+  }
+  for (auto rel : relations) {
+    TI_ERROR_IF(from_end_element_order(rel) > top_order ||
+                    to_end_element_order(rel) > top_order,
+                "Relation {} is not available on this mesh",
+                relation_type_name(rel));
+  }
+  std::vector<MeshRelationType> unique_relations = relations;
+  std::sort(unique_relations.begin(), unique_relations.end());
+  unique_relations.erase(
+      std::unique(unique_relations.begin(), unique_relations.end()),
+      unique_relations.end());
+  MeshPatcher patcher(topology, elements, num_verts, positions, config);
+  return patcher.run(unique_relations);
+}
+
+}  // namespace mesh
+}  // namespace taichi::lang
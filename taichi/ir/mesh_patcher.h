@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "taichi/ir/mesh.h"
+
+namespace taichi::lang {
+namespace mesh {
+
+// The patches of one element type, in the layout expected by Mesh:
+//  - The elements owned by patch p are numbered contiguously in the reordered
+//    index space, from owned_offsets[p] to owned_offsets[p + 1].
+//  - Inside patch p, the local indices of its owned elements come first,
+//    followed by its ghost elements. The local index space of all patches is
+//    concatenated, patch p starting from total_offsets[p].
+struct PatchedElement {
+  MeshElementType type{MeshElementType::Vertex};
+  int num{0};
+  int max_num_per_patch{0};
+  std::vector<uint32> owned_offsets;
+  std::vector<uint32> total_offsets;
+  std::vector<uint32> l2g_mapping;
+  std::vector<uint32> l2r_mapping;
+  std::vector<uint32> g2r_mapping;
+};
+
+// A relation between the elements of the patches, as patch-local indices.
+//  - From higher to lower order elements (e.g. CV), |value| has a fixed number
+//    of entries per element, for both owned and ghost elements.
+//  - Otherwise, |value| lists the neighbors of the owned elements of each
+//    patch, starting from patch_offset[p]. For the i-th owned element of patch
+//    p, they are at offset[p + owned_offsets[p] + i] to the next entry,
+//    relative to patch_offset[p].
+struct PatchedRelation {
+  MeshRelationType type{MeshRelationType::VV};
+  std::vector<uint16> value;
+  std::vector<uint16> offset;
+  std::vector<uint32> patch_offset;
+};
+
+struct PatchedMesh {
+  int num_patches{0};
+  std::vector<PatchedElement> elements;
+  std::vector<PatchedRelation> relations;
+};
+
+// How the top-level elements are ordered before being cut into patches.
+enum class MeshReorderMethod {
+  // Reverse Cuthill-McKee ordering of the elements sharing a facet.
+  rcm,
+  // Morton order of the element centroids. Requires the vertex positions.
+  sfc,
+};
+
+struct MeshPatcherConfig {
+  // The number of top-level elements (cells of tetrahedral meshes, faces of
+  // triangle meshes) per patch.
+  int patch_size{256};
+  MeshReorderMethod reorder{MeshReorderMethod::rcm};
+  // 0 for the number of hardware threads.
+  int num_threads{0};
+};
+
+MeshReorderMethod mesh_reorder_method_from_name(const std::string &name);
+
+// Partitions a triangle or tetrahedral mesh into patches and builds the
+// requested relations for them. This replaces the offline meshtaichi patcher.
+//
+// |elements| lists the vertices of each top-level element. |positions| holds
+// three coordinates per vertex, and may be empty if the reordering doesn't
+// need it. Edges and faces are numbered in the lexicographic order of their
+// sorted vertices.
+PatchedMesh build_patched_mesh(MeshTopology topology,
+                               const std::vector<int> &elements,
+                               int num_verts,
+                               const std::vector<float> &positions,
+                               const std::vector<MeshRelationType> &relations,
+                               const MeshPatcherConfig &config);
+
+}  // namespace mesh
+}  // namespace taichi::lang
@@ -107,6 +107,39 @@ SNode &SNode::create_node(std::vector<Axis> axes,
   return new_node;
 }
 
+SNode &SNode::morton(bool val) {
+  if (val) {
+    TI_ERROR_IF(type != SNodeType::dense,
+                "Morton layout is only supported on dense SNodes, got {}",
+                snode_type_name(type));
+    for (int i = 0; i < taichi_max_num_indices; i++) {
+      TI_ERROR_IF(
+          extractors[i].active && !bit::is_power_of_two(extractors[i].shape),
+          "Morton layout requires power-of-two shapes, got {} along axis {}",
+          extractors[i].shape, i);
+    }
+  }
+  _morton = val;
+  return *this;
+}
+
+std::vector<std::pair<int, int>> SNode::morton_bits() const {
+  std::vector<std::pair<int, int>> bits;
+  for (int bit = 0;; bit++) {
+    bool added = false;
+    // The last axis takes the lowest bit of each group, as in row-major order.
+    for (int i = taichi_max_num_indices - 1; i >= 0; i--) {
+      if ((1 << bit) < extractors[i].shape) {
+        bits.emplace_back(i, bit);
+        added = true;
+      }
+    }
+    if (!added) {
+      return bits;
+    }
+  }
+}
+
 SNode &SNode::dynamic(const Axis &expr,
                       int n,
                       int chunk_size,
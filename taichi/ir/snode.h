@@ -223,10 +223,15 @@ class SNode {
                  int chunk_size,
                  const std::string &tb);
 
-  SNode &morton(bool val = true) {
-    _morton = val;
-    return *this;
-  }
+  // Stores the cells of a dense SNode in Morton (Z-curve) order instead of
+  // row-major order. The shape of every axis must be a power of two.
+  SNode &morton(bool val = true);
+
+  // The bits of the linear cell index of a Morton-ordered SNode, from the
+  // least significant one. Bit i of the cell index holds bit
+  // |morton_bits()[i].second| of the coordinate along axis
+  // |morton_bits()[i].first|.
+  std::vector<std::pair<int, int>> morton_bits() const;
 
   int child_id(SNode *c) {
     for (int i = 0; i < (int)ch.size(); i++) {
@@ -217,7 +217,21 @@ class ArgLoadStmt : public Stmt {
  */
 class RandStmt : public Stmt {
  public:
-  explicit RandStmt(const DataType &dt) {
+  // Set by make_counter_based_rand. If |index| is not null, the number is
+  // drawn from a counter-based generator keyed by the random seed and the
+  // kernel launch, at the counter (|index|, |stream|, |counter|): the loop
+  // index, the id of this call in the kernel, and how many times this
+  // iteration has called it before. Otherwise it comes from the state of the
+  // current thread.
+  Stmt *index{nullptr};
+  Stmt *counter{nullptr};
+  int stream{0};
+
+  explicit RandStmt(const DataType &dt,
+                    Stmt *index = nullptr,
+                    Stmt *counter = nullptr,
+                    int stream = 0)
+      : index(index), counter(counter), stream(stream) {
     ret_type = dt;
     TI_STMT_REG_FIELDS;
   }
@@ -230,7 +244,7 @@ class RandStmt : public Stmt {
     return false;
   }
 
-  TI_STMT_DEF_FIELDS(ret_type);
+  TI_STMT_DEF_FIELDS(ret_type, index, counter, stream);
   TI_DEFINE_ACCEPT_AND_CLONE
 };
 
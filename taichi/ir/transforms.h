@@ -10,6 +10,7 @@
 #include "taichi/ir/pass.h"
 #include "taichi/transforms/check_out_of_bound.h"
 #include "taichi/transforms/constant_fold.h"
+#include "taichi/transforms/fuse_range_fors.h"
 #include "taichi/transforms/inlining.h"
 #include "taichi/transforms/lower_access.h"
 #include "taichi/transforms/make_block_local.h"
@@ -50,6 +51,8 @@ bool unreachable_code_elimination(IRNode *root);
 bool loop_invariant_code_motion(IRNode *root, const CompileConfig &config);
 bool cache_loop_invariant_global_vars(IRNode *root,
                                       const CompileConfig &config);
+bool strength_reduce_induction_variables(IRNode *root,
+                                         const CompileConfig &config);
 void full_simplify(IRNode *root,
                    const CompileConfig &config,
                    const FullSimplifyPass::Args &args);
@@ -69,6 +72,7 @@ bool check_out_of_bound(IRNode *root,
                         const CompileConfig &config,
                         const CheckOutOfBoundPass::Args &args);
 void handle_external_ptr_boundary(IRNode *root, const CompileConfig &config);
+void specialize_ndarray_shapes(IRNode *root, const Kernel *kernel);
 void make_thread_local(IRNode *root, const CompileConfig &config);
 std::unique_ptr<ScratchPads> initialize_scratch_pad(OffloadedStmt *root);
 void make_block_local(IRNode *root,
@@ -86,6 +90,7 @@ void demote_mesh_statements(IRNode *root,
                             const CompileConfig &config,
                             const DemoteMeshStatements::Args &args);
 bool remove_loop_unique(IRNode *root);
+void make_counter_based_rand(IRNode *root);
 bool remove_range_assumption(IRNode *root);
 bool lower_access(IRNode *root,
                   const CompileConfig &config,
@@ -135,10 +140,18 @@ bool replace_statements(IRNode *root,
                         std::function<bool(Stmt *)> filter,
                         std::function<Stmt *(Stmt *)> finder);
 void demote_dense_struct_fors(IRNode *root);
+// Merges adjacent top-level range-fors with the same bounds whose iterations
+// don't depend on each other through global memory.
+FuseRangeForsPass::Result fuse_range_fors(IRNode *root);
+// Merges adjacent range-for tasks with the same bounds and launch
+// configuration, under the same conditions as fuse_range_fors().
+FuseRangeForsPass::Result fuse_offloaded_range_fors(IRNode *root);
 void demote_no_access_mesh_fors(IRNode *root);
 bool demote_atomics(IRNode *root, const CompileConfig &config);
 void reverse_segments(IRNode *root);  // for autograd
 void detect_read_only(IRNode *root);
+void detect_element_wise_quant_arrays(IRNode *root,
+                                      const CompileConfig &config);
 void optimize_bit_struct_stores(IRNode *root,
                                 const CompileConfig &config,
                                 AnalysisManager *amgr);
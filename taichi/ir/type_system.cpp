@@ -315,6 +315,20 @@ void Operations::init_internals() {
   PLAIN_OP(refresh_counter, i32_void, true);
   PLAIN_OP(test_internal_func_args, i32, true, f32, f32, i32);
 
+  // CPU parallel primitives, see runtime_module/parallel_primitives.h.
+  // Pointers are passed as u64, e.g. from ti.get_addr().
+  PLAIN_OP(cpu_parallel_scan_add_i32, i32_void, true, u64, i32, i32);
+  PLAIN_OP(cpu_parallel_scan_add_f32, i32_void, true, u64, i32, i32);
+  PLAIN_OP(cpu_parallel_compact_32, i32, true, u64, u64, u64, i32);
+
+#define CPU_RADIX_SORT(dt)                                                   \
+  PLAIN_OP(cpu_parallel_radix_sort_##dt, i32_void, true, u64, u64, u64, u64, \
+           i32)
+  CPU_RADIX_SORT(u32);
+  CPU_RADIX_SORT(i32);
+  CPU_RADIX_SORT(f32);
+#undef CPU_RADIX_SORT
+
   // CUDA ops:
   // block_barrier, grid_memfence, cuda_all_sync, cuda_any_sync, cuda_uni_sync,
   // cuda_ballot, cuda_shfl_sync, cuda_shfl_up_sync, cuda_shfl_down_sync,
@@ -33,7 +33,9 @@ int Callable::insert_arr_param(const DataType &dt,
 int Callable::insert_ndarray_param(const DataType &dt,
                                    int ndim,
                                    const std::string &name,
-                                   bool needs_grad) {
+                                   bool needs_grad,
+                                   const std::vector<int> &shape) {
+  TI_ASSERT(shape.empty() || (int)shape.size() == ndim);
   // Transform ndarray param to a struct type with a pointer to `dt`.
   std::vector<int> element_shape{};
   auto dtype = dt;
@@ -50,6 +52,7 @@ int Callable::insert_ndarray_param(const DataType &dt,
                               element_shape, BufferFormat::unknown, needs_grad);
   parameter_list.back().name = name;
   parameter_list.back().ptype = ParameterType::kNdarray;
+  parameter_list.back().shape = shape;
   return (int)parameter_list.size() - 1;
 }
 
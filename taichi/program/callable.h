@@ -20,18 +20,23 @@ class TI_DLL_EXPORT CallableBase {
     bool needs_grad{false};  // TODO: reorder for better alignment
     std::vector<int> element_shape{};
     ParameterType ptype{ParameterType::kUnknown};
+    // The extents of the array axes the kernel is specialized on, -1 for the
+    // axes left generic. Empty if the kernel takes arrays of any shape.
+    std::vector<int> shape{};
     TI_IO_DEF(is_array,
               total_dim,
               format,
               dt_,
               needs_grad,
               element_shape,
-              ptype);
+              ptype,
+              shape);
 
     bool operator==(const Parameter &o) const {
       return is_array == o.is_array && total_dim == o.total_dim &&
              format == o.format && dt_ == o.dt_ && needs_grad == o.needs_grad &&
-             element_shape == o.element_shape && ptype == o.ptype;
+             element_shape == o.element_shape && ptype == o.ptype &&
+             shape == o.shape;
     }
 
     /* [arguments with TensorType]
@@ -132,7 +137,8 @@ class TI_DLL_EXPORT Callable : public CallableBase {
   int insert_ndarray_param(const DataType &dt,
                            int ndim,
                            const std::string &name = "",
-                           bool needs_grad = false);
+                           bool needs_grad = false,
+                           const std::vector<int> &shape = {});
   int insert_texture_param(int total_dim, const std::string &name = "");
   int insert_pointer_param(const DataType &dt, const std::string &name = "");
   int insert_rw_texture_param(int total_dim,
@@ -40,6 +40,7 @@ CompileConfig::CompileConfig() {
   fast_math = true;
   flatten_if = false;
   make_thread_local = true;
+  thread_local_array_max_bytes = 16 * 1024;
   make_block_local = true;
   detect_read_only = true;
   real_matrix_scalarize = true;
@@ -8,9 +8,15 @@ namespace taichi::lang {
 struct CompileConfig {
   Arch arch;
   bool debug;
+  // In debug mode, check for runtime errors such as failed assertions at the
+  // next synchronization instead of after every kernel launch, so that the
+  // launches don't block. LLVM backends only.
+  bool async_runtime_error_check{false};
   bool cfg_optimization;
   bool check_out_of_bound;
   bool validate_autodiff;
+  // Number of 32-bit lanes the CPU backend vectorizes range-for loops to,
+  // capped by `max_vector_width`. 1 disables loop vectorization.
   int simd_width;
   int opt_level;
   int external_optimization_level;
@@ -35,6 +41,10 @@ struct CompileConfig {
   bool fast_math;
   bool flatten_if;
   bool make_thread_local;
+  // On CPU, make_thread_local also gives each thread a private copy of the
+  // fields of at most this size that a range-for only reduces into, e.g.
+  // histograms. 0 disables it.
+  int thread_local_array_max_bytes;
   bool make_block_local;
   bool detect_read_only;
   bool real_matrix_scalarize;
@@ -56,7 +66,42 @@ struct CompileConfig {
   int saturating_grid_dim;
   int max_block_dim;
   int cpu_max_num_threads;
+  // Pinning of the CPU thread pool workers: "none", "compact", "scatter" or an
+  // explicit list of CPUs such as "0-7,16-23". See get_thread_affinity().
+  std::string cpu_thread_affinity{"none"};
+  // Launch independent dispatches of a compute graph concurrently on the CPU
+  // thread pool. The parallel loops of the dispatches share its workers.
+  bool cpu_graph_parallel_dispatch{false};
+  // Defer the garbage collection of sparse SNodes on CPU until the free list
+  // runs shorter than the list of nodes waiting to be recycled, instead of
+  // collecting after every deactivation.
+  bool cpu_deferred_gc{true};
+  // Time the first launches of the parallel tasks on CPU with a few block
+  // sizes and thread counts, and launch them with the fastest ones from then
+  // on. With the offline cache on, the winners are saved next to it.
+  bool cpu_launch_autotune{false};
+  // Fuse consecutive compatible dispatches of a compute graph into a single
+  // kernel, merging their range-for loops where legal.
+  bool graph_kernel_fusion{false};
+  // Merge adjacent range-for tasks of a kernel with the same bounds when no
+  // iteration depends on another one through global memory.
+  bool fuse_range_for_tasks{false};
+  // Replace the divisions of the loop indices of serial range-fors, e.g. the
+  // ones decomposing the index of ndrange loops into coordinates, with
+  // counters carried across the iterations.
+  bool strength_reduction{false};
   int random_seed;
+  // Draw ti.random() from a counter-based generator (Philox4x32-10) keyed by
+  // the seed, the kernel launch and the loop index instead of from per-thread
+  // states, so that the numbers don't depend on the number of threads. The
+  // launches are numbered by a counter of the runtime, in the order they are
+  // issued; concurrent graph dispatches take theirs in the order of the graph.
+  // LLVM backends only.
+  bool counter_based_rng{false};
+  // Compile an instance of a kernel per shape of its ndarray arguments, with
+  // the extents as constants: "none", "innermost" for the innermost array axis
+  // only, so that arrays of any length share an instance, or "all".
+  std::string ndarray_shape_specialization{"none"};
 
   // LLVM backend options:
   bool print_struct_llvm_ir;
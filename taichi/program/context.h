@@ -19,11 +19,20 @@ struct RuntimeContext {
 
   int32_t cpu_thread_id;
 
+  // Distinguishes the launches of kernels for the counter-based generator.
+  uint32_t rand_launch_id{0};
+
   // We move the pointer of result buffer from LLVMRuntime to RuntimeContext
   // because each real function need a place to store its result, but
   // LLVMRuntime is shared among functions. So we moved the pointer to
   // RuntimeContext which each function have one.
   uint64_t *result_buffer;
+
+  // The block size and the number of threads the parallel loops of the task
+  // run with on CPU, chosen by the launch autotuner. 0 keeps the compiled
+  // values.
+  int32_t cpu_block_dim{0};
+  int32_t cpu_num_threads{0};
 };
 
 #if defined(TI_RUNTIME_HOST)
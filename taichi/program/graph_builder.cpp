@@ -1,8 +1,392 @@
 #include "taichi/program/graph_builder.h"
 #include "taichi/program/ndarray.h"
 #include "taichi/program/program.h"
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+
+#include <map>
+#include <set>
 
 namespace taichi::lang {
+
+namespace {
+
+// Returns the SNode that owns the memory of |snode| at cell granularity.
+// Places inside a bit_struct or quant_array share their physical word with
+// their siblings.
+const SNode *get_storage_snode(const SNode *snode) {
+  if (snode->parent && (snode->parent->type == SNodeType::bit_struct ||
+                        snode->parent->type == SNodeType::quant_array)) {
+    return snode->parent;
+  }
+  return snode;
+}
+
+bool is_dense_snode(const SNode *snode) {
+  for (auto *s = snode; s; s = s->parent) {
+    if (s->type != SNodeType::place && s->type != SNodeType::dense &&
+        s->type != SNodeType::root && s->type != SNodeType::bit_struct &&
+        s->type != SNodeType::quant_array) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Collects the global memory accessed by |kernel|. Any access that can't be
+// attributed to an ndarray parameter or a dense field leaves the result
+// unanalyzed. The kernel is only lowered to CHI IR for this, and the result is
+// kept on the kernel for the other dispatches of it.
+const aot::DispatchAccess &analyze_dispatch_access(
+    Kernel &kernel,
+    const CompileConfig &config) {
+  if (kernel.dispatch_access) {
+    return *kernel.dispatch_access;
+  }
+  auto &access = kernel.dispatch_access.emplace();
+  // The accesses of the adjoint kernels are only known after autodiff.
+  if (kernel.autodiff_mode != AutodiffMode::kNone) {
+    return access;
+  }
+  for (const auto &param : kernel.parameter_list) {
+    if (param.ptype == ParameterType::kTexture ||
+        param.ptype == ParameterType::kRWTexture) {
+      return access;
+    }
+  }
+
+  std::unique_ptr<IRNode> lowered;
+  IRNode *ir = kernel.ir.get();
+  if (kernel.ir_is_ast()) {
+    lowered = irpass::analysis::clone(kernel.ir.get());
+    irpass::frontend_type_check(lowered.get());
+    irpass::lower_ast(lowered.get());
+    irpass::type_check(lowered.get(), config);
+    ir = lowered.get();
+  }
+
+  // The top-level statements become the offloaded tasks. Range-fors with
+  // bounds that aren't constants, and local variables used by several tasks,
+  // are moved to global temporaries.
+  for (auto &stmt : ir->as<Block>()->statements) {
+    if (auto *offload = stmt->cast<OffloadedStmt>()) {
+      if (offload->task_type != OffloadedStmt::TaskType::serial &&
+          offload->task_type != OffloadedStmt::TaskType::range_for) {
+        return access;
+      }
+      if (offload->task_type == OffloadedStmt::TaskType::range_for &&
+          (!offload->const_begin || !offload->const_end)) {
+        access.uses_global_temporaries = true;
+      }
+    } else if (auto *range_for = stmt->cast<RangeForStmt>()) {
+      if (!range_for->begin->is<ConstStmt>() ||
+          !range_for->end->is<ConstStmt>()) {
+        access.uses_global_temporaries = true;
+      }
+    } else if (stmt->is<StructForStmt>() || stmt->is<MeshForStmt>()) {
+      return access;
+    } else if (stmt->is<AllocaStmt>()) {
+      access.uses_global_temporaries = true;
+    }
+  }
+
+  bool analyzable = true;
+  auto add_snode = [&](const SNode *snode, bool read, bool write) {
+    if (!is_dense_snode(snode)) {
+      analyzable = false;
+      return;
+    }
+    snode = get_storage_snode(snode);
+    if (read)
+      access.snode_reads.insert(snode);
+    if (write)
+      access.snode_writes.insert(snode);
+  };
+  irpass::analysis::gather_statements(ir, [&](Stmt *s) {
+    if (s->is<SNodeOpStmt>() || s->is<ExternalFuncCallStmt>() ||
+        s->is<FuncCallStmt>() || s->is<ReturnStmt>()) {
+      analyzable = false;
+    } else if (s->is<GlobalTemporaryStmt>()) {
+      access.uses_global_temporaries = true;
+    }
+    Stmt *ptr = nullptr;
+    bool read = false, write = false;
+    if (auto *load = s->cast<GlobalLoadStmt>()) {
+      ptr = load->src;
+      read = true;
+    } else if (auto *store = s->cast<GlobalStoreStmt>()) {
+      ptr = store->dest;
+      write = true;
+    } else if (auto *atomic = s->cast<AtomicOpStmt>()) {
+      ptr = atomic->dest;
+      read = write = true;
+    }
+    if (!ptr) {
+      return false;
+    }
+    if (auto *matrix_ptr = ptr->cast<MatrixPtrStmt>()) {
+      ptr = matrix_ptr->origin;
+    }
+    if (auto *global_ptr = ptr->cast<GlobalPtrStmt>()) {
+      add_snode(global_ptr->snode, read, write);
+    } else if (auto *matrix_ptrs = ptr->cast<MatrixOfGlobalPtrStmt>()) {
+      for (auto *snode : matrix_ptrs->snodes) {
+        add_snode(snode, read, write);
+      }
+    } else if (auto *external_ptr = ptr->cast<ExternalPtrStmt>()) {
+      auto *arg = external_ptr->base_ptr->cast<ArgLoadStmt>();
+      if (!arg) {
+        analyzable = false;
+        return false;
+      }
+      if (read)
+        access.arr_reads.insert(arg->arg_id);
+      if (write)
+        access.arr_writes.insert(arg->arg_id);
+    } else if (!ptr->is<AllocaStmt>() && !ptr->is<GlobalTemporaryStmt>() &&
+               !ptr->is<ThreadLocalPtrStmt>() &&
+               !ptr->is<BlockLocalPtrStmt>()) {
+      analyzable = false;
+    }
+    return false;
+  });
+  access.analyzed = analyzable;
+  return access;
+}
+
+struct LoweredDispatch {
+  Dispatch *dispatch;
+  std::unique_ptr<IRNode> ir;
+};
+
+// Graph arguments with the same name are bound to the same kernel parameter
+// of the fused kernel, so their parameter declarations must agree.
+bool can_join(const std::vector<LoweredDispatch> &group,
+              const Dispatch &dispatch) {
+  if (group.empty()) {
+    return true;
+  }
+  if (group.front().dispatch->kernel()->program !=
+      dispatch.kernel()->program) {
+    return false;
+  }
+  const auto &args = dispatch.symbolic_args();
+  for (int i = 0; i < (int)args.size(); i++) {
+    for (const auto &member : group) {
+      const auto &member_args = member.dispatch->symbolic_args();
+      for (int j = 0; j < (int)member_args.size(); j++) {
+        if (member_args[j].name == args[i].name &&
+            !(member.dispatch->kernel()->parameter_list[j] ==
+              dispatch.kernel()->parameter_list[i])) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Returns a copy of |block| in which the shapes of the ndarray arguments are
+// read from the first argument with the same dimensions, or nullptr if no
+// shape is affected. The groups of arguments whose shapes were unified are
+// added to |same_shape_args|.
+std::unique_ptr<IRNode> unify_ndarray_shapes(
+    Block *block,
+    const std::vector<aot::Arg> &args,
+    std::vector<std::vector<std::string>> &same_shape_args) {
+  std::vector<int> representative(args.size());
+  for (int i = 0; i < (int)args.size(); i++) {
+    representative[i] = i;
+    for (int j = 0; j < i && args[i].tag == aot::ArgKind::kNdarray; j++) {
+      if (args[j].tag == aot::ArgKind::kNdarray &&
+          args[j].field_dim == args[i].field_dim &&
+          args[j].element_shape == args[i].element_shape) {
+        representative[i] = j;
+        break;
+      }
+    }
+  }
+  auto unified = irpass::analysis::clone(block);
+  std::map<int, std::set<int>> groups;
+  irpass::analysis::gather_statements(unified.get(), [&](Stmt *stmt) {
+    if (auto *shape = stmt->cast<ExternalTensorShapeAlongAxisStmt>()) {
+      int arg_id = representative[shape->arg_id];
+      groups[arg_id].insert(shape->arg_id);
+      shape->arg_id = arg_id;
+    }
+    return false;
+  });
+  for (auto &[arg_id, members] : groups) {
+    members.insert(arg_id);
+    if (members.size() > 1) {
+      auto &names = same_shape_args.emplace_back();
+      for (int member : members) {
+        names.push_back(args[member].name);
+      }
+    }
+  }
+  if (same_shape_args.empty()) {
+    return nullptr;
+  }
+  return unified;
+}
+
+// Adds |kernel|, made of the fused dispatches |kernel_names|, to the program.
+aot::CompiledDispatch make_fused_dispatch(
+    std::unique_ptr<Kernel> kernel,
+    const std::vector<aot::Arg> &args,
+    const std::vector<std::string> &kernel_names,
+    const FuseRangeForsPass::Result &fusion) {
+  auto *prog = kernel->program;
+  const auto &config = prog->compile_config();
+  TI_TRACE(
+      "Fused graph dispatches [{}] into kernel {}: {} range-for loop(s) "
+      "merged, ~{} bytes of global memory loads saved per iteration",
+      fmt::join(kernel_names, ", "), kernel->get_name(),
+      fusion.num_fused_loops, fusion.saved_bytes_per_iteration);
+
+  aot::CompiledDispatch dispatch;
+  dispatch.kernel_name = kernel->get_name();
+  dispatch.symbolic_args = args;
+  dispatch.ti_kernel = kernel.get();
+  dispatch.compiled_kernel = nullptr;
+  dispatch.num_fused_loops = fusion.num_fused_loops;
+  if (arch_is_cpu(config.arch) && config.cpu_graph_parallel_dispatch) {
+    dispatch.access = analyze_dispatch_access(*kernel, config);
+  }
+  prog->kernels.push_back(std::move(kernel));
+  return dispatch;
+}
+
+// Concatenates the kernels of |group| into a single CHI IR kernel owned by the
+// program, and merges the loops of adjacent kernels where possible.
+void compile_fused_dispatches(
+    std::vector<LoweredDispatch> &group,
+    std::vector<aot::CompiledDispatch> &compiled_dispatches) {
+  auto *prog = group.front().dispatch->kernel()->program;
+  const auto &config = prog->compile_config();
+  auto name = fmt::format("fused_{}_{}",
+                          group.front().dispatch->kernel()->get_name(),
+                          prog->kernels.size());
+  auto kernel = std::make_unique<Kernel>(*prog, std::make_unique<Block>(),
+                                         name);
+  auto *block = kernel->ir->as<Block>();
+  block->set_parent_kernel(kernel.get());
+
+  std::vector<aot::Arg> fused_args;
+  std::unordered_map<std::string, int> arg_ids;
+  std::vector<std::string> kernel_names;
+  for (auto &member : group) {
+    auto *member_kernel = member.dispatch->kernel();
+    const auto &args = member.dispatch->symbolic_args();
+    kernel_names.push_back(member_kernel->get_name());
+    std::vector<int> new_arg_ids(args.size());
+    for (int i = 0; i < (int)args.size(); i++) {
+      auto it = arg_ids.find(args[i].name);
+      if (it == arg_ids.end()) {
+        it = arg_ids.emplace(args[i].name, (int)fused_args.size()).first;
+        fused_args.push_back(args[i]);
+        kernel->parameter_list.push_back(member_kernel->parameter_list[i]);
+      }
+      new_arg_ids[i] = it->second;
+    }
+    irpass::analysis::gather_statements(member.ir.get(), [&](Stmt *stmt) {
+      if (auto *arg = stmt->cast<ArgLoadStmt>()) {
+        arg->arg_id = new_arg_ids[arg->arg_id];
+      } else if (auto *shape = stmt->cast<ExternalTensorShapeAlongAxisStmt>()) {
+        shape->arg_id = new_arg_ids[shape->arg_id];
+      }
+      return false;
+    });
+    for (auto &stmt : member.ir->as<Block>()->statements) {
+      block->insert(std::move(stmt));
+    }
+    member.ir->as<Block>()->statements.clear();
+  }
+  kernel->finalize_params();
+  kernel->finalize_rets();
+
+  irpass::type_check(block, config);
+  irpass::full_simplify(block, config,
+                        {false, /*autodiff_enabled*/ false, name, false});
+  // Loops over the shapes of different ndarrays, e.g. range(x.shape[0]) and
+  // range(y.shape[0]), are only merged if the shapes are read from the same
+  // argument. If that merges more loops, the kernel with the unified shapes
+  // is launched when the ndarrays have the same shapes, and the kernel
+  // without them otherwise.
+  std::vector<std::vector<std::string>> same_shape_args;
+  auto unified = unify_ndarray_shapes(block, fused_args, same_shape_args);
+  auto fusion = irpass::fuse_range_fors(block);
+  irpass::analysis::verify(block);
+  std::unique_ptr<Kernel> unified_kernel;
+  FuseRangeForsPass::Result unified_fusion;
+  if (unified) {
+    unified_fusion = irpass::fuse_range_fors(unified.get());
+    irpass::analysis::verify(unified.get());
+  }
+  if (unified && unified_fusion.num_fused_loops > fusion.num_fused_loops) {
+    unified_kernel = std::make_unique<Kernel>(*prog, std::move(unified),
+                                              name + "_same_shapes");
+    unified_kernel->ir->as<Block>()->set_parent_kernel(unified_kernel.get());
+    unified_kernel->parameter_list = kernel->parameter_list;
+    unified_kernel->finalize_params();
+    unified_kernel->finalize_rets();
+  }
+
+  auto dispatch =
+      make_fused_dispatch(std::move(kernel), fused_args, kernel_names, fusion);
+  if (unified_kernel) {
+    auto guarded = make_fused_dispatch(std::move(unified_kernel), fused_args,
+                                       kernel_names, unified_fusion);
+    guarded.same_shape_args = std::move(same_shape_args);
+    guarded.fallback.push_back(std::move(dispatch));
+    dispatch = std::move(guarded);
+  }
+  compiled_dispatches.push_back(std::move(dispatch));
+}
+
+}  // namespace
+
+std::unique_ptr<IRNode> Dispatch::lower_for_fusion() const {
+  const auto &config = kernel_->program->compile_config();
+  if (!config.graph_kernel_fusion ||
+      kernel_->autodiff_mode != AutodiffMode::kNone || kernel_->is_accessor ||
+      !kernel_->rets.empty() || !kernel_->no_activate.empty() ||
+      symbolic_args_.size() != kernel_->parameter_list.size()) {
+    return nullptr;
+  }
+  for (int i = 0; i < (int)symbolic_args_.size(); i++) {
+    auto ptype = kernel_->parameter_list[i].ptype;
+    if ((ptype != ParameterType::kScalar &&
+         ptype != ParameterType::kNdarray) ||
+        (symbolic_args_[i].tag != aot::ArgKind::kScalar &&
+         symbolic_args_[i].tag != aot::ArgKind::kNdarray)) {
+      return nullptr;
+    }
+  }
+
+  auto ir = irpass::analysis::clone(kernel_->ir.get());
+  if (kernel_->ir_is_ast()) {
+    irpass::frontend_type_check(ir.get());
+    irpass::lower_ast(ir.get());
+  }
+  bool fusible = true;
+  irpass::analysis::gather_statements(ir.get(), [&](Stmt *stmt) {
+    if (stmt->is<FuncCallStmt>() || stmt->is<ReturnStmt>()) {
+      fusible = false;
+    }
+    return false;
+  });
+  if (!fusible) {
+    return nullptr;
+  }
+  irpass::eliminate_immutable_local_vars(ir.get());
+  irpass::type_check(ir.get(), config);
+  irpass::lower_matrix_ptr(ir.get());
+  return ir;
+}
+
 void Dispatch::compile(
     std::vector<aot::CompiledDispatch> &compiled_dispatches) {
   aot::CompiledDispatch dispatch;
@@ -10,15 +394,39 @@ void Dispatch::compile(
   dispatch.symbolic_args = symbolic_args_;
   dispatch.ti_kernel = kernel_;
   dispatch.compiled_kernel = nullptr;
+  const auto &config = kernel_->program->compile_config();
+  if (arch_is_cpu(config.arch) && config.cpu_graph_parallel_dispatch) {
+    dispatch.access = analyze_dispatch_access(*kernel_, config);
+  }
   compiled_dispatches.push_back(std::move(dispatch));
 }
 
 void Sequential::compile(
     std::vector<aot::CompiledDispatch> &compiled_dispatches) {
-  // In the future we can do more across-kernel optimization here.
+  // Consecutive dispatches that can be fused are emitted as a single kernel.
+  std::vector<LoweredDispatch> group;
+  auto flush = [&]() {
+    if (group.size() == 1) {
+      group.front().dispatch->compile(compiled_dispatches);
+    } else if (group.size() > 1) {
+      compile_fused_dispatches(group, compiled_dispatches);
+    }
+    group.clear();
+  };
   for (Node *n : sequence_) {
-    n->compile(compiled_dispatches);
+    auto *dispatch = dynamic_cast<Dispatch *>(n);
+    auto ir = dispatch ? dispatch->lower_for_fusion() : nullptr;
+    if (!ir) {
+      flush();
+      n->compile(compiled_dispatches);
+      continue;
+    }
+    if (!can_join(group, *dispatch)) {
+      flush();
+    }
+    group.push_back({dispatch, std::move(ir)});
   }
+  flush();
 }
 
 void Sequential::append(Node *node) {
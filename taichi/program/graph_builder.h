@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,7 @@
 
 namespace taichi::lang {
 class Kernel;
+class IRNode;
 class GraphBuilder;
 
 class Node {
@@ -32,6 +34,19 @@ class Dispatch : public Node {
   void compile(
       std::vector<aot::CompiledDispatch> &compiled_dispatches) override;
 
+  Kernel *kernel() const {
+    return kernel_;
+  }
+
+  const std::vector<aot::Arg> &symbolic_args() const {
+    return symbolic_args_;
+  }
+
+  // Returns the kernel lowered to CHI IR if it can be fused with other
+  // dispatches, see CompileConfig::graph_kernel_fusion. Returns nullptr
+  // otherwise.
+  std::unique_ptr<IRNode> lower_for_fusion() const;
+
  private:
   mutable bool serialized_{false};
   Kernel *kernel_{nullptr};
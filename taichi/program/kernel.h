@@ -10,6 +10,8 @@
 #include "taichi/aot/graph_data.h"
 #include "taichi/program/launch_context_builder.h"
 
+#include <optional>
+
 namespace taichi::lang {
 
 class Program;
@@ -20,6 +22,10 @@ class TI_DLL_EXPORT Kernel : public Callable {
 
   bool is_accessor{false};
   AutodiffMode autodiff_mode{AutodiffMode::kNone};
+  // The global memory accessed by the kernel, computed the first time it is
+  // dispatched in a compute graph, see
+  // CompileConfig::cpu_graph_parallel_dispatch.
+  std::optional<aot::DispatchAccess> dispatch_access;
 
   Kernel(Program &program,
          const std::function<void()> &func,
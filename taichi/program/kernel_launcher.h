@@ -12,6 +12,11 @@ class KernelLauncher {
   virtual void launch_kernel(const CompiledKernelData &compiled_kernel_data,
                              LaunchContextBuilder &ctx) = 0;
 
+  // Saves what the launcher learned about the kernels, e.g. tuned launch
+  // parameters, next to the offline cache.
+  virtual void dump_cache_data_to_disk() {
+  }
+
   virtual ~KernelLauncher() = default;
 };
 
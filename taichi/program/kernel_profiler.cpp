@@ -6,6 +6,7 @@
 #include "taichi/system/timeline.h"
 
 #include "taichi/rhi/amdgpu/amdgpu_profiler.h"
+#include "taichi/rhi/cpu/cpu_profiler.h"
 
 namespace taichi::lang {
 
@@ -151,6 +152,12 @@ std::unique_ptr<KernelProfilerBase> make_profiler(Arch arch, bool enable) {
     return std::make_unique<KernelProfilerAMDGPU>();
 #else
     TI_NOT_IMPLEMENTED
+#endif
+  } else if (arch_is_cpu(arch)) {
+#if defined(TI_WITH_LLVM)
+    return std::make_unique<KernelProfilerCPU>();
+#else
+    return std::make_unique<DefaultProfiler>();
 #endif
   } else {
     return std::make_unique<DefaultProfiler>();
@@ -4,8 +4,40 @@
 #undef TI_RUNTIME_HOST
 #include "fp16.h"
 
+#include <cstring>
+
 namespace taichi::lang {
 
+ArgBufferLayout::ArgBufferLayout(const StructType *args_type) {
+  if (args_type == nullptr) {
+    return;
+  }
+  const auto &members = args_type->elements();
+  args.resize(members.size());
+  for (int i = 0; i < members.size(); ++i) {
+    auto &entry = args[i];
+    entry.dtype = members[i].type;
+    entry.offset = args_type->get_element_offset({i});
+    if (auto struct_type = entry.dtype->cast<StructType>()) {
+      entry.kind = Kind::kArray;
+      auto shape_type =
+          struct_type
+              ->get_element_type({TypeFactory::SHAPE_POS_IN_NDARRAY})
+              ->as<StructType>();
+      for (int j = 0; j < shape_type->elements().size(); ++j) {
+        entry.shape_offsets.push_back(args_type->get_element_offset(
+            {i, TypeFactory::SHAPE_POS_IN_NDARRAY, j}));
+      }
+    } else if (entry.dtype->is<TensorType>()) {
+      entry.kind = Kind::kTensor;
+      entry.size = data_type_size(entry.dtype);
+    } else {
+      entry.kind = Kind::kScalar;
+      entry.size = data_type_size(entry.dtype);
+    }
+  }
+}
+
 LaunchContextBuilder::LaunchContextBuilder(CallableBase *kernel)
     : kernel_(kernel),
       owned_ctx_(std::make_unique<RuntimeContext>()),
@@ -260,6 +292,38 @@ void LaunchContextBuilder::set_arg_rw_texture_impl(
   }
 }
 
+void LaunchContextBuilder::set_arg_with_layout(
+    int arg_id,
+    const ArgBufferLayout::Entry &entry,
+    const void *data,
+    size_t size) {
+  TI_ASSERT(entry.offset + size <= arg_buffer_size);
+  std::memcpy(ctx_->arg_buffer + entry.offset, data, size);
+  set_array_device_allocation_type(arg_id, DevAllocType::kNone);
+}
+
+void LaunchContextBuilder::set_arg_ndarray_with_layout(
+    int arg_id,
+    const ArgBufferLayout::Entry &entry,
+    intptr_t devalloc_ptr,
+    const int *shape,
+    size_t ndim) {
+  TI_ASSERT(entry.kind == ArgBufferLayout::Kind::kArray);
+  TI_ASSERT(ndim <= entry.shape_offsets.size());
+  array_ptrs[{arg_id, TypeFactory::DATA_PTR_POS_IN_NDARRAY}] =
+      (void *)devalloc_ptr;
+  if (devalloc_ptr != 0) {
+    array_ptrs[{arg_id, TypeFactory::GRAD_PTR_POS_IN_NDARRAY}] = nullptr;
+  }
+  set_array_device_allocation_type(arg_id, DevAllocType::kNdarray);
+  size_t total_size = 1;
+  for (size_t i = 0; i < ndim; ++i) {
+    *(int32 *)(ctx_->arg_buffer + entry.shape_offsets[i]) = shape[i];
+    total_size *= shape[i];
+  }
+  set_array_runtime_size(arg_id, total_size);
+}
+
 void LaunchContextBuilder::set_arg_ndarray_impl(int arg_id,
                                                 intptr_t devalloc_ptr,
                                                 const std::vector<int> &shape,
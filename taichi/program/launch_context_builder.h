@@ -7,6 +7,35 @@ namespace taichi::lang {
 
 struct RuntimeContext;
 
+/**
+ * Positions of the kernel arguments inside the argument buffer, resolved once
+ * from `args_type`. Callers that launch the same kernel many times use it to
+ * encode arguments without walking the struct type for every value.
+ */
+struct ArgBufferLayout {
+  enum class Kind : int8_t {
+    kScalar,
+    kTensor,
+    // Ndarrays and textures. Both are passed as a struct holding the shape
+    // followed by the pointers.
+    kArray,
+  };
+
+  struct Entry {
+    Kind kind{Kind::kScalar};
+    // Type of the member in `args_type`.
+    const Type *dtype{nullptr};
+    size_t offset{0};
+    size_t size{0};
+    // kArray only. Offset of each i32 shape component.
+    std::vector<size_t> shape_offsets;
+  };
+
+  explicit ArgBufferLayout(const StructType *args_type);
+
+  std::vector<Entry> args;
+};
+
 class LaunchContextBuilder {
  public:
   enum class DevAllocType : int8_t {
@@ -80,6 +109,18 @@ class LaunchContextBuilder {
                                const std::array<int, 3> &shape);
   void set_arg_rw_texture(int arg_id, const Texture &tex);
 
+  // Same as `set_arg` and `set_arg_ndarray_impl`, with the position of the
+  // argument taken from a precomputed `ArgBufferLayout`.
+  void set_arg_with_layout(int arg_id,
+                           const ArgBufferLayout::Entry &entry,
+                           const void *data,
+                           size_t size);
+  void set_arg_ndarray_with_layout(int arg_id,
+                                   const ArgBufferLayout::Entry &entry,
+                                   intptr_t devalloc_ptr,
+                                   const int *shape,
+                                   size_t ndim);
+
   TypedConstant fetch_ret(const std::vector<int> &index);
   float64 get_struct_ret_float(const std::vector<int> &index);
   int64 get_struct_ret_int(const std::vector<int> &index);
@@ -104,6 +145,9 @@ class LaunchContextBuilder {
   size_t arg_buffer_size{0};
   const StructType *args_type{nullptr};
   size_t result_buffer_size{0};
+  // The id of the launch for the counter-based random generator, or -1 to
+  // take the next one of the runtime when the kernel is launched.
+  int64 rand_launch_id{-1};
 
   // Note that I've tried to group `array_runtime_size` and
   // `is_device_allocations` into a small struct. However, it caused some test
@@ -77,6 +77,10 @@ class TI_DLL_EXPORT Ndarray {
   std::vector<int> total_shape_;
 
   Program *prog_{nullptr};
+
+  // Program::import_ndarray sets |prog_| so that the slot of the imported
+  // DeviceAllocation is released with the Ndarray.
+  friend class Program;
 };
 
 }  // namespace taichi::lang
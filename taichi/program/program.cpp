@@ -191,7 +191,11 @@ void Program::launch_kernel(const CompiledKernelData &compiled_kernel_data,
                             LaunchContextBuilder &ctx) {
   program_impl_->get_kernel_launcher().launch_kernel(compiled_kernel_data, ctx);
   if (compile_config().debug && arch_uses_llvm(compiled_kernel_data.arch())) {
-    program_impl_->check_runtime_error(result_buffer);
+    if (compile_config().async_runtime_error_check) {
+      runtime_error_check_pending_ = true;
+    } else {
+      program_impl_->check_runtime_error(result_buffer);
+    }
   }
 }
 
@@ -260,6 +264,10 @@ SNode *Program::get_snode_root(int tree_id) {
 
 void Program::synchronize() {
   program_impl_->synchronize();
+  if (runtime_error_check_pending_) {
+    runtime_error_check_pending_ = false;
+    program_impl_->check_runtime_error(result_buffer);
+  }
 }
 
 StreamSemaphore Program::flush() {
@@ -332,6 +340,18 @@ void Program::finalize() {
     return;
   }
 
+  // The errors of the last launches can't be thrown from here, so they are
+  // logged instead.
+  if (runtime_error_check_pending_) {
+    runtime_error_check_pending_ = false;
+    program_impl_->synchronize();
+    try {
+      program_impl_->check_runtime_error(result_buffer);
+    } catch (const TaichiAssertionError &e) {
+      TI_WARN("Runtime error in a kernel launched before finalizing: {}",
+              e.what());
+    }
+  }
   synchronize();
   TI_TRACE("Program finalizing...");
 
@@ -395,6 +415,23 @@ Ndarray *Program::create_ndarray(const DataType type,
   return arr_ptr;
 }
 
+Ndarray *Program::import_ndarray(void *ptr,
+                                 const DataType type,
+                                 const std::vector<int> &shape) {
+  std::size_t size = data_type_size(type);
+  for (auto dim : shape) {
+    size *= dim;
+  }
+  auto alloc = program_impl_->import_memory(ptr, size);
+  auto arr = std::make_unique<Ndarray>(alloc, type, shape);
+  // Deallocating imported memory only releases its slot on the device, the
+  // memory itself stays with the exporter.
+  arr->prog_ = this;
+  auto arr_ptr = arr.get();
+  ndarrays_.insert({arr_ptr, std::move(arr)});
+  return arr_ptr;
+}
+
 void Program::delete_ndarray(Ndarray *ndarray) {
   // [Note] Ndarray memory deallocation
   // Ndarray's memory allocation is managed by Taichi and Python can control
@@ -443,6 +480,18 @@ intptr_t Program::get_ndarray_data_ptr_as_int(const Ndarray *ndarray) {
   return reinterpret_cast<intptr_t>(data_ptr);
 }
 
+intptr_t Program::get_snode_tree_data_ptr_as_int(int tree_id) {
+  Arch arch = compile_config().arch;
+  if (!arch_is_cpu(arch) && arch != Arch::cuda && arch != Arch::amdgpu) {
+    return 0;
+  }
+  // The root buffer is imported into the device by the LLVM runtime, so it is
+  // looked up like the allocation of an ndarray.
+  auto ptr = get_snode_tree_device_ptr(tree_id);
+  auto base = program_impl_->get_ndarray_alloc_info_ptr(ptr);
+  return reinterpret_cast<intptr_t>(base) + ptr.offset;
+}
+
 void Program::fill_ndarray_fast_u32(Ndarray *ndarray, uint32_t val) {
   // This is a temporary solution to bypass device api.
   // Should be moved to CommandList once available in CUDA.
@@ -269,6 +269,12 @@ class TI_DLL_EXPORT Program {
     return program_impl_->get_struct_type_with_data_layout(old_ty, layout);
   }
 
+  // Wraps the memory at |ptr| of another library in an ndarray without
+  // copying. The memory must stay alive until the ndarray is deleted.
+  Ndarray *import_ndarray(void *ptr,
+                          const DataType type,
+                          const std::vector<int> &shape);
+
   void delete_ndarray(Ndarray *ndarray);
 
   Texture *create_texture(BufferFormat buffer_format,
@@ -276,8 +282,20 @@ class TI_DLL_EXPORT Program {
 
   intptr_t get_ndarray_data_ptr_as_int(const Ndarray *ndarray);
 
+  // The address of the root buffer of an SNode tree, 0 if the backend doesn't
+  // expose physical pointers.
+  intptr_t get_snode_tree_data_ptr_as_int(int tree_id);
+
   void fill_ndarray_fast_u32(Ndarray *ndarray, uint32_t val);
 
+  void run_concurrently(const std::vector<std::function<void()>> &tasks) {
+    program_impl_->run_concurrently(tasks);
+  }
+
+  uint32 reserve_rand_launch_ids(uint32 n) {
+    return program_impl_->reserve_rand_launch_ids(n);
+  }
+
   Identifier get_next_global_id(const std::string &name = "") {
     return Identifier(global_id_counter_++, name);
   }
@@ -334,6 +352,9 @@ class TI_DLL_EXPORT Program {
   float64 total_compilation_time_{0.0};
   static std::atomic<int> num_instances_;
   bool finalized_{false};
+  // Whether kernels were launched since the last check for runtime errors,
+  // see CompileConfig::async_runtime_error_check.
+  bool runtime_error_check_pending_{false};
 
   // TODO: Move ndarrays_ and textures_ to be managed by runtime
   std::unordered_map<void *, std::unique_ptr<Ndarray>> ndarrays_;
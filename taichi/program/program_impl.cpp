@@ -17,6 +17,9 @@ void ProgramImpl::dump_cache_data_to_disk() {
                           config->offline_cache_max_size_of_files,
                           config->offline_cache_cleaning_factor);
   mgr.dump();
+  if (kernel_launcher_) {
+    kernel_launcher_->dump_cache_data_to_disk();
+  }
 }
 
 KernelCompilationManager &ProgramImpl::get_kernel_compilation_manager() {
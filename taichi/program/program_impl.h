@@ -100,6 +100,12 @@ class ProgramImpl {
     return kDeviceNullAllocation;
   }
 
+  // Wraps memory owned by someone else, which is never freed by Taichi.
+  virtual DeviceAllocation import_memory(void *ptr, std::size_t size) {
+    TI_ERROR("import_memory() not implemented on the current backend");
+    return kDeviceNullAllocation;
+  }
+
   virtual bool used_in_kernel(DeviceAllocationId) {
     return false;
   }
@@ -125,6 +131,25 @@ class ProgramImpl {
     TI_ERROR("fill_ndarray() not implemented on the current backend");
   }
 
+  /**
+   * Runs |tasks| concurrently on the host thread pool of the backend. Backends
+   * without one run them in order.
+   */
+  virtual void run_concurrently(
+      const std::vector<std::function<void()>> &tasks) {
+    for (const auto &task : tasks) {
+      task();
+    }
+  }
+
+  /**
+   * Takes |n| consecutive launch ids for the counter-based random generator,
+   * see LaunchContextBuilder::rand_launch_id. Returns the first one.
+   */
+  virtual uint32 reserve_rand_launch_ids(uint32 n) {
+    return 0;
+  }
+
   virtual void enqueue_compute_op_lambda(
       std::function<void(Device *device, CommandList *cmdlist)> op,
       const std::vector<ComputeOpImageRef> &image_refs) {
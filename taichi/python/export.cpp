@@ -21,6 +21,7 @@ PYBIND11_MODULE(taichi_python, m) {
   export_misc(m);
   export_visual(m);
   export_ggui(m);
+  export_dlpack(m);
 }
 
 }  // namespace taichi
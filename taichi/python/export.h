@@ -37,4 +37,6 @@ void export_visual(py::module &m);
 
 void export_ggui(py::module &m);
 
+void export_dlpack(py::module &m);
+
 }  // namespace taichi
@@ -0,0 +1,377 @@
+// Bindings for exchanging ndarrays and fields with other array libraries
+// through DLPack (https://dmlc.github.io/dlpack/latest/) without copying.
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "taichi/ir/snode.h"
+#include "taichi/ir/type_utils.h"
+#include "taichi/program/ndarray.h"
+#include "taichi/program/program.h"
+#include "taichi/python/export.h"
+
+namespace taichi {
+
+namespace {
+
+// The subset of dlpack.h used here. The layouts are part of the stable ABI of
+// DLPack, so they are declared here instead of depending on the header.
+enum DLDeviceType : int32_t {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLROCM = 10,
+};
+
+enum DLDataTypeCode : uint8_t {
+  kDLInt = 0,
+  kDLUInt = 1,
+  kDLFloat = 2,
+};
+
+struct DLDevice {
+  int32_t device_type;
+  int32_t device_id;
+};
+
+struct DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+};
+
+struct DLTensor {
+  void *data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t *shape;
+  int64_t *strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void *manager_ctx;
+  void (*deleter)(DLManagedTensor *self);
+};
+
+struct DLPackVersion {
+  uint32_t major;
+  uint32_t minor;
+};
+
+struct DLManagedTensorVersioned {
+  DLPackVersion version;
+  void *manager_ctx;
+  void (*deleter)(DLManagedTensorVersioned *self);
+  uint64_t flags;
+  DLTensor dl_tensor;
+};
+
+constexpr uint64_t kDLPackFlagReadOnly = 1;
+constexpr const char *kCapsuleName = "dltensor";
+constexpr const char *kUsedCapsuleName = "used_dltensor";
+constexpr const char *kVersionedCapsuleName = "dltensor_versioned";
+constexpr const char *kUsedVersionedCapsuleName = "used_dltensor_versioned";
+constexpr const char *kImportedCapsuleName = "taichi_imported_dltensor";
+
+using namespace taichi::lang;
+
+DLDevice get_dlpack_device(Arch arch) {
+  if (arch_is_cpu(arch)) {
+    return {kDLCPU, 0};
+  } else if (arch == Arch::cuda) {
+    return {kDLCUDA, 0};
+  } else if (arch == Arch::amdgpu) {
+    return {kDLROCM, 0};
+  }
+  TI_ERROR("DLPack is not supported on arch={}", arch_name(arch));
+  return {};
+}
+
+DLDataType get_dlpack_dtype(DataType dt) {
+  if (dt->is_primitive(PrimitiveTypeID::f16) ||
+      dt->is_primitive(PrimitiveTypeID::f32) ||
+      dt->is_primitive(PrimitiveTypeID::f64)) {
+    return {kDLFloat, (uint8_t)(data_type_size(dt) * 8), 1};
+  } else if (dt->is<PrimitiveType>() && is_integral(dt) &&
+             !dt->is_primitive(PrimitiveTypeID::u1)) {
+    return {is_signed(dt) ? kDLInt : kDLUInt,
+            (uint8_t)(data_type_size(dt) * 8), 1};
+  }
+  TI_ERROR("Data type {} can't be exchanged through DLPack", dt->to_string());
+  return {};
+}
+
+DataType from_dlpack_dtype(const DLDataType &dtype) {
+  if (dtype.lanes == 1) {
+    if (dtype.code == kDLFloat) {
+      switch (dtype.bits) {
+        case 16:
+          return PrimitiveType::f16;
+        case 32:
+          return PrimitiveType::f32;
+        case 64:
+          return PrimitiveType::f64;
+      }
+    } else if (dtype.code == kDLInt || dtype.code == kDLUInt) {
+      bool is_signed = dtype.code == kDLInt;
+      switch (dtype.bits) {
+        case 8:
+          return is_signed ? PrimitiveType::i8 : PrimitiveType::u8;
+        case 16:
+          return is_signed ? PrimitiveType::i16 : PrimitiveType::u16;
+        case 32:
+          return is_signed ? PrimitiveType::i32 : PrimitiveType::u32;
+        case 64:
+          return is_signed ? PrimitiveType::i64 : PrimitiveType::u64;
+      }
+    }
+  }
+  TI_ERROR("DLPack data type (code={}, bits={}, lanes={}) is not supported",
+           dtype.code, dtype.bits, dtype.lanes);
+  return PrimitiveType::unknown;
+}
+
+// Keeps the exported Python object, and with it the memory, alive until the
+// consumer calls the deleter.
+struct ExportContext {
+  py::object owner;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+};
+
+template <typename ManagedTensor>
+void delete_managed_tensor(ManagedTensor *self) {
+  // Consumers may call the deleter from any thread.
+  py::gil_scoped_acquire gil;
+  delete static_cast<ExportContext *>(self->manager_ctx);
+  delete self;
+}
+
+template <typename ManagedTensor>
+void destroy_capsule(PyObject *capsule) {
+  const char *name = std::is_same_v<ManagedTensor, DLManagedTensorVersioned>
+                         ? kVersionedCapsuleName
+                         : kCapsuleName;
+  // A consumed capsule is renamed, and the consumer owns the tensor.
+  if (!PyCapsule_IsValid(capsule, name)) {
+    return;
+  }
+  auto tensor =
+      static_cast<ManagedTensor *>(PyCapsule_GetPointer(capsule, name));
+  tensor->deleter(tensor);
+}
+
+template <typename ManagedTensor>
+py::object make_capsule(void *data,
+                        Arch arch,
+                        DataType dtype,
+                        const std::vector<int> &shape,
+                        py::object owner,
+                        bool read_only) {
+  auto device = get_dlpack_device(arch);
+  auto dl_dtype = get_dlpack_dtype(dtype);
+  auto ctx = new ExportContext{std::move(owner), {}, {}};
+  ctx->shape.assign(shape.begin(), shape.end());
+  // Row-major strides, in elements.
+  ctx->strides.resize(shape.size());
+  int64_t stride = 1;
+  for (int i = (int)shape.size() - 1; i >= 0; i--) {
+    ctx->strides[i] = stride;
+    stride *= shape[i];
+  }
+
+  auto tensor = new ManagedTensor{};
+  tensor->manager_ctx = ctx;
+  tensor->deleter = delete_managed_tensor<ManagedTensor>;
+  const char *name = kCapsuleName;
+  if constexpr (std::is_same_v<ManagedTensor, DLManagedTensorVersioned>) {
+    tensor->version = {1, 0};
+    tensor->flags = read_only ? kDLPackFlagReadOnly : 0;
+    name = kVersionedCapsuleName;
+  }
+  auto &dl_tensor = tensor->dl_tensor;
+  dl_tensor.data = data;
+  dl_tensor.device = device;
+  dl_tensor.ndim = (int32_t)shape.size();
+  dl_tensor.dtype = dl_dtype;
+  dl_tensor.shape = ctx->shape.data();
+  dl_tensor.strides = ctx->strides.data();
+  dl_tensor.byte_offset = 0;
+
+  auto capsule = PyCapsule_New(tensor, name, destroy_capsule<ManagedTensor>);
+  if (!capsule) {
+    tensor->deleter(tensor);
+    throw py::error_already_set();
+  }
+  return py::reinterpret_steal<py::object>(capsule);
+}
+
+py::object to_dlpack(Program *program,
+                     intptr_t data,
+                     DataType dtype,
+                     const std::vector<int> &shape,
+                     py::object owner,
+                     bool versioned,
+                     bool read_only) {
+  auto arch = program->compile_config().arch;
+  if (!data) {
+    TI_ERROR("DLPack is not supported on arch={}", arch_name(arch));
+  }
+  if (versioned) {
+    return make_capsule<DLManagedTensorVersioned>(
+        (void *)data, arch, dtype, shape, std::move(owner), read_only);
+  }
+  return make_capsule<DLManagedTensor>((void *)data, arch, dtype, shape,
+                                       std::move(owner), read_only);
+}
+
+py::object ndarray_to_dlpack(Program *program,
+                             Ndarray *ndarray,
+                             py::object owner,
+                             bool versioned) {
+  return to_dlpack(program, program->get_ndarray_data_ptr_as_int(ndarray),
+                   ndarray->get_element_data_type(), ndarray->total_shape(),
+                   std::move(owner), versioned, /*read_only=*/false);
+}
+
+// Exports the fields placed in |members| as one array of shape
+// field shape + |element_shape|. This needs the members to be exactly the
+// children of a dense SNode directly under the root, so that the elements are
+// laid out densely in row-major order in the root buffer. Other layouts
+// would need a copy.
+py::object field_to_dlpack(Program *program,
+                           const std::vector<SNode *> &members,
+                           const std::vector<int> &element_shape,
+                           py::object owner,
+                           bool versioned) {
+  TI_ASSERT(!members.empty());
+  auto dense = members[0]->parent;
+  TI_ERROR_IF(!dense || dense->type != SNodeType::dense || !dense->parent ||
+                  dense->parent->type != SNodeType::root,
+              "Only fields placed in a dense SNode directly under the root "
+              "can be exported through DLPack");
+  TI_ERROR_IF(dense->ch.size() != members.size(),
+              "The fields placed together with {} must be exported together",
+              members[0]->get_node_type_name_hinted());
+  auto dtype = members[0]->dt;
+  std::size_t size = data_type_size(dtype);
+  for (int i = 0; i < (int)members.size(); i++) {
+    TI_ERROR_IF(dense->ch[i].get() != members[i] || !members[i]->is_place() ||
+                    members[i]->dt != dtype ||
+                    members[i]->offset_bytes_in_parent_cell != i * size,
+                "The members of the field are not laid out contiguously");
+  }
+  TI_ERROR_IF(dense->cell_size_bytes != members.size() * size,
+              "The elements of the field are padded");
+  TI_ERROR_IF(dense->_morton, "Morton-coded fields can't be exported");
+
+  std::vector<int> shape;
+  int64 num_cells = 1;
+  for (int i = 0; i < dense->num_active_indices; i++) {
+    TI_ERROR_IF(dense->physical_index_position[i] != i,
+                "Fields with permuted axes can't be exported");
+    shape.push_back(dense->shape_along_axis(i));
+    num_cells *= shape.back();
+  }
+  TI_ERROR_IF(dense->num_cells_per_container != num_cells,
+              "The shape of the field is padded");
+  shape.insert(shape.end(), element_shape.begin(), element_shape.end());
+
+  auto root_ptr =
+      program->get_snode_tree_data_ptr_as_int(dense->get_snode_tree_id());
+  auto data =
+      root_ptr ? root_ptr + (intptr_t)dense->offset_bytes_in_parent_cell : 0;
+  // The layout of a field is owned by its SNode tree, so consumers must not
+  // write into it. Only versioned capsules can carry this flag.
+  return to_dlpack(program, data, dtype, shape, std::move(owner), versioned,
+                   /*read_only=*/true);
+}
+
+template <typename ManagedTensor>
+void destroy_imported_tensor(PyObject *capsule) {
+  auto tensor = static_cast<ManagedTensor *>(
+      PyCapsule_GetPointer(capsule, kImportedCapsuleName));
+  if (tensor->deleter) {
+    tensor->deleter(tensor);
+  }
+}
+
+// Wraps the tensor of a DLPack capsule in an ndarray without copying. Returns
+// the ndarray and an object that keeps the tensor alive, which must outlive
+// the ndarray.
+std::pair<Ndarray *, py::object> ndarray_from_dlpack(Program *program,
+                                                     py::object capsule) {
+  auto obj = capsule.ptr();
+  DLTensor *dl_tensor = nullptr;
+  void *tensor = nullptr;
+  bool versioned = false;
+  if (PyCapsule_IsValid(obj, kVersionedCapsuleName)) {
+    auto managed = static_cast<DLManagedTensorVersioned *>(
+        PyCapsule_GetPointer(obj, kVersionedCapsuleName));
+    TI_ERROR_IF(managed->version.major != 1,
+                "DLPack version {}.{} is not supported",
+                managed->version.major, managed->version.minor);
+    TI_ERROR_IF(managed->flags & kDLPackFlagReadOnly,
+                "Read-only DLPack tensors can't be imported");
+    dl_tensor = &managed->dl_tensor;
+    tensor = managed;
+    versioned = true;
+  } else if (PyCapsule_IsValid(obj, kCapsuleName)) {
+    auto managed = static_cast<DLManagedTensor *>(
+        PyCapsule_GetPointer(obj, kCapsuleName));
+    dl_tensor = &managed->dl_tensor;
+    tensor = managed;
+  } else {
+    TI_ERROR("Expected an unconsumed DLPack capsule");
+  }
+
+  auto arch = program->compile_config().arch;
+  auto device = get_dlpack_device(arch);
+  TI_ERROR_IF(dl_tensor->device.device_type != device.device_type ||
+                  dl_tensor->device.device_id != device.device_id,
+              "DLPack tensor on device (type={}, id={}) can't be used on "
+              "arch={}",
+              dl_tensor->device.device_type, dl_tensor->device.device_id,
+              arch_name(arch));
+  auto dtype = from_dlpack_dtype(dl_tensor->dtype);
+  std::vector<int> shape(dl_tensor->shape,
+                         dl_tensor->shape + dl_tensor->ndim);
+  if (dl_tensor->strides) {
+    int64_t stride = 1;
+    for (int i = dl_tensor->ndim - 1; i >= 0; i--) {
+      // The stride of an axis of extent 1 doesn't matter.
+      TI_ERROR_IF(shape[i] != 1 && dl_tensor->strides[i] != stride,
+                  "Only contiguous DLPack tensors can be imported");
+      stride *= shape[i];
+    }
+  }
+
+  auto data = (char *)dl_tensor->data + dl_tensor->byte_offset;
+  auto ndarray = program->import_ndarray(data, dtype, shape);
+
+  // The tensor now belongs to us and is released when the owner is collected.
+  PyCapsule_SetName(obj, versioned ? kUsedVersionedCapsuleName
+                                   : kUsedCapsuleName);
+  auto owner = PyCapsule_New(
+      tensor, kImportedCapsuleName,
+      versioned ? destroy_imported_tensor<DLManagedTensorVersioned>
+                : destroy_imported_tensor<DLManagedTensor>);
+  if (!owner) {
+    throw py::error_already_set();
+  }
+  return {ndarray, py::reinterpret_steal<py::object>(owner)};
+}
+
+}  // namespace
+
+void export_dlpack(py::module &m) {
+  m.def("ndarray_to_dlpack", &ndarray_to_dlpack);
+  m.def("field_to_dlpack", &field_to_dlpack);
+  m.def("ndarray_from_dlpack", &ndarray_from_dlpack,
+        py::return_value_policy::reference);
+}
+
+}  // namespace taichi
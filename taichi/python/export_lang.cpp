@@ -28,6 +28,7 @@
 #include "taichi/program/conjugate_gradient.h"
 #include "taichi/aot/graph_data.h"
 #include "taichi/ir/mesh.h"
+#include "taichi/ir/mesh_patcher.h"
 
 #include "taichi/program/kernel_profiler.h"
 
@@ -148,6 +149,8 @@ void export_lang(py::module &m) {
       .def_readwrite("debug", &CompileConfig::debug)
       .def_readwrite("cfg_optimization", &CompileConfig::cfg_optimization)
       .def_readwrite("check_out_of_bound", &CompileConfig::check_out_of_bound)
+      .def_readwrite("async_runtime_error_check",
+                     &CompileConfig::async_runtime_error_check)
       .def_readwrite("print_accessor_ir", &CompileConfig::print_accessor_ir)
       .def_readwrite("use_llvm", &CompileConfig::use_llvm)
       .def_readwrite("print_struct_llvm_ir",
@@ -177,7 +180,24 @@ void export_lang(py::module &m) {
       .def_readwrite("saturating_grid_dim", &CompileConfig::saturating_grid_dim)
       .def_readwrite("max_block_dim", &CompileConfig::max_block_dim)
       .def_readwrite("cpu_max_num_threads", &CompileConfig::cpu_max_num_threads)
+      .def_readwrite("cpu_thread_affinity",
+                     &CompileConfig::cpu_thread_affinity)
+      .def_readwrite("simd_width", &CompileConfig::simd_width)
+      .def_readwrite("max_vector_width", &CompileConfig::max_vector_width)
+      .def_readwrite("cpu_graph_parallel_dispatch",
+                     &CompileConfig::cpu_graph_parallel_dispatch)
+      .def_readwrite("cpu_deferred_gc", &CompileConfig::cpu_deferred_gc)
+      .def_readwrite("cpu_launch_autotune",
+                     &CompileConfig::cpu_launch_autotune)
+      .def_readwrite("graph_kernel_fusion",
+                     &CompileConfig::graph_kernel_fusion)
+      .def_readwrite("fuse_range_for_tasks",
+                     &CompileConfig::fuse_range_for_tasks)
+      .def_readwrite("strength_reduction", &CompileConfig::strength_reduction)
       .def_readwrite("random_seed", &CompileConfig::random_seed)
+      .def_readwrite("counter_based_rng", &CompileConfig::counter_based_rng)
+      .def_readwrite("ndarray_shape_specialization",
+                     &CompileConfig::ndarray_shape_specialization)
       .def_readwrite("verbose_kernel_launches",
                      &CompileConfig::verbose_kernel_launches)
       .def_readwrite("verbose", &CompileConfig::verbose)
@@ -197,6 +217,8 @@ void export_lang(py::module &m) {
       .def_readwrite("ad_stack_size", &CompileConfig::ad_stack_size)
       .def_readwrite("flatten_if", &CompileConfig::flatten_if)
       .def_readwrite("make_thread_local", &CompileConfig::make_thread_local)
+      .def_readwrite("thread_local_array_max_bytes",
+                     &CompileConfig::thread_local_array_max_bytes)
       .def_readwrite("make_block_local", &CompileConfig::make_block_local)
       .def_readwrite("detect_read_only", &CompileConfig::detect_read_only)
       .def_readwrite("real_matrix_scalarize",
@@ -328,6 +350,9 @@ void export_lang(py::module &m) {
       .def("parallelize", &ASTBuilder::parallelize)
       .def("strictly_serialize", &ASTBuilder::strictly_serialize)
       .def("block_dim", &ASTBuilder::block_dim)
+      .def("get_next_loop_block_dim", &ASTBuilder::get_next_loop_block_dim)
+      .def("tile", &ASTBuilder::tile)
+      .def("get_next_loop_tile_sizes", &ASTBuilder::get_next_loop_tile_sizes)
       .def("insert_snode_access_flag", &ASTBuilder::insert_snode_access_flag)
       .def("reset_snode_access_flag", &ASTBuilder::reset_snode_access_flag);
 
@@ -489,6 +514,8 @@ void export_lang(py::module &m) {
                                const std::string &))(&SNode::hash),
            py::return_value_policy::reference)
       .def("dynamic", &SNode::dynamic, py::return_value_policy::reference)
+      .def("morton", &SNode::morton, py::arg("val") = true,
+           py::return_value_policy::reference)
       .def("bitmasked",
            (SNode & (SNode::*)(const std::vector<Axis> &,
                                const std::vector<int> &,
@@ -670,7 +697,14 @@ void export_lang(py::module &m) {
                }
              }
              self->jit_run(compile_config, args);
-           });
+           })
+      .def("num_fused_loops", [](aot::CompiledGraph *self) {
+        int num_fused_loops = 0;
+        for (const auto &dispatch : self->dispatches) {
+          num_fused_loops += dispatch.num_fused_loops;
+        }
+        return num_fused_loops;
+      });
 
   py::class_<Kernel>(m, "Kernel")
       .def("no_activate",
@@ -680,7 +714,10 @@ void export_lang(py::module &m) {
            })
       .def("insert_scalar_param", &Kernel::insert_scalar_param)
       .def("insert_arr_param", &Kernel::insert_arr_param)
-      .def("insert_ndarray_param", &Kernel::insert_ndarray_param)
+      .def("insert_ndarray_param", &Kernel::insert_ndarray_param,
+           py::arg("dt"), py::arg("ndim"), py::arg("name") = "",
+           py::arg("needs_grad") = false,
+           py::arg("shape") = std::vector<int>())
       .def("insert_texture_param", &Kernel::insert_texture_param)
       .def("insert_pointer_param", &Kernel::insert_pointer_param)
       .def("insert_rw_texture_param", &Kernel::insert_rw_texture_param)
@@ -1424,6 +1461,73 @@ void export_lang(py::module &m) {
               type, mesh::MeshLocalRelation(value, patch_offset, offset)));
         });
 
+  // Builds the patches in the MeshMetadata format, see mesh.py
+  m.def(
+      "build_patched_mesh",
+      [](mesh::MeshTopology topology,
+         py::array_t<int, py::array::c_style | py::array::forcecast> elements,
+         int num_verts,
+         py::array_t<float, py::array::c_style | py::array::forcecast>
+             positions,
+         const std::vector<mesh::MeshRelationType> &relations, int patch_size,
+         const std::string &reorder, int num_threads) {
+        auto to_vector = [](const auto &array) {
+          return std::vector(array.data(), array.data() + array.size());
+        };
+        mesh::MeshPatcherConfig config;
+        config.patch_size = patch_size;
+        config.reorder = mesh::mesh_reorder_method_from_name(reorder);
+        config.num_threads = num_threads;
+        auto elements_vec = to_vector(elements);
+        auto positions_vec = to_vector(positions);
+        mesh::PatchedMesh patched;
+        {
+          py::gil_scoped_release release;
+          patched = mesh::build_patched_mesh(topology, elements_vec, num_verts,
+                                             positions_vec, relations, config);
+        }
+
+        auto to_numpy = [](const auto &vec) {
+          using T = typename std::decay_t<decltype(vec)>::value_type;
+          return py::array_t<T>((py::ssize_t)vec.size(), vec.data());
+        };
+        py::list elements_list;
+        for (const auto &element : patched.elements) {
+          py::dict d;
+          d["order"] = mesh::element_order(element.type);
+          d["num"] = element.num;
+          d["max_num_per_patch"] = element.max_num_per_patch;
+          d["owned_offsets"] = to_numpy(element.owned_offsets);
+          d["total_offsets"] = to_numpy(element.total_offsets);
+          d["l2g_mapping"] = to_numpy(element.l2g_mapping);
+          d["l2r_mapping"] = to_numpy(element.l2r_mapping);
+          d["g2r_mapping"] = to_numpy(element.g2r_mapping);
+          elements_list.append(d);
+        }
+        py::list relations_list;
+        for (const auto &relation : patched.relations) {
+          py::dict d;
+          int from_order = mesh::from_end_element_order(relation.type);
+          int to_order = mesh::to_end_element_order(relation.type);
+          d["from_order"] = from_order;
+          d["to_order"] = to_order;
+          d["value"] = to_numpy(relation.value);
+          if (from_order <= to_order) {
+            d["offset"] = to_numpy(relation.offset);
+            d["patch_offset"] = to_numpy(relation.patch_offset);
+          }
+          relations_list.append(d);
+        }
+        py::dict data;
+        data["num_patches"] = patched.num_patches;
+        data["elements"] = elements_list;
+        data["relations"] = relations_list;
+        return data;
+      },
+      py::arg("topology"), py::arg("elements"), py::arg("num_verts"),
+      py::arg("positions"), py::arg("relations"), py::arg("patch_size") = 256,
+      py::arg("reorder") = "rcm", py::arg("num_threads") = 0);
+
   m.def("wait_for_debugger", []() {
 #ifdef WIN32
     while (!::IsDebuggerPresent())
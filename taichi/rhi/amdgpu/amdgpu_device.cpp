@@ -100,7 +100,12 @@ void AmdgpuDevice::dealloc_memory(DeviceAllocation handle) {
   if (info.ptr == nullptr) {
     TI_ERROR("the DeviceAllocation is already deallocated");
   }
-  TI_ASSERT(!info.is_imported);
+  if (info.is_imported) {
+    // The memory is owned by the exporter, only the slot is released.
+    info = AllocInfo();
+    free_imported_ids_.push_back(handle.alloc_id);
+    return;
+  }
   if (info.use_cached) {
     DeviceMemoryPool::get_instance().release(info.size, (uint64_t *)info.ptr,
                                              false);
@@ -146,8 +151,14 @@ DeviceAllocation AmdgpuDevice::import_memory(void *ptr, size_t size) {
   info.is_imported = true;
 
   DeviceAllocation alloc;
-  alloc.alloc_id = allocations_.size();
   alloc.device = this;
+  if (!free_imported_ids_.empty()) {
+    alloc.alloc_id = free_imported_ids_.back();
+    free_imported_ids_.pop_back();
+    allocations_[alloc.alloc_id] = info;
+    return alloc;
+  }
+  alloc.alloc_id = allocations_.size();
 
   allocations_.push_back(info);
   return alloc;
@@ -115,10 +115,13 @@ class AmdgpuDevice : public LlvmDevice {
 
   void clear() override {
     allocations_.clear();
+    free_imported_ids_.clear();
   }
 
  private:
   std::vector<AllocInfo> allocations_;
+  // Slots of released imported allocations, reused by |import_memory|.
+  std::vector<DeviceAllocationId> free_imported_ids_;
   void validate_device_alloc(const DeviceAllocation alloc) {
     if (allocations_.size() <= alloc.alloc_id) {
       TI_ERROR("invalid DeviceAllocation");
@@ -219,14 +219,14 @@ void EventToolkitAMDGPU::update_timeline(
   if (Timelines::get_instance().get_enabled()) {
     auto &timeline = Timeline::get_this_thread_instance();
     for (auto &record : traced_records) {
-      timeline.insert_event({record.name, /*param_name=begin*/ true,
-                             base_time_ + record.time_since_base * 1e-3,
-                             "amdgpu"});
-      timeline.insert_event({record.name, /*param_name=begin*/ false,
-                             base_time_ + (record.time_since_base +
-                                           record.kernel_elapsed_time_in_ms) *
-                                              1e-3,
-                             "amdgpu"});
+      timeline.insert_event(record.name, /*begin=*/true,
+                            base_time_ + record.time_since_base * 1e-3,
+                            "amdgpu");
+      timeline.insert_event(record.name, /*begin=*/false,
+                            base_time_ + (record.time_since_base +
+                                          record.kernel_elapsed_time_in_ms) *
+                                             1e-3,
+                            "amdgpu");
     }
   }
 }
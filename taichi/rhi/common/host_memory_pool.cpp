@@ -43,6 +43,28 @@ void HostMemoryPool::release(std::size_t size, void *ptr) {
   }
 }
 
+void HostMemoryPool::discard_pages(void *ptr, std::size_t size) {
+  TI_ERROR_IF(((uint64_t)ptr) % page_size != 0 || size % page_size != 0,
+              "Range ({:}, {} B) is not aligned by page size {}", ptr, size,
+              page_size);
+#if defined(TI_PLATFORM_LINUX)
+  // Private anonymous pages read as zeros after MADV_DONTNEED.
+  TI_ERROR_IF(madvise(ptr, size, MADV_DONTNEED) != 0,
+              "Failed to discard pages ({} B)", size);
+#elif defined(TI_PLATFORM_UNIX)
+  // MADV_DONTNEED doesn't zero the pages on every Unix, so map fresh ones
+  // over the range instead.
+  void *ret = mmap(ptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  TI_ERROR_IF(ret == MAP_FAILED, "Failed to discard pages ({} B)", size);
+#else
+  // Decommitted pages are zeroed when they are committed again.
+  TI_ERROR_IF(!VirtualFree(ptr, size, MEM_DECOMMIT) ||
+                  !VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE),
+              "Failed to discard pages ({} B)", size);
+#endif
+}
+
 void *HostMemoryPool::allocate_raw_memory(std::size_t size) {
   /*
     Be aware that this methods is not protected by the mutex.
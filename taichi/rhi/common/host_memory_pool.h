@@ -21,6 +21,9 @@ class TI_DLL_EXPORT HostMemoryPool {
                  std::size_t alignment,
                  bool exclusive = false);
   void release(std::size_t size, void *ptr);
+  // Returns the physical pages of the page-aligned range [ptr, ptr + size) to
+  // the OS. The range stays mapped and reads as zeros afterwards.
+  void discard_pages(void *ptr, std::size_t size);
   void reset();
   HostMemoryPool();
   ~HostMemoryPool();
@@ -67,6 +67,12 @@ void CpuDevice::dealloc_memory(DeviceAllocation handle) {
   if (info.ptr == nullptr) {
     TI_ERROR("the DeviceAllocation is already deallocated");
   }
+  if (info.is_imported) {
+    // The memory is owned by the exporter, only the slot is released.
+    info = AllocInfo();
+    free_imported_ids_.push_back(handle.alloc_id);
+    return;
+  }
   if (!info.use_cached) {
     HostMemoryPool::get_instance().release(info.size, info.ptr);
     info.ptr = nullptr;
@@ -87,7 +93,7 @@ RhiResult CpuDevice::upload_data(DevicePtr *device_ptr,
     }
 
     AllocInfo &info = allocations_[device_ptr[i].alloc_id];
-    memcpy((uint8_t *)info.ptr + device_ptr[i].offset, data[i], size[i]);
+    host_memcpy((uint8_t *)info.ptr + device_ptr[i].offset, data[i], size[i]);
   }
 
   return RhiResult::success;
@@ -109,7 +115,7 @@ RhiResult CpuDevice::readback_data(
     }
 
     AllocInfo &info = allocations_[device_ptr[i].alloc_id];
-    memcpy(data[i], (uint8_t *)info.ptr + device_ptr[i].offset, size[i]);
+    host_memcpy(data[i], (uint8_t *)info.ptr + device_ptr[i].offset, size[i]);
   }
 
   return RhiResult::success;
@@ -144,17 +150,32 @@ void CpuDevice::memcpy_internal(DevicePtr dst, DevicePtr src, uint64_t size) {
       static_cast<char *>(allocations_[dst.alloc_id].ptr) + dst.offset;
   void *src_ptr =
       static_cast<char *>(allocations_[src.alloc_id].ptr) + src.offset;
-  std::memcpy(dst_ptr, src_ptr, size);
+  host_memcpy(dst_ptr, src_ptr, size);
+}
+
+void CpuDevice::host_memcpy(void *dst, const void *src, size_t size) {
+  if (thread_pool_) {
+    thread_pool_->parallel_memcpy(dst, src, size);
+  } else {
+    std::memcpy(dst, src, size);
+  }
 }
 
 DeviceAllocation CpuDevice::import_memory(void *ptr, size_t size) {
   AllocInfo info;
   info.ptr = ptr;
   info.size = size;
+  info.is_imported = true;
 
   DeviceAllocation alloc;
-  alloc.alloc_id = allocations_.size();
   alloc.device = this;
+  if (!free_imported_ids_.empty()) {
+    alloc.alloc_id = free_imported_ids_.back();
+    free_imported_ids_.pop_back();
+    allocations_[alloc.alloc_id] = info;
+    return alloc;
+  }
+  alloc.alloc_id = allocations_.size();
 
   allocations_.push_back(info);
   return alloc;
@@ -6,6 +6,7 @@
 
 #include "taichi/common/core.h"
 #include "taichi/rhi/llvm/llvm_device.h"
+#include "taichi/system/threading.h"
 
 namespace taichi::lang {
 namespace cpu {
@@ -64,6 +65,7 @@ class CpuDevice : public LlvmDevice {
     void *ptr{nullptr};
     size_t size{0};
     bool use_cached{false};
+    bool is_imported{false};
   };
 
   AllocInfo get_alloc_info(const DeviceAllocation handle);
@@ -111,12 +113,22 @@ class CpuDevice : public LlvmDevice {
 
   void memcpy_internal(DevicePtr dst, DevicePtr src, uint64_t size) override;
 
+  // Large copies are split across |thread_pool| when it is set.
+  void set_thread_pool(ThreadPool *thread_pool) {
+    thread_pool_ = thread_pool;
+  }
+
   Stream *get_compute_stream() override{TI_NOT_IMPLEMENTED};
 
   void wait_idle() override{TI_NOT_IMPLEMENTED};
 
  private:
   std::vector<AllocInfo> allocations_;
+  // Slots of released imported allocations, reused by |import_memory|.
+  std::vector<DeviceAllocationId> free_imported_ids_;
+  ThreadPool *thread_pool_{nullptr};
+
+  void host_memcpy(void *dst, const void *src, size_t size);
 
   void validate_device_alloc(const DeviceAllocation alloc) {
     if (allocations_.size() <= alloc.alloc_id) {
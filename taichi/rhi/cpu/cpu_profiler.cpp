@@ -0,0 +1,301 @@
+#include "taichi/rhi/cpu/cpu_profiler.h"
+
+#include "taichi/system/timer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+
+#if defined(TI_PLATFORM_LINUX)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace taichi::lang {
+
+namespace {
+
+struct CpuMetric {
+  const char *name;
+  // Whether this is a hardware counter, or a statistic of the thread pool.
+  bool hardware;
+  uint64 perf_config;
+};
+
+#if defined(TI_PLATFORM_LINUX)
+const CpuMetric cpu_metrics[] = {
+    {"cycles", true, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", true, PERF_COUNT_HW_INSTRUCTIONS},
+    // Generic cache misses are last level cache misses on most CPUs.
+    {"llc_misses", true, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", true, PERF_COUNT_HW_BRANCH_MISSES},
+    {"thread_busy_ms", false, 0},
+    {"thread_idle_ms", false, 0},
+    {"thread_busy_max_ms", false, 0},
+};
+#else
+const CpuMetric cpu_metrics[] = {
+    {"thread_busy_ms", false, 0},
+    {"thread_idle_ms", false, 0},
+    {"thread_busy_max_ms", false, 0},
+};
+#endif
+
+const CpuMetric *find_cpu_metric(const std::string &name) {
+  for (const auto &metric : cpu_metrics) {
+    if (name == metric.name) {
+      return &metric;
+    }
+  }
+  return nullptr;
+}
+
+int get_os_thread_id() {
+#if defined(TI_PLATFORM_LINUX)
+  return (int)syscall(SYS_gettid);
+#else
+  return -1;
+#endif
+}
+
+}  // namespace
+
+// A group of hardware counters on each of the profiled threads. The counters
+// keep running, and are read at the start and the end of each task.
+class PerfEventCounters {
+ public:
+  explicit PerfEventCounters(std::vector<uint64> configs)
+      : configs_(std::move(configs)) {
+  }
+
+  ~PerfEventCounters() {
+    for (auto &[tid, fds] : fds_) {
+      close_all(fds);
+    }
+  }
+
+  // Opens the counters of the thread |tid|, if not opened yet. On failure,
+  // returns false with errno set.
+  bool attach(int tid) {
+#if defined(TI_PLATFORM_LINUX)
+    if (fds_.find(tid) != fds_.end()) {
+      return true;
+    }
+    std::vector<int> fds;
+    for (auto config : configs_) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.read_format = PERF_FORMAT_GROUP;
+      // Only count user space code, which is allowed with the default
+      // perf_event_paranoid setting.
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      int group_fd = fds.empty() ? -1 : fds[0];
+      int fd = (int)syscall(SYS_perf_event_open, &attr, tid, -1, group_fd,
+                            PERF_FLAG_FD_CLOEXEC);
+      if (fd < 0) {
+        int error = errno;
+        close_all(fds);
+        errno = error;
+        return false;
+      }
+      fds.push_back(fd);
+    }
+    fds_[tid] = std::move(fds);
+    return true;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+  }
+
+  // Sums up the counters of all the threads.
+  void read(std::vector<uint64> &values) const {
+    values.assign(configs_.size(), 0);
+#if defined(TI_PLATFORM_LINUX)
+    // The group format: the number of counters followed by their values.
+    std::vector<uint64> buffer(configs_.size() + 1);
+    for (const auto &[tid, fds] : fds_) {
+      auto size = sizeof(uint64) * buffer.size();
+      if (::read(fds[0], buffer.data(), size) != (ssize_t)size) {
+        continue;
+      }
+      for (std::size_t i = 0; i < configs_.size(); i++) {
+        values[i] += buffer[i + 1];
+      }
+    }
+#endif
+  }
+
+ private:
+  static void close_all(const std::vector<int> &fds) {
+#if defined(TI_PLATFORM_LINUX)
+    for (int fd : fds) {
+      close(fd);
+    }
+#endif
+  }
+
+  std::vector<uint64> configs_;
+  std::map<int, std::vector<int>> fds_;
+};
+
+KernelProfilerCPU::KernelProfilerCPU() = default;
+
+KernelProfilerCPU::~KernelProfilerCPU() = default;
+
+void KernelProfilerCPU::set_thread_pool(ThreadPool *thread_pool) {
+  thread_pool_ = thread_pool;
+  if (counters_ && thread_pool_) {
+    for (int tid : thread_pool_->worker_os_thread_ids) {
+      if (tid >= 0 && !counters_->attach(tid)) {
+        TI_WARN("Failed to open the hardware counters of thread {}: {}", tid,
+                std::strerror(errno));
+      }
+    }
+  }
+}
+
+bool KernelProfilerCPU::set_profiler_toolkit(std::string toolkit_name) {
+  if (toolkit_name == "default") {
+    use_perf_ = false;
+    metric_list_.clear();
+    counters_.reset();
+    return true;
+  }
+#if defined(TI_PLATFORM_LINUX)
+  if (toolkit_name == "perf") {
+    use_perf_ = true;
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool KernelProfilerCPU::reinit_with_metrics(
+    const std::vector<std::string> metrics) {
+  if (!use_perf_) {
+    return false;
+  }
+  std::vector<uint64> configs;
+  for (const auto &name : metrics) {
+    auto *metric = find_cpu_metric(name);
+    if (metric == nullptr) {
+      std::vector<std::string> names;
+      for (const auto &m : cpu_metrics) {
+        names.push_back(m.name);
+      }
+      TI_WARN("Unknown CPU profiler metric \"{}\", expected one of: {}", name,
+              fmt::join(names, ", "));
+      return false;
+    }
+    if (metric->hardware) {
+      configs.push_back(metric->perf_config);
+    }
+  }
+
+  std::unique_ptr<PerfEventCounters> counters;
+  if (!configs.empty()) {
+    counters = std::make_unique<PerfEventCounters>(std::move(configs));
+    std::vector<int> tids = {get_os_thread_id()};
+    if (thread_pool_) {
+      for (int tid : thread_pool_->worker_os_thread_ids) {
+        if (tid >= 0) {
+          tids.push_back(tid);
+        }
+      }
+    }
+    for (int tid : tids) {
+      if (!counters->attach(tid)) {
+        TI_WARN(
+            "Failed to open the hardware counters: {}. Check "
+            "/proc/sys/kernel/perf_event_paranoid.",
+            std::strerror(errno));
+        return false;
+      }
+    }
+  }
+  counters_ = std::move(counters);
+  metric_list_ = metrics;
+  return true;
+}
+
+void KernelProfilerCPU::clear() {
+  total_time_ms_ = 0;
+  traced_records_.clear();
+  statistical_results_.clear();
+}
+
+void KernelProfilerCPU::read_thread_pool(std::vector<uint64> &busy_ns) const {
+  busy_ns.clear();
+  if (thread_pool_) {
+    for (int i = 0; i < thread_pool_->max_num_threads; i++) {
+      busy_ns.push_back(
+          thread_pool_->worker_busy_ns[i].load(std::memory_order_relaxed));
+    }
+  }
+}
+
+void KernelProfilerCPU::start(const std::string &kernel_name) {
+  event_name_ = kernel_name;
+  if (!metric_list_.empty()) {
+    // Kernels may be launched from another thread than the one setting the
+    // metrics.
+    if (counters_ && !counters_->attach(get_os_thread_id())) {
+      TI_WARN("Failed to open the hardware counters: {}",
+              std::strerror(errno));
+    }
+    if (counters_) {
+      counters_->read(start_counters_);
+    }
+    read_thread_pool(start_busy_ns_);
+  }
+  // Taken last, so that reading the counters isn't part of the task time.
+  start_t_ = Time::get_time();
+}
+
+void KernelProfilerCPU::stop() {
+  double ms = (Time::get_time() - start_t_) * 1000.0;
+  insert_record(event_name_, ms);
+  if (metric_list_.empty()) {
+    return;
+  }
+
+  std::vector<uint64> counters;
+  if (counters_) {
+    counters_->read(counters);
+  }
+  std::vector<uint64> busy_ns;
+  read_thread_pool(busy_ns);
+  double busy_ms_sum = 0;
+  double busy_ms_max = 0;
+  for (std::size_t i = 0; i < busy_ns.size(); i++) {
+    double busy_ms = (busy_ns[i] - start_busy_ns_[i]) * 1e-6;
+    busy_ms_sum += busy_ms;
+    busy_ms_max = std::max(busy_ms_max, busy_ms);
+  }
+  double busy_ms_avg = busy_ns.empty() ? 0 : busy_ms_sum / busy_ns.size();
+
+  auto &values = traced_records_.back().metric_values;
+  std::size_t counter_id = 0;
+  for (const auto &name : metric_list_) {
+    if (find_cpu_metric(name)->hardware) {
+      values.push_back(
+          float(counters[counter_id] - start_counters_[counter_id]));
+      counter_id++;
+    } else if (name == "thread_busy_ms") {
+      values.push_back(float(busy_ms_avg));
+    } else if (name == "thread_idle_ms") {
+      values.push_back(float(std::max(0.0, ms - busy_ms_avg)));
+    } else {
+      values.push_back(float(busy_ms_max));
+    }
+  }
+}
+
+}  // namespace taichi::lang
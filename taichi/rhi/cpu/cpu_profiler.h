@@ -0,0 +1,58 @@
+#pragma once
+
+#include "taichi/program/kernel_profiler.h"
+#include "taichi/system/threading.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace taichi::lang {
+
+class PerfEventCounters;
+
+// The kernel profiler of the CPU backends. Offloaded tasks are timed on the
+// launching thread, like with the default profiler.
+//
+// With the "perf" toolkit (Linux only), each record also gets the values of
+// the metrics selected by reinit_with_metrics():
+//  - "cycles", "instructions", "llc_misses" and "branch_misses": hardware
+//    counters read through perf_event_open(), summed over the launching thread
+//    and the thread pool workers.
+//  - "thread_busy_ms" and "thread_idle_ms": the average time a thread pool
+//    worker spent running or waiting for splits during the task.
+//  - "thread_busy_max_ms": the busy time of the busiest worker.
+class KernelProfilerCPU : public KernelProfilerBase {
+ public:
+  KernelProfilerCPU();
+  ~KernelProfilerCPU() override;
+
+  void set_thread_pool(ThreadPool *thread_pool);
+
+  bool set_profiler_toolkit(std::string toolkit_name) override;
+  bool reinit_with_metrics(const std::vector<std::string> metrics) override;
+
+  void sync() override {
+  }
+  void update() override {
+  }
+  void clear() override;
+
+  void start(const std::string &kernel_name) override;
+  void stop() override;
+
+ private:
+  void read_thread_pool(std::vector<uint64> &busy_ns) const;
+
+  bool use_perf_{false};
+  ThreadPool *thread_pool_{nullptr};
+  std::vector<std::string> metric_list_;
+  std::unique_ptr<PerfEventCounters> counters_;
+
+  std::string event_name_;
+  double start_t_{0};
+  std::vector<uint64> start_counters_;
+  std::vector<uint64> start_busy_ns_;
+};
+
+}  // namespace taichi::lang
@@ -103,7 +103,12 @@ void CudaDevice::dealloc_memory(DeviceAllocation handle) {
   if (info.ptr == nullptr) {
     TI_ERROR("the DeviceAllocation is already deallocated");
   }
-  TI_ASSERT(!info.is_imported);
+  if (info.is_imported) {
+    // The memory is owned by the exporter, only the slot is released.
+    info = AllocInfo();
+    free_imported_ids_.push_back(handle.alloc_id);
+    return;
+  }
   if (info.use_memory_pool) {
     CUDADriver::get_instance().mem_free_async(info.ptr, nullptr);
   } else if (info.use_cached) {
@@ -193,8 +198,14 @@ DeviceAllocation CudaDevice::import_memory(void *ptr, size_t size) {
   info.is_imported = true;
 
   DeviceAllocation alloc;
-  alloc.alloc_id = allocations_.size();
   alloc.device = this;
+  if (!free_imported_ids_.empty()) {
+    alloc.alloc_id = free_imported_ids_.back();
+    free_imported_ids_.pop_back();
+    allocations_[alloc.alloc_id] = info;
+    return alloc;
+  }
+  alloc.alloc_id = allocations_.size();
 
   allocations_.push_back(info);
   return alloc;
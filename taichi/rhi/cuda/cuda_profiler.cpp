@@ -340,16 +340,14 @@ void EventToolkit::update_timeline(
   if (Timelines::get_instance().get_enabled()) {
     auto &timeline = Timeline::get_this_thread_instance();
     for (auto &record : traced_records) {
-      // param of insert_event() :
-      // struct TimelineEvent @ taichi/taichi/system/timeline.h
-      timeline.insert_event({record.name, /*param_name=begin*/ true,
-                             base_time_ + record.time_since_base * 1e-3,
-                             "cuda"});
-      timeline.insert_event({record.name, /*param_name=begin*/ false,
-                             base_time_ + (record.time_since_base +
-                                           record.kernel_elapsed_time_in_ms) *
-                                              1e-3,
-                             "cuda"});
+      timeline.insert_event(record.name, /*begin=*/true,
+                            base_time_ + record.time_since_base * 1e-3,
+                            "cuda");
+      timeline.insert_event(record.name, /*begin=*/false,
+                            base_time_ + (record.time_since_base +
+                                          record.kernel_elapsed_time_in_ms) *
+                                             1e-3,
+                            "cuda");
     }
   }
 }
@@ -24,6 +24,9 @@ void KernelLauncher::launch_llvm_kernel(Handle handle,
 
   AMDGPUContext::get_instance().make_current();
   ctx.get_context().runtime = executor->get_llvm_runtime();
+  ctx.get_context().rand_launch_id =
+      ctx.rand_launch_id >= 0 ? (uint32)ctx.rand_launch_id
+                              : executor->next_rand_launch_id();
 
   std::unordered_map<std::vector<int>, std::pair<void *, DeviceAllocation>,
                      hashing::Hasher<std::vector<int>>>
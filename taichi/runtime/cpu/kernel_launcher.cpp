@@ -1,16 +1,36 @@
 #include "taichi/runtime/cpu/kernel_launcher.h"
 #include "taichi/rhi/arch.h"
+#include "taichi/system/timeline.h"
+#include "taichi/system/timer.h"
 
 namespace taichi::lang {
 namespace cpu {
 
+KernelLauncher::KernelLauncher(Config config) : Base(std::move(config)) {
+  const auto &compile_config = get_runtime_executor()->get_config();
+  if (compile_config.cpu_launch_autotune) {
+    autotuner_ = std::make_unique<LaunchAutotuner>(
+        compile_config.offline_cache ? compile_config.offline_cache_file_path
+                                     : "");
+  }
+}
+
 void KernelLauncher::launch_llvm_kernel(Handle handle,
                                         LaunchContextBuilder &ctx) {
-  TI_ASSERT(handle.get_launch_id() < contexts_.size());
-  auto launcher_ctx = contexts_[handle.get_launch_id()];
+  TI_AUTO_TIMELINE;
+  const Context *launcher_ctx_ptr;
+  {
+    std::lock_guard<std::mutex> _(contexts_mutex_);
+    TI_ASSERT(handle.get_launch_id() < contexts_.size());
+    launcher_ctx_ptr = contexts_[handle.get_launch_id()].get();
+  }
+  const auto &launcher_ctx = *launcher_ctx_ptr;
   auto *executor = get_runtime_executor();
 
   ctx.get_context().runtime = executor->get_llvm_runtime();
+  ctx.get_context().rand_launch_id =
+      ctx.rand_launch_id >= 0 ? (uint32)ctx.rand_launch_id
+                              : executor->next_rand_launch_id();
   // For taichi ndarrays, context.array_ptrs saves pointer to its
   // |DeviceAllocation|, CPU backend actually want to use the raw ptr here.
   const auto &parameters = launcher_ctx.parameters;
@@ -40,8 +60,19 @@ void KernelLauncher::launch_llvm_kernel(Handle handle,
       ctx.set_ndarray_ptrs(i, host_ptr, host_ptr_grad);
     }
   }
-  for (auto task : launcher_ctx.task_funcs) {
-    task(&ctx.get_context());
+  for (std::size_t i = 0; i < launcher_ctx.task_funcs.size(); i++) {
+    TI_TIMELINE(launcher_ctx.task_names[i]);
+    if (!autotuner_) {
+      launcher_ctx.task_funcs[i](&ctx.get_context());
+      continue;
+    }
+    auto config = autotuner_->get_config(launcher_ctx.tuning_id, i);
+    ctx.get_context().cpu_block_dim = config.block_dim;
+    ctx.get_context().cpu_num_threads = config.num_threads;
+    auto start = Time::get_time();
+    launcher_ctx.task_funcs[i](&ctx.get_context());
+    autotuner_->record(launcher_ctx.tuning_id, i, config,
+                       Time::get_time() - start);
   }
 }
 
@@ -49,12 +80,14 @@ KernelLauncher::Handle KernelLauncher::register_llvm_kernel(
     const LLVM::CompiledKernelData &compiled) {
   TI_ASSERT(arch_is_cpu(compiled.arch()));
 
+  std::lock_guard<std::mutex> _(contexts_mutex_);
   if (!compiled.get_handle()) {
     auto handle = make_handle();
     auto index = handle.get_launch_id();
     contexts_.resize(index + 1);
+    contexts_[index] = std::make_unique<Context>();
 
-    auto &ctx = contexts_[index];
+    auto &ctx = *contexts_[index];
     auto *executor = get_runtime_executor();
 
     auto data = compiled.get_internal_data().compiled_data.clone();
@@ -64,22 +97,35 @@ KernelLauncher::Handle KernelLauncher::register_llvm_kernel(
     // Construct task_funcs
     using TaskFunc = int32 (*)(void *);
     std::vector<TaskFunc> task_funcs;
+    std::vector<std::string> task_names;
     task_funcs.reserve(data.tasks.size());
     for (auto &task : data.tasks) {
       auto *func_ptr = jit_module->lookup_function(task.name);
       TI_ASSERT_INFO(func_ptr, "Offloaded datum function {} not found",
                      task.name);
       task_funcs.push_back((TaskFunc)(func_ptr));
+      task_names.push_back(task.name);
     }
 
     // Populate ctx
     ctx.parameters = std::move(parameters);
     ctx.task_funcs = std::move(task_funcs);
+    ctx.task_names = std::move(task_names);
+    if (autotuner_) {
+      ctx.tuning_id =
+          autotuner_->register_kernel(compiled.get_kernel_key(), data.tasks);
+    }
 
     compiled.set_handle(handle);
   }
   return *compiled.get_handle();
 }
 
+void KernelLauncher::dump_cache_data_to_disk() {
+  if (autotuner_) {
+    autotuner_->dump();
+  }
+}
+
 }  // namespace cpu
 }  // namespace taichi::lang
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include "taichi/codegen/llvm/compiled_kernel_data.h"
+#include "taichi/runtime/cpu/launch_autotuner.h"
 #include "taichi/runtime/llvm/kernel_launcher.h"
 
 namespace taichi::lang {
@@ -12,18 +16,29 @@ class KernelLauncher : public LLVM::KernelLauncher {
   struct Context {
     using TaskFunc = int32 (*)(void *);
     std::vector<TaskFunc> task_funcs;
+    // For the timeline
+    std::vector<std::string> task_names;
     std::vector<Callable::Parameter> parameters;
+    // The id of the kernel in the launch autotuner
+    int tuning_id{-1};
   };
 
  public:
-  using Base::Base;
+  explicit KernelLauncher(Config config);
 
   void launch_llvm_kernel(Handle handle, LaunchContextBuilder &ctx) override;
   Handle register_llvm_kernel(
       const LLVM::CompiledKernelData &compiled) override;
+  void dump_cache_data_to_disk() override;
 
  private:
-  std::vector<Context> contexts_;
+  // Held by pointer so that launches can use them outside of the lock while
+  // other kernels are registered.
+  std::vector<std::unique_ptr<Context>> contexts_;
+  // Kernels may be launched from several host threads at once, e.g. by the
+  // concurrent dispatches of a compute graph.
+  std::mutex contexts_mutex_;
+  std::unique_ptr<LaunchAutotuner> autotuner_;
 };
 
 }  // namespace cpu
@@ -0,0 +1,186 @@
+#include "taichi/runtime/cpu/launch_autotuner.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace taichi::lang {
+namespace cpu {
+
+namespace {
+
+// The block sizes tried after the thread counts.
+constexpr int kBlockDims[] = {16, 64, 256, 1024};
+
+constexpr double kNoTime = std::numeric_limits<double>::infinity();
+
+}  // namespace
+
+LaunchAutotuner::LaunchAutotuner(const std::string &cache_path)
+    : cache_path_(cache_path) {
+  if (cache_path_.empty()) {
+    return;
+  }
+  auto filepath = join_path(cache_path_, kFilename);
+  auto lock_path = join_path(cache_path_, kLockName);
+  if (path_exists(filepath)) {
+    if (lock_with_file(lock_path)) {
+      auto _ = make_unlocker(lock_path);
+      offline_cache::load_metadata_with_checking(loaded_, filepath);
+    } else {
+      TI_WARN("Lock {} failed. Please remove it and try again.", lock_path);
+    }
+  }
+}
+
+int LaunchAutotuner::register_kernel(const std::string &kernel_key,
+                                     const std::vector<OffloadedTask> &tasks) {
+  std::lock_guard<std::mutex> _(mut_);
+  KernelTuning kernel;
+  kernel.key = kernel_key;
+  auto saved = loaded_.kernels.find(kernel_key);
+  bool restored = !kernel_key.empty() && saved != loaded_.kernels.end() &&
+                  saved->second.size() == tasks.size();
+  for (int i = 0; i < (int)tasks.size(); i++) {
+    TaskTuning t;
+    t.name = tasks[i].name;
+    t.block_dim = tasks[i].block_dim;
+    t.max_num_threads = tasks[i].grid_dim;
+    if (restored) {
+      t.best = saved->second[i];
+      t.tuned = true;
+    } else {
+      start_tuning(t);
+    }
+    kernel.tasks.push_back(std::move(t));
+  }
+  kernels_.push_back(std::move(kernel));
+  return (int)kernels_.size() - 1;
+}
+
+TaskLaunchConfig LaunchAutotuner::get_config(int kernel, int task) {
+  std::lock_guard<std::mutex> _(mut_);
+  const auto &t = kernels_[kernel].tasks[task];
+  return t.tuned ? t.best : t.candidates[t.current];
+}
+
+void LaunchAutotuner::record(int kernel,
+                             int task,
+                             const TaskLaunchConfig &config,
+                             double seconds) {
+  std::lock_guard<std::mutex> _(mut_);
+  auto &k = kernels_[kernel];
+  auto &t = k.tasks[task];
+  // A concurrent launch of the kernel may have moved on to the next
+  // candidate in the meantime.
+  if (t.tuned || !(t.candidates[t.current] == config)) {
+    return;
+  }
+  t.current_seconds = std::min(t.current_seconds, seconds);
+  if (++t.num_samples < kNumSamples) {
+    return;
+  }
+  next_candidate(t);
+  if (!t.tuned) {
+    return;
+  }
+  TI_DEBUG("Tuned task {}: block_dim={}, num_threads={} ({} ms)", t.name,
+           t.best.block_dim, t.best.num_threads, t.best_seconds * 1e3);
+  k.to_save = is_tuned(k);
+}
+
+bool LaunchAutotuner::is_tuned(int kernel) {
+  std::lock_guard<std::mutex> _(mut_);
+  return is_tuned(kernels_[kernel]);
+}
+
+void LaunchAutotuner::dump() {
+  std::lock_guard<std::mutex> guard(mut_);
+  if (cache_path_.empty() ||
+      std::none_of(kernels_.begin(), kernels_.end(), [](const auto &k) {
+        return k.to_save && !k.key.empty();
+      })) {
+    return;
+  }
+
+  taichi::create_directories(cache_path_);
+  auto filepath = join_path(cache_path_, kFilename);
+  auto lock_path = join_path(cache_path_, kLockName);
+  if (!lock_with_file(lock_path)) {
+    TI_WARN("Lock {} failed. Please remove it and try again.", lock_path);
+    return;
+  }
+
+  auto _ = make_unlocker(lock_path);
+  TuningData data;
+  // Keep the kernels tuned by the other runs
+  if (offline_cache::load_metadata_with_checking(data, filepath) !=
+      offline_cache::LoadMetadataError::kNoError) {
+    data.kernels.clear();
+  }
+  data.version[0] = TI_VERSION_MAJOR;
+  data.version[1] = TI_VERSION_MINOR;
+  data.version[2] = TI_VERSION_PATCH;
+  for (auto &k : kernels_) {
+    if (!k.to_save || k.key.empty()) {
+      continue;
+    }
+    auto &configs = data.kernels[k.key];
+    configs.clear();
+    for (const auto &t : k.tasks) {
+      configs.push_back(t.best);
+    }
+    k.to_save = false;
+  }
+  write_to_binary_file(data, filepath);
+}
+
+bool LaunchAutotuner::is_tuned(const KernelTuning &kernel) {
+  return std::all_of(kernel.tasks.begin(), kernel.tasks.end(),
+                     [](const TaskTuning &t) { return t.tuned; });
+}
+
+void LaunchAutotuner::start_tuning(TaskTuning &t) {
+  // Only the parallel loops have a grid_dim, which is the number of threads
+  // they are compiled for.
+  if (t.max_num_threads <= 1) {
+    t.tuned = true;
+    return;
+  }
+  t.candidates.push_back({0, 0});
+  for (int n = t.max_num_threads / 2; n >= 1 && t.candidates.size() < 3;
+       n /= 2) {
+    t.candidates.push_back({0, n});
+  }
+  t.current_seconds = kNoTime;
+  t.best_seconds = kNoTime;
+}
+
+void LaunchAutotuner::next_candidate(TaskTuning &t) {
+  if (t.current_seconds < t.best_seconds) {
+    t.best = t.candidates[t.current];
+    t.best_seconds = t.current_seconds;
+  }
+  t.num_samples = 0;
+  t.current_seconds = kNoTime;
+  if (++t.current < (int)t.candidates.size()) {
+    return;
+  }
+  // The range-fors split into a serial loop per thread by
+  // make_cpu_multithreaded_range_for run a single iteration per block.
+  if (!t.block_dims_tried && t.block_dim != 1) {
+    t.block_dims_tried = true;
+    t.candidates.clear();
+    for (auto block_dim : kBlockDims) {
+      if (block_dim != t.block_dim) {
+        t.candidates.push_back({block_dim, t.best.num_threads});
+      }
+    }
+    t.current = 0;
+    return;
+  }
+  t.candidates.clear();
+  t.tuned = true;
+}
+
+}  // namespace cpu
+}  // namespace taichi::lang
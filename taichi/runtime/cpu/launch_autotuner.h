@@ -0,0 +1,103 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "taichi/codegen/llvm/llvm_compiled_data.h"
+#include "taichi/util/offline_cache.h"
+
+namespace taichi::lang {
+namespace cpu {
+
+// The block size and the number of threads the parallel loop of an offloaded
+// task runs with. 0 keeps the compiled value.
+struct TaskLaunchConfig {
+  int block_dim{0};
+  int num_threads{0};
+
+  bool operator==(const TaskLaunchConfig &o) const {
+    return block_dim == o.block_dim && num_threads == o.num_threads;
+  }
+
+  TI_IO_DEF(block_dim, num_threads);
+};
+
+// Tunes the launch configurations of the parallel tasks on CPU by timing
+// their first launches. A task first tries a few thread counts with its
+// compiled block size, then a few block sizes with the fastest thread count,
+// and keeps the fastest configuration from then on. The winners are saved
+// per offline cache key of the kernel, so that later runs start tuned.
+class LaunchAutotuner {
+ public:
+  static constexpr char kFilename[] = "cpu_launch_tuning.tcb";
+  static constexpr char kLockName[] = "cpu_launch_tuning.lock";
+  // The number of launches each candidate is timed for. The fastest one
+  // counts, which leaves out the warm-up of the first launch.
+  static constexpr int kNumSamples = 3;
+
+  // Loads the winners saved in |cache_path|. An empty path disables saving.
+  explicit LaunchAutotuner(const std::string &cache_path);
+
+  // Returns the id the tasks of a kernel are tuned under. The tasks of the
+  // kernels tuned in earlier runs start tuned.
+  int register_kernel(const std::string &kernel_key,
+                      const std::vector<OffloadedTask> &tasks);
+
+  // Returns the configuration to launch the |task|-th task of |kernel| with.
+  TaskLaunchConfig get_config(int kernel, int task);
+
+  // Records that a launch of the task with |config| took |seconds|.
+  void record(int kernel,
+              int task,
+              const TaskLaunchConfig &config,
+              double seconds);
+
+  bool is_tuned(int kernel);
+
+  // Saves the winners of the kernels tuned in this run.
+  void dump();
+
+ private:
+  struct TaskTuning {
+    std::string name;
+    int block_dim{0};
+    int max_num_threads{0};
+    std::vector<TaskLaunchConfig> candidates;
+    int current{0};
+    int num_samples{0};
+    double current_seconds{0};
+    bool block_dims_tried{false};
+    TaskLaunchConfig best;
+    double best_seconds{0};
+    bool tuned{false};
+  };
+
+  struct KernelTuning {
+    std::string key;
+    std::vector<TaskTuning> tasks;
+    // Whether all the tasks got tuned in this run.
+    bool to_save{false};
+  };
+
+  struct TuningData {
+    offline_cache::Version version{};
+    std::unordered_map<std::string, std::vector<TaskLaunchConfig>> kernels;
+
+    // NOTE: The "version" must be the first field to be serialized
+    TI_IO_DEF(version, kernels);
+  };
+
+  static bool is_tuned(const KernelTuning &kernel);
+  static void start_tuning(TaskTuning &t);
+  static void next_candidate(TaskTuning &t);
+
+  std::string cache_path_;
+  TuningData loaded_;
+  std::vector<KernelTuning> kernels_;
+  std::mutex mut_;
+};
+
+}  // namespace cpu
+}  // namespace taichi::lang
@@ -50,6 +50,9 @@ void KernelLauncher::launch_llvm_kernel(Handle handle,
       (void **)&device_result_buffer,
       std::max(ctx.result_buffer_size, sizeof(uint64)), nullptr);
   ctx.get_context().runtime = executor->get_llvm_runtime();
+  ctx.get_context().rand_launch_id =
+      ctx.rand_launch_id >= 0 ? (uint32)ctx.rand_launch_id
+                              : executor->next_rand_launch_id();
 
   for (int i = 0; i < (int)parameters.size(); i++) {
     if (parameters[i].is_array) {
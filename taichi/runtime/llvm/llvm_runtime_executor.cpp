@@ -1,8 +1,10 @@
 #include "taichi/runtime/llvm/llvm_runtime_executor.h"
 
 #include "taichi/rhi/common/host_memory_pool.h"
+#include "taichi/ir/type_utils.h"
 #include "taichi/runtime/llvm/llvm_offline_cache.h"
 #include "taichi/rhi/cpu/cpu_device.h"
+#include "taichi/rhi/cpu/cpu_profiler.h"
 #include "taichi/rhi/cuda/cuda_device.h"
 #include "taichi/platform/cuda/detect_cuda.h"
 #include "taichi/rhi/cuda/cuda_driver.h"
@@ -78,14 +80,20 @@ LlvmRuntimeExecutor::LlvmRuntimeExecutor(CompileConfig &config,
   }
 
   snode_tree_buffer_manager_ = std::make_unique<SNodeTreeBufferManager>(this);
-  thread_pool_ = std::make_unique<ThreadPool>(config.cpu_max_num_threads);
+  thread_pool_ = std::make_unique<ThreadPool>(
+      config.cpu_max_num_threads,
+      arch_is_cpu(config.arch)
+          ? get_thread_affinity(config.cpu_thread_affinity,
+                                config.cpu_max_num_threads)
+          : std::vector<int>{});
 
   llvm_runtime_ = nullptr;
 
   if (arch_is_cpu(config.arch)) {
     config.max_block_dim = 1024;
-    device_ = std::make_shared<cpu::CpuDevice>();
-
+    auto cpu_device = std::make_shared<cpu::CpuDevice>();
+    cpu_device->set_thread_pool(thread_pool_.get());
+    device_ = std::move(cpu_device);
   }
 #if defined(TI_WITH_CUDA)
   else if (config.arch == Arch::cuda) {
@@ -430,9 +438,11 @@ void LlvmRuntimeExecutor::initialize_llvm_runtime_snodes(
 #else
     TI_NOT_IMPLEMENTED;
 #endif
-  } else {
+  } else if (!arch_is_cpu(config_.arch)) {
     std::memset(root_buffer, 0, rounded_size);
   }
+  // On CPU, the buffer manager hands out pages that the OS has zeroed. Not
+  // touching them here keeps the unused parts of sparse trees out of memory.
 
   DeviceAllocation alloc =
       llvm_device()->import_memory(root_buffer, rounded_size);
@@ -514,8 +524,68 @@ void LlvmRuntimeExecutor::fill_ndarray(const DeviceAllocation &alloc,
     TI_NOT_IMPLEMENTED;
 #endif
   } else {
-    std::fill((uint32_t *)ptr, (uint32_t *)ptr + size, data);
+    thread_pool_->parallel_fill_u32((uint32_t *)ptr, data, size);
+  }
+}
+
+void LlvmRuntimeExecutor::run_concurrently(
+    const std::vector<std::function<void()>> &tasks) {
+  if (!arch_is_cpu(config_.arch) || tasks.size() <= 1) {
+    for (const auto &task : tasks) {
+      task();
+    }
+    return;
   }
+  thread_pool_->run(tasks.size(), config_.cpu_max_num_threads,
+                    const_cast<std::vector<std::function<void()>> *>(&tasks),
+                    [](void *tasks, int thread_id, int i) {
+                      (*(std::vector<std::function<void()>> *)tasks)[i]();
+                    });
+}
+
+void LlvmRuntimeExecutor::parallel_scan_add(PrimitiveTypeID dt,
+                                            void *data,
+                                            int n,
+                                            bool exclusive) {
+  TI_ASSERT(arch_is_cpu(config_.arch));
+  TI_ERROR_IF(dt != PrimitiveTypeID::i32 && dt != PrimitiveTypeID::f32,
+              "Parallel scan only supports i32 and f32, got {}",
+              data_type_name(PrimitiveType::get(dt)));
+  get_runtime_jit_module()->call<void *, void *, int32, int32>(
+      fmt::format("runtime_cpu_parallel_scan_add_{}",
+                  data_type_name(PrimitiveType::get(dt))),
+      llvm_runtime_, data, n, (int32)exclusive);
+}
+
+int LlvmRuntimeExecutor::parallel_compact(void *out,
+                                          const void *in,
+                                          const int32 *flags,
+                                          int n,
+                                          uint64 *result_buffer) {
+  TI_ASSERT(arch_is_cpu(config_.arch));
+  return runtime_query<int32>("cpu_parallel_compact_32", result_buffer, out,
+                              const_cast<void *>(in),
+                              (void *)const_cast<int32 *>(flags), n);
+}
+
+void LlvmRuntimeExecutor::parallel_radix_sort(PrimitiveTypeID key_dt,
+                                              void *keys,
+                                              void *values,
+                                              void *keys_tmp,
+                                              void *values_tmp,
+                                              int n) {
+  TI_ASSERT(arch_is_cpu(config_.arch));
+  TI_ERROR_IF(key_dt != PrimitiveTypeID::u32 &&
+                  key_dt != PrimitiveTypeID::i32 &&
+                  key_dt != PrimitiveTypeID::f32,
+              "Radix sort only supports u32, i32 and f32 keys, got {}",
+              data_type_name(PrimitiveType::get(key_dt)));
+  TI_ASSERT(values == nullptr || values_tmp != nullptr);
+  get_runtime_jit_module()
+      ->call<void *, void *, void *, void *, void *, int32>(
+          fmt::format("runtime_cpu_parallel_radix_sort_{}",
+                      data_type_name(PrimitiveType::get(key_dt))),
+          llvm_runtime_, keys, values, keys_tmp, values_tmp, n);
 }
 
 uint64_t *LlvmRuntimeExecutor::get_ndarray_alloc_info_ptr(
@@ -547,7 +617,11 @@ uint64_t *LlvmRuntimeExecutor::get_ndarray_alloc_info_ptr(
 }
 
 void LlvmRuntimeExecutor::finalize() {
+  if (auto *cpu_profiler = dynamic_cast<KernelProfilerCPU *>(profiler_)) {
+    cpu_profiler->set_thread_pool(nullptr);
+  }
   profiler_ = nullptr;
+  snode_tree_buffer_manager_->clear_cache();
   if (config_.arch == Arch::cuda || config_.arch == Arch::amdgpu) {
     preallocated_runtime_objects_allocs_.reset();
     preallocated_runtime_memory_allocs_.reset();
@@ -752,6 +826,9 @@ void LlvmRuntimeExecutor::materialize_runtime(KernelProfilerBase *profiler,
     runtime_jit->call<void *, void *>(
         "LLVMRuntime_set_profiler_stop", llvm_runtime_,
         (void *)&KernelProfilerBase::profiler_stop);
+    if (auto *cpu_profiler = dynamic_cast<KernelProfilerCPU *>(profiler)) {
+      cpu_profiler->set_thread_pool(thread_pool_.get());
+    }
   }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 
@@ -55,6 +56,31 @@ class LlvmRuntimeExecutor {
 
   void check_runtime_error(uint64 *result_buffer);
 
+  // Runs |tasks| concurrently on the thread pool (CPU only).
+  void run_concurrently(const std::vector<std::function<void()>> &tasks);
+
+  // Parallel primitives over |n| 32-bit elements in host memory, run on the
+  // thread pool (CPU only). See runtime_module/parallel_primitives.h.
+  //
+  // In-place prefix sum of i32 or f32 |data|.
+  void parallel_scan_add(PrimitiveTypeID dt, void *data, int n, bool exclusive);
+  // Writes the elements of |in| (or their indices if |in| is null) whose
+  // |flags| are non-zero to |out|, and returns how many were written.
+  int parallel_compact(void *out,
+                       const void *in,
+                       const int32 *flags,
+                       int n,
+                       uint64 *result_buffer);
+  // Stable sort of u32, i32 or f32 |keys|, permuting |values| (if not null)
+  // along with them. |keys_tmp| and |values_tmp| are scratch buffers of |n|
+  // elements.
+  void parallel_radix_sort(PrimitiveTypeID key_dt,
+                           void *keys,
+                           void *values,
+                           void *keys_tmp,
+                           void *values_tmp,
+                           int n);
+
   uint64_t *get_ndarray_alloc_info_ptr(const DeviceAllocation &alloc);
 
   const CompileConfig &get_config() const {
@@ -79,6 +105,16 @@ class LlvmRuntimeExecutor {
     return use_device_memory_pool_;
   }
 
+  // Numbers the kernel launches, for the keys of the counter-based generator.
+  uint32 next_rand_launch_id() {
+    return rand_launch_id_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Takes |n| consecutive launch ids, and returns the first one.
+  uint32 reserve_rand_launch_ids(uint32 n) {
+    return rand_launch_id_.fetch_add(n, std::memory_order_relaxed);
+  }
+
  private:
   /* ----------------------- */
   /* ------ Allocation ----- */
@@ -160,6 +196,7 @@ class LlvmRuntimeExecutor {
   friend SNodeTreeBufferManager;
 
   bool use_device_memory_pool_ = false;
+  std::atomic<uint32> rand_launch_id_{0};
   bool finalized_{false};
   KernelProfilerBase *profiler_ = nullptr;
 };
@@ -0,0 +1,316 @@
+#pragma once
+
+// Parallel primitives over 32-bit elements, run on the CPU thread pool:
+// prefix sum (scan), stream compaction and LSD radix sort.
+//
+// The input is split into at most |cpu_primitive_max_blocks| contiguous
+// blocks. Every primitive first computes a partial result per block in
+// parallel, then combines the partials serially, and finally writes its
+// output block by block in parallel. Since blocks are processed in order, the
+// compaction and the sort are stable.
+//
+// These functions must not be called from within a parallel loop: they
+// dispatch to the thread pool themselves.
+
+constexpr int cpu_primitive_max_blocks = 64;
+constexpr int cpu_primitive_min_block_size = 16384;
+constexpr int cpu_radix_bits = 8;
+constexpr int cpu_radix_size = 1 << cpu_radix_bits;
+
+struct CpuPrimitiveBlocks {
+  int n;
+  int num_blocks;
+  int block_size;
+
+  explicit CpuPrimitiveBlocks(int n) : n(n) {
+    num_blocks = std::min(cpu_primitive_max_blocks,
+                          std::max(1, (n + cpu_primitive_min_block_size - 1) /
+                                          cpu_primitive_min_block_size));
+    block_size = (n + num_blocks - 1) / num_blocks;
+  }
+
+  int begin(int b) const {
+    return std::min(n, b * block_size);
+  }
+
+  int end(int b) const {
+    return std::min(n, (b + 1) * block_size);
+  }
+};
+
+// Calls |func(b)| for every block b on the thread pool.
+template <typename Func>
+void cpu_primitive_for_each_block(LLVMRuntime *runtime,
+                                  const CpuPrimitiveBlocks &blocks,
+                                  Func &func) {
+  runtime->parallel_for(runtime->thread_pool, blocks.num_blocks,
+                        blocks.num_blocks, &func,
+                        [](void *func, int thread_id, int b) {
+                          (*(Func *)func)(b);
+                        });
+}
+
+template <typename T>
+void cpu_parallel_scan_add(LLVMRuntime *runtime,
+                           T *data,
+                           int n,
+                           bool exclusive) {
+  if (n <= 0)
+    return;
+  CpuPrimitiveBlocks blocks(n);
+  T block_sums[cpu_primitive_max_blocks];
+
+  auto reduce = [&](int b) {
+    T sum = 0;
+    for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+      sum += data[i];
+    }
+    block_sums[b] = sum;
+  };
+  cpu_primitive_for_each_block(runtime, blocks, reduce);
+
+  T running = 0;
+  for (int b = 0; b < blocks.num_blocks; b++) {
+    T sum = block_sums[b];
+    block_sums[b] = running;
+    running += sum;
+  }
+
+  auto scan = [&](int b) {
+    T running = block_sums[b];
+    for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+      T value = data[i];
+      if (exclusive) {
+        data[i] = running;
+        running += value;
+      } else {
+        running += value;
+        data[i] = running;
+      }
+    }
+  };
+  cpu_primitive_for_each_block(runtime, blocks, scan);
+}
+
+// Writes the elements of |in| whose |flags| are non-zero to |out|, or their
+// indices if |in| is null. Returns the number of elements written.
+inline int cpu_parallel_compact(LLVMRuntime *runtime,
+                                u32 *out,
+                                const u32 *in,
+                                const i32 *flags,
+                                int n) {
+  if (n <= 0)
+    return 0;
+  CpuPrimitiveBlocks blocks(n);
+  int block_offsets[cpu_primitive_max_blocks];
+
+  auto count = [&](int b) {
+    int num_selected = 0;
+    for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+      num_selected += flags[i] != 0;
+    }
+    block_offsets[b] = num_selected;
+  };
+  cpu_primitive_for_each_block(runtime, blocks, count);
+
+  int total = 0;
+  for (int b = 0; b < blocks.num_blocks; b++) {
+    int num_selected = block_offsets[b];
+    block_offsets[b] = total;
+    total += num_selected;
+  }
+
+  auto write = [&](int b) {
+    int offset = block_offsets[b];
+    for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+      if (flags[i] != 0) {
+        out[offset++] = in ? in[i] : (u32)i;
+      }
+    }
+  };
+  cpu_primitive_for_each_block(runtime, blocks, write);
+  return total;
+}
+
+// Maps a key to an unsigned integer with the same ordering.
+template <typename T>
+u32 cpu_radix_sort_key(u32 bits);
+
+template <>
+inline u32 cpu_radix_sort_key<u32>(u32 bits) {
+  return bits;
+}
+
+template <>
+inline u32 cpu_radix_sort_key<i32>(u32 bits) {
+  return bits ^ 0x80000000u;
+}
+
+template <>
+inline u32 cpu_radix_sort_key<f32>(u32 bits) {
+  // Negative floats are ordered backwards, so all their bits are flipped.
+  return bits ^ ((u32)((i32)bits >> 31) | 0x80000000u);
+}
+
+// Sorts |n| keys of type T, stored as raw bits, in ascending order. If
+// |values| is not null, it is permuted along with the keys. |keys_tmp| and
+// |values_tmp| are scratch buffers of |n| elements; |values_tmp| may be null
+// if |values| is.
+template <typename T>
+void cpu_parallel_radix_sort(LLVMRuntime *runtime,
+                             u32 *keys,
+                             u32 *values,
+                             u32 *keys_tmp,
+                             u32 *values_tmp,
+                             int n) {
+  if (n <= 1)
+    return;
+  CpuPrimitiveBlocks blocks(n);
+  int offsets[cpu_primitive_max_blocks][cpu_radix_size];
+
+  u32 *src_keys = keys, *dst_keys = keys_tmp;
+  u32 *src_values = values, *dst_values = values_tmp;
+  for (int shift = 0; shift < 32; shift += cpu_radix_bits) {
+    auto histogram = [&](int b) {
+      int *counts = offsets[b];
+      for (int d = 0; d < cpu_radix_size; d++) {
+        counts[d] = 0;
+      }
+      for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+        counts[(cpu_radix_sort_key<T>(src_keys[i]) >> shift) &
+               (cpu_radix_size - 1)]++;
+      }
+    };
+    cpu_primitive_for_each_block(runtime, blocks, histogram);
+
+    // Turn the counts into the position of the first key of each (digit,
+    // block) pair, ordered by digit first.
+    int total = 0;
+    bool skip = false;
+    for (int d = 0; d < cpu_radix_size && !skip; d++) {
+      int digit_begin = total;
+      for (int b = 0; b < blocks.num_blocks; b++) {
+        int count = offsets[b][d];
+        offsets[b][d] = total;
+        total += count;
+      }
+      // All keys share this digit, so the pass would not move any of them.
+      skip = digit_begin == 0 && total == n;
+    }
+    if (skip)
+      continue;
+
+    auto scatter = [&](int b) {
+      int *positions = offsets[b];
+      for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+        u32 key = src_keys[i];
+        int pos = positions[(cpu_radix_sort_key<T>(key) >> shift) &
+                            (cpu_radix_size - 1)]++;
+        dst_keys[pos] = key;
+        if (src_values) {
+          dst_values[pos] = src_values[i];
+        }
+      }
+    };
+    cpu_primitive_for_each_block(runtime, blocks, scatter);
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+  }
+
+  if (src_keys != keys) {
+    auto copy_back = [&](int b) {
+      for (int i = blocks.begin(b); i < blocks.end(b); i++) {
+        keys[i] = src_keys[i];
+        if (src_values) {
+          values[i] = src_values[i];
+        }
+      }
+    };
+    cpu_primitive_for_each_block(runtime, blocks, copy_back);
+  }
+}
+
+extern "C" {
+
+// Entry points for the host, called through the runtime JIT module.
+
+void runtime_cpu_parallel_scan_add_i32(LLVMRuntime *runtime,
+                                       i32 *data,
+                                       int n,
+                                       int exclusive) {
+  cpu_parallel_scan_add(runtime, data, n, exclusive != 0);
+}
+
+void runtime_cpu_parallel_scan_add_f32(LLVMRuntime *runtime,
+                                       f32 *data,
+                                       int n,
+                                       int exclusive) {
+  cpu_parallel_scan_add(runtime, data, n, exclusive != 0);
+}
+
+void runtime_cpu_parallel_compact_32(LLVMRuntime *runtime,
+                                     u32 *out,
+                                     u32 *in,
+                                     i32 *flags,
+                                     int n) {
+  runtime->set_result(taichi_result_buffer_runtime_query_id,
+                      cpu_parallel_compact(runtime, out, in, flags, n));
+}
+
+#define DEFINE_RUNTIME_CPU_RADIX_SORT(T)                                     \
+  void runtime_cpu_parallel_radix_sort_##T(                                  \
+      LLVMRuntime *runtime, u32 *keys, u32 *values, u32 *keys_tmp,           \
+      u32 *values_tmp, int n) {                                              \
+    cpu_parallel_radix_sort<T>(runtime, keys, values, keys_tmp, values_tmp,  \
+                               n);                                           \
+  }
+
+DEFINE_RUNTIME_CPU_RADIX_SORT(u32)
+DEFINE_RUNTIME_CPU_RADIX_SORT(i32)
+DEFINE_RUNTIME_CPU_RADIX_SORT(f32)
+
+#undef DEFINE_RUNTIME_CPU_RADIX_SORT
+
+// Internal functions callable from the serial part of a kernel. Pointers are
+// passed as 64-bit integers, e.g. from ti.get_addr().
+
+i32 cpu_parallel_scan_add_i32(RuntimeContext *context,
+                              int64 data,
+                              int n,
+                              int exclusive) {
+  cpu_parallel_scan_add(context->runtime, (i32 *)data, n, exclusive != 0);
+  return 0;
+}
+
+i32 cpu_parallel_scan_add_f32(RuntimeContext *context,
+                              int64 data,
+                              int n,
+                              int exclusive) {
+  cpu_parallel_scan_add(context->runtime, (f32 *)data, n, exclusive != 0);
+  return 0;
+}
+
+i32 cpu_parallel_compact_32(RuntimeContext *context,
+                            int64 out,
+                            int64 in,
+                            int64 flags,
+                            int n) {
+  return cpu_parallel_compact(context->runtime, (u32 *)out, (const u32 *)in,
+                              (const i32 *)flags, n);
+}
+
+#define DEFINE_CPU_RADIX_SORT(T)                                             \
+  i32 cpu_parallel_radix_sort_##T(RuntimeContext *context, int64 keys,       \
+                                  int64 values, int64 keys_tmp,              \
+                                  int64 values_tmp, int n) {                 \
+    cpu_parallel_radix_sort<T>(context->runtime, (u32 *)keys, (u32 *)values, \
+                               (u32 *)keys_tmp, (u32 *)values_tmp, n);       \
+    return 0;                                                                \
+  }
+
+DEFINE_CPU_RADIX_SORT(u32)
+DEFINE_CPU_RADIX_SORT(i32)
+DEFINE_CPU_RADIX_SORT(f32)
+
+#undef DEFINE_CPU_RADIX_SORT
+}
@@ -41,6 +41,11 @@ using host_vsnprintf_type = int (*)(char *,
                                     std::va_list);
 using host_allocator_type = void *(*)(void *, std::size_t, std::size_t);
 using RangeForTaskFunc = void(RuntimeContext *, const char *tls, int i);
+// Runs the iterations [begin, end) of a range-for in a single call.
+using RangeForBlockTaskFunc = void(RuntimeContext *,
+                                   const char *tls,
+                                   int begin,
+                                   int end);
 using MeshForTaskFunc = void(RuntimeContext *, const char *tls, uint32_t i);
 using parallel_for_type = void (*)(void *thread_pool,
                                    int splits,
@@ -694,6 +699,15 @@ struct NodeManager {
     }
     recycled_list->clear();
   }
+
+  // Whether collecting now is worth it: the unused part of the free list is
+  // shorter than the list of nodes waiting to be recycled, so allocations are
+  // about to grow |data_list| instead of reusing nodes.
+  bool gc_pressure() {
+    auto num_recycled = recycled_list->size();
+    return num_recycled > 0 &&
+           free_list->size() - free_list_used < num_recycled;
+  }
 };
 
 extern "C" {
@@ -1428,6 +1442,13 @@ void parallel_struct_for(RuntimeContext *context,
     i += grid_dim();
   }
 #else
+  if (context->cpu_block_dim > 0 &&
+      element_size % context->cpu_block_dim == 0) {
+    element_split = element_size / context->cpu_block_dim;
+  }
+  if (context->cpu_num_threads > 0) {
+    num_threads = context->cpu_num_threads;
+  }
   cpu_block_task_helper_context ctx;
   ctx.context = context;
   ctx.task = task;
@@ -1449,7 +1470,7 @@ using mesh_for_xlogue = void (*)(RuntimeContext *,
 struct range_task_helper_context {
   RuntimeContext *context;
   range_for_xlogue prologue{nullptr};
-  RangeForTaskFunc *body{nullptr};
+  RangeForBlockTaskFunc *body{nullptr};
   range_for_xlogue epilogue{nullptr};
   std::size_t tls_size{1};
   int begin;
@@ -1469,18 +1490,16 @@ void cpu_parallel_range_for_task(void *range_context,
 
   RuntimeContext this_thread_context = *ctx.context;
   this_thread_context.cpu_thread_id = thread_id;
+  // The body iterates over the whole block itself (backwards if the loop is
+  // reversed), which keeps the loop visible to LLVM's vectorizers.
   if (ctx.step == 1) {
     int block_start = ctx.begin + task_id * ctx.block_size;
     int block_end = std::min(block_start + ctx.block_size, ctx.end);
-    for (int i = block_start; i < block_end; i++) {
-      ctx.body(&this_thread_context, tls_ptr, i);
-    }
+    ctx.body(&this_thread_context, tls_ptr, block_start, block_end);
   } else if (ctx.step == -1) {
-    int block_start = ctx.end - task_id * ctx.block_size;
-    int block_end = std::max(ctx.begin, block_start * ctx.block_size);
-    for (int i = block_start - 1; i >= block_end; i--) {
-      ctx.body(&this_thread_context, tls_ptr, i);
-    }
+    int block_end = ctx.end - task_id * ctx.block_size;
+    int block_start = std::max(ctx.begin, block_end - ctx.block_size);
+    ctx.body(&this_thread_context, tls_ptr, block_start, block_end);
   }
   if (ctx.epilogue)
     ctx.epilogue(ctx.context, tls_ptr);
@@ -1493,7 +1512,7 @@ void cpu_parallel_range_for(RuntimeContext *context,
                             int step,
                             int block_dim,
                             range_for_xlogue prologue,
-                            RangeForTaskFunc *body,
+                            RangeForBlockTaskFunc *body,
                             range_for_xlogue epilogue,
                             std::size_t tls_size) {
   range_task_helper_context ctx;
@@ -1509,6 +1528,12 @@ void cpu_parallel_range_for(RuntimeContext *context,
     taichi_printf(context->runtime, "step must not be %d\n", step);
     exit(-1);
   }
+  if (context->cpu_block_dim > 0) {
+    block_dim = context->cpu_block_dim;
+  }
+  if (context->cpu_num_threads > 0) {
+    num_threads = context->cpu_num_threads;
+  }
   ctx.block_size = block_dim;
   auto runtime = context->runtime;
   runtime->parallel_for(runtime->thread_pool,
@@ -1589,6 +1614,12 @@ void cpu_parallel_mesh_for(RuntimeContext *context,
   ctx.body = body;
   ctx.epilogue = epilogue;
   ctx.num_patches = num_patches;
+  if (context->cpu_block_dim > 0) {
+    block_dim = context->cpu_block_dim;
+  }
+  if (context->cpu_num_threads > 0) {
+    num_threads = context->cpu_num_threads;
+  }
   if (block_dim == 0) {
     // adaptive block dim
     // ensure each thread has at least ~32 tasks for load balancing
@@ -1761,6 +1792,108 @@ void gc_parallel_2(RuntimeContext *context, int snode_id) {
   LLVMRuntime *runtime = context->runtime;
   gc_parallel_impl_2(runtime->node_allocators[snode_id]);
 }
+
+// Zero-filling fewer bytes than this isn't worth waking up the thread pool.
+constexpr std::size_t cpu_parallel_gc_min_bytes = 256 * 1024;
+
+struct cpu_gc_helper_context {
+  NodeManager *allocator;
+  // The items of the free list to move in the compaction phase, or the
+  // recycled nodes to zero-fill in the second phase.
+  i32 num_items;
+  i32 block_size;
+  // Where the recycled nodes go in the free list.
+  i32 free_list_offset;
+};
+
+// The CPU counterpart of gc_parallel_impl_0, with each task moving a block of
+// items instead of each GPU thread moving a strided subset.
+void cpu_gc_compact_task(void *gc_context, int thread_id, int task_id) {
+  auto ctx = (cpu_gc_helper_context *)gc_context;
+  auto free_list = ctx->allocator->free_list;
+  auto free_list_size = free_list->size();
+  auto free_list_used = ctx->allocator->free_list_used;
+  using T = NodeManager::list_data_type;
+  // The same non-overlapping moves as gc_parallel_impl_0.
+  auto src = free_list_used * 2 > free_list_size
+                 ? free_list_used
+                 : free_list_size - free_list_used;
+  int begin = task_id * ctx->block_size;
+  int end = std::min(begin + ctx->block_size, ctx->num_items);
+  for (int i = begin; i < end; i++) {
+    free_list->get<T>(i) = free_list->get<T>(src + i);
+  }
+}
+
+// The CPU counterpart of gc_parallel_impl_2. The free list is already sized
+// for the recycled nodes, so each of them goes to a fixed slot instead of
+// being appended.
+void cpu_gc_zero_fill_task(void *gc_context, int thread_id, int task_id) {
+  auto ctx = (cpu_gc_helper_context *)gc_context;
+  auto allocator = ctx->allocator;
+  auto free_list = allocator->free_list;
+  auto recycled_list = allocator->recycled_list;
+  auto data_list = allocator->data_list;
+  using T = NodeManager::list_data_type;
+  int begin = task_id * ctx->block_size;
+  int end = std::min(begin + ctx->block_size, ctx->num_items);
+  for (int i = begin; i < end; i++) {
+    auto idx = recycled_list->get<T>(i);
+    std::memset(data_list->get_element_ptr(idx), 0, allocator->element_size);
+    free_list->get<T>(ctx->free_list_offset + i) = idx;
+  }
+}
+
+void cpu_parallel_gc(RuntimeContext *context,
+                     int snode_id,
+                     int num_threads,
+                     bool deferred) {
+  auto runtime = context->runtime;
+  auto allocator = runtime->node_allocators[snode_id];
+  if (deferred ? !allocator->gc_pressure()
+               : allocator->recycled_list->size() == 0) {
+    return;
+  }
+  auto num_recycled = allocator->recycled_list->size();
+  if ((std::size_t)num_recycled * allocator->element_size <
+          cpu_parallel_gc_min_bytes ||
+      num_threads <= 1) {
+    allocator->gc_serial();
+    return;
+  }
+  auto parallel_for = [&](cpu_gc_helper_context &ctx,
+                          void (*task)(void *, int, int)) {
+    if (ctx.num_items > 0) {
+      ctx.block_size = (ctx.num_items + num_threads - 1) / num_threads;
+      runtime->parallel_for(runtime->thread_pool,
+                            (ctx.num_items + ctx.block_size - 1) /
+                                ctx.block_size,
+                            num_threads, &ctx, task);
+    }
+  };
+  auto free_list = allocator->free_list;
+  const i32 num_unused =
+      max_i32(free_list->size() - allocator->free_list_used, 0);
+
+  cpu_gc_helper_context ctx;
+  ctx.allocator = allocator;
+  ctx.free_list_offset = num_unused;
+  ctx.num_items = std::min(num_unused, allocator->free_list_used);
+  parallel_for(ctx, cpu_gc_compact_task);
+
+  gc_parallel_impl_1(allocator);
+
+  // Touch the chunks of the free list the recycled nodes go to, so that the
+  // tasks don't contend for its lock.
+  auto log2chunk = free_list->log2chunk_num_elements;
+  for (int i = num_unused >> log2chunk;
+       i <= (num_unused + num_recycled - 1) >> log2chunk; i++) {
+    free_list->touch_chunk(i);
+  }
+  ctx.num_items = num_recycled;
+  parallel_for(ctx, cpu_gc_zero_fill_task);
+  free_list->resize(num_unused + num_recycled);
+}
 }
 
 extern "C" {
@@ -1803,8 +1936,92 @@ i32 rand_i32(RuntimeContext *context) {
 i64 rand_i64(RuntimeContext *context) {
   return rand_u64(context);
 }
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"). Each output is a pure function of the key and the counter, so there is
+// no state to load or store, and calls in different iterations of a loop can
+// be vectorized.
+void philox4x32_10(u32 counter[4], u32 key[2]) {
+  for (int round = 0; round < 10; round++) {
+    u64 product0 = (u64)0xD2511F53 * counter[0];
+    u64 product1 = (u64)0xCD9E8D57 * counter[2];
+    u32 c0 = (u32)(product1 >> 32) ^ counter[1] ^ key[0];
+    u32 c2 = (u32)(product0 >> 32) ^ counter[3] ^ key[1];
+    counter[0] = c0;
+    counter[1] = (u32)product1;
+    counter[2] = c2;
+    counter[3] = (u32)product0;
+    key[0] += 0x9E3779B9;
+    key[1] += 0xBB67AE85;
+  }
+}
+
+// Draws the first two words of the block at (|index|, |stream|, |counter|)
+// under the key (|seed|, launch id).
+u64 philox_rand(RuntimeContext *context,
+                i32 seed,
+                i32 index,
+                i32 stream,
+                u32 counter) {
+  u32 c[4] = {(u32)index, (u32)stream, counter, 0};
+  u32 key[2] = {(u32)seed, context->rand_launch_id};
+  philox4x32_10(c, key);
+  return ((u64)c[0] << 32) | c[1];
+}
+
+u32 philox_rand_u32(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return (u32)philox_rand(context, seed, index, stream, counter);
+}
+
+u64 philox_rand_u64(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return philox_rand(context, seed, index, stream, counter);
+}
+
+f32 philox_rand_f32(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return (philox_rand_u32(context, seed, index, stream, counter) >> 8) *
+         (1.0f / 16777216.0f);
+}
+
+f64 philox_rand_f64(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return (philox_rand_u64(context, seed, index, stream, counter) >> 11) *
+         (1.0 / 9007199254740992.0);
+}
+
+i32 philox_rand_i32(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return philox_rand_u32(context, seed, index, stream, counter);
+}
+
+i64 philox_rand_i64(RuntimeContext *context,
+                    i32 seed,
+                    i32 index,
+                    i32 stream,
+                    u32 counter) {
+  return philox_rand_u64(context, seed, index, stream, counter);
+}
 };
 
+#include "parallel_primitives.h"
+
 struct printf_helper {
   char buffer[1024];
   int tail;
@@ -1,4 +1,5 @@
 #include "snode_tree_buffer_manager.h"
+#include "taichi/rhi/common/host_memory_pool.h"
 #include "taichi/runtime/llvm/llvm_runtime_executor.h"
 
 namespace taichi::lang {
@@ -12,15 +13,41 @@ SNodeTreeBufferManager::SNodeTreeBufferManager(
 Ptr SNodeTreeBufferManager::allocate(std::size_t size,
                                      const int snode_tree_id,
                                      uint64 *result_buffer) {
-  auto devalloc = runtime_exec_->allocate_memory_ndarray(size, result_buffer);
+  DeviceAllocation devalloc;
+  auto cached = cached_buffers_.find(size);
+  if (cached != cached_buffers_.end()) {
+    devalloc = cached->second;
+    cached_buffers_.erase(cached);
+  } else {
+    devalloc = runtime_exec_->allocate_memory_ndarray(size, result_buffer);
+  }
   snode_tree_id_to_device_alloc_[snode_tree_id] = devalloc;
+  snode_tree_id_to_size_[snode_tree_id] = size;
   return (Ptr)runtime_exec_->get_ndarray_alloc_info_ptr(devalloc);
 }
 
 void SNodeTreeBufferManager::destroy(SNodeTree *snode_tree) {
   auto devalloc = snode_tree_id_to_device_alloc_[snode_tree->id()];
-  runtime_exec_->deallocate_memory_ndarray(devalloc);
+  auto size = snode_tree_id_to_size_[snode_tree->id()];
+  if (arch_is_cpu(runtime_exec_->get_config().arch) &&
+      cached_buffers_.size() < kMaxCachedBuffers) {
+    // Cheaper than unmapping the buffer, and leaves it zeroed for the next
+    // tree of the same size.
+    HostMemoryPool::get_instance().discard_pages(
+        runtime_exec_->get_ndarray_alloc_info_ptr(devalloc), size);
+    cached_buffers_.emplace(size, devalloc);
+  } else {
+    runtime_exec_->deallocate_memory_ndarray(devalloc);
+  }
   snode_tree_id_to_device_alloc_.erase(snode_tree->id());
+  snode_tree_id_to_size_.erase(snode_tree->id());
+}
+
+void SNodeTreeBufferManager::clear_cache() {
+  for (auto &[size, devalloc] : cached_buffers_) {
+    runtime_exec_->deallocate_memory_ndarray(devalloc);
+  }
+  cached_buffers_.clear();
 }
 
 }  // namespace taichi::lang
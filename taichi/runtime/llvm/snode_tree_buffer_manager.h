@@ -17,15 +17,28 @@ class SNodeTreeBufferManager {
  public:
   explicit SNodeTreeBufferManager(LlvmRuntimeExecutor *runtime_exec);
 
+  // On CPU, the returned buffer is already zero-initialized: it consists of
+  // fresh pages from the OS, or of a destroyed tree's pages that have been
+  // discarded. Other archs have to clear it.
   Ptr allocate(std::size_t size,
                const int snode_tree_id,
                uint64 *result_buffer);
 
   void destroy(SNodeTree *snode_tree);
 
+  // Frees the buffers kept for reuse.
+  void clear_cache();
+
  private:
+  // Buffers of destroyed trees are kept at most this many at a time.
+  static constexpr std::size_t kMaxCachedBuffers = 16;
+
   LlvmRuntimeExecutor *runtime_exec_;
   std::map<int, DeviceAllocation> snode_tree_id_to_device_alloc_;
+  std::map<int, std::size_t> snode_tree_id_to_size_;
+  // CPU only: buffers of destroyed trees by size. Their pages have been
+  // returned to the OS, so they read as zeros.
+  std::multimap<std::size_t, DeviceAllocation> cached_buffers_;
 };
 
 }  // namespace taichi::lang
@@ -121,6 +121,15 @@ class LlvmProgramImpl : public ProgramImpl {
     return runtime_exec_->fill_ndarray(alloc, size, data);
   }
 
+  void run_concurrently(
+      const std::vector<std::function<void()>> &tasks) override {
+    runtime_exec_->run_concurrently(tasks);
+  }
+
+  uint32 reserve_rand_launch_ids(uint32 n) override {
+    return runtime_exec_->reserve_rand_launch_ids(n);
+  }
+
   DeviceAllocation allocate_memory_ndarray(std::size_t alloc_size,
                                            uint64 *result_buffer) override {
     return runtime_exec_->allocate_memory_ndarray(alloc_size, result_buffer);
@@ -206,6 +215,10 @@ class LlvmProgramImpl : public ProgramImpl {
     return runtime_exec_->get_snode_tree_device_ptr(tree_id);
   }
 
+  DeviceAllocation import_memory(void *ptr, std::size_t size) override {
+    return llvm_device()->import_memory(ptr, size);
+  }
+
   LlvmDevice *llvm_device() {
     return runtime_exec_->llvm_device();
   }
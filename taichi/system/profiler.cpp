@@ -213,7 +213,8 @@ void ProfilerRecords::print(ProfilerRecordNode *node, int depth) {
   }
 }
 
-ScopedProfiler::ScopedProfiler(std::string name, uint64 elements) {
+ScopedProfiler::ScopedProfiler(std::string name, uint64 elements)
+    : timeline_guard_(name) {
   start_time_ = Time::get_time();
   this->name_ = name;
   this->elements_ = elements;
@@ -231,6 +232,7 @@ void ScopedProfiler::stop() {
     ProfilerRecords::get_this_thread_instance().insert_sample(elapsed);
   }
   ProfilerRecords::get_this_thread_instance().pop();
+  timeline_guard_.stop();
 }
 
 void ScopedProfiler::disable() {
@@ -12,6 +12,7 @@
 #include <thread>
 
 #include "taichi/common/core.h"
+#include "taichi/system/timeline.h"
 #include "taichi/system/timer.h"
 
 namespace taichi {
@@ -19,7 +20,7 @@ namespace taichi {
 class ProfilerRecords;
 
 // Captures running time between the construction and destruction of the
-// profiler instance
+// profiler instance, which is also recorded on the timeline if enabled
 class ScopedProfiler {
  public:
   explicit ScopedProfiler(std::string name, uint64 elements = -1);
@@ -37,6 +38,7 @@ class ScopedProfiler {
   float64 start_time_;
   uint64 elements_;
   bool stopped_;
+  Timeline::Guard timeline_guard_;
 };
 
 // A profiling system for multithreaded applications
@@ -4,14 +4,199 @@
 *******************************************************************************/
 
 #include "taichi/system/threading.h"
+#include "taichi/system/timeline.h"
 
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include <thread>
 #include <vector>
 
+#if defined(TI_PLATFORM_WINDOWS)
+#include "taichi/platform/windows/windows.h"
+#elif defined(TI_PLATFORM_LINUX) || defined(TI_PLATFORM_ANDROID)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace taichi {
 
+namespace {
+// The pool owning the current thread (if it is a worker) and the worker id.
+// A task that calls back into its own pool, e.g. a kernel launched as one of
+// the concurrent dispatches of a compute graph, starts a nested run.
+thread_local ThreadPool *current_pool = nullptr;
+thread_local int current_thread_id = -1;
+
+constexpr std::size_t parallel_memory_page_size = 4096;
+// Below this many bytes per thread, waking up the workers costs more than the
+// memory operation itself.
+constexpr std::size_t parallel_memory_min_bytes_per_thread = 1 << 20;
+
+struct PageRangesContext {
+  const std::vector<std::size_t> *bounds;
+  const std::function<void(std::size_t, std::size_t)> *func;
+};
+
+bool is_decimal(const std::string &s) {
+  return !s.empty() && s.size() <= 6 &&
+         std::all_of(s.begin(), s.end(),
+                     [](char c) { return '0' <= c && c <= '9'; });
+}
+
+// Parses a list of CPUs in the format of Linux's cpulist, e.g. "0-3,8,10-11".
+bool parse_cpu_list(const std::string &list, std::vector<int> &cpus) {
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    range = trim_string(range);
+    auto dash = range.find('-');
+    std::string first = range.substr(0, dash);
+    std::string last =
+        dash == std::string::npos ? first : range.substr(dash + 1);
+    if (!is_decimal(first) || !is_decimal(last)) {
+      return false;
+    }
+    int begin = std::stoi(first);
+    int end = std::stoi(last);
+    if (begin > end) {
+      return false;
+    }
+    for (int cpu = begin; cpu <= end; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return !cpus.empty();
+}
+
+// Returns the logical CPUs this process may run on, grouped by NUMA node.
+// Without NUMA information, all CPUs are in a single node.
+std::vector<std::vector<int>> get_numa_nodes() {
+  std::vector<int> allowed;
+#if defined(TI_PLATFORM_LINUX) || defined(TI_PLATFORM_ANDROID)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        allowed.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (allowed.empty()) {
+    for (int cpu = 0; cpu < (int)std::thread::hardware_concurrency(); cpu++) {
+      allowed.push_back(cpu);
+    }
+  }
+
+  std::vector<std::vector<int>> nodes;
+#if defined(TI_PLATFORM_LINUX) || defined(TI_PLATFORM_ANDROID)
+  auto read_line = [](const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+  };
+  std::vector<int> node_ids;
+  if (parse_cpu_list(read_line("/sys/devices/system/node/online"),
+                     node_ids)) {
+    for (int id : node_ids) {
+      std::vector<int> node_cpus, node;
+      parse_cpu_list(read_line(fmt::format(
+                         "/sys/devices/system/node/node{}/cpulist", id)),
+                     node_cpus);
+      for (int cpu : node_cpus) {
+        if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+          node.push_back(cpu);
+        }
+      }
+      if (!node.empty()) {
+        nodes.push_back(std::move(node));
+      }
+    }
+  }
+#endif
+  if (nodes.empty()) {
+    nodes.push_back(std::move(allowed));
+  }
+  return nodes;
+}
+
+void pin_current_thread(int cpu) {
+#if defined(TI_PLATFORM_LINUX) || defined(TI_PLATFORM_ANDROID)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    TI_WARN("Failed to pin a CPU thread pool worker to CPU {}", cpu);
+  }
+#elif defined(TI_PLATFORM_WINDOWS)
+  if (cpu >= 64 ||
+      SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) == 0) {
+    TI_WARN("Failed to pin a CPU thread pool worker to CPU {}", cpu);
+  }
+#endif
+}
+
+int get_os_thread_id() {
+#if defined(TI_PLATFORM_LINUX) || defined(TI_PLATFORM_ANDROID)
+  return (int)syscall(SYS_gettid);
+#else
+  return -1;
+#endif
+}
+}  // namespace
+
+std::vector<int> get_thread_affinity(const std::string &policy,
+                                     int num_threads) {
+  if (policy.empty() || policy == "none") {
+    return {};
+  }
+#if defined(TI_PLATFORM_OSX)
+  TI_WARN("Thread affinity \"{}\" ignored: not supported on macOS", policy);
+  return {};
+#else
+  std::vector<int> cpus;
+  if (policy == "compact" || policy == "scatter") {
+    auto nodes = get_numa_nodes();
+    if (policy == "compact") {
+      for (const auto &node : nodes) {
+        cpus.insert(cpus.end(), node.begin(), node.end());
+      }
+    } else {
+      std::size_t max_node_size = 0;
+      for (const auto &node : nodes) {
+        max_node_size = std::max(max_node_size, node.size());
+      }
+      for (std::size_t i = 0; i < max_node_size; i++) {
+        for (const auto &node : nodes) {
+          if (i < node.size()) {
+            cpus.push_back(node[i]);
+          }
+        }
+      }
+    }
+  } else {
+    TI_ERROR_IF(!parse_cpu_list(policy, cpus),
+                "Invalid thread affinity \"{}\": expected \"none\", "
+                "\"compact\", \"scatter\" or a list of CPUs such as "
+                "\"0-3,8\"",
+                policy);
+  }
+  std::vector<int> affinity(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    affinity[i] = cpus[i % cpus.size()];
+  }
+  return affinity;
+#endif
+}
+
 bool test_threading() {
   auto tp = ThreadPool(20);
   for (int j = 0; j < 100; j++) {
@@ -26,7 +211,8 @@ bool test_threading() {
   return true;
 }
 
-ThreadPool::ThreadPool(int max_num_threads) : max_num_threads(max_num_threads) {
+ThreadPool::ThreadPool(int max_num_threads, std::vector<int> cpu_affinity)
+    : max_num_threads(max_num_threads), cpu_affinity(std::move(cpu_affinity)) {
   exiting = false;
   started = false;
   running_threads = 0;
@@ -34,17 +220,37 @@ ThreadPool::ThreadPool(int max_num_threads) : max_num_threads(max_num_threads) {
   last_finished = 0;
   task_head = 0;
   task_tail = 0;
+  desired_num_threads = 0;
   thread_counter = 0;
+  if (!this->cpu_affinity.empty()) {
+    worker_task_heads = std::make_unique<std::atomic<int>[]>(max_num_threads);
+  }
+  worker_os_thread_ids.resize((std::size_t)max_num_threads, -1);
+  worker_busy_ns = std::make_unique<std::atomic<uint64>[]>(max_num_threads);
+  for (int i = 0; i < max_num_threads; i++) {
+    worker_busy_ns[i] = 0;
+  }
   threads.resize((std::size_t)max_num_threads);
   for (int i = 0; i < max_num_threads; i++) {
     threads[i] = std::thread([this] { this->target(); });
   }
+  // Wait for the workers to register their ids.
+  std::unique_lock<std::mutex> lock(mutex);
+  master_cv.wait(lock,
+                 [this] { return thread_counter == this->max_num_threads; });
 }
 
 void ThreadPool::run(int splits,
                      int desired_num_threads,
                      void *range_for_task_context,
                      RangeForTaskFunc *func) {
+  if (current_pool == this) {
+    run_nested(splits, range_for_task_context, func);
+    return;
+  }
+  static const uint32 timeline_name =
+      Timelines::get_instance().intern("ThreadPool::run");
+  Timeline::Guard _timeline_guard(timeline_name);
   {
     std::lock_guard _(mutex);
     this->range_for_task_context = range_for_task_context;
@@ -55,6 +261,11 @@ void ThreadPool::run(int splits,
     started = false;
     task_head = 0;
     task_tail = splits;
+    if (worker_task_heads) {
+      for (int i = 0; i < this->desired_num_threads; i++) {
+        worker_task_heads[i] = (int64)splits * i / this->desired_num_threads;
+      }
+    }
     timestamp++;
     TI_ASSERT(timestamp < (1LL << 62));  // avoid overflowing here
   }
@@ -66,7 +277,90 @@ void ThreadPool::run(int splits,
     // TODO: the workers may have finished before master waiting on master_cv
     master_cv.wait(lock, [this] { return started && running_threads == 0; });
   }
-  TI_ASSERT(task_head >= task_tail);
+  TI_ASSERT(worker_task_heads || task_head >= task_tail);
+}
+
+void ThreadPool::run_nested(int splits,
+                            void *range_for_task_context,
+                            RangeForTaskFunc *func) {
+  NestedRun nested;
+  nested.func = func;
+  nested.range_for_task_context = range_for_task_context;
+  nested.splits = splits;
+  {
+    std::lock_guard<std::mutex> _(nested_mutex);
+    nested_runs.push_back(&nested);
+  }
+  nested_cv.notify_all();
+  while (true) {
+    int split = nested.next_split.fetch_add(1, std::memory_order_relaxed);
+    if (split >= splits)
+      break;
+    run_nested_split(nested, current_thread_id, split);
+  }
+  // The helpers may still be running the last splits they claimed.
+  std::unique_lock<std::mutex> lock(nested_mutex);
+  nested_runs.erase(std::find(nested_runs.begin(), nested_runs.end(), &nested));
+  nested_cv.wait(lock, [&] { return nested.finished_splits == splits; });
+}
+
+void ThreadPool::run_nested_split(NestedRun &nested, int thread_id, int split) {
+  nested.func(nested.range_for_task_context, thread_id, split);
+  if (nested.finished_splits.fetch_add(1) + 1 == nested.splits) {
+    // |nested| may be destroyed as soon as the lock is released.
+    std::lock_guard<std::mutex> _(nested_mutex);
+    nested_cv.notify_all();
+  }
+}
+
+void ThreadPool::help_nested_runs(int thread_id) {
+  // Nested runs are only started by the workers still running splits of the
+  // outer run, so there is nothing left to help with once they are done.
+  std::unique_lock<std::mutex> lock(nested_mutex);
+  num_outer_workers--;
+  if (num_outer_workers == 0) {
+    nested_cv.notify_all();
+  }
+  while (true) {
+    NestedRun *nested = nullptr;
+    nested_cv.wait(lock, [&] {
+      for (auto *run : nested_runs) {
+        if (run->next_split < run->splits) {
+          nested = run;
+          return true;
+        }
+      }
+      return num_outer_workers == 0;
+    });
+    if (!nested) {
+      break;
+    }
+    int split = nested->next_split.fetch_add(1, std::memory_order_relaxed);
+    if (split >= nested->splits) {
+      continue;
+    }
+    lock.unlock();
+    run_nested_split(*nested, thread_id, split);
+    lock.lock();
+  }
+}
+
+void ThreadPool::run_worker_ranges(int thread_id) {
+  // Each worker first runs its own range of splits, so that a loop launched
+  // repeatedly over the same index range keeps every block on the same core,
+  // then helps with the ranges of the workers that haven't finished yet.
+  int num_ranges = desired_num_threads;
+  for (int i = 0; i < num_ranges; i++) {
+    int range = (thread_id + i) % num_ranges;
+    int range_end = (int64)task_tail * (range + 1) / num_ranges;
+    while (true) {
+      int task_id =
+          worker_task_heads[range].fetch_add(1, std::memory_order_relaxed);
+      if (task_id >= range_end)
+        break;
+      func(this->range_for_task_context, thread_id, task_id);
+    }
+  }
 }
 
 void ThreadPool::target() {
@@ -75,6 +369,17 @@ void ThreadPool::target() {
   {
     std::lock_guard<std::mutex> lock(mutex);
     thread_id = thread_counter++;
+    worker_os_thread_ids[thread_id] = get_os_thread_id();
+  }
+  master_cv.notify_all();
+  current_pool = this;
+  current_thread_id = thread_id;
+  Timeline::get_this_thread_instance().set_name(
+      fmt::format("thread_pool_{}", thread_id));
+  const uint32 timeline_name =
+      Timelines::get_instance().intern("ThreadPool::target");
+  if (!cpu_affinity.empty()) {
+    pin_current_thread(cpu_affinity[thread_id % cpu_affinity.size()]);
   }
   while (true) {
     {
@@ -100,17 +405,34 @@ void ThreadPool::target() {
       }
     }
 
-    while (true) {
-      // For a single parallel task
-      int task_id;
-      {
-        task_id = task_head.fetch_add(1, std::memory_order_relaxed);
-        if (task_id >= task_tail)
-          break;
-      }
+    {
+      std::lock_guard<std::mutex> _(nested_mutex);
+      num_outer_workers++;
+    }
+    Timeline::Guard timeline_guard(timeline_name);
+    auto begin = std::chrono::steady_clock::now();
+    if (worker_task_heads) {
+      run_worker_ranges(thread_id);
+    } else {
+      while (true) {
+        // For a single parallel task
+        int task_id;
+        {
+          task_id = task_head.fetch_add(1, std::memory_order_relaxed);
+          if (task_id >= task_tail)
+            break;
+        }
 
-      func(this->range_for_task_context, thread_id, task_id);
+        func(this->range_for_task_context, thread_id, task_id);
+      }
     }
+    worker_busy_ns[thread_id].fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin)
+            .count(),
+        std::memory_order_relaxed);
+    timeline_guard.stop();
+    help_nested_runs(thread_id);
 
     bool all_finished = false;
     {
@@ -126,6 +448,68 @@ void ThreadPool::target() {
   }
 }
 
+void ThreadPool::run_on_pages(
+    void *ptr,
+    std::size_t size,
+    const std::function<void(std::size_t, std::size_t)> &func) {
+  std::size_t num_ranges = std::min<std::size_t>(
+      max_num_threads, size / parallel_memory_min_bytes_per_thread);
+  if (num_ranges <= 1) {
+    func(0, size);
+    return;
+  }
+  // Boundaries are rounded up to the next page of the actual addresses, so
+  // that no page is shared by two ranges.
+  auto base = reinterpret_cast<std::uintptr_t>(ptr);
+  std::size_t range_size = (size + num_ranges - 1) / num_ranges;
+  std::vector<std::size_t> bounds(num_ranges + 1);
+  for (std::size_t i = 1; i < num_ranges; i++) {
+    std::uintptr_t end = base + i * range_size;
+    end = (end + parallel_memory_page_size - 1) / parallel_memory_page_size *
+          parallel_memory_page_size;
+    bounds[i] = std::min<std::size_t>(size, end - base);
+  }
+  bounds[0] = 0;
+  bounds[num_ranges] = size;
+
+  PageRangesContext ctx{&bounds, &func};
+  run((int)num_ranges, (int)num_ranges, &ctx,
+      [](void *ctx, int _thread_id, int i) {
+        auto *context = (PageRangesContext *)ctx;
+        std::size_t begin = (*context->bounds)[i];
+        std::size_t end = (*context->bounds)[i + 1];
+        if (begin < end) {
+          (*context->func)(begin, end);
+        }
+      });
+}
+
+void ThreadPool::parallel_memset(void *ptr, uint8 value, std::size_t size) {
+  run_on_pages(ptr, size, [&](std::size_t begin, std::size_t end) {
+    std::memset((char *)ptr + begin, value, end - begin);
+  });
+}
+
+void ThreadPool::parallel_fill_u32(uint32 *ptr,
+                                   uint32 value,
+                                   std::size_t count) {
+  run_on_pages(ptr, count * sizeof(uint32),
+               [&](std::size_t begin, std::size_t end) {
+                 std::fill(ptr + begin / sizeof(uint32),
+                           ptr + end / sizeof(uint32), value);
+               });
+}
+
+void ThreadPool::parallel_memcpy(void *dst,
+                                 const void *src,
+                                 std::size_t size) {
+  // The ranges follow the pages of the destination, which is what gets
+  // first-touched.
+  run_on_pages(dst, size, [&](std::size_t begin, std::size_t end) {
+    std::memcpy((char *)dst + begin, (const char *)src + begin, end - begin);
+  });
+}
+
 ThreadPool::~ThreadPool() {
   {
     std::lock_guard<std::mutex> lg(mutex);
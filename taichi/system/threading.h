@@ -10,7 +10,10 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace taichi {
 
@@ -38,8 +41,38 @@ class ThreadPool {
                                  // LLVM runtime, which is different from
                                  // taichi::lang::Context.
   int thread_counter;
+  // The logical CPU each worker is pinned to, or empty if the workers are not
+  // pinned. See get_thread_affinity().
+  std::vector<int> cpu_affinity;
+  // When the workers are pinned, the splits of a run are divided into one
+  // contiguous range per worker, and |worker_task_heads[i]| is the next split
+  // to run in the range of worker i.
+  std::unique_ptr<std::atomic<int>[]> worker_task_heads;
+  // The OS thread id of each worker on Linux, for attaching per-thread
+  // performance counters, or -1 on other platforms.
+  std::vector<int> worker_os_thread_ids;
+  // The total time each worker has spent running splits, in nanoseconds.
+  std::unique_ptr<std::atomic<uint64>[]> worker_busy_ns;
 
-  explicit ThreadPool(int max_num_threads);
+  // A run started from a split of another run of the same pool, e.g. by a
+  // kernel launched concurrently with others. Its splits are run by the
+  // worker that started it and by the workers that have finished their part
+  // of the outer run.
+  struct NestedRun {
+    RangeForTaskFunc *func;
+    void *range_for_task_context;
+    int splits;
+    // Only claimed under |nested_mutex| by the helping workers.
+    std::atomic<int> next_split{0};
+    std::atomic<int> finished_splits{0};
+  };
+  std::mutex nested_mutex;
+  std::condition_variable nested_cv;
+  std::vector<NestedRun *> nested_runs;
+  // The number of workers running splits of the current outer run.
+  int num_outer_workers{0};
+
+  explicit ThreadPool(int max_num_threads, std::vector<int> cpu_affinity = {});
 
   void run(int splits,
            int desired_num_threads,
@@ -54,9 +87,41 @@ class ThreadPool {
     return pool->run(splits, desired_num_threads, range_for_task_context, func);
   }
 
+  // Memory routines for large host buffers. The buffer is split into at most
+  // |max_num_threads| page-aligned ranges, one per split, so that pages
+  // touched for the first time are placed on the NUMA node of the worker that
+  // processes their range. Small buffers are handled on the calling thread.
+  void parallel_memset(void *ptr, uint8 value, std::size_t size);
+  void parallel_fill_u32(uint32 *ptr, uint32 value, std::size_t count);
+  void parallel_memcpy(void *dst, const void *src, std::size_t size);
+
+  // Calls |func(begin, end)| on the pool for the page-aligned byte ranges
+  // partitioning the |size| bytes starting at |ptr|.
+  void run_on_pages(void *ptr,
+                    std::size_t size,
+                    const std::function<void(std::size_t, std::size_t)> &func);
+
   void target();
 
   ~ThreadPool();
+
+ private:
+  void run_worker_ranges(int thread_id);
+  void run_nested(int splits,
+                  void *range_for_task_context,
+                  RangeForTaskFunc *func);
+  void run_nested_split(NestedRun &nested, int thread_id, int split);
+  void help_nested_runs(int thread_id);
 };
 
+// Returns the logical CPU to pin each thread of a pool of |num_threads|
+// threads to under |policy|, or an empty list if they shouldn't be pinned:
+//  - "none": the threads are not pinned.
+//  - "compact": consecutive threads fill a NUMA node before the next one.
+//  - "scatter": consecutive threads are placed on alternating NUMA nodes.
+//  - a list of CPUs such as "0-7,16-23", assigned to the threads in order.
+// If there are more threads than CPUs, the threads wrap around the CPUs.
+std::vector<int> get_thread_affinity(const std::string &policy,
+                                     int num_threads);
+
 }  // namespace taichi
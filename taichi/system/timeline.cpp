@@ -1,21 +1,43 @@
 #include "taichi/system/timeline.h"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define TI_TIMELINE_USE_TSC
+#endif
+
 namespace taichi {
 
-std::string TimelineEvent::to_json() {
-  std::string json{"{"};
-  json += fmt::format("\"cat\":\"taichi\",");
-  json += fmt::format("\"pid\":0,");
-  json += fmt::format("\"tid\":\"{}\",", tid);
-  json += fmt::format("\"ph\":\"{}\",", begin ? "B" : "E");
-  json += fmt::format("\"name\":\"{}\",", name);
-  json += fmt::format("\"ts\":\"{}\"", uint64(time * 1000000));
-  json += "}";
-  return json;
+namespace {
+
+std::string escape_json(const std::string &s) {
+  std::string escaped;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if ((unsigned char)c < 0x20) {
+      escaped += fmt::format("\\u{:04x}", (int)c);
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
 }
 
-Timeline::Timeline() : tid_("unnamed") {
-  Timelines::get_instance().insert_timeline(this);
+}  // namespace
+
+Timeline::Timeline() {
+  auto &timelines = Timelines::get_instance();
+  timelines.insert_timeline(this);
+  track_ = intern(name_);
 }
 
 Timeline &Timeline::get_this_thread_instance() {
@@ -24,46 +46,98 @@ Timeline &Timeline::get_this_thread_instance() {
 }
 
 Timeline::~Timeline() {
-  Timelines::get_instance().insert_events(fetch_events());
   Timelines::get_instance().remove_timeline(this);
 }
 
-void Timeline::clear() {
-  std::lock_guard<std::mutex> _(mut_);
-  events_.clear();
+uint64 Timeline::now() {
+#if defined(TI_TIMELINE_USE_TSC)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+void Timeline::set_name(const std::string &name) {
+  name_ = name;
+  track_ = intern(name);
+}
+
+uint32 Timeline::intern(const std::string &name) {
+  auto it = name_ids_.find(name);
+  if (it != name_ids_.end()) {
+    return it->second;
+  }
+  auto id = Timelines::get_instance().intern(name);
+  name_ids_[name] = id;
+  return id;
 }
-void Timeline::insert_event(const TimelineEvent &e) {
+
+void Timeline::insert_event(uint32 name, bool begin) {
   if (!Timelines::get_instance().get_enabled())
     return;
-  std::lock_guard<std::mutex> _(mut_);
-  events_.push_back(e);
+  push({now(), name, track_, begin});
 }
 
-std::vector<TimelineEvent> Timeline::fetch_events() {
-  std::lock_guard<std::mutex> _(mut_);
-  std::vector<TimelineEvent> fetched;
-  std::swap(fetched, events_);
-  return fetched;
+void Timeline::insert_event(const std::string &name,
+                            bool begin,
+                            float64 time,
+                            const std::string &track) {
+  auto &timelines = Timelines::get_instance();
+  if (!timelines.get_enabled())
+    return;
+  auto ticks = (int64)timelines.base_ticks_ +
+               (int64)((time - timelines.base_time_) /
+                       timelines.seconds_per_tick());
+  push({(uint64)std::max<int64>(ticks, 0), intern(name), intern(track),
+        begin});
+}
+
+void Timeline::new_chunk() {
+  auto chunk = new Chunk;
+  auto &timelines = Timelines::get_instance();
+  std::lock_guard<std::mutex> _(timelines.mut_);
+  if (current_) {
+    timelines.chunks_.emplace_back(current_);
+  }
+  current_ = chunk;
 }
 
-Timeline::Guard::Guard(const std::string &name) : name_(name) {
-  auto &timeline = Timeline::get_this_thread_instance();
-  timeline.insert_event({name, true, Time::get_time(), timeline.tid_});
+Timeline::Guard::Guard(const std::string &name) {
+  if (Timelines::get_instance().get_enabled()) {
+    auto &timeline = Timeline::get_this_thread_instance();
+    name_ = timeline.intern(name);
+    active_ = true;
+    timeline.push({now(), name_, timeline.track_, true});
+  }
 }
 
-Timeline::Guard::~Guard() {
-  auto &timeline = Timeline::get_this_thread_instance();
-  timeline.insert_event({name_, false, Time::get_time(), timeline.tid_});
+Timeline::Guard::Guard(uint32 name) : name_(name) {
+  if (Timelines::get_instance().get_enabled()) {
+    auto &timeline = Timeline::get_this_thread_instance();
+    active_ = true;
+    timeline.push({now(), name_, timeline.track_, true});
+  }
 }
 
-void Timelines::insert_events(const std::vector<TimelineEvent> &events) {
-  std::lock_guard<std::mutex> _(mut_);
-  insert_events_without_locking(events);
+void Timeline::Guard::stop() {
+  // Always ends an event that has begun, even if the timeline was disabled in
+  // between.
+  if (active_) {
+    auto &timeline = Timeline::get_this_thread_instance();
+    timeline.push({now(), name_, timeline.track_, false});
+    active_ = false;
+  }
+}
+
+Timeline::Guard::~Guard() {
+  stop();
 }
 
-void Timelines::insert_events_without_locking(
-    const std::vector<TimelineEvent> &events) {
-  events_.insert(events_.end(), events.begin(), events.end());
+Timelines::Timelines() {
+  base_ticks_ = Timeline::now();
+  base_time_ = Time::get_time();
 }
 
 Timelines &taichi::Timelines::get_instance() {
@@ -71,55 +145,125 @@ Timelines &taichi::Timelines::get_instance() {
   return *instance;
 }
 
-void Timelines::clear() {
+float64 Timelines::seconds_per_tick() {
+#if defined(TI_TIMELINE_USE_TSC)
+  // Calibrated against Time::get_time(), which gets more accurate as the
+  // program runs.
+  auto ticks = Timeline::now() - base_ticks_;
+  auto time = Time::get_time() - base_time_;
+  if (ticks < 1000000 || time <= 0) {
+    // Too close to the base for a meaningful ratio, assume a 3 GHz clock.
+    return 1 / 3e9;
+  }
+  return time / ticks;
+#else
+  return 1e-9;
+#endif
+}
+
+uint32 Timelines::intern(const std::string &name) {
   std::lock_guard<std::mutex> _(mut_);
-  events_.clear();
-  for (auto timeline : timelines_) {
-    timeline->clear();
+  auto it = name_ids_.find(name);
+  if (it != name_ids_.end()) {
+    return it->second;
   }
+  auto id = (uint32)names_.size();
+  names_.push_back(name);
+  name_ids_[name] = id;
+  return id;
+}
+
+void Timelines::clear() {
+  std::lock_guard<std::mutex> _(mut_);
+  chunks_.clear();
+  // The threads keep appending to their current chunks, so the events already
+  // in there are skipped when saving instead.
+  cutoff_ticks_ = Timeline::now();
 }
 
 void Timelines::save(const std::string &filename) {
   std::lock_guard<std::mutex> _(mut_);
-  std::sort(timelines_.begin(), timelines_.end(), [](Timeline *a, Timeline *b) {
-    return a->get_name() < b->get_name();
-  });
+  std::vector<TimelineEvent> events;
+  auto collect = [&](const Timeline::Chunk *chunk) {
+    if (!chunk) {
+      return;
+    }
+    auto size = chunk->size.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < size; i++) {
+      if (chunk->events[i].ticks >= cutoff_ticks_) {
+        events.push_back(chunk->events[i]);
+      }
+    }
+  };
+  // Chunks are handed over in order, so the events of each thread stay in
+  // the order they were recorded.
+  for (auto &chunk : chunks_) {
+    collect(chunk.get());
+  }
   for (auto timeline : timelines_) {
-    insert_events_without_locking(timeline->fetch_events());
+    collect(timeline->current_);
   }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TimelineEvent &a, const TimelineEvent &b) {
+                     return a.track < b.track;
+                   });
+
   if (!ends_with(filename, ".json")) {
     TI_WARN("Timeline filename {} should end with '.json'.", filename);
   }
   std::ofstream fout(filename);
-  fout << "[";
+  fout << "{\"traceEvents\":[";
   bool first = true;
-  for (auto &e : events_) {
-    if (first) {
-      first = false;
-    } else {
-      fout << ",";
+  auto separate = [&]() {
+    if (!first) {
+      fout << ",\n";
     }
-    fout << e.to_json() << std::endl;
+    first = false;
+  };
+  // Tracks are shown as threads, named by metadata events.
+  for (std::size_t i = 0; i < events.size(); i++) {
+    if (i == 0 || events[i].track != events[i - 1].track) {
+      separate();
+      fout << fmt::format(
+          "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},"
+          "\"args\":{{\"name\":\"{}\"}}}}",
+          events[i].track, escape_json(names_[events[i].track]));
+    }
+  }
+  std::vector<std::string> escaped_names(names_.size());
+  auto us_per_tick = seconds_per_tick() * 1e6;
+  for (auto &e : events) {
+    auto &name = escaped_names[e.name];
+    if (name.empty()) {
+      name = escape_json(names_[e.name]);
+    }
+    separate();
+    fout << fmt::format(
+        "{{\"name\":\"{}\",\"cat\":\"taichi\",\"ph\":\"{}\",\"pid\":0,"
+        "\"tid\":{},\"ts\":{:.3f}}}",
+        name, e.begin ? "B" : "E", e.track,
+        ((int64)e.ticks - (int64)base_ticks_) * us_per_tick);
   }
-  fout << "]";
+  fout << "]}";
 }
 
 void Timelines::insert_timeline(Timeline *timeline) {
   std::lock_guard<std::mutex> _(mut_);
   timelines_.push_back(timeline);
+  timeline->name_ = fmt::format("thread_{}", num_threads_++);
 }
 
 void Timelines::remove_timeline(Timeline *timeline) {
   std::lock_guard<std::mutex> _(mut_);
+  if (timeline->current_) {
+    chunks_.emplace_back(timeline->current_);
+    timeline->current_ = nullptr;
+  }
   trash(std::remove(timelines_.begin(), timelines_.end(), timeline));
 }
 
-bool Timelines::get_enabled() {
-  return enabled_;
-}
-
 void Timelines::set_enabled(bool enabled) {
-  enabled_ = enabled;
+  enabled_.store(enabled, std::memory_order_relaxed);
 }
 
 }  // namespace taichi
@@ -1,58 +1,103 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include "taichi/common/core.h"
 #include "taichi/system/timer.h"
 
 namespace taichi {
 
+// A fixed-size binary event. |name| and |track| are ids interned by
+// Timelines, and |ticks| is read from Timeline::now().
 struct TimelineEvent {
-  std::string name;
+  uint64 ticks;
+  uint32 name;
+  uint32 track;
   bool begin;
-  float64 time;
-  std::string tid;
-
-  std::string to_json();
 };
 
+// The events of a single thread. Recording an event doesn't take any lock:
+// the thread appends it to its current chunk and publishes the new size, and
+// Timelines::save() only reads the published part. Full chunks are handed
+// over to Timelines, which is the only time a lock is taken.
 class Timeline {
  public:
+  static constexpr std::size_t chunk_size = 4096;
+
+  struct Chunk {
+    std::atomic<std::size_t> size{0};
+    TimelineEvent events[chunk_size];
+  };
+
   Timeline();
 
   ~Timeline();
 
   static Timeline &get_this_thread_instance();
 
-  void set_name(const std::string &tid) {
-    tid_ = tid;
-  }
+  // A monotonic clock: the time stamp counter on x64, which is constant rate
+  // and synchronized between cores on any recent CPU, or steady_clock
+  // nanoseconds elsewhere.
+  static uint64 now();
+
+  // Sets the name of the track the events of this thread are shown on.
+  void set_name(const std::string &name);
 
   std::string get_name() {
-    return tid_;
+    return name_;
   }
 
-  void clear();
+  uint32 intern(const std::string &name);
 
-  void insert_event(const TimelineEvent &e);
+  void insert_event(uint32 name, bool begin);
 
-  std::vector<TimelineEvent> fetch_events();
+  // Inserts an event measured by another clock, e.g. a GPU kernel timed with
+  // device events. |time| is in seconds of Time::get_time().
+  void insert_event(const std::string &name,
+                    bool begin,
+                    float64 time,
+                    const std::string &track);
 
   class Guard {
    public:
     explicit Guard(const std::string &name);
 
+    explicit Guard(uint32 name);
+
+    // Ends the event before the guard goes out of scope.
+    void stop();
+
     ~Guard();
 
    private:
-    std::string name_;
+    uint32 name_{0};
+    bool active_{false};
   };
 
  private:
-  std::string tid_;
-  std::mutex mut_;
-  std::vector<TimelineEvent> events_;
+  friend class Timelines;
+
+  void push(const TimelineEvent &e) {
+    auto size = current_ ? current_->size.load(std::memory_order_relaxed)
+                         : chunk_size;
+    if (size == chunk_size) {
+      new_chunk();
+      size = 0;
+    }
+    current_->events[size] = e;
+    current_->size.store(size + 1, std::memory_order_release);
+  }
+
+  void new_chunk();
+
+  std::string name_;
+  uint32 track_{0};
+  // Only replaced with the lock of Timelines held.
+  Chunk *current_{nullptr};
+  std::unordered_map<std::string, uint32> name_ids_;
 };
 
 // A timeline system for multi-threaded applications
@@ -60,27 +105,45 @@ class Timelines {
  public:
   static Timelines &get_instance();
 
-  void insert_events(const std::vector<TimelineEvent> &events);
-
-  void insert_events_without_locking(const std::vector<TimelineEvent> &events);
+  uint32 intern(const std::string &name);
 
   void insert_timeline(Timeline *timeline);
 
   void remove_timeline(Timeline *timeline);
 
+  // Drops all the events recorded so far.
   void clear();
 
+  // Saves the events in the Chrome trace event format, which can be opened in
+  // chrome://tracing or https://ui.perfetto.dev.
   void save(const std::string &filename);
 
-  bool get_enabled();
+  bool get_enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
 
   void set_enabled(bool enabled);
 
  private:
+  friend class Timeline;
+
+  Timelines();
+
+  float64 seconds_per_tick();
+
   std::mutex mut_;
-  std::vector<TimelineEvent> events_;
   std::vector<Timeline *> timelines_;
-  bool enabled_{false};
+  std::vector<std::unique_ptr<Timeline::Chunk>> chunks_;
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, uint32> name_ids_;
+  std::atomic<bool> enabled_{false};
+  // A pair of Timeline::now() and Time::get_time() sampled at the same time,
+  // for converting the ticks to seconds.
+  uint64 base_ticks_;
+  float64 base_time_;
+  // Events before this are dropped by clear().
+  uint64 cutoff_ticks_{0};
+  int num_threads_{0};
 };
 
 #define TI_TIMELINE(name) \
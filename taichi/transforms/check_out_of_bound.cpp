@@ -1,3 +1,4 @@
+#include "taichi/ir/analysis.h"
 #include "taichi/ir/ir.h"
 #include "taichi/ir/statements.h"
 #include "taichi/ir/transforms.h"
@@ -29,6 +30,92 @@ class CheckOutOfBound : public BasicStmtVisitor {
     visited.insert(stmt->instance_id);
   }
 
+  // The checks below are skipped for the bounds that the value range analysis
+  // proves, e.g. for the loop indices of range-fors over constant bounds.
+  static bool nonnegative(Stmt *index) {
+    auto range = irpass::analysis::value_range(index);
+    return range && range->first >= 0;
+  }
+
+  static bool below(Stmt *index, int64 bound) {
+    auto range = irpass::analysis::value_range(index);
+    return range && range->second < bound;
+  }
+
+  static bool is_extent(Stmt *stmt, int arg_id, int axis) {
+    auto *shape = stmt->cast<ExternalTensorShapeAlongAxisStmt>();
+    return shape && shape->arg_id == arg_id && shape->axis == axis;
+  }
+
+  // Checks whether |index| is less than the extent of the ndarray at |arg_id|
+  // along |axis|, which is only known at runtime. This recognizes the indices
+  // of range-fors over the extent, struct-fors over the ndarray and ndrange
+  // loops over the extents.
+  static bool below_extent(Stmt *index, int arg_id, int axis) {
+    if (auto *loop_index = index->cast<LoopIndexStmt>()) {
+      auto *range_for = loop_index->loop->cast<RangeForStmt>();
+      return range_for && is_extent(range_for->end, arg_id, axis);
+    }
+    auto *binary = index->cast<BinaryOpStmt>();
+    if (!binary) {
+      return false;
+    }
+    auto is_this_extent = [&](Stmt *stmt) {
+      return is_extent(stmt, arg_id, axis);
+    };
+    switch (binary->op_type) {
+      case BinaryOpType::add:
+        return (below(binary->rhs, 1) &&
+                below_extent(binary->lhs, arg_id, axis)) ||
+               (below(binary->lhs, 1) &&
+                below_extent(binary->rhs, arg_id, axis));
+      case BinaryOpType::sub: {
+        if (nonnegative(binary->rhs) &&
+            below_extent(binary->lhs, arg_id, axis)) {
+          return true;
+        }
+        // x - x / n * n
+        auto *product = binary->rhs->cast<BinaryOpStmt>();
+        if (!nonnegative(binary->lhs) || !product ||
+            product->op_type != BinaryOpType::mul) {
+          return false;
+        }
+        auto is_quotient = [&](Stmt *stmt) {
+          auto *div = stmt->cast<BinaryOpStmt>();
+          return div &&
+                 (div->op_type == BinaryOpType::div ||
+                  div->op_type == BinaryOpType::floordiv) &&
+                 div->lhs == binary->lhs && is_this_extent(div->rhs);
+        };
+        return (is_this_extent(product->lhs) && is_quotient(product->rhs)) ||
+               (is_this_extent(product->rhs) && is_quotient(product->lhs));
+      }
+      case BinaryOpType::mod:
+        return nonnegative(binary->lhs) && is_this_extent(binary->rhs);
+      case BinaryOpType::div:
+      case BinaryOpType::floordiv: {
+        // i / n for the index i of a loop over m * n.
+        auto *loop_index = binary->lhs->cast<LoopIndexStmt>();
+        auto *range_for =
+            loop_index ? loop_index->loop->cast<RangeForStmt>() : nullptr;
+        auto *end = range_for ? range_for->end->cast<BinaryOpStmt>() : nullptr;
+        if (!nonnegative(binary->lhs) || !end ||
+            end->op_type != BinaryOpType::mul) {
+          return false;
+        }
+        return (is_this_extent(end->lhs) &&
+                irpass::analysis::same_value(end->rhs, binary->rhs)) ||
+               (is_this_extent(end->rhs) &&
+                irpass::analysis::same_value(end->lhs, binary->rhs));
+      }
+      case BinaryOpType::min:
+        return below_extent(binary->lhs, arg_id, axis) ||
+               below_extent(binary->rhs, arg_id, axis);
+      default:
+        return false;
+    }
+  }
+
   void visit(SNodeOpStmt *stmt) override {
     if (stmt->ptr != nullptr) {
       TI_ASSERT(stmt->ptr->is<GlobalPtrStmt>());
@@ -46,27 +133,39 @@ class CheckOutOfBound : public BasicStmtVisitor {
     auto new_stmts = VecStatement();
     auto zero = new_stmts.push_back<ConstStmt>(TypedConstant(0));
     Stmt *result = new_stmts.push_back<ConstStmt>(TypedConstant(true));
+    auto arg_id = stmt->base_ptr->as<ArgLoadStmt>()->arg_id;
     std::string msg = fmt::format(
         "[kernel={}] Out of bound access to ndarray at arg {} with indices [",
-        kernel_name, stmt->base_ptr->as<ArgLoadStmt>()->arg_id);
+        kernel_name, arg_id);
     std::vector<Stmt *> args;
+    bool checked = false;
     int flattened_element = 1;
     for (int i = 0; i < stmt->element_shape.size(); i++) {
       flattened_element *= stmt->element_shape[i];
     }
     for (int i = 0; i < stmt->indices.size(); i++) {
-      auto lower_bound = zero;
-      auto check_lower_bound = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::cmp_ge, stmt->indices[i], lower_bound);
-      Stmt *upper_bound{nullptr};
+      auto index = stmt->indices[i];
+      args.emplace_back(index);
 
       auto ndim = stmt->ndim;
+      if (!nonnegative(index)) {
+        auto lower_bound = zero;
+        auto check_lower_bound = new_stmts.push_back<BinaryOpStmt>(
+            BinaryOpType::cmp_ge, index, lower_bound);
+        result = new_stmts.push_back<BinaryOpStmt>(BinaryOpType::bit_and,
+                                                   result, check_lower_bound);
+        checked = true;
+      }
+      if (i < ndim ? below_extent(index, arg_id, /*axis=*/i)
+                   : below(index, flattened_element)) {
+        continue;
+      }
+      Stmt *upper_bound{nullptr};
       if (i < ndim) {
         // Check for External Shape
         auto axis = i;
         upper_bound = new_stmts.push_back<ExternalTensorShapeAlongAxisStmt>(
-            /*axis=*/axis,
-            /*arg_id=*/stmt->base_ptr->as<ArgLoadStmt>()->arg_id);
+            /*axis=*/axis, /*arg_id=*/arg_id);
       } else {
         // Check for Element Shape
         upper_bound =
@@ -74,14 +173,14 @@ class CheckOutOfBound : public BasicStmtVisitor {
       }
 
       auto check_upper_bound = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::cmp_lt, stmt->indices[i], upper_bound);
-      auto check_i = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::bit_and, check_lower_bound, check_upper_bound);
+          BinaryOpType::cmp_lt, index, upper_bound);
       result = new_stmts.push_back<BinaryOpStmt>(BinaryOpType::bit_and, result,
-                                                 check_i);
-
-      auto input_index = stmt->indices[i];
-      args.emplace_back(input_index);
+                                                 check_upper_bound);
+      checked = true;
+    }
+    set_done(stmt);
+    if (!checked) {
+      return;
     }
 
     for (int i = 0; i < stmt->indices.size(); i++) {
@@ -93,7 +192,6 @@ class CheckOutOfBound : public BasicStmtVisitor {
 
     new_stmts.push_back<AssertStmt>(result, msg, args);
     modifier.insert_before(stmt, std::move(new_stmts));
-    set_done(stmt);
   }
 
   void visit(GlobalPtrStmt *stmt) override {
@@ -110,25 +208,29 @@ class CheckOutOfBound : public BasicStmtVisitor {
                     snode->get_node_type_name_hinted());
     std::string offset_msg = "offset (";
     std::vector<Stmt *> args;
+    bool checked = false;
     for (int i = 0; i < stmt->indices.size(); i++) {
       int offset_i = has_offset ? snode->index_offsets[i] : 0;
 
       // Note that during lower_ast, index arguments to GlobalPtrStmt are
       // already converted to [0, +inf) range.
 
-      auto lower_bound = zero;
-      auto check_lower_bound = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::cmp_ge, stmt->indices[i], lower_bound);
       int size_i = snode->shape_along_axis(i);
-      int upper_bound_i = size_i;
-      auto upper_bound =
-          new_stmts.push_back<ConstStmt>(TypedConstant(upper_bound_i));
-      auto check_upper_bound = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::cmp_lt, stmt->indices[i], upper_bound);
-      auto check_i = new_stmts.push_back<BinaryOpStmt>(
-          BinaryOpType::bit_and, check_lower_bound, check_upper_bound);
-      result = new_stmts.push_back<BinaryOpStmt>(BinaryOpType::bit_and, result,
-                                                 check_i);
+      if (!nonnegative(stmt->indices[i]) || !below(stmt->indices[i], size_i)) {
+        auto lower_bound = zero;
+        auto check_lower_bound = new_stmts.push_back<BinaryOpStmt>(
+            BinaryOpType::cmp_ge, stmt->indices[i], lower_bound);
+        int upper_bound_i = size_i;
+        auto upper_bound =
+            new_stmts.push_back<ConstStmt>(TypedConstant(upper_bound_i));
+        auto check_upper_bound = new_stmts.push_back<BinaryOpStmt>(
+            BinaryOpType::cmp_lt, stmt->indices[i], upper_bound);
+        auto check_i = new_stmts.push_back<BinaryOpStmt>(
+            BinaryOpType::bit_and, check_lower_bound, check_upper_bound);
+        result = new_stmts.push_back<BinaryOpStmt>(BinaryOpType::bit_and,
+                                                   result, check_i);
+        checked = true;
+      }
       if (i > 0) {
         msg += ", ";
         offset_msg += ", ";
@@ -144,6 +246,10 @@ class CheckOutOfBound : public BasicStmtVisitor {
       }
       args.emplace_back(input_index);
     }
+    set_done(stmt);
+    if (!checked) {
+      return;
+    }
     offset_msg += ") ";
     msg += ") " + (has_offset ? offset_msg : "") + "with indices (";
     for (int i = 0; i < stmt->indices.size(); i++) {
@@ -156,7 +262,6 @@ class CheckOutOfBound : public BasicStmtVisitor {
 
     new_stmts.push_back<AssertStmt>(result, msg, args);
     modifier.insert_before(stmt, std::move(new_stmts));
-    set_done(stmt);
   }
 
   // TODO: As offset information per dimension is lacking, only the accumulated
@@ -174,6 +279,10 @@ class CheckOutOfBound : public BasicStmtVisitor {
     max_valid_index -= 1;
 
     auto index = stmt->offset;
+    if (nonnegative(index) && below(index, max_valid_index + 1)) {
+      set_done(stmt);
+      return;
+    }
     auto new_stmts = VecStatement();
     auto zero = new_stmts.push_back<ConstStmt>(TypedConstant(0));
     Stmt *result = new_stmts.push_back<ConstStmt>(TypedConstant(true));
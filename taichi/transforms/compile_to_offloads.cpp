@@ -114,6 +114,10 @@ void compile_to_offloads(IRNode *ir,
     irpass::analysis::verify(ir);
   }
 
+  // After the passes above, which read the shapes of ndarrays too.
+  irpass::specialize_ndarray_shapes(ir, kernel);
+  print("Ndarray shapes specialized");
+
   irpass::flag_access(ir);
   print("Access flagged I");
   irpass::analysis::verify(ir);
@@ -190,6 +194,26 @@ void offload_to_executable(IRNode *ir,
     irpass::analysis::verify(ir);
   }
 
+  if (config.fuse_range_for_tasks) {
+    auto fusion = irpass::fuse_offloaded_range_fors(ir);
+    if (fusion.num_fused_loops > 0) {
+      TI_INFO(
+          "Fused {} range-for task(s) in kernel {}, ~{} bytes of global "
+          "memory loads saved per iteration",
+          fusion.num_fused_loops, kernel->get_name(),
+          fusion.saved_bytes_per_iteration);
+    }
+    print("Range-for tasks fused");
+    irpass::analysis::verify(ir);
+  }
+
+  if (config.counter_based_rng && arch_uses_llvm(config.arch)) {
+    irpass::make_counter_based_rand(ir);
+    irpass::type_check(ir, config);
+    print("Counter-based rand made");
+    irpass::analysis::verify(ir);
+  }
+
   if (config.make_cpu_multithreading_loop && arch_is_cpu(config.arch)) {
     irpass::make_cpu_multithreaded_range_for(ir, config);
     irpass::type_check(ir, config);
@@ -213,7 +237,10 @@ void offload_to_executable(IRNode *ir,
   if (is_extension_supported(config.arch, Extension::mesh)) {
     irpass::make_mesh_thread_local(ir, config, {kernel->get_name()});
     print("Make mesh thread local");
-    if (config.make_mesh_block_local && config.arch == Arch::cuda) {
+    // On CPU, the patch-local attributes are cached in a thread-local
+    // buffer instead of shared memory.
+    if (config.make_mesh_block_local &&
+        (config.arch == Arch::cuda || arch_is_cpu(config.arch))) {
       irpass::make_mesh_block_local(ir, config, {kernel->get_name()});
       print("Make mesh block local");
       irpass::full_simplify(
@@ -254,6 +281,11 @@ void offload_to_executable(IRNode *ir,
         ir, config,
         {false, /*autodiff_enabled*/ false, kernel->get_name(), verbose});
     print("Simplified before lower access");
+    // Needs the indices of the global pointers, before they are lowered.
+    if (arch_is_cpu(config.arch) && config.quant_opt_atomic_demotion &&
+        is_extension_supported(config.arch, Extension::quant)) {
+      irpass::detect_element_wise_quant_arrays(ir, config);
+    }
     irpass::lower_access(ir, config, {kernel->no_activate, true});
     print("Access lowered");
     irpass::analysis::verify(ir);
@@ -267,6 +299,13 @@ void offload_to_executable(IRNode *ir,
     irpass::analysis::verify(ir);
   }
 
+  if (config.strength_reduction) {
+    // Before the floor divisions are demoted.
+    irpass::strength_reduce_induction_variables(ir, config);
+    print("Induction variables strength reduced");
+    irpass::analysis::verify(ir);
+  }
+
   irpass::demote_operations(ir, config);
   print("Operations demoted");
 
@@ -29,7 +29,9 @@ class DemoteAtomics : public BasicStmtVisitor {
     bool demote = false;
     bool is_local = false;
     if (current_offloaded) {
-      if (stmt->dest->is<ThreadLocalPtrStmt>()) {
+      if (stmt->dest->is<ThreadLocalPtrStmt>() ||
+          (stmt->dest->is<MatrixPtrStmt>() &&
+           stmt->dest->as<MatrixPtrStmt>()->origin->is<ThreadLocalPtrStmt>())) {
         demote = true;
       }
       if (current_offloaded->task_type == OffloadedTaskType::serial) {
@@ -68,12 +68,17 @@ void convert_to_range_for(OffloadedStmt *offloaded) {
       if (!ext.active)
         continue;
       Stmt *index = extracted;
-      if (is_first_extraction) {  // first extraction doesn't need a mod
-        is_first_extraction = false;
+      if (snode->_morton) {
+        // The loop still visits the cells in storage order.
+        index = generate_morton_decode(&body_header, snode, extracted, p);
       } else {
-        index = generate_mod(&body_header, index, ext.acc_shape * ext.shape);
+        if (is_first_extraction) {  // first extraction doesn't need a mod
+          is_first_extraction = false;
+        } else {
+          index = generate_mod(&body_header, index, ext.acc_shape * ext.shape);
+        }
+        index = generate_div(&body_header, index, ext.acc_shape);
       }
-      index = generate_div(&body_header, index, ext.acc_shape);
       total_shape[p] /= ext.shape;
       auto multiplier =
           body_header.push_back<ConstStmt>(TypedConstant(total_shape[p]));
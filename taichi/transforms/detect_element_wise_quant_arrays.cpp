@@ -0,0 +1,114 @@
+#include "taichi/ir/ir.h"
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/snode.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "taichi/util/bit.h"
+
+#include <unordered_map>
+
+namespace taichi::lang {
+
+namespace irpass {
+
+namespace {
+
+// The quant_array holding the element |ptr| points to, if any.
+SNode *get_quant_array(Stmt *ptr) {
+  if (auto matrix_ptr = ptr->cast<MatrixPtrStmt>()) {
+    ptr = matrix_ptr->origin;
+  }
+  if (auto global_ptr = ptr->cast<GlobalPtrStmt>()) {
+    auto parent = global_ptr->snode->parent;
+    if (parent && parent->type == SNodeType::quant_array) {
+      return parent;
+    }
+  }
+  return nullptr;
+}
+
+// Whether |index| is the index of the range-for task |offload|. With
+// |multithreaded_loops|, the original loop of the task is the serial loop over
+// the share of a thread made by make_cpu_multithreaded_range_for, the only
+// strictly serialized loop directly in the task.
+bool is_task_index(Stmt *index,
+                   OffloadedStmt *offload,
+                   bool multithreaded_loops) {
+  auto loop_index = index->cast<LoopIndexStmt>();
+  if (!loop_index || loop_index->index != 0) {
+    return false;
+  }
+  if (!multithreaded_loops) {
+    return loop_index->loop == offload;
+  }
+  auto loop = loop_index->loop->cast<RangeForStmt>();
+  return loop && loop->strictly_serialized && !loop->reversed &&
+         loop->parent == offload->body.get();
+}
+
+void detect_element_wise_quant_arrays_in_task(OffloadedStmt *offload,
+                                               bool multithreaded_loops) {
+  if (offload->task_type != OffloadedStmt::TaskType::range_for ||
+      offload->reversed) {
+    return;
+  }
+  // Whether each quant_array written in the task is only written at the loop
+  // index, so that the loop iterations covering all the elements of a
+  // physical word can update the word without atomics.
+  std::unordered_map<SNode *, bool> element_wise;
+  irpass::analysis::gather_statements(offload->body.get(), [&](Stmt *stmt) {
+    if (stmt->is<GlobalLoadStmt>()) {
+      return false;
+    }
+    for (auto op : stmt->get_operands()) {
+      auto quant_array = op ? get_quant_array(op) : nullptr;
+      if (!quant_array) {
+        continue;
+      }
+      bool at_loop_index = false;
+      if (auto ptr = op->cast<GlobalPtrStmt>();
+          ptr && ptr->indices.size() == 1 &&
+          (stmt->is<GlobalStoreStmt>() || stmt->is<AtomicOpStmt>())) {
+        at_loop_index =
+            is_task_index(ptr->indices[0], offload, multithreaded_loops);
+      }
+      // The elements of a word must be consecutive indices of the loop.
+      at_loop_index =
+          at_loop_index && quant_array->num_active_indices == 1 &&
+          bit::is_power_of_two(quant_array->num_cells_per_container);
+      auto it = element_wise.find(quant_array);
+      if (it == element_wise.end()) {
+        element_wise[quant_array] = at_loop_index;
+      } else {
+        it->second = it->second && at_loop_index;
+      }
+    }
+    return false;
+  });
+  for (auto &[snode, flag] : element_wise) {
+    if (flag) {
+      offload->mem_access_opt.add_flag(snode, SNodeAccessFlag::element_wise);
+    }
+  }
+}
+
+}  // namespace
+
+void detect_element_wise_quant_arrays(IRNode *root,
+                                      const CompileConfig &config) {
+  TI_AUTO_PROF;
+  bool multithreaded_loops = config.make_cpu_multithreading_loop;
+  if (root->is<Block>()) {
+    for (auto &offload : root->as<Block>()->statements) {
+      detect_element_wise_quant_arrays_in_task(offload->as<OffloadedStmt>(),
+                                               multithreaded_loops);
+    }
+  } else {
+    detect_element_wise_quant_arrays_in_task(root->as<OffloadedStmt>(),
+                                             multithreaded_loops);
+  }
+}
+
+}  // namespace irpass
+
+}  // namespace taichi::lang
@@ -0,0 +1,589 @@
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/ir.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "taichi/ir/visitors.h"
+#include "taichi/system/profiler.h"
+
+namespace taichi::lang {
+
+const PassID FuseRangeForsPass::id = "FuseRangeForsPass";
+
+namespace {
+
+/* This pass merges adjacent top-level range-for loops with identical bounds
+ * into a single loop, e.g.
+ *
+ *   for i in range(n):
+ *     a[i] = b[i] + c[i]
+ *   for i in range(n):
+ *     d[i] = a[i] * 2
+ *
+ * becomes
+ *
+ *   for i in range(n):
+ *     a[i] = b[i] + c[i]
+ *     d[i] = a[i] * 2
+ *
+ * so that a[i] is forwarded from the store instead of being read back from
+ * global memory, and the loop overhead is paid once.
+ *
+ * Merging is only legal when no iteration of the second loop depends on a
+ * different iteration of the first one through global memory. We require
+ * that every global variable written by either loop and accessed by both is
+ * accessed at one single index in both bodies, and that this index takes a
+ * different value in every iteration.
+ *
+ * The same merging is applied to the range-for tasks of a kernel after
+ * offloading, where it also covers the demoted dense struct-fors and saves a
+ * kernel launch, or a barrier of the CPU thread pool, per fused task.
+ */
+
+constexpr int kMaxRecoveryDepth = 8;
+
+// Checks whether two statements, each inside the body of its own loop, are
+// guaranteed to evaluate to the same value in the same iteration.
+class IndexComparator {
+ public:
+  IndexComparator(Stmt *loop1, Stmt *loop2) : loop1_(loop1), loop2_(loop2) {
+  }
+
+  bool same(Stmt *a, Stmt *b) const {
+    if (a == b) {
+      return true;
+    }
+    if (auto *const_a = a->cast<ConstStmt>()) {
+      auto *const_b = b->cast<ConstStmt>();
+      return const_b && const_a->val == const_b->val;
+    }
+    if (auto *index_a = a->cast<LoopIndexStmt>()) {
+      auto *index_b = b->cast<LoopIndexStmt>();
+      return index_b && index_a->loop == loop1_ && index_b->loop == loop2_ &&
+             index_a->index == index_b->index;
+    }
+    if (auto *arg_a = a->cast<ArgLoadStmt>()) {
+      auto *arg_b = b->cast<ArgLoadStmt>();
+      return arg_b && arg_a->arg_id == arg_b->arg_id &&
+             arg_a->is_ptr == arg_b->is_ptr &&
+             arg_a->ret_type == arg_b->ret_type;
+    }
+    if (auto *shape_a = a->cast<ExternalTensorShapeAlongAxisStmt>()) {
+      auto *shape_b = b->cast<ExternalTensorShapeAlongAxisStmt>();
+      return shape_b && shape_a->arg_id == shape_b->arg_id &&
+             shape_a->axis == shape_b->axis;
+    }
+    if (auto *unary_a = a->cast<UnaryOpStmt>()) {
+      auto *unary_b = b->cast<UnaryOpStmt>();
+      return unary_b && unary_a->same_operation(unary_b) &&
+             same(unary_a->operand, unary_b->operand);
+    }
+    if (auto *binary_a = a->cast<BinaryOpStmt>()) {
+      auto *binary_b = b->cast<BinaryOpStmt>();
+      return binary_b && binary_a->op_type == binary_b->op_type &&
+             same(binary_a->lhs, binary_b->lhs) &&
+             same(binary_a->rhs, binary_b->rhs);
+    }
+    return false;
+  }
+
+ private:
+  Stmt *loop1_;
+  Stmt *loop2_;
+};
+
+Stmt *strip_constant_offset(Stmt *stmt) {
+  while (auto *binary = stmt->cast<BinaryOpStmt>()) {
+    if (binary->op_type == BinaryOpType::add && binary->rhs->is<ConstStmt>()) {
+      stmt = binary->lhs;
+    } else if (binary->op_type == BinaryOpType::add &&
+               binary->lhs->is<ConstStmt>()) {
+      stmt = binary->rhs;
+    } else if (binary->op_type == BinaryOpType::sub &&
+               binary->rhs->is<ConstStmt>()) {
+      stmt = binary->lhs;
+    } else {
+      break;
+    }
+  }
+  return stmt;
+}
+
+// Checks whether an index tuple takes a different value in every iteration of
+// |loop|, i.e. whether the loop index can be recovered from the tuple. Besides
+// the loop index itself (up to a constant offset), this recognizes the
+// quotient/remainder decomposition of the linear index emitted for ndrange
+// loops.
+class InjectivityChecker {
+ public:
+  InjectivityChecker(Stmt *loop, Block *body)
+      : loop_(loop), comparator_(loop, loop) {
+    irpass::analysis::gather_statements(body, [&](Stmt *stmt) {
+      if (auto *binary = stmt->cast<BinaryOpStmt>()) {
+        binary_ops_.push_back(binary);
+      }
+      return false;
+    });
+  }
+
+  bool is_injective(const std::vector<Stmt *> &indices) const {
+    std::vector<Stmt *> components;
+    for (auto *index : indices) {
+      components.push_back(strip_constant_offset(index));
+    }
+    return recoverable(nullptr, components, 0);
+  }
+
+ private:
+  // A null |value| stands for the loop index.
+  bool matches(Stmt *stmt, Stmt *value) const {
+    if (value == nullptr) {
+      auto *index = stmt->cast<LoopIndexStmt>();
+      return index && index->loop == loop_ && index->index == 0;
+    }
+    return comparator_.same(stmt, value);
+  }
+
+  bool recoverable(Stmt *value,
+                   const std::vector<Stmt *> &components,
+                   int depth) const {
+    if (depth > kMaxRecoveryDepth) {
+      return false;
+    }
+    for (auto *component : components) {
+      if (matches(component, value)) {
+        return true;
+      }
+    }
+    // value = quotient * divisor + remainder
+    for (auto *quotient : binary_ops_) {
+      if ((quotient->op_type != BinaryOpType::floordiv &&
+           quotient->op_type != BinaryOpType::div &&
+           quotient->op_type != BinaryOpType::bit_sar &&
+           quotient->op_type != BinaryOpType::bit_shr) ||
+          !matches(quotient->lhs, value)) {
+        continue;
+      }
+      for (auto *remainder : binary_ops_) {
+        if (is_remainder(remainder, quotient, value) &&
+            recoverable(quotient, components, depth + 1) &&
+            recoverable(remainder, components, depth + 1)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool is_remainder(BinaryOpStmt *stmt,
+                    BinaryOpStmt *quotient,
+                    Stmt *value) const {
+    if (!matches(stmt->lhs, value)) {
+      return false;
+    }
+    auto *divisor = quotient->rhs;
+    bool is_shift = quotient->op_type == BinaryOpType::bit_sar ||
+                    quotient->op_type == BinaryOpType::bit_shr;
+    if (stmt->op_type == BinaryOpType::mod && !is_shift) {
+      return comparator_.same(stmt->rhs, divisor);
+    }
+    if (stmt->op_type == BinaryOpType::sub && !is_shift) {
+      auto *product = stmt->rhs->cast<BinaryOpStmt>();
+      if (!product || product->op_type != BinaryOpType::mul) {
+        return false;
+      }
+      return (comparator_.same(product->lhs, quotient) &&
+              comparator_.same(product->rhs, divisor)) ||
+             (comparator_.same(product->lhs, divisor) &&
+              comparator_.same(product->rhs, quotient));
+    }
+    if (stmt->op_type == BinaryOpType::bit_and && is_shift) {
+      auto *shift = divisor->cast<ConstStmt>();
+      auto *mask = stmt->rhs->cast<ConstStmt>();
+      if (!shift || !mask) {
+        return false;
+      }
+      auto bits = shift->val.val_as_int64();
+      return bits >= 0 && bits < 63 &&
+             mask->val.val_as_int64() == (int64(1) << bits) - 1;
+    }
+    return false;
+  }
+
+  Stmt *loop_;
+  IndexComparator comparator_;
+  std::vector<BinaryOpStmt *> binary_ops_;
+};
+
+struct MemoryAccess {
+  // Accesses to the same SNode or to ndarrays of the same element type may
+  // alias. Two ndarray parameters can be bound to the same ndarray, so they
+  // are only told apart by their element type.
+  const SNode *snode{nullptr};
+  const Type *arr_element_type{nullptr};
+  std::vector<Stmt *> indices;
+  bool is_write{false};
+  std::size_t load_bytes{0};
+
+  bool may_alias(const MemoryAccess &other) const {
+    return snode == other.snode && arr_element_type == other.arr_element_type;
+  }
+};
+
+bool is_inside(Stmt *stmt, Block *body) {
+  for (auto *block = stmt->parent; block; block = block->parent_block()) {
+    if (block == body) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Collects the global memory accesses in |body|. Returns false if |body|
+// contains anything that prevents it from being merged with another loop.
+bool gather_accesses(Block *body, std::vector<MemoryAccess> &accesses) {
+  bool fusible = true;
+  irpass::analysis::gather_statements(body, [&](Stmt *stmt) {
+    if (stmt->is<SNodeOpStmt>() || stmt->is<ExternalFuncCallStmt>() ||
+        stmt->is<FuncCallStmt>() || stmt->is<ReturnStmt>() ||
+        stmt->is<ContinueStmt>() || stmt->is<InternalFuncStmt>() ||
+        stmt->is<GlobalTemporaryStmt>() || stmt->is<ThreadLocalPtrStmt>() ||
+        stmt->is<BlockLocalPtrStmt>()) {
+      fusible = false;
+      return false;
+    }
+    MemoryAccess access;
+    Stmt *ptr = nullptr;
+    if (auto *load = stmt->cast<GlobalLoadStmt>()) {
+      ptr = load->src;
+      access.load_bytes = data_type_size(load->ret_type);
+    } else if (auto *store = stmt->cast<GlobalStoreStmt>()) {
+      ptr = store->dest;
+      access.is_write = true;
+    } else if (auto *atomic = stmt->cast<AtomicOpStmt>()) {
+      ptr = atomic->dest;
+      access.is_write = true;
+    } else if (auto *local_load = stmt->cast<LocalLoadStmt>()) {
+      ptr = local_load->src;
+    } else if (auto *local_store = stmt->cast<LocalStoreStmt>()) {
+      ptr = local_store->dest;
+    }
+    if (!ptr) {
+      return false;
+    }
+    Stmt *offset = nullptr;
+    if (auto *matrix_ptr = ptr->cast<MatrixPtrStmt>()) {
+      ptr = matrix_ptr->origin;
+      offset = matrix_ptr->offset;
+    }
+    if (ptr->is<AllocaStmt>()) {
+      // Local variables declared outside the loop are shared between
+      // iterations.
+      fusible = fusible && is_inside(ptr, body);
+      return false;
+    }
+    if (auto *global_ptr = ptr->cast<GlobalPtrStmt>()) {
+      if (!global_ptr->snode->is_path_all_dense) {
+        fusible = false;
+        return false;
+      }
+      const SNode *snode = global_ptr->snode;
+      while (snode->is_bit_level && snode->parent) {
+        snode = snode->parent;
+      }
+      access.snode = snode;
+      access.indices = global_ptr->indices;
+    } else if (auto *external_ptr = ptr->cast<ExternalPtrStmt>()) {
+      if (!external_ptr->base_ptr->is<ArgLoadStmt>()) {
+        fusible = false;
+        return false;
+      }
+      access.arr_element_type =
+          external_ptr->ret_type.ptr_removed().get_element_type();
+      access.indices = external_ptr->indices;
+    } else {
+      fusible = false;
+      return false;
+    }
+    if (offset) {
+      access.indices.push_back(offset);
+    }
+    accesses.push_back(std::move(access));
+    return false;
+  });
+  return fusible;
+}
+
+// Checks whether the body of |loop2| can be appended to the body of |loop1|.
+// Returns std::nullopt if not, otherwise the number of bytes per iteration
+// that |loop2| loads from addresses already accessed by |loop1|.
+std::optional<std::size_t> check_fusion(Stmt *loop1,
+                                        Block *body1,
+                                        Stmt *loop2,
+                                        Block *body2) {
+  std::vector<MemoryAccess> accesses1, accesses2;
+  if (!gather_accesses(body1, accesses1) ||
+      !gather_accesses(body2, accesses2)) {
+    return std::nullopt;
+  }
+  IndexComparator across(loop1, loop2);
+  IndexComparator within1(loop1, loop1);
+  IndexComparator within2(loop2, loop2);
+  InjectivityChecker injectivity(loop1, body1);
+
+  auto same_indices = [](const IndexComparator &comparator,
+                         const std::vector<Stmt *> &a,
+                         const std::vector<Stmt *> &b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (int i = 0; i < (int)a.size(); i++) {
+      if (!comparator.same(a[i], b[i])) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::size_t saved_bytes = 0;
+  for (auto &access : accesses1) {
+    bool shared = false, written = false;
+    for (auto &other : accesses2) {
+      if (access.may_alias(other)) {
+        shared = true;
+        written = written || other.is_write;
+      }
+    }
+    if (!shared) {
+      continue;
+    }
+    for (auto &other : accesses1) {
+      if (access.may_alias(other)) {
+        written = written || other.is_write;
+      }
+    }
+    if (!written) {
+      // Read-only in both loops.
+      continue;
+    }
+    // |access| is used as the reference index of the variable.
+    if (!injectivity.is_injective(access.indices)) {
+      return std::nullopt;
+    }
+    for (auto &other : accesses1) {
+      if (access.may_alias(other) &&
+          !same_indices(within1, access.indices, other.indices)) {
+        return std::nullopt;
+      }
+    }
+    for (auto &other : accesses2) {
+      if (access.may_alias(other) &&
+          !same_indices(across, access.indices, other.indices)) {
+        return std::nullopt;
+      }
+    }
+  }
+  for (auto &access : accesses2) {
+    if (access.load_bytes == 0) {
+      continue;
+    }
+    for (auto &other : accesses1) {
+      if (access.may_alias(other) &&
+          same_indices(across, other.indices, access.indices)) {
+        saved_bytes += access.load_bytes;
+        break;
+      }
+    }
+  }
+  return saved_bytes;
+}
+
+// Statements that may be moved from between two loops to before the first
+// one: they neither access memory nor have side effects.
+bool is_hoistable(Stmt *stmt) {
+  return stmt->is<ConstStmt>() || stmt->is<ArgLoadStmt>() ||
+         stmt->is<ExternalTensorShapeAlongAxisStmt>() ||
+         stmt->is<UnaryOpStmt>() || stmt->is<BinaryOpStmt>() ||
+         stmt->is<TernaryOpStmt>();
+}
+
+bool same_loop_attributes(RangeForStmt *loop1, RangeForStmt *loop2) {
+  IndexComparator bounds(nullptr, nullptr);
+  return !loop1->reversed && !loop2->reversed && !loop1->strictly_serialized &&
+         !loop2->strictly_serialized && !loop1->is_bit_vectorized &&
+         !loop2->is_bit_vectorized &&
+         loop1->num_cpu_threads == loop2->num_cpu_threads &&
+         loop1->block_dim == loop2->block_dim &&
+         bounds.same(loop1->begin, loop2->begin) &&
+         bounds.same(loop1->end, loop2->end);
+}
+
+bool same_task_attributes(OffloadedStmt *task1, OffloadedStmt *task2) {
+  // Non-constant bounds are read from global temporaries. Nothing can write
+  // them in between two adjacent tasks, so the same offset means the same
+  // value.
+  auto same_bound = [](bool const1,
+                       int32 value1,
+                       std::size_t offset1,
+                       bool const2,
+                       int32 value2,
+                       std::size_t offset2) {
+    return const1 == const2 && (const1 ? value1 == value2 : offset1 == offset2);
+  };
+  return task1->task_type == OffloadedStmt::TaskType::range_for &&
+         task2->task_type == OffloadedStmt::TaskType::range_for &&
+         !task1->reversed && !task2->reversed && !task1->is_bit_vectorized &&
+         !task2->is_bit_vectorized && task1->end_stmt == nullptr &&
+         task2->end_stmt == nullptr && !task1->tls_prologue &&
+         !task2->tls_prologue && !task1->bls_prologue &&
+         !task2->bls_prologue &&
+         task1->num_cpu_threads == task2->num_cpu_threads &&
+         task1->grid_dim == task2->grid_dim &&
+         task1->block_dim == task2->block_dim &&
+         same_bound(task1->const_begin, task1->begin_value,
+                    task1->begin_offset, task2->const_begin,
+                    task2->begin_value, task2->begin_offset) &&
+         same_bound(task1->const_end, task1->end_value, task1->end_offset,
+                    task2->const_end, task2->end_value, task2->end_offset);
+}
+
+// An SNode stays read-only in the fused task only if it was read-only in
+// both tasks. The other flags are requested by the user and must agree.
+std::optional<MemoryAccessOptions> merge_access_options(
+    const MemoryAccessOptions &opt1,
+    const MemoryAccessOptions &opt2) {
+  auto user_flags = [](const MemoryAccessOptions &opt) {
+    std::unordered_map<SNode *, std::unordered_set<SNodeAccessFlag>> flags;
+    for (auto &[snode, snode_flags] : opt.get_all()) {
+      for (auto flag : snode_flags) {
+        if (flag != SNodeAccessFlag::read_only) {
+          flags[snode].insert(flag);
+        }
+      }
+    }
+    return flags;
+  };
+  if (user_flags(opt1) != user_flags(opt2)) {
+    return std::nullopt;
+  }
+  MemoryAccessOptions merged;
+  for (auto &[snode, snode_flags] : opt1.get_all()) {
+    for (auto flag : snode_flags) {
+      if (flag != SNodeAccessFlag::read_only ||
+          opt2.has_flag(snode, SNodeAccessFlag::read_only)) {
+        merged.add_flag(snode, flag);
+      }
+    }
+  }
+  return merged;
+}
+
+}  // namespace
+
+namespace irpass {
+
+FuseRangeForsPass::Result fuse_range_fors(IRNode *root) {
+  TI_AUTO_PROF;
+  FuseRangeForsPass::Result result;
+  auto *block = root->as<Block>();
+
+  stmt_vector fused;
+  // The last loop emitted, and the hoistable statements seen after it.
+  RangeForStmt *loop = nullptr;
+  int loop_position = 0;
+  stmt_vector pending;
+
+  auto flush_pending = [&]() {
+    for (auto &stmt : pending) {
+      fused.push_back(std::move(stmt));
+    }
+    pending.clear();
+  };
+
+  for (auto &stmt : block->statements) {
+    if (loop && is_hoistable(stmt.get())) {
+      pending.push_back(std::move(stmt));
+      continue;
+    }
+    if (loop && stmt->is<RangeForStmt>()) {
+      auto *next = stmt->as<RangeForStmt>();
+      std::optional<std::size_t> saved_bytes;
+      if (same_loop_attributes(loop, next)) {
+        saved_bytes =
+            check_fusion(loop, loop->body.get(), next, next->body.get());
+      }
+      if (saved_bytes.has_value()) {
+        // The statements in between don't depend on |loop|, so they can be
+        // evaluated before it.
+        for (auto &hoisted : pending) {
+          fused.insert(fused.begin() + loop_position, std::move(hoisted));
+          loop_position++;
+        }
+        pending.clear();
+        for (auto &body_stmt : next->body->statements) {
+          loop->body->insert(std::move(body_stmt));
+        }
+        next->body->statements.clear();
+        irpass::replace_all_usages_with(loop->body.get(), next, loop);
+        result.num_fused_loops++;
+        result.saved_bytes_per_iteration += saved_bytes.value();
+        continue;
+      }
+    }
+    flush_pending();
+    if (stmt->is<RangeForStmt>()) {
+      loop = stmt->as<RangeForStmt>();
+      loop_position = (int)fused.size();
+    } else {
+      loop = nullptr;
+    }
+    fused.push_back(std::move(stmt));
+  }
+  flush_pending();
+  block->statements = std::move(fused);
+  return result;
+}
+
+FuseRangeForsPass::Result fuse_offloaded_range_fors(IRNode *root) {
+  TI_AUTO_PROF;
+  FuseRangeForsPass::Result result;
+  auto *block = root->as<Block>();
+
+  stmt_vector fused;
+  // The last range-for task emitted.
+  OffloadedStmt *task = nullptr;
+  for (auto &stmt : block->statements) {
+    auto *next = stmt->cast<OffloadedStmt>();
+    if (task && next && same_task_attributes(task, next)) {
+      auto access_opt =
+          merge_access_options(task->mem_access_opt, next->mem_access_opt);
+      std::optional<std::size_t> saved_bytes;
+      if (access_opt.has_value()) {
+        saved_bytes =
+            check_fusion(task, task->body.get(), next, next->body.get());
+      }
+      if (saved_bytes.has_value()) {
+        for (auto &body_stmt : next->body->statements) {
+          task->body->insert(std::move(body_stmt));
+        }
+        next->body->statements.clear();
+        irpass::replace_all_usages_with(task->body.get(), next, task);
+        task->mem_access_opt = std::move(access_opt.value());
+        result.num_fused_loops++;
+        result.saved_bytes_per_iteration += saved_bytes.value();
+        continue;
+      }
+    }
+    if (next && next->task_type == OffloadedStmt::TaskType::range_for) {
+      task = next;
+    } else {
+      task = nullptr;
+    }
+    fused.push_back(std::move(stmt));
+  }
+  block->statements = std::move(fused);
+  return result;
+}
+
+}  // namespace irpass
+
+}  // namespace taichi::lang
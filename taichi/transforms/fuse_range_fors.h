@@ -0,0 +1,21 @@
+#pragma once
+
+#include "taichi/ir/pass.h"
+
+namespace taichi::lang {
+
+class FuseRangeForsPass : public Pass {
+ public:
+  static const PassID id;
+
+  struct Result {
+    // Number of loops merged into a preceding loop.
+    int num_fused_loops{0};
+    // Estimated global memory loads, in bytes per iteration, that the fused
+    // loops no longer need to issue: the data was already loaded or stored at
+    // the same address by an earlier part of the fused body.
+    std::size_t saved_bytes_per_iteration{0};
+  };
+};
+
+}  // namespace taichi::lang
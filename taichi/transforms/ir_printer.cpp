@@ -182,7 +182,13 @@ class IRPrinter : public IRVisitor {
   }
 
   void visit(RandStmt *stmt) override {
-    print("{}{} = rand()", stmt->type_hint(), stmt->name());
+    if (stmt->index) {
+      print("{}{} = rand(index={}, stream={}, counter={})", stmt->type_hint(),
+            stmt->name(), stmt->index->name(), stmt->stream,
+            stmt->counter->name());
+    } else {
+      print("{}{} = rand()", stmt->type_hint(), stmt->name());
+    }
   }
 
   void visit(DecorationStmt *stmt) override {
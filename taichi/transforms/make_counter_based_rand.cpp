@@ -0,0 +1,98 @@
+#include "taichi/ir/ir.h"
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/snode.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "taichi/system/profiler.h"
+
+namespace taichi::lang {
+
+namespace {
+
+// The index of the current iteration of |offload|, the same whatever thread
+// runs it. Null if the task has no such index.
+Stmt *insert_iteration_index(OffloadedStmt *offload, Block *block) {
+  using TaskType = OffloadedStmt::TaskType;
+  if (offload->task_type == TaskType::serial) {
+    return block->insert(
+        Stmt::make<ConstStmt>(TypedConstant(PrimitiveType::i32, 0)), 0);
+  }
+  if (offload->task_type == TaskType::range_for) {
+    return block->insert(Stmt::make<LoopIndexStmt>(offload, 0), 0);
+  }
+  if (offload->task_type != TaskType::struct_for) {
+    return nullptr;
+  }
+  // Linearize the coordinates of the element.
+  auto snode = offload->snode;
+  VecStatement stmts;
+  Stmt *index = nullptr;
+  for (int i = 0; i < snode->num_active_indices; i++) {
+    auto coordinate = stmts.push_back<LoopIndexStmt>(
+        offload, snode->physical_index_position[i]);
+    if (index) {
+      auto shape = stmts.push_back<ConstStmt>(
+          TypedConstant(PrimitiveType::i32, snode->shape_along_axis(i)));
+      index = stmts.push_back<BinaryOpStmt>(BinaryOpType::mul, index, shape);
+      index = stmts.push_back<BinaryOpStmt>(BinaryOpType::add, index,
+                                            coordinate);
+    } else {
+      index = coordinate;
+    }
+  }
+  if (!index) {
+    index = stmts.push_back<ConstStmt>(TypedConstant(PrimitiveType::i32, 0));
+  }
+  block->insert(std::move(stmts), 0);
+  return index;
+}
+
+void make_counter_based_rand_in_task(OffloadedStmt *offload, int &stream) {
+  auto rands = irpass::analysis::gather_statements(
+      offload->body.get(), [](Stmt *stmt) { return stmt->is<RandStmt>(); });
+  if (rands.empty()) {
+    return;
+  }
+  auto body = offload->body.get();
+  auto index = insert_iteration_index(offload, body);
+  if (!index) {
+    return;
+  }
+  // Allocas are zero-initialized, and the body runs once per iteration.
+  auto counter = body->insert(Stmt::make<AllocaStmt>(PrimitiveType::u32), 0);
+  for (auto stmt : rands) {
+    auto rand = stmt->as<RandStmt>();
+    auto count = rand->insert_before_me(Stmt::make<LocalLoadStmt>(counter));
+    auto one = rand->insert_before_me(
+        Stmt::make<ConstStmt>(TypedConstant(PrimitiveType::u32, 1)));
+    auto next = rand->insert_before_me(
+        Stmt::make<BinaryOpStmt>(BinaryOpType::add, count, one));
+    rand->insert_before_me(Stmt::make<LocalStoreStmt>(counter, next));
+    rand->index = index;
+    rand->counter = count;
+    rand->stream = stream++;
+  }
+}
+
+}  // namespace
+
+namespace irpass {
+
+// Makes the RandStmts in range-for, struct-for and serial tasks draw from a
+// counter-based generator, so that the numbers don't depend on which thread
+// runs which iteration.
+void make_counter_based_rand(IRNode *root) {
+  TI_AUTO_PROF;
+  int stream = 0;
+  if (root->is<Block>()) {
+    for (auto &offload : root->as<Block>()->statements) {
+      make_counter_based_rand_in_task(offload->as<OffloadedStmt>(), stream);
+    }
+  } else {
+    make_counter_based_rand_in_task(root->as<OffloadedStmt>(), stream);
+  }
+}
+
+}  // namespace irpass
+
+}  // namespace taichi::lang
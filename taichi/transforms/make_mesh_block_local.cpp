@@ -148,6 +148,16 @@ void MakeMeshBlockLocal::replace_global_ptrs(SNode *snode) {
   }
 }
 
+Stmt *MakeMeshBlockLocal::create_thread_idx() {
+  if (config_.arch == Arch::x64 || config_.arch == Arch::arm64) {
+    // On CPU a single thread processes the whole patch and owns the
+    // thread-local BLS buffer.
+    return block_->push_back<ConstStmt>(TypedConstant(0));
+  }
+  return block_->push_back<LoopLinearIndexStmt>(
+      offload_);  // Equivalent to CUDA threadIdx
+}
+
 // This function creates loop like:
 // int i = start_val;
 // while (i < end_val) {
@@ -322,13 +332,7 @@ void MakeMeshBlockLocal::fetch_mapping(
         mapping_callback_handler,
     std::function<void(Block *body, Stmt *idx_val, Stmt *mapping_val)>
         attr_callback_handler) {
-  Stmt *thread_idx_stmt;
-  if (config_.arch == Arch::x64 || config_.arch == Arch::arm64) {
-    thread_idx_stmt = block_->push_back<ConstStmt>(TypedConstant(0));
-  } else {
-    thread_idx_stmt = block_->push_back<LoopLinearIndexStmt>(
-        offload_);  // Equivalent to CUDA threadIdx
-  }
+  Stmt *thread_idx_stmt = create_thread_idx();
   Stmt *total_element_num =
       offload_->total_num_local.find(element_type_)->second;
   Stmt *total_element_offset =
@@ -563,8 +567,7 @@ MakeMeshBlockLocal::MakeMeshBlockLocal(OffloadedStmt *offload,
     }
     block_ = offload->bls_epilogue.get();
     {
-      Stmt *thread_idx_stmt = block_->push_back<LoopLinearIndexStmt>(
-          offload);  // Equivalent to CUDA threadIdx
+      Stmt *thread_idx_stmt = create_thread_idx();
       Stmt *total_element_num =
           offload->total_num_local.find(element_type)->second;
       [[maybe_unused]] Stmt *total_element_offset =
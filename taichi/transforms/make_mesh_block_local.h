@@ -31,6 +31,7 @@ class MakeMeshBlockLocal : public Pass {
   void fetch_attr_to_bls(Block *body, Stmt *idx_val, Stmt *mapping_val);
   void push_attr_to_global(Block *body, Stmt *idx_val, Stmt *mapping_val);
 
+  Stmt *create_thread_idx();
   Stmt *create_xlogue(
       Stmt *start_val,
       Stmt *end_val,
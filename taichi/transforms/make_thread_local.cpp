@@ -1,12 +1,16 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <optional>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "taichi/ir/analysis.h"
 #include "taichi/ir/ir.h"
 #include "taichi/ir/statements.h"
 #include "taichi/ir/transforms.h"
+#include "taichi/ir/type_factory.h"
 #include "taichi/ir/visitors.h"
 #include "taichi/system/profiler.h"
 
@@ -97,7 +101,235 @@ std::vector<std::pair<T *, AtomicOpType>> find_global_reduction_destinations(
   return valid_reduction_values;
 }
 
-void make_thread_local_offload(OffloadedStmt *offload) {
+// Find the fields that a task only reduces into through indexed atomics with
+// a single op type, e.g. histograms.
+std::vector<std::pair<SNode *, AtomicOpType>> find_array_reduction_fields(
+    OffloadedStmt *offload) {
+  std::vector<GlobalPtrStmt *> ptrs;
+  std::unordered_map<Stmt *, std::vector<Stmt *>> users;
+  std::unordered_set<SNode *> invalid_fields;
+  irpass::analysis::gather_statements(offload, [&](Stmt *stmt) {
+    if (auto ptr = stmt->cast<GlobalPtrStmt>()) {
+      ptrs.push_back(ptr);
+    } else if (auto ptrs_of_matrix = stmt->cast<MatrixOfGlobalPtrStmt>()) {
+      for (auto snode : ptrs_of_matrix->snodes) {
+        invalid_fields.insert(snode);
+      }
+    }
+    for (auto op : stmt->get_operands()) {
+      if (op) {
+        users[op].push_back(stmt);
+      }
+    }
+    return false;
+  });
+
+  // We use std::vector instead of std::map to keep a deterministic order here.
+  std::vector<std::pair<SNode *, AtomicOpType>> fields;
+  for (auto ptr : ptrs) {
+    auto snode = ptr->snode;
+    // No TLS on quant types.
+    bool valid = snode->type == SNodeType::place &&
+                 snode->is_path_all_dense && snode->dt->is<PrimitiveType>() &&
+                 !ptr->indices.empty() &&
+                 (int)ptr->indices.size() == snode->num_active_indices;
+    // The pointer must only be the destination of reductions, whose values
+    // are not used.
+    std::optional<AtomicOpType> op_type;
+    for (auto user : users[ptr]) {
+      auto atomic = user->cast<AtomicOpStmt>();
+      if (!valid || !atomic || atomic->dest != ptr || atomic->val == ptr ||
+          !users[atomic].empty() ||
+          (atomic->op_type != AtomicOpType::add &&
+           atomic->op_type != AtomicOpType::sub &&
+           atomic->op_type != AtomicOpType::max &&
+           atomic->op_type != AtomicOpType::min)) {
+        valid = false;
+        break;
+      }
+      auto this_op_type = atomic->op_type == AtomicOpType::sub
+                              ? AtomicOpType::add
+                              : atomic->op_type;
+      if (op_type && *op_type != this_op_type) {
+        valid = false;
+        break;
+      }
+      op_type = this_op_type;
+    }
+
+    auto field = std::find_if(
+        fields.begin(), fields.end(),
+        [&](const std::pair<SNode *, AtomicOpType> &elem) {
+          return elem.first == snode;
+        });
+    if (!valid || (op_type && field != fields.end() &&
+                   field->second != *op_type)) {
+      invalid_fields.insert(snode);
+    } else if (op_type && field == fields.end()) {
+      fields.push_back({snode, *op_type});
+    }
+  }
+  fields.erase(std::remove_if(fields.begin(), fields.end(),
+                              [&](const std::pair<SNode *, AtomicOpType> &f) {
+                                return invalid_fields.count(f.first) > 0;
+                              }),
+               fields.end());
+  return fields;
+}
+
+TypedConstant get_reduction_identity(AtomicOpType op_type, DataType dt) {
+  return op_type == AtomicOpType::max   ? get_min_value(dt)
+         : op_type == AtomicOpType::min ? get_max_value(dt)
+                                        : TypedConstant(dt, 0);
+}
+
+// A serial loop over [0, end) at the end of |block|.
+RangeForStmt *push_back_serial_loop(Block *block, int end) {
+  auto begin_stmt = block->push_back<ConstStmt>(TypedConstant(0));
+  auto end_stmt = block->push_back<ConstStmt>(TypedConstant(end));
+  return block
+      ->push_back<RangeForStmt>(begin_stmt, end_stmt, std::make_unique<Block>(),
+                                /*is_bit_vectorized=*/false,
+                                /*num_cpu_threads=*/1, /*block_dim=*/1,
+                                /*strictly_serialized=*/false)
+      ->as<RangeForStmt>();
+}
+
+// Gives each thread a private copy of the small fields the task reduces into,
+// so that the reductions in the loop body are plain loads and stores. The
+// copies are merged into the fields when the threads finish.
+//
+// Only the CPU range-fors made by make_cpu_multithreaded_range_for iterate
+// once per thread: elsewhere the TLS buffer is set up for each block, or is
+// too small for an array.
+void make_thread_local_arrays(OffloadedStmt *offload,
+                              const CompileConfig &config,
+                              std::size_t &tls_offset) {
+  std::size_t array_bytes = 0;
+  for (auto &field : find_array_reduction_fields(offload)) {
+    auto snode = field.first;
+    auto op_type = field.second;
+    auto data_type = snode->dt;
+    auto dtype_size = data_type_size(data_type);
+    int dim = snode->num_active_indices;
+    std::vector<int> shape(dim);
+    int64 num_elements = 1;
+    for (int i = 0; i < dim; i++) {
+      shape[i] = snode->shape_along_axis(i);
+      num_elements *= shape[i];
+    }
+    if (array_bytes + num_elements * dtype_size >
+        (std::size_t)config.thread_local_array_max_bytes) {
+      continue;
+    }
+    array_bytes += num_elements * dtype_size;
+
+    // ensure alignment
+    tls_offset += (dtype_size - tls_offset % dtype_size) % dtype_size;
+    auto array_ptr_type = TypeFactory::get_instance().get_pointer_type(
+        TypeFactory::create_tensor_type({(int)num_elements}, data_type));
+    // Pointer to the element |index| of the private copy.
+    auto make_element_ptr = [&](VecStatement &stmts, Stmt *index) {
+      auto array_ptr =
+          stmts.push_back<ThreadLocalPtrStmt>(tls_offset, array_ptr_type);
+      auto offset_bytes = stmts.push_back<BinaryOpStmt>(
+          BinaryOpType::mul, index,
+          stmts.push_back<ConstStmt>(TypedConstant((int32)dtype_size)));
+      return stmts.push_back<MatrixPtrStmt>(array_ptr, offset_bytes);
+    };
+    auto identity = get_reduction_identity(op_type, data_type);
+
+    // Step 1:
+    // Fill the private copy with the identity of the reduction
+    {
+      if (offload->tls_prologue == nullptr) {
+        offload->tls_prologue = std::make_unique<Block>();
+        offload->tls_prologue->set_parent_stmt(offload);
+      }
+      auto loop =
+          push_back_serial_loop(offload->tls_prologue.get(), num_elements);
+      VecStatement stmts;
+      auto index = stmts.push_back<LoopIndexStmt>(loop, 0);
+      auto element_ptr = make_element_ptr(stmts, index);
+      auto value = stmts.push_back<ConstStmt>(identity);
+      // TODO: do not use GlobalStore for TLS ptr.
+      stmts.push_back<GlobalStoreStmt>(element_ptr, value);
+      loop->body->insert(std::move(stmts));
+    }
+
+    // Step 2:
+    // Make loop body accumulate to the private copy instead of the field
+    {
+      std::vector<GlobalPtrStmt *> global_ptrs;
+      irpass::analysis::gather_statements(offload->body.get(), [&](Stmt *stmt) {
+        if (auto global_ptr = stmt->cast<GlobalPtrStmt>()) {
+          if (global_ptr->snode == snode) {
+            global_ptrs.push_back(global_ptr);
+          }
+        }
+        return false;
+      });
+      for (auto global_ptr : global_ptrs) {
+        // Row-major linear index of the element.
+        VecStatement stmts;
+        auto linear_index = global_ptr->indices[0];
+        for (int i = 1; i < dim; i++) {
+          linear_index = stmts.push_back<BinaryOpStmt>(
+              BinaryOpType::mul, linear_index,
+              stmts.push_back<ConstStmt>(TypedConstant(shape[i])));
+          linear_index = stmts.push_back<BinaryOpStmt>(
+              BinaryOpType::add, linear_index, global_ptr->indices[i]);
+        }
+        auto element_ptr = make_element_ptr(stmts, linear_index);
+        global_ptr->replace_usages_with(element_ptr);
+        global_ptr->parent->insert_before(global_ptr, std::move(stmts));
+      }
+    }
+
+    // Step 3:
+    // Reduce the elements of the private copy into the field, skipping the
+    // ones the thread didn't touch
+    {
+      if (offload->tls_epilogue == nullptr) {
+        offload->tls_epilogue = std::make_unique<Block>();
+        offload->tls_epilogue->set_parent_stmt(offload);
+      }
+      auto loop =
+          push_back_serial_loop(offload->tls_epilogue.get(), num_elements);
+      VecStatement stmts;
+      auto index = stmts.push_back<LoopIndexStmt>(loop, 0);
+      auto element_ptr = make_element_ptr(stmts, index);
+      // TODO: do not use global load from TLS.
+      auto value = stmts.push_back<GlobalLoadStmt>(element_ptr);
+      auto cond = stmts.push_back<BinaryOpStmt>(
+          BinaryOpType::cmp_ne, value, stmts.push_back<ConstStmt>(identity));
+      auto if_stmt = stmts.push_back<IfStmt>(cond);
+      loop->body->insert(std::move(stmts));
+
+      auto true_block = std::make_unique<Block>();
+      std::vector<Stmt *> indices(dim);
+      Stmt *partial_index = index;
+      for (int i = dim - 1; i >= 0; i--) {
+        auto shape_stmt = true_block->push_back<ConstStmt>(
+            TypedConstant(shape[i]));
+        indices[i] = true_block->push_back<BinaryOpStmt>(
+            BinaryOpType::mod, partial_index, shape_stmt);
+        partial_index = true_block->push_back<BinaryOpStmt>(
+            BinaryOpType::div, partial_index, shape_stmt);
+      }
+      auto global_ptr = true_block->push_back<GlobalPtrStmt>(snode, indices);
+      true_block->insert(
+          AtomicOpStmt::make_for_reduction(op_type, global_ptr, value), -1);
+      if_stmt->set_true_statements(std::move(true_block));
+    }
+
+    // allocate storage for the TLS array
+    tls_offset += num_elements * dtype_size;
+  }
+}
+
+void make_thread_local_offload(OffloadedStmt *offload,
+                               const CompileConfig &config) {
   if (offload->task_type != OffloadedTaskType::range_for &&
       offload->task_type != OffloadedTaskType::struct_for)
     return;
@@ -207,6 +439,12 @@ void make_thread_local_offload(OffloadedStmt *offload) {
     tls_offset += dtype_size;
   }
 
+  if (arch_is_cpu(config.arch) && config.make_cpu_multithreading_loop &&
+      offload->task_type == OffloadedTaskType::range_for &&
+      config.thread_local_array_max_bytes > 0) {
+    make_thread_local_arrays(offload, config, tls_offset);
+  }
+
   offload->tls_size = std::max(std::size_t(1), tls_offset);
 }
 
@@ -219,10 +457,10 @@ void make_thread_local(IRNode *root, const CompileConfig &config) {
   TI_AUTO_PROF;
   if (auto root_block = root->cast<Block>()) {
     for (auto &offload : root_block->statements) {
-      make_thread_local_offload(offload->cast<OffloadedStmt>());
+      make_thread_local_offload(offload->cast<OffloadedStmt>(), config);
     }
   } else {
-    make_thread_local_offload(root->as<OffloadedStmt>());
+    make_thread_local_offload(root->as<OffloadedStmt>(), config);
   }
   type_check(root, config);
 }
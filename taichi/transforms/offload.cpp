@@ -692,6 +692,7 @@ void insert_gc(IRNode *root, const CompileConfig &config) {
         auto gc_task = Stmt::make_typed<OffloadedStmt>(
             OffloadedStmt::TaskType::gc, config.arch, b->parent_kernel());
         gc_task->snode = snode;
+        gc_task->num_cpu_threads = config.cpu_max_num_threads;
         b->insert(std::move(gc_task), i + 1);
       }
     }
@@ -54,6 +54,8 @@ void ScalarPointerLowerer::run() {
     }
     std::vector<Stmt *> lowered_indices;
     std::vector<int> strides;
+    // Coordinates within this SNode per axis, for the Morton layout.
+    std::vector<Stmt *> axis_indices(taichi_max_num_indices, nullptr);
     // extract lowered indices
     for (int k_ = 0; k_ < (int)indices_.size(); k_++) {
       int k = leaf_snode->physical_index_position[k_];
@@ -76,6 +78,13 @@ void ScalarPointerLowerer::run() {
       is_first_extraction[k] = false;
       lowered_indices.push_back(extracted);
       strides.push_back(snode->extractors[k].shape);
+      axis_indices[k] = extracted;
+    }
+    if (snode->_morton) {
+      // The cells are not in row-major order: compute the cell index here and
+      // linearize it on its own.
+      lowered_indices = {generate_morton_encode(lowered_, snode, axis_indices)};
+      strides = {(int)snode->num_cells_per_container};
     }
     // linearize
     auto *linearized =
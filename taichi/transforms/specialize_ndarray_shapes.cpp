@@ -0,0 +1,38 @@
+#include "taichi/ir/ir.h"
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "taichi/program/kernel.h"
+#include "taichi/system/profiler.h"
+
+namespace taichi::lang {
+
+namespace irpass {
+
+// Replaces the extents of the ndarray arguments |kernel| is specialized on
+// with constants, so that the loops over them get constant bounds and the
+// index arithmetic can be folded. The accesses to the ndarrays are specialized
+// by the codegen, which reads the shapes from the parameters as well.
+void specialize_ndarray_shapes(IRNode *root, const Kernel *kernel) {
+  TI_AUTO_PROF;
+  const auto &params = kernel->parameter_list;
+  auto shapes = irpass::analysis::gather_statements(root, [&](Stmt *stmt) {
+    auto shape = stmt->cast<ExternalTensorShapeAlongAxisStmt>();
+    if (!shape) {
+      return false;
+    }
+    const auto &specialized = params[shape->arg_id].shape;
+    return shape->axis < (int)specialized.size() &&
+           specialized[shape->axis] >= 0;
+  });
+  for (auto stmt : shapes) {
+    auto shape = stmt->as<ExternalTensorShapeAlongAxisStmt>();
+    auto extent = params[shape->arg_id].shape[shape->axis];
+    stmt->replace_with(
+        Stmt::make<ConstStmt>(TypedConstant(PrimitiveType::i32, extent)));
+  }
+}
+
+}  // namespace irpass
+
+}  // namespace taichi::lang
@@ -0,0 +1,369 @@
+#include "taichi/ir/ir.h"
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "taichi/ir/visitors.h"
+#include "taichi/system/profiler.h"
+
+#include <map>
+
+namespace taichi::lang {
+
+namespace {
+
+/* This pass replaces the divisions of a value that advances by one per
+ * iteration of a serial range-for loop, e.g. the loop index, by a
+ * loop-invariant divisor with a quotient and a remainder carried across the
+ * iterations. The remainder is incremented in every iteration, and the
+ * division only runs when it reaches the divisor.
+ *
+ * For example, the following loop, which ndrange loops lower to:
+ *
+ *   for i in range(begin, end):
+ *     q = i // w
+ *     r = i - q * w
+ *
+ * becomes (for w > 0):
+ *
+ *   r_var = w - 1  # so that the first iteration divides
+ *   for i in range(begin, end):
+ *     r_var += 1
+ *     if r_var == w:
+ *       q_var = i // w
+ *       r_var = i - q_var * w
+ *     q = q_var
+ *     r = r_var
+ *
+ * The remainders advance by one as well except when the division runs, and
+ * the quotients by positive divisors advance by one when the remainder wraps
+ * around, so the divisions of both are reduced in turn. This covers the
+ * decomposition of the linear loop index into coordinates by ndrange loops,
+ * and by demoted dense struct-fors and ndarray struct-fors, whose truncating
+ * divisions and remainders by positive divisors are handled too. The
+ * addresses computed from the coordinates then advance by a constant stride
+ * between the divisions, which LLVM turns into pointer increments.
+ *
+ * Only the divisions at the top level of the loop body are reduced, so that
+ * the division of the first iteration runs wherever the original one did.
+ * Parallel loops are left alone, but on CPU the range-fors are split into a
+ * serial loop per thread by make_cpu_multithreaded_range_for.
+ */
+class StrengthReduceInductionVariables : public BasicStmtVisitor {
+ public:
+  using BasicStmtVisitor::visit;
+
+  explicit StrengthReduceInductionVariables(const CompileConfig &config)
+      : config_(config) {
+  }
+
+  void visit(Block *block) override {
+    // The reductions insert statements before the loops.
+    std::vector<Stmt *> statements;
+    for (auto &stmt : block->statements) {
+      statements.push_back(stmt.get());
+    }
+    for (auto stmt : statements) {
+      stmt->accept(this);
+    }
+  }
+
+  void visit(RangeForStmt *stmt) override {
+    stmt->body->accept(this);
+    // The CPU codegen runs the aligned word groups of the element-wise
+    // quant_arrays first, and then jumps back for the rest of the loop.
+    if (stmt->reversed || stmt->is_bit_vectorized || has_continue(stmt) ||
+        irpass::analysis::quant_array_word_group_size(stmt, config_) > 1) {
+      return;
+    }
+    reduce(stmt);
+  }
+
+  static bool run(IRNode *root, const CompileConfig &config) {
+    StrengthReduceInductionVariables pass(config);
+    root->accept(&pass);
+    return pass.modified_;
+  }
+
+ private:
+  // A value that advances by one in the iterations of the loop where
+  // |advance| is true, and is unrelated to its previous value in the ones
+  // where |reset| is true. nullptr stands for every iteration and for none,
+  // respectively.
+  struct Counter {
+    Stmt *advance{nullptr};
+    Stmt *reset{nullptr};
+  };
+
+  struct Reduced {
+    Stmt *quotient;
+    Stmt *remainder;
+  };
+
+  // A continue would skip the increments of the remainders.
+  static bool has_continue(RangeForStmt *loop) {
+    auto continues =
+        irpass::analysis::gather_statements(loop->body.get(), [&](Stmt *s) {
+          auto cont = s->cast<ContinueStmt>();
+          return cont && (cont->scope == nullptr || cont->scope == loop);
+        });
+    return !continues.empty();
+  }
+
+  static bool is_i32(Stmt *stmt) {
+    return stmt->ret_type->is_primitive(PrimitiveTypeID::i32);
+  }
+
+  bool is_defined_outside_loop(Stmt *stmt) const {
+    for (auto block = stmt->parent; block && block->parent_stmt();
+         block = block->parent_stmt()->parent) {
+      if (block->parent_stmt() == loop_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns whether |stmt| has the same value in all the iterations of the
+  // loop. The offload pass copies the ndarray extents and the arithmetic on
+  // them into the loop bodies, e.g. the divisors of ndrange loops over
+  // ndarrays.
+  bool is_invariant(Stmt *stmt) const {
+    if (is_defined_outside_loop(stmt) || stmt->is<ConstStmt>() ||
+        stmt->is<ExternalTensorShapeAlongAxisStmt>()) {
+      return true;
+    }
+    auto bin = stmt->cast<BinaryOpStmt>();
+    // The divisions are not copied before the loop, where they may divide by
+    // zero when the loop runs no iteration.
+    return bin && !is_comparison(bin->op_type) &&
+           bin->op_type != BinaryOpType::div &&
+           bin->op_type != BinaryOpType::floordiv &&
+           bin->op_type != BinaryOpType::mod && is_invariant(bin->lhs) &&
+           is_invariant(bin->rhs);
+  }
+
+  // Returns the value of the invariant |stmt| before the loop.
+  Stmt *hoist(Stmt *stmt, VecStatement &before) const {
+    if (is_defined_outside_loop(stmt)) {
+      return stmt;
+    }
+    auto copy = stmt->clone();
+    for (int i = 0; i < copy->num_operands(); i++) {
+      copy->set_operand(i, hoist(copy->operand(i), before));
+    }
+    return before.push_back(std::move(copy));
+  }
+
+  // The extents of ndarrays and positive constants.
+  static bool is_known_positive(Stmt *stmt) {
+    if (auto c = stmt->cast<ConstStmt>()) {
+      return c->val.val_int32() > 0;
+    }
+    // An extent of 0 would be a division by zero.
+    return stmt->is<ExternalTensorShapeAlongAxisStmt>();
+  }
+
+  bool is_counter(Stmt *stmt, Counter *counter) const {
+    if (auto it = counters_.find(stmt); it != counters_.end()) {
+      *counter = it->second;
+      return true;
+    }
+    if (auto index = stmt->cast<LoopIndexStmt>()) {
+      *counter = Counter();
+      return index->loop == loop_ && index->index == 0;
+    }
+    auto bin = stmt->cast<BinaryOpStmt>();
+    if (!bin || !is_i32(bin) || (bin->op_type != BinaryOpType::add &&
+                                 bin->op_type != BinaryOpType::sub)) {
+      return false;
+    }
+    if (is_invariant(bin->rhs)) {
+      return is_counter(bin->lhs, counter);
+    }
+    return bin->op_type == BinaryOpType::add && is_invariant(bin->lhs) &&
+           is_counter(bin->rhs, counter);
+  }
+
+  // Floor divisions are reduced for any invariant divisor, truncating ones
+  // for positive divisors only.
+  bool is_reducible_divisor(Stmt *divisor, bool floor) const {
+    if (auto c = divisor->cast<ConstStmt>()) {
+      return floor ? c->val.val_int32() != 0 : c->val.val_int32() > 0;
+    }
+    return floor ? is_invariant(divisor) : is_known_positive(divisor);
+  }
+
+  Reduced reduce_division(BinaryOpStmt *op, bool floor, const Counter &of) {
+    auto dividend = op->lhs;
+    auto divisor = op->rhs;
+
+    // The remainder at which the quotient changes: the divisor if it is
+    // positive, and 1 otherwise, since the remainders of floor divisions by
+    // negative divisors count up to 0.
+    VecStatement before;
+    Stmt *wrap;
+    if (auto c = divisor->cast<ConstStmt>()) {
+      auto value = c->val.val_int32();
+      wrap = before.push_back<ConstStmt>(
+          TypedConstant(PrimitiveType::i32, value > 0 ? value : 1));
+    } else if (is_known_positive(divisor)) {
+      wrap = hoist(divisor, before);
+    } else {
+      auto value = hoist(divisor, before);
+      auto zero = before.push_back<ConstStmt>(TypedConstant(0));
+      auto one = before.push_back<ConstStmt>(TypedConstant(1));
+      auto positive =
+          before.push_back<BinaryOpStmt>(BinaryOpType::cmp_gt, value, zero);
+      wrap = before.push_back<TernaryOpStmt>(TernaryOpType::select, positive,
+                                             value, one);
+    }
+    auto quotient_var = before.push_back<AllocaStmt>(PrimitiveType::i32);
+    auto remainder_var = before.push_back<AllocaStmt>(PrimitiveType::i32);
+    auto one = before.push_back<ConstStmt>(TypedConstant(1));
+    auto init = before.push_back<BinaryOpStmt>(BinaryOpType::sub, wrap, one);
+    before.push_back<LocalStoreStmt>(remainder_var, init);
+    loop_->parent->insert_before(loop_, std::move(before));
+
+    VecStatement body;
+    Stmt *remainder = body.push_back<LocalLoadStmt>(remainder_var);
+    auto next = body.push_back<BinaryOpStmt>(
+        BinaryOpType::add, remainder,
+        body.push_back<ConstStmt>(TypedConstant(1)));
+    if (of.advance) {
+      remainder = body.push_back<TernaryOpStmt>(TernaryOpType::select,
+                                                of.advance, next, remainder);
+    } else {
+      remainder = next;
+    }
+    body.push_back<LocalStoreStmt>(remainder_var, remainder);
+    Stmt *wrapped =
+        body.push_back<BinaryOpStmt>(BinaryOpType::cmp_eq, remainder, wrap);
+    if (!floor) {
+      // The remainders of the negative dividends count up from 1 - divisor
+      // to 0.
+      auto zero = body.push_back<ConstStmt>(TypedConstant(0));
+      auto at_one = body.push_back<BinaryOpStmt>(
+          BinaryOpType::cmp_eq, remainder,
+          body.push_back<ConstStmt>(TypedConstant(1)));
+      auto non_positive = body.push_back<BinaryOpStmt>(BinaryOpType::cmp_le,
+                                                       dividend, zero);
+      wrapped = body.push_back<BinaryOpStmt>(
+          BinaryOpType::logical_or, wrapped,
+          body.push_back<BinaryOpStmt>(BinaryOpType::logical_and, at_one,
+                                       non_positive));
+    }
+    Stmt *divide = wrapped;
+    if (of.reset) {
+      divide = body.push_back<BinaryOpStmt>(BinaryOpType::logical_or, wrapped,
+                                            of.reset);
+    }
+    auto if_stmt = body.push_back<IfStmt>(divide);
+    auto true_block = std::make_unique<Block>();
+    auto quotient = true_block->push_back<BinaryOpStmt>(
+        floor ? BinaryOpType::floordiv : BinaryOpType::div, dividend, divisor);
+    auto product = true_block->push_back<BinaryOpStmt>(BinaryOpType::mul,
+                                                       quotient, divisor);
+    auto exact_remainder = true_block->push_back<BinaryOpStmt>(
+        BinaryOpType::sub, dividend, product);
+    true_block->push_back<LocalStoreStmt>(quotient_var, quotient);
+    true_block->push_back<LocalStoreStmt>(remainder_var, exact_remainder);
+    if_stmt->set_true_statements(std::move(true_block));
+
+    Reduced reduced;
+    reduced.quotient = body.push_back<LocalLoadStmt>(quotient_var);
+    reduced.remainder = body.push_back<LocalLoadStmt>(remainder_var);
+    // The remainder advances with the dividend unless the division runs. The
+    // quotient advances by one when the remainder wraps around a positive
+    // divisor, which is how ndarray struct-fors decompose their index.
+    counters_[reduced.remainder] = {of.advance, divide};
+    if (is_known_positive(divisor)) {
+      counters_[reduced.quotient] = {wrapped, of.reset};
+    }
+    op->parent->insert_before(op, std::move(body));
+    return reduced;
+  }
+
+  void reduce(RangeForStmt *loop) {
+    loop_ = loop;
+    counters_.clear();
+    std::map<std::tuple<Stmt *, Stmt *, bool>, Reduced> reduced;
+
+    std::vector<Stmt *> statements;
+    for (auto &s : loop->body->statements) {
+      statements.push_back(s.get());
+    }
+    for (auto s : statements) {
+      auto op = s->cast<BinaryOpStmt>();
+      if (!op || !is_i32(op)) {
+        continue;
+      }
+      bool floor = op->op_type == BinaryOpType::floordiv;
+      if (!floor && op->op_type != BinaryOpType::div &&
+          op->op_type != BinaryOpType::mod) {
+        continue;
+      }
+      Counter counter;
+      if (!is_counter(op->lhs, &counter) ||
+          !is_reducible_divisor(op->rhs, floor)) {
+        continue;
+      }
+      auto key = std::make_tuple(op->lhs, op->rhs, floor);
+      auto it = reduced.find(key);
+      if (it == reduced.end()) {
+        it = reduced.emplace(key, reduce_division(op, floor, counter)).first;
+      }
+      if (op->op_type == BinaryOpType::mod) {
+        irpass::replace_all_usages_with(loop->body.get(), op,
+                                        it->second.remainder);
+        modified_ = true;
+        continue;
+      }
+      if (floor) {
+        // The remainders of floor divisions are spelled x - x // w * w.
+        auto remainders =
+            irpass::analysis::gather_statements(loop->body.get(), [&](Stmt *s) {
+              auto sub = s->cast<BinaryOpStmt>();
+              if (!sub || sub->op_type != BinaryOpType::sub ||
+                  sub->lhs != op->lhs) {
+                return false;
+              }
+              auto mul = sub->rhs->cast<BinaryOpStmt>();
+              return mul && mul->op_type == BinaryOpType::mul &&
+                     ((mul->lhs == op && mul->rhs == op->rhs) ||
+                      (mul->lhs == op->rhs && mul->rhs == op));
+            });
+        for (auto remainder : remainders) {
+          irpass::replace_all_usages_with(loop->body.get(), remainder,
+                                          it->second.remainder);
+        }
+      }
+      irpass::replace_all_usages_with(loop->body.get(), op,
+                                      it->second.quotient);
+      modified_ = true;
+    }
+  }
+
+  const CompileConfig &config_;
+  RangeForStmt *loop_{nullptr};
+  // The quotients and remainders reduced in the current loop.
+  std::unordered_map<Stmt *, Counter> counters_;
+  bool modified_{false};
+};
+
+}  // namespace
+
+namespace irpass {
+
+bool strength_reduce_induction_variables(IRNode *root,
+                                         const CompileConfig &config) {
+  TI_AUTO_PROF;
+  bool modified = StrengthReduceInductionVariables::run(root, config);
+  if (modified) {
+    type_check(root, config);
+  }
+  return modified;
+}
+
+}  // namespace irpass
+
+}  // namespace taichi::lang
@@ -1,3 +1,6 @@
+#include <cstdlib>
+
+#include "taichi/ir/snode.h"
 #include "taichi/ir/statements.h"
 
 namespace taichi::lang {
@@ -21,4 +24,58 @@ Stmt *generate_div(VecStatement *stmts, Stmt *x, int y) {
   return stmts->push_back<BinaryOpStmt>(BinaryOpType::div, x, const_stmt);
 }
 
+namespace {
+
+// Moves the bits of |x| selected by |mask| up by |shift| bits, or down if
+// |shift| is negative.
+Stmt *generate_move_bits(VecStatement *stmts, Stmt *x, int mask, int shift) {
+  auto mask_stmt = stmts->push_back<ConstStmt>(TypedConstant(mask));
+  Stmt *bits =
+      stmts->push_back<BinaryOpStmt>(BinaryOpType::bit_and, x, mask_stmt);
+  if (shift != 0) {
+    auto shift_stmt = stmts->push_back<ConstStmt>(
+        TypedConstant(PrimitiveType::i32, std::abs(shift)));
+    bits = stmts->push_back<BinaryOpStmt>(
+        shift > 0 ? BinaryOpType::bit_shl : BinaryOpType::bit_shr, bits,
+        shift_stmt);
+  }
+  return bits;
+}
+
+}  // namespace
+
+Stmt *generate_morton_encode(VecStatement *stmts,
+                             const SNode *snode,
+                             const std::vector<Stmt *> &indices) {
+  Stmt *linear = stmts->push_back<ConstStmt>(TypedConstant(0));
+  auto bits = snode->morton_bits();
+  for (int i = 0; i < (int)bits.size(); i++) {
+    auto [axis, bit] = bits[i];
+    TI_ASSERT(indices[axis] != nullptr);
+    // Bit |bit| of the coordinate never moves down, since every lower bit of
+    // the coordinate comes before it in the cell index.
+    auto moved = generate_move_bits(stmts, indices[axis], 1 << bit, i - bit);
+    linear =
+        stmts->push_back<BinaryOpStmt>(BinaryOpType::bit_or, linear, moved);
+  }
+  return linear;
+}
+
+Stmt *generate_morton_decode(VecStatement *stmts,
+                             const SNode *snode,
+                             Stmt *linear,
+                             int axis) {
+  Stmt *index = stmts->push_back<ConstStmt>(TypedConstant(0));
+  auto bits = snode->morton_bits();
+  for (int i = 0; i < (int)bits.size(); i++) {
+    if (bits[i].first != axis) {
+      continue;
+    }
+    int bit = bits[i].second;
+    auto moved = generate_move_bits(stmts, linear, 1 << i, bit - i);
+    index = stmts->push_back<BinaryOpStmt>(BinaryOpType::bit_or, index, moved);
+  }
+  return index;
+}
+
 }  // namespace taichi::lang
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 namespace taichi::lang {
 
 // These two helper functions are targeting cases where x is assumed
@@ -8,4 +10,17 @@ namespace taichi::lang {
 Stmt *generate_mod(VecStatement *stmts, Stmt *x, int y);
 Stmt *generate_div(VecStatement *stmts, Stmt *x, int y);
 
+// Computes the linear cell index within a Morton-ordered |snode| from the
+// coordinates within the SNode, given per axis in |indices| (null for the
+// inactive axes).
+Stmt *generate_morton_encode(VecStatement *stmts,
+                             const SNode *snode,
+                             const std::vector<Stmt *> &indices);
+// Computes the coordinate along |axis| within a Morton-ordered |snode| from
+// the linear cell index |linear|.
+Stmt *generate_morton_decode(VecStatement *stmts,
+                             const SNode *snode,
+                             Stmt *linear,
+                             int axis);
+
 }  // namespace taichi::lang
@@ -3,6 +3,7 @@
 #include "taichi/ir/analysis.h"
 #include "taichi/ir/ir_builder.h"
 #include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
 
 namespace taichi::lang {
 namespace irpass {
@@ -129,6 +130,57 @@ TEST(DiffRangeTest, Shl) {
   EXPECT_EQ(diff.high, 1);
 }
 
+TEST(ValueRangeTest, RangeFor) {
+  IRBuilder builder;
+
+  auto *loop = builder.create_range_for(/*begin=*/builder.get_int32(2),
+                                        /*end=*/builder.get_int32(10));
+  Stmt *affine, *mod, *remainder;
+  {
+    auto _ = builder.get_loop_guard(loop);
+    auto *loop_idx = builder.get_loop_index(loop);
+    affine = builder.create_add(
+        builder.create_mul(loop_idx, builder.get_int32(2)),
+        builder.get_int32(1));
+    mod = builder.create_mod(loop_idx, builder.get_int32(4));
+    auto *three = builder.get_int32(3);
+    remainder = builder.create_sub(
+        loop_idx,
+        builder.create_mul(builder.create_floordiv(loop_idx, three), three));
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  EXPECT_EQ(value_range(affine), std::make_pair(int64(5), int64(19)));
+  EXPECT_EQ(value_range(mod), std::make_pair(int64(0), int64(3)));
+  EXPECT_EQ(value_range(remainder), std::make_pair(int64(0), int64(2)));
+}
+
+TEST(ValueRangeTest, UnknownEnd) {
+  IRBuilder builder;
+
+  auto *n = builder.create_arg_load(/*arg_id=*/0, PrimitiveType::i32,
+                                    /*is_ptr=*/false);
+  auto *loop = builder.create_range_for(/*begin=*/builder.get_int32(0),
+                                        /*end=*/n);
+  Stmt *next, *overflow;
+  {
+    auto _ = builder.get_loop_guard(loop);
+    auto *loop_idx = builder.get_loop_index(loop);
+    next = builder.create_add(loop_idx, builder.get_int32(1));
+    overflow = builder.create_mul(loop_idx, builder.get_int32(2));
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  constexpr int64 kMax = std::numeric_limits<int32>::max();
+  constexpr int64 kMin = std::numeric_limits<int32>::min();
+  EXPECT_EQ(value_range(n), std::make_pair(kMin, kMax));
+  EXPECT_EQ(value_range(next), std::make_pair(int64(1), kMax));
+  // The values may wrap around.
+  EXPECT_EQ(value_range(overflow), std::make_pair(kMin, kMax));
+}
+
 }  // namespace analysis
 }  // namespace irpass
 }  // namespace taichi::lang
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "taichi/system/threading.h"
+
+namespace taichi {
+
+TEST(ThreadingTest, ParallelMemoryRoutines) {
+  ThreadPool pool(4);
+  // Not a multiple of the page size, and offset from the start of the vectors
+  // so that the buffers aren't page aligned either.
+  const std::size_t n = (1 << 22) + 5;
+
+  std::vector<uint32> data(n + 1, 0);
+  pool.parallel_fill_u32(data.data() + 1, 42, n);
+  EXPECT_EQ(data[0], 0u);
+  for (std::size_t i = 1; i <= n; i++) {
+    ASSERT_EQ(data[i], 42u);
+  }
+
+  std::vector<uint32> src(n);
+  std::iota(src.begin(), src.end(), 0);
+  pool.parallel_memcpy(data.data() + 1, src.data(), n * sizeof(uint32));
+  EXPECT_EQ(data[0], 0u);
+  for (std::size_t i = 0; i < n; i++) {
+    ASSERT_EQ(data[i + 1], i);
+  }
+
+  pool.parallel_memset(data.data() + 1, 0xff, n * sizeof(uint32));
+  EXPECT_EQ(data[0], 0u);
+  for (std::size_t i = 1; i <= n; i++) {
+    ASSERT_EQ(data[i], 0xffffffffu);
+  }
+
+  // Small buffers are handled on the calling thread.
+  std::vector<uint32> small(3, 0);
+  pool.parallel_fill_u32(small.data(), 1, small.size());
+  EXPECT_EQ(small, std::vector<uint32>(3, 1));
+}
+
+TEST(ThreadingTest, ThreadAffinity) {
+  EXPECT_TRUE(get_thread_affinity("none", 4).empty());
+  EXPECT_EQ(get_thread_affinity("0-1, 3", 5),
+            std::vector<int>({0, 1, 3, 0, 1}));
+  EXPECT_THROW(get_thread_affinity("0-", 4), std::string);
+  EXPECT_THROW(get_thread_affinity("3-1", 4), std::string);
+
+  // Every split runs exactly once when the splits are divided between pinned
+  // workers, including when there are fewer splits than workers.
+  ThreadPool pool(4, get_thread_affinity("compact", 4));
+  for (int splits : {1, 3, 1000}) {
+    for (int num_threads : {1, 2, 4}) {
+      std::vector<std::atomic<int>> counts(splits);
+      pool.run(splits, num_threads, &counts, [](void *counts, int, int i) {
+        (*(std::vector<std::atomic<int>> *)counts)[i]++;
+      });
+      for (int i = 0; i < splits; i++) {
+        ASSERT_EQ(counts[i], 1);
+      }
+    }
+  }
+}
+
+TEST(ThreadingTest, NestedRuns) {
+  // Each split of the outer run starts a nested run on the same pool, whose
+  // splits the idle workers help with.
+  struct Context {
+    ThreadPool *pool;
+    std::vector<std::atomic<int>> counts;
+  };
+  ThreadPool pool(4);
+  const int outer_splits = 3, nested_splits = 1000;
+  Context ctx{&pool, std::vector<std::atomic<int>>(outer_splits *
+                                                   nested_splits)};
+  pool.run(outer_splits, 4, &ctx, [](void *ctx, int, int i) {
+    auto *context = (Context *)ctx;
+    std::pair<Context *, int> nested_ctx{context, i};
+    context->pool->run(nested_splits, 4, &nested_ctx,
+                       [](void *nested_ctx, int, int j) {
+                         auto [context, i] =
+                             *(std::pair<Context *, int> *)nested_ctx;
+                         context->counts[i * nested_splits + j]++;
+                       });
+  });
+  for (auto &count : ctx.counts) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+}  // namespace taichi
@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taichi/system/timeline.h"
+
+namespace taichi {
+
+namespace {
+
+std::string save_timeline() {
+  const std::string filename = "timeline_test.json";
+  Timelines::get_instance().save(filename);
+  std::ifstream fin(filename);
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  std::remove(filename.c_str());
+  return ss.str();
+}
+
+int count(const std::string &s, const std::string &pattern) {
+  int n = 0;
+  for (auto pos = s.find(pattern); pos != std::string::npos;
+       pos = s.find(pattern, pos + 1)) {
+    n++;
+  }
+  return n;
+}
+
+}  // namespace
+
+TEST(TimelineTest, Events) {
+  auto &timelines = Timelines::get_instance();
+  timelines.set_enabled(false);
+  timelines.clear();
+  {
+    TI_TIMELINE("disabled");
+  }
+
+  timelines.set_enabled(true);
+  const int num_threads = 4;
+  // Enough events to fill a few chunks on each thread.
+  const int num_events = Timeline::chunk_size * 2 + 10;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([i] {
+      Timeline::get_this_thread_instance().set_name(
+          fmt::format("test_thread_{}", i));
+      for (int j = 0; j < num_events / 2; j++) {
+        TI_TIMELINE("event \"quoted\"");
+      }
+    });
+  }
+  {
+    TI_TIMELINE("main");
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  timelines.set_enabled(false);
+  {
+    TI_TIMELINE("disabled");
+  }
+
+  auto json = save_timeline();
+  EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+  EXPECT_EQ(json.substr(json.size() - 2), "]}");
+  EXPECT_EQ(count(json, "\"disabled\""), 0);
+  EXPECT_EQ(count(json, "\"name\":\"main\""), 2);
+  EXPECT_EQ(count(json, "\"name\":\"event \\\"quoted\\\"\""),
+            num_threads * (num_events / 2) * 2);
+  EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+  for (int i = 0; i < num_threads; i++) {
+    EXPECT_EQ(count(json, fmt::format("\"name\":\"test_thread_{}\"", i)), 1);
+  }
+
+  timelines.clear();
+  json = save_timeline();
+  EXPECT_EQ(json, "{\"traceEvents\":[]}");
+}
+
+TEST(TimelineTest, ExternalEvents) {
+  auto &timelines = Timelines::get_instance();
+  timelines.clear();
+  timelines.set_enabled(true);
+  auto &timeline = Timeline::get_this_thread_instance();
+  // Later than the clear() above, even with the rounding of the conversion.
+  auto t = Time::get_time() + 1e-3;
+  timeline.insert_event("device_kernel", true, t, "device");
+  timeline.insert_event("device_kernel", false, t + 1e-3, "device");
+  timelines.set_enabled(false);
+
+  auto json = save_timeline();
+  EXPECT_EQ(count(json, "\"name\":\"device_kernel\""), 2);
+  EXPECT_EQ(count(json, "\"args\":{\"name\":\"device\"}"), 1);
+  timelines.clear();
+}
+
+}  // namespace taichi
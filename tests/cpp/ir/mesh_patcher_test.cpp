@@ -0,0 +1,256 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "taichi/ir/mesh_patcher.h"
+
+namespace taichi::lang {
+namespace mesh {
+
+namespace {
+
+// A n*n*n grid of cubes, each split into 6 tetrahedra, followed by a
+// tetrahedron sharing a face with the grid and an isolated vertex.
+struct TetGrid {
+  int num_verts{0};
+  std::vector<int> cells;
+  std::vector<float> positions;
+  // The sorted vertices of each vertex, edge, face and cell, numbered the same
+  // way as the patcher does.
+  std::vector<std::vector<std::vector<int>>> elements;
+
+  explicit TetGrid(int n) {
+    const int tets[6][4] = {{0, 1, 3, 7}, {0, 1, 5, 7}, {0, 2, 3, 7},
+                            {0, 2, 6, 7}, {0, 4, 5, 7}, {0, 4, 6, 7}};
+    auto vert_id = [&](int i, int j, int k) {
+      return (i * (n + 1) + j) * (n + 1) + k;
+    };
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        for (int k = 0; k < n; k++) {
+          int corners[8];
+          for (int c = 0; c < 8; c++) {
+            corners[c] = vert_id(i + (c >> 2), j + (c >> 1 & 1), k + (c & 1));
+          }
+          for (auto &tet : tets) {
+            for (int c : tet) {
+              cells.push_back(corners[c]);
+            }
+          }
+        }
+      }
+    }
+    num_verts = (n + 1) * (n + 1) * (n + 1);
+    cells.insert(cells.end(), {0, 1, 2, num_verts});
+    num_verts += 2;
+    for (int v = 0; v < num_verts; v++) {
+      positions.push_back(v % (n + 1));
+      positions.push_back(v / (n + 1) % (n + 1));
+      positions.push_back(v / (n + 1) / (n + 1));
+    }
+
+    elements.resize(4);
+    std::set<std::vector<int>> edges, faces;
+    for (int v = 0; v < num_verts; v++) {
+      elements[0].push_back({v});
+    }
+    for (std::size_t c = 0; c < cells.size(); c += 4) {
+      std::vector<int> cell(cells.begin() + c, cells.begin() + c + 4);
+      std::sort(cell.begin(), cell.end());
+      elements[3].push_back(cell);
+      for (int a = 0; a < 4; a++) {
+        for (int b = a + 1; b < 4; b++) {
+          edges.insert({cell[a], cell[b]});
+          for (int d = b + 1; d < 4; d++) {
+            faces.insert({cell[a], cell[b], cell[d]});
+          }
+        }
+      }
+    }
+    elements[1].assign(edges.begin(), edges.end());
+    elements[2].assign(faces.begin(), faces.end());
+  }
+
+  // Brute-force neighbors of each element of order |from| in order |to|.
+  std::vector<std::set<int>> neighbors(int from, int to) const {
+    auto contains = [](const std::vector<int> &a, const std::vector<int> &b) {
+      return std::includes(a.begin(), a.end(), b.begin(), b.end());
+    };
+    std::vector<std::set<int>> result(elements[from].size());
+    if (from == to) {
+      // Vertices sharing an edge, or elements sharing a lower order element.
+      int shared = from == 0 ? 1 : from - 1;
+      for (const auto &group : neighbors(shared, from)) {
+        for (int x : group) {
+          for (int y : group) {
+            if (x != y)
+              result[x].insert(y);
+          }
+        }
+      }
+    } else if (from < to) {
+      auto inverse = neighbors(to, from);
+      for (int y = 0; y < (int)inverse.size(); y++) {
+        for (int x : inverse[y])
+          result[x].insert(y);
+      }
+    } else {
+      for (int x = 0; x < (int)elements[from].size(); x++) {
+        for (int y = 0; y < (int)elements[to].size(); y++) {
+          if (contains(elements[from][x], elements[to][y]))
+            result[x].insert(y);
+        }
+      }
+    }
+    return result;
+  }
+};
+
+void check_patched_mesh(const TetGrid &grid, const PatchedMesh &mesh) {
+  std::map<int, const PatchedElement *> elements;
+  for (const auto &element : mesh.elements) {
+    elements[element_order(element.type)] = &element;
+  }
+  ASSERT_EQ(elements.size(), 4);
+  const int num_patches = mesh.num_patches;
+
+  for (const auto &[order, element] : elements) {
+    ASSERT_EQ(element->num, grid.elements[order].size());
+    std::vector<int> num_owners(element->num, 0);
+    for (int p = 0; p < num_patches; p++) {
+      uint32 begin = element->total_offsets[p];
+      int num_owned = element->owned_offsets[p + 1] - element->owned_offsets[p];
+      int num_total = element->total_offsets[p + 1] - begin;
+      ASSERT_LE(num_total, element->max_num_per_patch);
+      for (int l = 0; l < num_total; l++) {
+        uint32 g = element->l2g_mapping[begin + l];
+        uint32 r = element->l2r_mapping[begin + l];
+        ASSERT_EQ(element->g2r_mapping[g], r);
+        if (l < num_owned) {
+          // Owned elements are numbered contiguously in the reordered space.
+          ASSERT_EQ(r, element->owned_offsets[p] + l);
+          num_owners[g]++;
+        }
+      }
+    }
+    for (int g = 0; g < element->num; g++) {
+      ASSERT_EQ(num_owners[g], 1);
+    }
+  }
+
+  ASSERT_EQ(mesh.relations.size(), 16);
+  for (const auto &relation : mesh.relations) {
+    int from = from_end_element_order(relation.type);
+    int to = to_end_element_order(relation.type);
+    const auto &from_element = *elements[from];
+    const auto &to_element = *elements[to];
+    const auto expected = grid.neighbors(from, to);
+    for (int p = 0; p < num_patches; p++) {
+      uint32 from_begin = from_element.total_offsets[p];
+      uint32 to_begin = to_element.total_offsets[p];
+      uint32 to_num = to_element.total_offsets[p + 1] - to_begin;
+      auto to_global = [&](uint16 local) {
+        EXPECT_LT(local, to_num);
+        return (int)to_element.l2g_mapping[to_begin + local];
+      };
+      if (from > to) {
+        int stride = relation.type == MeshRelationType::CE ? 6 : from + 1;
+        int num_total = from_element.total_offsets[p + 1] - from_begin;
+        for (int l = 0; l < num_total; l++) {
+          std::set<int> result;
+          for (int s = 0; s < stride; s++) {
+            auto local = relation.value[(from_begin + l) * stride + s];
+            result.insert(to_global(local));
+          }
+          int g = from_element.l2g_mapping[from_begin + l];
+          ASSERT_EQ(result, expected[g])
+              << relation_type_name(relation.type) << " of " << g;
+        }
+      } else {
+        int num_owned =
+            from_element.owned_offsets[p + 1] - from_element.owned_offsets[p];
+        for (int l = 0; l < num_owned; l++) {
+          int i = p + from_element.owned_offsets[p] + l;
+          std::set<int> result;
+          for (int j = relation.offset[i]; j < relation.offset[i + 1]; j++) {
+            auto local = relation.value[relation.patch_offset[p] + j];
+            result.insert(to_global(local));
+          }
+          int g = from_element.l2g_mapping[from_begin + l];
+          ASSERT_EQ(result, expected[g])
+              << relation_type_name(relation.type) << " of " << g;
+        }
+      }
+    }
+  }
+}
+
+std::vector<MeshRelationType> all_relations() {
+  std::vector<MeshRelationType> relations;
+  for (int from = 0; from < 4; from++) {
+    for (int to = 0; to < 4; to++) {
+      relations.push_back(relation_by_orders(from, to));
+    }
+  }
+  return relations;
+}
+
+}  // namespace
+
+TEST(MeshPatcher, Relations) {
+  TetGrid grid(3);
+  for (auto reorder : {MeshReorderMethod::rcm, MeshReorderMethod::sfc}) {
+    // From one element per patch to a single patch.
+    for (int patch_size : {1, 7, 40, 1000}) {
+      MeshPatcherConfig config;
+      config.patch_size = patch_size;
+      config.reorder = reorder;
+      config.num_threads = 3;
+      auto mesh =
+          build_patched_mesh(MeshTopology::Tetrahedron, grid.cells,
+                             grid.num_verts, grid.positions, all_relations(),
+                             config);
+      int num_cells = grid.cells.size() / 4;
+      EXPECT_EQ(mesh.num_patches, (num_cells + patch_size - 1) / patch_size);
+      check_patched_mesh(grid, mesh);
+    }
+  }
+}
+
+TEST(MeshPatcher, OnlyRequestedElements) {
+  std::vector<int> triangles = {0, 1, 2, 1, 2, 3, 2, 3, 4};
+  auto mesh = build_patched_mesh(MeshTopology::Triangle, triangles, 5, {},
+                                 {MeshRelationType::FV, MeshRelationType::VV},
+                                 MeshPatcherConfig{});
+  // No edges, and no cells on a triangle mesh.
+  ASSERT_EQ(mesh.elements.size(), 2);
+  EXPECT_EQ(mesh.elements[0].type, MeshElementType::Vertex);
+  EXPECT_EQ(mesh.elements[1].type, MeshElementType::Face);
+  EXPECT_EQ(mesh.relations.size(), 2);
+}
+
+TEST(MeshPatcher, InvalidInput) {
+  TetGrid grid(1);
+  MeshPatcherConfig config;
+  config.reorder = MeshReorderMethod::sfc;
+  // Reordering along a space-filling curve requires the vertex positions.
+  EXPECT_THROW(build_patched_mesh(MeshTopology::Tetrahedron, grid.cells,
+                                  grid.num_verts, {}, {MeshRelationType::CV},
+                                  config),
+               std::string);
+  EXPECT_THROW(build_patched_mesh(MeshTopology::Tetrahedron, grid.cells,
+                                  grid.num_verts - 2, {},
+                                  {MeshRelationType::CV}, MeshPatcherConfig{}),
+               std::string);
+  EXPECT_THROW(build_patched_mesh(MeshTopology::Triangle, {0, 1, 2}, 3, {},
+                                  {MeshRelationType::CV}, MeshPatcherConfig{}),
+               std::string);
+  EXPECT_THROW(mesh_reorder_method_from_name("metis"), std::string);
+}
+
+}  // namespace mesh
+}  // namespace taichi::lang
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <random>
+
+#include "taichi/common/cleanup.h"
+#include "taichi/runtime/cpu/launch_autotuner.h"
+
+namespace taichi::lang {
+namespace cpu {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Creates a new empty directory under the temporary directory.
+fs::path make_temp_directory() {
+  std::random_device rd;
+  while (true) {
+    auto path = fs::temp_directory_path() /
+                fmt::format("taichi_launch_autotuner_test_{:08x}", rd());
+    if (fs::create_directory(path)) {
+      return path;
+    }
+  }
+}
+
+std::vector<OffloadedTask> make_tasks() {
+  // A serial task and a range-for compiled for 8 threads with a block_dim of
+  // 32.
+  return {OffloadedTask("k_0_serial"),
+          OffloadedTask("k_1_range_for", /*block_dim=*/32, /*grid_dim=*/8)};
+}
+
+}  // namespace
+
+TEST(LaunchAutotuner, TuneAndReload) {
+  auto tmp_dir = make_temp_directory();
+  auto cleanup = make_cleanup([tmp_dir]() { fs::remove_all(tmp_dir); });
+  auto path = tmp_dir.string();
+  {
+    LaunchAutotuner tuner(path);
+    int kernel = tuner.register_kernel("key", make_tasks());
+    EXPECT_EQ(tuner.get_config(kernel, 0), TaskLaunchConfig());
+
+    int num_launches = 0;
+    while (!tuner.is_tuned(kernel)) {
+      auto config = tuner.get_config(kernel, 1);
+      double seconds = (config.num_threads == 4 ? 1.0 : 2.0) +
+                       (config.block_dim == 256 ? 0.0 : 0.5);
+      tuner.record(kernel, 1, config, seconds);
+      num_launches++;
+    }
+    // 3 thread counts, then 4 block sizes.
+    EXPECT_EQ(num_launches, 7 * LaunchAutotuner::kNumSamples);
+    EXPECT_EQ(tuner.get_config(kernel, 1), (TaskLaunchConfig{256, 4}));
+    tuner.dump();
+  }
+  {
+    LaunchAutotuner tuner(path);
+    int kernel = tuner.register_kernel("key", make_tasks());
+    EXPECT_TRUE(tuner.is_tuned(kernel));
+    EXPECT_EQ(tuner.get_config(kernel, 1), (TaskLaunchConfig{256, 4}));
+
+    int other = tuner.register_kernel("other_key", make_tasks());
+    EXPECT_FALSE(tuner.is_tuned(other));
+    EXPECT_EQ(tuner.get_config(other, 1), TaskLaunchConfig());
+  }
+}
+
+}  // namespace cpu
+}  // namespace taichi::lang
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+
+#ifdef TI_WITH_LLVM
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "taichi/program/program.h"
+#include "taichi/rhi/arch.h"
+#include "taichi/runtime/program_impls/llvm/llvm_program.h"
+
+namespace taichi::lang {
+namespace {
+
+class ParallelPrimitivesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    prog_ = std::make_unique<Program>(host_arch());
+    prog_->materialize_runtime();
+    executor_ = get_llvm_program(prog_.get())->get_runtime_executor();
+  }
+
+  std::unique_ptr<Program> prog_{nullptr};
+  LlvmRuntimeExecutor *executor_{nullptr};
+};
+
+TEST_F(ParallelPrimitivesTest, ScanAdd) {
+  for (int n : {0, 1, 1000, 1 << 20}) {
+    std::vector<int32> data(n);
+    std::mt19937 rng(n);
+    for (auto &x : data) {
+      x = rng() % 100;
+    }
+    std::vector<int32> inclusive = data;
+    std::vector<int32> exclusive = data;
+    executor_->parallel_scan_add(PrimitiveTypeID::i32, inclusive.data(), n,
+                                 /*exclusive=*/false);
+    executor_->parallel_scan_add(PrimitiveTypeID::i32, exclusive.data(), n,
+                                 /*exclusive=*/true);
+    int32 sum = 0;
+    for (int i = 0; i < n; i++) {
+      EXPECT_EQ(exclusive[i], sum);
+      sum += data[i];
+      EXPECT_EQ(inclusive[i], sum);
+    }
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, Compact) {
+  const int n = 100000;
+  std::vector<uint32> in(n);
+  std::vector<int32> flags(n);
+  for (int i = 0; i < n; i++) {
+    in[i] = i * 7;
+    flags[i] = i % 3 == 0;
+  }
+  std::vector<uint32> out(n);
+  int count = executor_->parallel_compact(out.data(), in.data(), flags.data(),
+                                          n, prog_->result_buffer);
+  ASSERT_EQ(count, (n + 2) / 3);
+  for (int i = 0; i < count; i++) {
+    EXPECT_EQ(out[i], i * 3 * 7);
+  }
+
+  // Without an input, the indices are written.
+  count = executor_->parallel_compact(out.data(), nullptr, flags.data(), n,
+                                      prog_->result_buffer);
+  ASSERT_EQ(count, (n + 2) / 3);
+  for (int i = 0; i < count; i++) {
+    EXPECT_EQ(out[i], i * 3);
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, RadixSortPairs) {
+  const int n = 300000;
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float32> dist(-1e3f, 1e3f);
+  std::vector<float32> keys(n);
+  std::vector<int32> values(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = dist(rng);
+    values[i] = i;
+  }
+  keys[0] = -0.0f;
+  keys[1] = 0.0f;
+  std::vector<float32> keys_tmp(n);
+  std::vector<int32> values_tmp(n);
+  std::vector<float32> original = keys;
+
+  executor_->parallel_radix_sort(PrimitiveTypeID::f32, keys.data(),
+                                 values.data(), keys_tmp.data(),
+                                 values_tmp.data(), n);
+  for (int i = 0; i < n; i++) {
+    if (i > 0) {
+      EXPECT_LE(keys[i - 1], keys[i]);
+      // The sort is stable.
+      if (keys[i - 1] == keys[i] && !std::signbit(keys[i - 1]) &&
+          !std::signbit(keys[i])) {
+        EXPECT_LT(values[i - 1], values[i]);
+      }
+    }
+    EXPECT_EQ(original[values[i]], keys[i]);
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, RadixSortKeys) {
+  const int n = 1 << 20;
+  std::mt19937 rng(1);
+  std::vector<int32> keys(n);
+  for (auto &x : keys) {
+    x = (int32)rng();
+  }
+  std::vector<int32> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  std::vector<int32> keys_tmp(n);
+  executor_->parallel_radix_sort(PrimitiveTypeID::i32, keys.data(), nullptr,
+                                 keys_tmp.data(), nullptr, n);
+  EXPECT_EQ(keys, expected);
+
+  // Keys sharing their upper bytes skip the corresponding passes.
+  for (auto &x : keys) {
+    x = rng() % 256;
+  }
+  expected = keys;
+  std::sort(expected.begin(), expected.end());
+  executor_->parallel_radix_sort(PrimitiveTypeID::i32, keys.data(), nullptr,
+                                 keys_tmp.data(), nullptr, n);
+  EXPECT_EQ(keys, expected);
+}
+
+// Keys with the highest bit set sort after the others. The timings against
+// std::sort and numpy are in benchmarks/microbenchmarks/sort.py.
+TEST_F(ParallelPrimitivesTest, RadixSortUnsignedKeys) {
+  const int n = 10000;
+  std::mt19937 rng(2);
+  std::vector<uint32> keys(n);
+  for (auto &x : keys) {
+    x = rng();
+  }
+  std::vector<uint32> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  std::vector<uint32> keys_tmp(n);
+  executor_->parallel_radix_sort(PrimitiveTypeID::u32, keys.data(), nullptr,
+                                 keys_tmp.data(), nullptr, n);
+  EXPECT_EQ(keys, expected);
+}
+
+}  // namespace
+}  // namespace taichi::lang
+
+#endif  // TI_WITH_LLVM
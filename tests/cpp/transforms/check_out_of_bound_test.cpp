@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/ir_builder.h"
+#include "taichi/ir/snode.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "tests/cpp/program/test_program.h"
+
+namespace taichi::lang {
+
+class CheckOutOfBoundTest : public ::testing::Test {
+ protected:
+  static constexpr int kN = 64;
+
+  void SetUp() override {
+    tp_.setup();
+    // x is placed in ti.root.dense(ti.i, kN).
+    root_ = std::make_unique<SNode>(/*depth=*/0, /*t=*/SNodeType::root);
+    x_ = &root_->dense(Axis{0}, kN, "").insert_children(SNodeType::place);
+    x_->dt = PrimitiveType::i32;
+  }
+
+  // Runs the pass on the IR built so far, and returns the number of bound
+  // checks it inserted.
+  int num_checks() {
+    auto ir = builder_.extract_ir();
+    CompileConfig config;
+    irpass::type_check(ir.get(), config);
+    irpass::check_out_of_bound(ir.get(), config, {"test"});
+    return irpass::analysis::gather_statements(ir.get(), [](Stmt *s) {
+             return s->is<AssertStmt>();
+           }).size();
+  }
+
+  TestProgram tp_;
+  IRBuilder builder_;
+  std::unique_ptr<SNode> root_;
+  SNode *x_{nullptr};
+};
+
+TEST_F(CheckOutOfBoundTest, FieldInBound) {
+  // for i in range(kN):
+  //   x[i] = i
+  auto *loop = builder_.create_range_for(builder_.get_int32(0),
+                                         builder_.get_int32(kN));
+  {
+    auto _ = builder_.get_loop_guard(loop);
+    auto *i = builder_.get_loop_index(loop);
+    builder_.create_global_store(builder_.create_global_ptr(x_, {i}), i);
+  }
+  EXPECT_EQ(num_checks(), 0);
+}
+
+TEST_F(CheckOutOfBoundTest, FieldOutOfBound) {
+  // for i in range(kN):
+  //   x[i + 1] = i
+  auto *loop = builder_.create_range_for(builder_.get_int32(0),
+                                         builder_.get_int32(kN));
+  {
+    auto _ = builder_.get_loop_guard(loop);
+    auto *i = builder_.get_loop_index(loop);
+    auto *next = builder_.create_add(i, builder_.get_int32(1));
+    builder_.create_global_store(builder_.create_global_ptr(x_, {next}), i);
+  }
+  EXPECT_EQ(num_checks(), 1);
+}
+
+TEST_F(CheckOutOfBoundTest, Ndarray) {
+  // for i in range(a.shape[0]):
+  //   a[i] = a[i - 1]
+  auto *a = builder_.create_ndarray_arg_load(/*arg_id=*/0,
+                                             get_data_type<int>(), 1);
+  auto *n = builder_.insert(Stmt::make_typed<ExternalTensorShapeAlongAxisStmt>(
+      /*axis=*/0, /*arg_id=*/0));
+  auto *loop = builder_.create_range_for(builder_.get_int32(0), n);
+  {
+    auto _ = builder_.get_loop_guard(loop);
+    auto *i = builder_.get_loop_index(loop);
+    auto *prev = builder_.create_sub(i, builder_.get_int32(1));
+    builder_.create_global_store(
+        builder_.create_external_ptr(a, {i}),
+        builder_.create_global_load(builder_.create_external_ptr(a, {prev})));
+  }
+  // Only a[i - 1] may be out of bound, below 0.
+  EXPECT_EQ(num_checks(), 1);
+}
+
+}  // namespace taichi::lang
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/ir_builder.h"
+#include "taichi/ir/snode.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "tests/cpp/program/test_program.h"
+
+namespace taichi::lang {
+
+class FuseOffloadedRangeForsTest : public ::testing::Test {
+ protected:
+  static constexpr int kN = 64;
+
+  void SetUp() override {
+    tp_.setup();
+    // a, b and c are placed in ti.root.dense(ti.i, kN).
+    root_ = std::make_unique<SNode>(/*depth=*/0, /*t=*/SNodeType::root);
+    auto &dense = root_->dense(Axis{0}, kN, "");
+    for (auto **place : {&a_, &b_, &c_}) {
+      *place = &dense.insert_children(SNodeType::place);
+      (*place)->dt = PrimitiveType::i32;
+    }
+    block_ = std::make_unique<Block>();
+  }
+
+  // Appends a range-for task over [0, kN) to the kernel, and moves the
+  // insertion point of |builder_| to its body.
+  OffloadedStmt *add_range_for_task() {
+    auto *stmt = block_->push_back<OffloadedStmt>(OffloadedTaskType::range_for,
+                                                  Arch::x64, nullptr);
+    auto *task = stmt->as<OffloadedStmt>();
+    task->const_begin = true;
+    task->const_end = true;
+    task->end_value = kN;
+    builder_.set_insertion_point({task->body.get(), 0});
+    return task;
+  }
+
+  int num_tasks() const {
+    int num = 0;
+    for (auto &stmt : block_->statements) {
+      num += stmt->is<OffloadedStmt>();
+    }
+    return num;
+  }
+
+  TestProgram tp_;
+  IRBuilder builder_;
+  std::unique_ptr<SNode> root_;
+  SNode *a_{nullptr};
+  SNode *b_{nullptr};
+  SNode *c_{nullptr};
+  std::unique_ptr<Block> block_;
+};
+
+TEST_F(FuseOffloadedRangeForsTest, Fused) {
+  // for i in range(n):
+  //   a[i] = i
+  auto *task1 = add_range_for_task();
+  auto *i = builder_.get_loop_index(task1);
+  builder_.create_global_store(builder_.create_global_ptr(a_, {i}), i);
+  // Reads a at the index written by the same iteration.
+  // for i in range(n):
+  //   b[i] = a[i] * 2
+  auto *task2 = add_range_for_task();
+  i = builder_.get_loop_index(task2);
+  auto *a_i = builder_.create_global_load(builder_.create_global_ptr(a_, {i}));
+  builder_.create_global_store(builder_.create_global_ptr(b_, {i}),
+                               builder_.create_mul(a_i, builder_.get_int32(2)));
+  irpass::type_check(block_.get(), CompileConfig());
+
+  auto result = irpass::fuse_offloaded_range_fors(block_.get());
+  irpass::analysis::verify(block_.get());
+
+  EXPECT_EQ(result.num_fused_loops, 1);
+  // The load of a[i] in the second task.
+  EXPECT_EQ(result.saved_bytes_per_iteration, sizeof(int32));
+  EXPECT_EQ(num_tasks(), 1);
+  EXPECT_EQ(block_->statements[0].get(), task1);
+  for (auto *index : irpass::analysis::gather_statements(
+           task1->body.get(),
+           [](Stmt *s) { return s->is<LoopIndexStmt>(); })) {
+    EXPECT_EQ(index->as<LoopIndexStmt>()->loop, task1);
+  }
+}
+
+TEST_F(FuseOffloadedRangeForsTest, NotFused) {
+  // for i in range(n):
+  //   b[i] = i
+  auto *task1 = add_range_for_task();
+  auto *i = builder_.get_loop_index(task1);
+  builder_.create_global_store(builder_.create_global_ptr(b_, {i}), i);
+  // Reads b written by another iteration.
+  // for i in range(n):
+  //   c[i] = b[(i + 1) % n]
+  auto *task2 = add_range_for_task();
+  i = builder_.get_loop_index(task2);
+  auto *next =
+      builder_.create_mod(builder_.create_add(i, builder_.get_int32(1)),
+                          builder_.get_int32(kN));
+  builder_.create_global_store(
+      builder_.create_global_ptr(c_, {i}),
+      builder_.create_global_load(builder_.create_global_ptr(b_, {next})));
+  irpass::type_check(block_.get(), CompileConfig());
+
+  auto result = irpass::fuse_offloaded_range_fors(block_.get());
+
+  EXPECT_EQ(result.num_fused_loops, 0);
+  EXPECT_EQ(num_tasks(), 2);
+}
+
+}  // namespace taichi::lang
@@ -130,5 +130,61 @@ TEST(ScalarPointerLowerer, EliminateModDiv) {
          lowered[i]->as<BinaryOpStmt>()->op_type == BinaryOpType::div));
   }
 }
+
+TEST(ScalarPointerLowerer, Morton) {
+  auto root = std::make_unique<SNode>(/*depth=*/0, SNodeType::root);
+  SNode *dense =
+      &(root->dense({Axis{0}, Axis{1}}, /*size=*/{4, 8}, "").morton());
+  SNode *leaf = &(dense->insert_children(SNodeType::place));
+  leaf->dt = PrimitiveType::f32;
+  // Bits of the cell index, from the least significant one:
+  // j0, i0, j1, i1, j2.
+  auto expected = [](int i, int j) {
+    return (j & 1) | (i & 1) << 1 | (j & 2) << 1 | (i & 2) << 2 |
+           (j & 4) << 2;
+  };
+
+  const CompileConfig cfg;
+  IRBuilder builder;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 8; j++) {
+      VecStatement lowered;
+      LowererImpl lowerer{leaf,
+                          {builder.get_int32(i), builder.get_int32(j)},
+                          SNodeOpType::undefined,
+                          /*is_bit_vectorized=*/false,
+                          &lowered};
+      lowerer.run();
+      ASSERT_EQ(lowerer.linears.size(), 2);
+
+      auto block = builder.extract_ir();
+      block->insert(std::move(lowered));
+      irpass::type_check(block.get(), cfg);
+
+      ArithmeticInterpretor::CodeRegion code_region;
+      code_region.block = block.get();
+      code_region.end = lowerer.linears[1];
+      ArithmeticInterpretor::EvalContext init_ctx;
+      for (auto &stmt : code_region.block->statements) {
+        if (stmt->is<GetRootStmt>()) {
+          init_ctx.ignore(stmt.get());
+          break;
+        }
+      }
+
+      ArithmeticInterpretor ai;
+      auto res_opt = ai.evaluate(code_region, init_ctx);
+      ASSERT_TRUE(res_opt.has_value());
+      EXPECT_EQ(res_opt.value().val_int(), expected(i, j));
+    }
+  }
+}
+
+TEST(ScalarPointerLowerer, MortonRequiresPowerOfTwo) {
+  auto root = std::make_unique<SNode>(/*depth=*/0, SNodeType::root);
+  SNode *dense = &(root->dense({Axis{0}, Axis{1}}, /*size=*/{4, 3}, ""));
+  EXPECT_THROW(dense->morton(), std::string);
+}
+
 }  // namespace
 }  // namespace taichi::lang
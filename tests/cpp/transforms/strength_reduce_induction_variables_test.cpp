@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+
+#include "taichi/ir/analysis.h"
+#include "taichi/ir/ir_builder.h"
+#include "taichi/ir/statements.h"
+#include "taichi/ir/transforms.h"
+#include "tests/cpp/program/test_program.h"
+
+namespace taichi::lang {
+
+class StrengthReduceInductionVariablesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tp_.setup();
+  }
+
+  // Returns the divisions and remainders left in |loop| outside of the ifs
+  // the pass guards them with.
+  static std::vector<Stmt *> unguarded_divisions(RangeForStmt *loop) {
+    return irpass::analysis::gather_statements(loop->body.get(), [](Stmt *s) {
+      auto op = s->cast<BinaryOpStmt>();
+      if (!op || (op->op_type != BinaryOpType::floordiv &&
+                  op->op_type != BinaryOpType::div &&
+                  op->op_type != BinaryOpType::mod)) {
+        return false;
+      }
+      auto parent = op->parent->parent_stmt();
+      return !parent || !parent->is<IfStmt>();
+    });
+  }
+
+  TestProgram tp_;
+};
+
+TEST_F(StrengthReduceInductionVariablesTest, Ndrange) {
+  IRBuilder builder;
+  // for i in range(n):
+  //   print(i // w, i - i // w * w)
+  auto *n = builder.create_arg_load(0, get_data_type<int>(), false);
+  auto *w = builder.create_arg_load(1, get_data_type<int>(), false);
+  auto *loop = builder.create_range_for(builder.get_int32(0), n,
+                                        /*is_bit_vectorized=*/false,
+                                        /*num_cpu_threads=*/1,
+                                        /*block_dim=*/1,
+                                        /*strictly_serialized=*/true);
+  PrintStmt *print;
+  {
+    auto _ = builder.get_loop_guard(loop);
+    auto *i = builder.get_loop_index(loop);
+    auto *q = builder.create_floordiv(i, w);
+    auto *r = builder.create_sub(i, builder.create_mul(q, w));
+    print = builder.create_print(q, r);
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  EXPECT_TRUE(irpass::strength_reduce_induction_variables(ir.get(),
+                                                          CompileConfig()));
+  irpass::die(ir.get());
+
+  EXPECT_TRUE(unguarded_divisions(loop).empty());
+  for (const auto &content : print->contents) {
+    ASSERT_TRUE(std::holds_alternative<Stmt *>(content));
+    EXPECT_TRUE(std::get<Stmt *>(content)->is<LocalLoadStmt>());
+  }
+}
+
+TEST_F(StrengthReduceInductionVariablesTest, DemotedStructFor) {
+  IRBuilder builder;
+  // The coordinates of a 3x4x5 dense field:
+  // for i in range(n):
+  //   print(i / 20, i % 20 / 5, i % 5)
+  auto *n = builder.create_arg_load(0, get_data_type<int>(), false);
+  auto *twenty = builder.get_int32(20);
+  auto *five = builder.get_int32(5);
+  auto *loop = builder.create_range_for(builder.get_int32(0), n,
+                                        /*is_bit_vectorized=*/false,
+                                        /*num_cpu_threads=*/1,
+                                        /*block_dim=*/1,
+                                        /*strictly_serialized=*/true);
+  {
+    auto _ = builder.get_loop_guard(loop);
+    auto *i = builder.get_loop_index(loop);
+    auto *x = builder.create_div(i, twenty);
+    auto *y = builder.create_div(builder.create_mod(i, twenty), five);
+    auto *z = builder.create_mod(i, five);
+    builder.create_print(x, y, z);
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  EXPECT_TRUE(irpass::strength_reduce_induction_variables(ir.get(),
+                                                          CompileConfig()));
+  irpass::die(ir.get());
+
+  EXPECT_TRUE(unguarded_divisions(loop).empty());
+  auto ifs = irpass::analysis::gather_statements(
+      loop->body.get(), [](Stmt *s) { return s->is<IfStmt>(); });
+  // One per dividend and divisor: (i, 20), (i % 20, 5) and (i, 5).
+  EXPECT_EQ(ifs.size(), 3);
+}
+
+TEST_F(StrengthReduceInductionVariablesTest, NdarrayStructFor) {
+  IRBuilder builder;
+  // The coordinates of a 3x4x5 ndarray:
+  // for i in range(n):
+  //   print(i / 5 / 4 % 3, i / 5 % 4, i % 5)
+  auto *n = builder.create_arg_load(0, get_data_type<int>(), false);
+  auto *three = builder.get_int32(3);
+  auto *four = builder.get_int32(4);
+  auto *five = builder.get_int32(5);
+  auto *loop = builder.create_range_for(builder.get_int32(0), n,
+                                        /*is_bit_vectorized=*/false,
+                                        /*num_cpu_threads=*/1,
+                                        /*block_dim=*/1,
+                                        /*strictly_serialized=*/true);
+  {
+    auto _ = builder.get_loop_guard(loop);
+    auto *i = builder.get_loop_index(loop);
+    auto *z = builder.create_mod(i, five);
+    auto *t = builder.create_div(i, five);
+    auto *y = builder.create_mod(t, four);
+    t = builder.create_div(t, four);
+    auto *x = builder.create_mod(t, three);
+    builder.create_print(x, y, z);
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  EXPECT_TRUE(irpass::strength_reduce_induction_variables(ir.get(),
+                                                          CompileConfig()));
+  irpass::die(ir.get());
+
+  EXPECT_TRUE(unguarded_divisions(loop).empty());
+}
+
+TEST_F(StrengthReduceInductionVariablesTest, NotReduced) {
+  IRBuilder builder;
+  auto *n = builder.create_arg_load(0, get_data_type<int>(), false);
+  auto *w = builder.create_arg_load(1, get_data_type<int>(), false);
+  // The divisor varies.
+  auto *loop1 = builder.create_range_for(builder.get_int32(0), n);
+  {
+    auto _ = builder.get_loop_guard(loop1);
+    auto *i = builder.get_loop_index(loop1);
+    auto *v = builder.create_add(i, builder.get_int32(1));
+    builder.create_print(builder.create_floordiv(i, v));
+  }
+  // A continue skips the rest of the iteration.
+  auto *loop2 = builder.create_range_for(builder.get_int32(0), n);
+  {
+    auto _ = builder.get_loop_guard(loop2);
+    auto *i = builder.get_loop_index(loop2);
+    auto *if_stmt = builder.create_if(builder.create_cmp_lt(i, w));
+    {
+      auto _ = builder.get_if_guard(if_stmt, true);
+      builder.create_continue();
+    }
+    builder.create_print(builder.create_floordiv(i, w));
+  }
+  // The division is conditional.
+  auto *loop3 = builder.create_range_for(builder.get_int32(0), n);
+  {
+    auto _ = builder.get_loop_guard(loop3);
+    auto *i = builder.get_loop_index(loop3);
+    auto *if_stmt = builder.create_if(builder.create_cmp_ne(w, n));
+    {
+      auto _ = builder.get_if_guard(if_stmt, true);
+      builder.create_print(builder.create_floordiv(i, w));
+    }
+  }
+  auto ir = builder.extract_ir();
+  irpass::type_check(ir.get(), CompileConfig());
+
+  EXPECT_FALSE(irpass::strength_reduce_induction_variables(ir.get(),
+                                                           CompileConfig()));
+}
+
+}  // namespace taichi::lang
@@ -66,6 +66,68 @@ def test_not_out_of_bound():
     func()
 
 
+@test_utils.test(require=ti.extension.assertion, debug=True, gdb_trigger=False)
+def test_out_of_bound_in_loops():
+    x = ti.field(ti.i32, shape=(8, 16))
+
+    @ti.kernel
+    def in_bound():
+        for i, j in ti.ndrange(8, 16):
+            x[i, j] = x[i, (j + 1) % 16] + 1
+        for i, j in x:
+            x[i, j] += 1
+
+    @ti.kernel
+    def out_of_bound():
+        for i in range(8):
+            x[i + 1, i] = 1
+
+    in_bound()
+    with pytest.raises(RuntimeError):
+        out_of_bound()
+
+
+@test_utils.test(arch=[ti.cpu, ti.cuda], debug=True, gdb_trigger=False)
+def test_ndarray_out_of_bound_in_loops():
+    a = ti.ndarray(ti.i32, shape=(4, 5))
+
+    @ti.kernel
+    def in_bound(a: ti.types.ndarray(ndim=2)):
+        for i, j in a:
+            a[i, j] = i
+        for i, j in ti.ndrange(a.shape[0], a.shape[1]):
+            a[i, j] += j
+        for i in range(a.shape[0] - 1):
+            a[i + 1, 0] += 1
+
+    @ti.kernel
+    def out_of_bound(a: ti.types.ndarray(ndim=2)):
+        for i in range(a.shape[0]):
+            a[i, a.shape[1]] = 1
+
+    in_bound(a)
+    assert a[3, 4] == 7
+    with pytest.raises(RuntimeError):
+        out_of_bound(a)
+
+
+@test_utils.test(arch=[ti.cpu, ti.cuda], debug=True, async_runtime_error_check=True, gdb_trigger=False)
+def test_async_runtime_error_check():
+    x = ti.field(ti.i32, shape=3)
+
+    @ti.kernel
+    def func(i: ti.i32):
+        x[i] = 1
+
+    # The error is reported by the next synchronization.
+    func(3)
+    with pytest.raises(AssertionError, match=r"Accessing field"):
+        ti.sync()
+    func(2)
+    ti.sync()
+    assert x[2] == 1
+
+
 @test_utils.test(
     require=[ti.extension.sparse, ti.extension.assertion],
     debug=True,
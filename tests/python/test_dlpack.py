@@ -0,0 +1,163 @@
+import numpy as np
+import pytest
+from taichi.lang.misc import get_host_arch_list
+from taichi.lang.util import has_pytorch
+
+import taichi as ti
+from tests import test_utils
+
+if has_pytorch():
+    import torch
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_ndarray_to_dlpack():
+    x = ti.ndarray(ti.f32, shape=(4, 5))
+
+    @ti.kernel
+    def fill(x: ti.types.ndarray()):
+        for i, j in x:
+            x[i, j] = i * 10 + j
+
+    fill(x)
+    a = np.from_dlpack(x)
+    assert a.shape == (4, 5)
+    assert a.dtype == np.float32
+    np.testing.assert_allclose(a, np.arange(4)[:, None] * 10 + np.arange(5))
+
+    # The memory is shared.
+    a[1, 2] = -1
+    assert x[1, 2] == -1
+    fill(x)
+    assert a[1, 2] == 12
+
+    # The exported array keeps the ndarray alive.
+    del x
+    assert a[3, 4] == 34
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_vector_ndarray_to_dlpack():
+    x = ti.Vector.ndarray(3, ti.i32, shape=4)
+
+    @ti.kernel
+    def fill(x: ti.types.ndarray()):
+        for i in x:
+            x[i] = [i, i + 1, i + 2]
+
+    fill(x)
+    a = np.from_dlpack(x)
+    assert a.shape == (4, 3)
+    np.testing.assert_array_equal(a, np.arange(4)[:, None] + np.arange(3))
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_ndarray_from_dlpack():
+    a = np.zeros((3, 4), dtype=np.int32)
+    x = ti.from_dlpack(a)
+    assert x.shape == (3, 4)
+    assert x.dtype == ti.i32
+
+    @ti.kernel
+    def fill(x: ti.types.ndarray()):
+        for i, j in x:
+            x[i, j] = i * 4 + j
+
+    fill(x)
+    ti.sync()
+    np.testing.assert_array_equal(a, np.arange(12).reshape(3, 4))
+
+    # The ndarray keeps the numpy array alive.
+    del a
+    fill(x)
+    np.testing.assert_array_equal(x.to_numpy(), np.arange(12).reshape(3, 4))
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_ndarray_from_dlpack_reuse():
+    @ti.kernel
+    def fill(x: ti.types.ndarray(), v: ti.i32):
+        for i in x:
+            x[i] = v
+
+    # Each deleted ndarray releases its slot for the next import.
+    arrays = []
+    for v in range(8):
+        a = np.zeros(4, dtype=np.int32)
+        x = ti.from_dlpack(a)
+        fill(x, v)
+        ti.sync()
+        del x
+        arrays.append(a)
+    for v, a in enumerate(arrays):
+        np.testing.assert_array_equal(a, np.full(4, v))
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_ndarray_from_dlpack_offset():
+    a = np.arange(12, dtype=np.float64).reshape(3, 4)
+    x = ti.from_dlpack(a[1:])
+    assert x.shape == (2, 4)
+    assert x[0, 0] == 4
+
+    with pytest.raises(RuntimeError, match=r"Only contiguous DLPack tensors can be imported"):
+        ti.from_dlpack(a[:, ::2])
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_field_to_dlpack():
+    x = ti.field(ti.f32, shape=(3, 4))
+    v = ti.Vector.field(2, ti.i32, shape=5)
+    m = ti.Matrix.field(2, 3, ti.f64, shape=2)
+
+    @ti.kernel
+    def fill():
+        for i, j in x:
+            x[i, j] = i * 4 + j
+        for i in v:
+            v[i] = [i, -i]
+        for i in m:
+            for j, k in ti.static(ti.ndrange(2, 3)):
+                m[i][j, k] = i * 6 + j * 3 + k
+
+    fill()
+    np.testing.assert_array_equal(np.from_dlpack(x), x.to_numpy())
+    np.testing.assert_array_equal(np.from_dlpack(v), v.to_numpy())
+    np.testing.assert_array_equal(np.from_dlpack(m), m.to_numpy())
+
+    # Exporting doesn't copy, so later writes are visible.
+    a = np.from_dlpack(x)
+    x[1, 1] = 100
+    assert a[1, 1] == 100
+
+
+@test_utils.test(arch=get_host_arch_list())
+def test_field_to_dlpack_layout():
+    x = ti.field(ti.i32)
+    y = ti.field(ti.i32)
+    ti.root.dense(ti.i, 4).place(x, y)
+    z = ti.field(ti.i32)
+    ti.root.pointer(ti.i, 2).dense(ti.i, 4).place(z)
+
+    # Each member of an AoS layout is strided.
+    with pytest.raises(RuntimeError, match=r"must be exported together"):
+        np.from_dlpack(x)
+    with pytest.raises(RuntimeError, match=r"dense SNode directly under the root"):
+        np.from_dlpack(z)
+
+
+@pytest.mark.skipif(not has_pytorch(), reason="Pytorch not installed.")
+@test_utils.test(arch=get_host_arch_list())
+def test_dlpack_torch():
+    x = ti.ndarray(ti.f32, shape=(2, 3))
+    x[1, 2] = 5
+    t = torch.utils.dlpack.from_dlpack(x)
+    assert t[1, 2] == 5
+    t[0, 0] = 3
+    assert x[0, 0] == 3
+
+    t = torch.arange(6, dtype=torch.int64).reshape(2, 3)
+    y = ti.from_dlpack(t)
+    assert y.dtype == ti.i64
+    y[0, 1] = 10
+    assert t[0, 1] == 10
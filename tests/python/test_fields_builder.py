@@ -196,6 +196,23 @@ def test_field_initialize_zero():
     assert b[0] == 0
 
 
+@test_utils.test(arch=[ti.cpu, ti.cuda, ti.vulkan, ti.dx11])
+def test_field_initialize_zero_reused_buffer():
+    n = 1 << 20
+    for i in range(3):
+        fb = ti.FieldsBuilder()
+        a = ti.field(ti.i32)
+        b = ti.field(ti.i32)
+        fb.dense(ti.i, n).place(a)
+        fb.pointer(ti.i, n // 64).dense(ti.i, 64).place(b)
+        c = fb.finalize()
+        assert a.to_numpy().sum() == 0
+        assert b.to_numpy().sum() == 0
+        a.fill(i + 1)
+        b.fill(i + 1)
+        c.destroy()
+
+
 @test_utils.test(exclude=[ti.opengl, ti.gles])
 def test_field_builder_place_grad():
     @ti.kernel
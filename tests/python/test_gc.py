@@ -88,3 +88,44 @@ def test_pointer_gc():
 
         # Note that being inactive doesn't mean it's not allocated.
         assert L._num_dynamically_allocated == 1
+
+
+def _test_pointer_gc_reuse():
+    n = 64
+    x = ti.field(dtype=ti.i32)
+    L = ti.root.pointer(ti.ij, n)
+    # Large enough blocks for the collection to run on all the CPU threads.
+    L.dense(ti.ij, 8).place(x)
+
+    @ti.kernel
+    def activate(k: ti.i32, r: ti.i32):
+        for i, j in ti.ndrange(n, n):
+            if (i + j) % k == r % k:
+                x[i * 8 + r % 8, j * 8] = 1
+
+    @ti.kernel
+    def count() -> ti.i32:
+        s = 0
+        for I in ti.grouped(x):
+            s += x[I]
+        return s
+
+    for r in range(16):
+        # Deactivating fewer blocks than the free list holds lets the CPU
+        # backend defer the collection.
+        k = 1 if r == 0 else 4
+        L.deactivate_all()
+        activate(k, r)
+        # Recycled blocks must come back zero-filled.
+        assert count() == n * n // k
+        assert L._num_dynamically_allocated <= n * n
+
+
+@test_utils.test(require=ti.extension.sparse)
+def test_pointer_gc_reuse():
+    _test_pointer_gc_reuse()
+
+
+@test_utils.test(arch=ti.cpu, cpu_deferred_gc=False)
+def test_pointer_gc_reuse_eager():
+    _test_pointer_gc_reuse()
@@ -429,3 +429,135 @@ def test_texture_struct_for():
 
     graph.run({"tex": tex, "arr": arr})
     assert arr.to_numpy().sum() == 128 * 128
+
+
+# The parallel loops of concurrent dispatches are split between the workers.
+@pytest.mark.parametrize("n", [1024, 1 << 20])
+@test_utils.test(arch=ti.cpu, cpu_graph_parallel_dispatch=True)
+def test_graph_parallel_dispatch(n):
+
+    @ti.kernel
+    def fill(arr: ti.types.ndarray(dtype=ti.i32, ndim=1), val: ti.i32):
+        for i in range(n):
+            arr[i] = val
+
+    @ti.kernel
+    def add(dst: ti.types.ndarray(dtype=ti.i32, ndim=1), src: ti.types.ndarray(dtype=ti.i32, ndim=1)):
+        for i in range(n):
+            dst[i] += src[i]
+
+    sym_a = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "a", ti.i32, ndim=1)
+    sym_b = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "b", ti.i32, ndim=1)
+    sym_c = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "c", ti.i32, ndim=1)
+    sym_x = ti.graph.Arg(ti.graph.ArgKind.SCALAR, "x", ti.i32)
+    sym_y = ti.graph.Arg(ti.graph.ArgKind.SCALAR, "y", ti.i32)
+    sym_z = ti.graph.Arg(ti.graph.ArgKind.SCALAR, "z", ti.i32)
+
+    g_builder = ti.graph.GraphBuilder()
+    # Three independent fills, then two dependent accumulations.
+    g_builder.dispatch(fill, sym_a, sym_x)
+    g_builder.dispatch(fill, sym_b, sym_y)
+    g_builder.dispatch(fill, sym_c, sym_z)
+    g_builder.dispatch(add, sym_a, sym_b)
+    g_builder.dispatch(add, sym_a, sym_c)
+    g = g_builder.compile()
+
+    a = ti.ndarray(ti.i32, shape=(n,))
+    b = ti.ndarray(ti.i32, shape=(n,))
+    c = ti.ndarray(ti.i32, shape=(n,))
+    for _ in range(3):
+        g.run({"a": a, "b": b, "c": c, "x": 1, "y": 10, "z": 100})
+        assert (a.to_numpy() == 111).all()
+
+    # The same ndarray bound to two arguments must keep the sequential order.
+    g.run({"a": a, "b": a, "c": c, "x": 1, "y": 10, "z": 100})
+    assert (a.to_numpy() == 120).all()
+
+
+@test_utils.test(arch=[ti.cpu] + supported_archs_cgraph, graph_kernel_fusion=True)
+def test_graph_kernel_fusion():
+    n = 1000
+
+    @ti.kernel
+    def add(
+        dst: ti.types.ndarray(dtype=ti.f32, ndim=1),
+        a: ti.types.ndarray(dtype=ti.f32, ndim=1),
+        b: ti.types.ndarray(dtype=ti.f32, ndim=1),
+    ):
+        for i in range(dst.shape[0]):
+            dst[i] = a[i] + b[i]
+
+    @ti.kernel
+    def scale(dst: ti.types.ndarray(dtype=ti.f32, ndim=1), src: ti.types.ndarray(dtype=ti.f32, ndim=1), k: ti.f32):
+        for i in range(dst.shape[0]):
+            dst[i] = src[i] * k
+
+    @ti.kernel
+    def rotate(dst: ti.types.ndarray(dtype=ti.f32, ndim=1), src: ti.types.ndarray(dtype=ti.f32, ndim=1)):
+        for i in range(dst.shape[0]):
+            dst[i] = src[(i + 1) % dst.shape[0]]
+
+    sym_a = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "a", ti.f32, ndim=1)
+    sym_b = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "b", ti.f32, ndim=1)
+    sym_c = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "c", ti.f32, ndim=1)
+    sym_d = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "d", ti.f32, ndim=1)
+    sym_k = ti.graph.Arg(ti.graph.ArgKind.SCALAR, "k", ti.f32)
+
+    g_builder = ti.graph.GraphBuilder()
+    # Loops over the shapes of c and d, merged when c and d have the same shape.
+    g_builder.dispatch(add, sym_c, sym_a, sym_b)
+    g_builder.dispatch(scale, sym_d, sym_c, sym_k)
+    # Reads a neighbor of what the previous dispatch wrote, so its loop can't
+    # be merged.
+    g_builder.dispatch(rotate, sym_c, sym_d)
+    g = g_builder.compile()
+    assert g._compiled_graph.num_fused_loops() == 1
+
+    a = ti.ndarray(ti.f32, shape=(n,))
+    b = ti.ndarray(ti.f32, shape=(n,))
+    c = ti.ndarray(ti.f32, shape=(n,))
+    d = ti.ndarray(ti.f32, shape=(n,))
+    a_np = np.arange(n, dtype=np.float32)
+    b_np = np.ones(n, dtype=np.float32)
+    a.from_numpy(a_np)
+    b.from_numpy(b_np)
+    g.run({"a": a, "b": b, "c": c, "d": d, "k": 2.0})
+    d_np = (a_np + b_np) * 2
+    assert np.allclose(d.to_numpy(), d_np)
+    assert np.allclose(c.to_numpy(), np.roll(d_np, -1))
+
+    # Binding one ndarray to several arguments keeps the dispatch semantics.
+    g.run({"a": a, "b": b, "c": a, "d": d, "k": 2.0})
+    assert np.allclose(d.to_numpy(), d_np)
+    assert np.allclose(a.to_numpy(), np.roll(d_np, -1))
+
+
+@test_utils.test(arch=[ti.cpu] + supported_archs_cgraph, graph_kernel_fusion=True)
+def test_graph_kernel_fusion_different_shapes():
+    n = 100
+
+    @ti.kernel
+    def fill(x: ti.types.ndarray(dtype=ti.i32, ndim=1)):
+        for i in range(x.shape[0]):
+            x[i] = i
+
+    @ti.kernel
+    def copy(y: ti.types.ndarray(dtype=ti.i32, ndim=1), x: ti.types.ndarray(dtype=ti.i32, ndim=1)):
+        for i in range(y.shape[0]):
+            y[i] = x[i]
+
+    sym_x = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "x", ti.i32, ndim=1)
+    sym_y = ti.graph.Arg(ti.graph.ArgKind.NDARRAY, "y", ti.i32, ndim=1)
+    g_builder = ti.graph.GraphBuilder()
+    g_builder.dispatch(fill, sym_x)
+    g_builder.dispatch(copy, sym_y, sym_x)
+    g = g_builder.compile()
+    assert g._compiled_graph.num_fused_loops() == 1
+
+    # The merged loop is only launched if x and y have the same shape.
+    for x_size in [n, 2 * n]:
+        x = ti.ndarray(ti.i32, shape=(x_size,))
+        y = ti.ndarray(ti.i32, shape=(n,))
+        g.run({"x": x, "y": y})
+        assert (x.to_numpy() == np.arange(x_size)).all()
+        assert (y.to_numpy() == np.arange(n)).all()
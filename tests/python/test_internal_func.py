@@ -1,5 +1,7 @@
 import time
 
+import numpy as np
+
 from taichi.lang import impl
 
 import taichi as ti
@@ -67,3 +69,37 @@ def test_return():
         assert ret == 9
 
     test_cpu()
+
+
+@test_utils.test(arch=ti.cpu)
+def test_cpu_parallel_primitives():
+    N = 100000
+    x = ti.field(ti.i32, N)
+    flags = ti.field(ti.i32, N)
+    out = ti.field(ti.i32, N)
+
+    @ti.kernel
+    def fill():
+        for i in x:
+            x[i] = i % 7
+            flags[i] = i % 3 == 0
+
+    @ti.kernel
+    def scan_and_compact() -> ti.i32:
+        impl.call_internal("cpu_parallel_scan_add_i32", ti.get_addr(x, [0]), N, 1)
+        return impl.call_internal(
+            "cpu_parallel_compact_32",
+            ti.get_addr(out, [0]),
+            ti.get_addr(x, [0]),
+            ti.get_addr(flags, [0]),
+            N,
+        )
+
+    fill()
+    x_np = x.to_numpy()
+    count = scan_and_compact()
+
+    scanned = np.concatenate([[0], np.cumsum(x_np)[:-1]])
+    np.testing.assert_array_equal(x.to_numpy(), scanned)
+    assert count == (N + 2) // 3
+    np.testing.assert_array_equal(out.to_numpy()[:count], scanned[::3])
@@ -0,0 +1,68 @@
+import platform
+
+import pytest
+
+import taichi as ti
+from taichi.profiler import kernel_metrics
+from tests import test_utils
+
+
+def _get_records():
+    ti.sync()
+    return ti.lang.impl.get_runtime().prog.get_kernel_profiler_records()
+
+
+@pytest.mark.skipif(platform.system() != "Linux", reason="The perf toolkit is only available on Linux")
+@test_utils.test(arch=ti.cpu, kernel_profiler=True, cpu_max_num_threads=4)
+def test_kernel_profiler_perf_thread_metrics():
+    x = ti.field(ti.f32, shape=1 << 20)
+
+    @ti.kernel
+    def fill():
+        for i in x:
+            x[i] = ti.sqrt(i)
+
+    assert ti.profiler.set_kernel_profiler_toolkit("perf")
+    # The thread pool metrics don't need access to the hardware counters.
+    ti.profiler.set_kernel_profiler_metrics([kernel_metrics.cpu_thread_busy, kernel_metrics.cpu_thread_idle])
+    fill()
+    records = [r for r in _get_records() if "range_for" in r.name]
+    assert len(records) == 1
+    busy, idle = records[0].metric_values
+    assert busy > 0
+    assert busy + idle == pytest.approx(records[0].kernel_time, rel=1e-3)
+
+
+@pytest.mark.skipif(platform.system() != "Linux", reason="The perf toolkit is only available on Linux")
+@test_utils.test(arch=ti.cpu, kernel_profiler=True)
+def test_kernel_profiler_perf_hardware_metrics():
+    x = ti.field(ti.f32, shape=1 << 20)
+
+    @ti.kernel
+    def fill():
+        for i in x:
+            x[i] = ti.sqrt(i)
+
+    assert ti.profiler.set_kernel_profiler_toolkit("perf")
+    fill()
+    records = _get_records()
+    if not records[0].metric_values:
+        pytest.skip("perf_event_open is not permitted")
+    for record in records:
+        assert len(record.metric_values) == len(kernel_metrics.default_perf_metrics)
+    cycles, instructions = records[-1].metric_values[:2]
+    assert cycles > 0 and instructions > 0
+    ti.profiler.print_kernel_profiler_info("trace")
+
+    # Back to timing only.
+    assert ti.profiler.set_kernel_profiler_toolkit("default")
+    ti.profiler.clear_kernel_profiler_info()
+    fill()
+    assert all(not r.metric_values for r in _get_records())
+
+
+@test_utils.test(arch=ti.cpu, kernel_profiler=True)
+def test_kernel_profiler_perf_unknown_metric():
+    if not ti.profiler.set_kernel_profiler_toolkit("perf"):
+        pytest.skip("The perf toolkit is not available")
+    assert not ti.lang.impl.get_runtime().prog.reinit_kernel_profiler_with_metrics(["dram__bytes.sum"])
@@ -1,6 +1,7 @@
 import os
 
 import numpy as np
+import pytest
 
 import taichi as ti
 from tests import test_utils
@@ -182,8 +183,7 @@ def test_multiple_meshes():
         assert out[i] == i**2
 
 
-@test_utils.test(require=ti.extension.mesh)
-def test_mesh_local():
+def _test_mesh_local():
     mesh_builder = ti.lang.mesh._TetMesh()
     mesh_builder.verts.place({"a": ti.i32})
     model = mesh_builder.build(ti.Mesh.load_meta(model_file_path))
@@ -217,6 +217,17 @@ def test_mesh_local():
         assert res1[i] == res4[i]
 
 
+@test_utils.test(require=ti.extension.mesh)
+def test_mesh_local():
+    _test_mesh_local()
+
+
+@test_utils.test(arch=ti.cpu, cpu_max_num_threads=4)
+def test_mesh_local_cpu_multithreaded():
+    # Each worker thread gathers its patches into its own scratch buffer.
+    _test_mesh_local()
+
+
 @test_utils.test(require=ti.extension.mesh, experimental_auto_mesh_local=True)
 def test_auto_mesh_local():
     mesh_builder = ti.lang.mesh._TetMesh()
@@ -318,3 +329,69 @@ def test_multiple_mesh_major_relations():
     sum1 = model.verts.s.to_numpy().sum()
     sum2 = model.verts.s_.to_numpy().sum()
     assert sum1 == sum2
+
+
+def _test_mesh_build_meta(reorder):
+    # A 3x3x3 grid of cubes, each split into 6 tetrahedra.
+    n = 3
+    cube_tets = np.array([(0, 1, 3, 7), (0, 1, 5, 7), (0, 2, 3, 7), (0, 2, 6, 7), (0, 4, 5, 7), (0, 4, 6, 7)])
+    i, j, k = np.meshgrid(np.arange(n + 1), np.arange(n + 1), np.arange(n + 1), indexing="ij")
+    positions = np.stack([i, j, k], axis=-1).reshape(-1, 3).astype(np.float32)
+    i, j, k = [a.reshape(-1, 1) for a in np.meshgrid(np.arange(n), np.arange(n), np.arange(n), indexing="ij")]
+    corners = np.concatenate(
+        [((i + (c >> 2)) * (n + 1) + j + (c >> 1 & 1)) * (n + 1) + k + (c & 1) for c in range(8)],
+        axis=1,
+    )
+    cells = corners[:, cube_tets].reshape(-1, 4)
+    num_verts = positions.shape[0]
+
+    # Small patches, so that most of the relations cross patch boundaries.
+    meta = ti.Mesh.build_meta(cells, positions, ["CV", "VC", "VV", "CC"], patch_size=8, reorder=reorder)
+    model = ti.Mesh._create_instance(meta)
+    model.verts.place({"num_cells": ti.i32, "vert_sum": ti.i32}, reorder=True)
+    model.cells.place({"vert_sum": ti.i32, "num_cells": ti.i32})
+
+    @ti.kernel
+    def foo():
+        for c in model.cells:
+            for j in range(c.verts.size):
+                c.vert_sum += c.verts[j].id
+            c.num_cells = c.cells.size
+        for v in model.verts:
+            v.num_cells = v.cells.size
+            for j in range(v.verts.size):
+                v.vert_sum += v.verts[j].id
+
+    foo()
+
+    assert (model.cells.vert_sum.to_numpy() == cells.sum(axis=1)).all()
+    assert (model.verts.num_cells.to_numpy() == np.bincount(cells.ravel(), minlength=num_verts)).all()
+
+    adjacent = np.zeros((num_verts, num_verts), dtype=bool)
+    for a in range(4):
+        for b in range(4):
+            if a != b:
+                adjacent[cells[:, a], cells[:, b]] = True
+    assert (model.verts.vert_sum.to_numpy() == adjacent @ np.arange(num_verts)).all()
+
+    # Cells sharing a face, i.e. three vertices.
+    faces = np.sort(cells[:, [[0, 1, 2], [0, 1, 3], [0, 2, 3], [1, 2, 3]]], axis=2).reshape(-1, 3)
+    _, face_id, face_count = np.unique(faces, axis=0, return_inverse=True, return_counts=True)
+    num_cells = (face_count[face_id.ravel()] - 1).reshape(-1, 4).sum(axis=1)
+    assert (model.cells.num_cells.to_numpy() == num_cells).all()
+
+
+@test_utils.test(require=ti.extension.mesh)
+def test_mesh_build_meta_rcm():
+    _test_mesh_build_meta("rcm")
+
+
+@test_utils.test(require=ti.extension.mesh)
+def test_mesh_build_meta_sfc():
+    _test_mesh_build_meta("sfc")
+
+
+@test_utils.test(require=ti.extension.mesh)
+def test_mesh_build_meta_invalid():
+    with pytest.raises(RuntimeError, match="Invalid vertex index"):
+        ti.Mesh.build_meta(np.array([[0, 1, 2, 3]]), np.zeros((3, 3)), ["CV"])
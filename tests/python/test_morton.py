@@ -0,0 +1,75 @@
+import numpy as np
+import pytest
+
+import taichi as ti
+from tests import test_utils
+
+
+def _test_morton_read_write():
+    n = 16
+    x = ti.field(ti.i32)
+    y = ti.field(ti.i32)
+    ti.root.dense(ti.ijk, (n, n // 2, 4)).morton().place(x, y)
+
+    @ti.kernel
+    def fill():
+        for i, j, k in ti.ndrange(n, n // 2, 4):
+            x[i, j, k] = i * 100 + j * 10 + k
+
+    @ti.kernel
+    def copy():
+        for i, j, k in x:
+            y[i, j, k] = x[i, j, k] * 2
+
+    fill()
+    copy()
+    i, j, k = np.meshgrid(np.arange(n), np.arange(n // 2), np.arange(4), indexing="ij")
+    expected = i * 100 + j * 10 + k
+    assert (x.to_numpy() == expected).all()
+    assert (y.to_numpy() == expected * 2).all()
+
+
+@test_utils.test()
+def test_morton_read_write():
+    _test_morton_read_write()
+
+
+@test_utils.test(demote_dense_struct_fors=False)
+def test_morton_read_write_no_demotion():
+    _test_morton_read_write()
+
+
+@test_utils.test(require=ti.extension.sparse)
+def test_morton_pointer_child():
+    x = ti.field(ti.i32)
+    ti.root.dense(ti.ij, 4).morton().pointer(ti.ij, 2).place(x)
+
+    @ti.kernel
+    def activate():
+        x[1, 6] = 1
+        x[7, 2] = 2
+
+    @ti.kernel
+    def count() -> ti.i32:
+        s = 0
+        for i, j in x:
+            s += i * 10 + j
+        return s
+
+    activate()
+    # Only the activated pointer cells, each holding 2x2 elements, are visited.
+    expected = sum(i * 10 + j for i in range(0, 2) for j in range(6, 8))
+    expected += sum(i * 10 + j for i in range(6, 8) for j in range(2, 4))
+    assert count() == expected
+
+
+@test_utils.test(arch=ti.cpu)
+def test_morton_non_power_of_two():
+    with pytest.raises(RuntimeError, match="power-of-two"):
+        ti.root.dense(ti.ij, (4, 3)).morton()
+
+
+@test_utils.test(require=ti.extension.sparse)
+def test_morton_non_dense():
+    with pytest.raises(RuntimeError, match="only supported on dense"):
+        ti.root.pointer(ti.ij, 4).morton()
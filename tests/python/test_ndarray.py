@@ -311,6 +311,21 @@ def test_ndarray_fill():
     assert (c.to_numpy() == cnp).all()
 
 
+@test_utils.test(arch=ti.cpu, cpu_max_num_threads=4)
+def test_ndarray_fill_large():
+    # Large enough for the fill and the zero-fill on creation to be split
+    # across threads, with a size that isn't a multiple of the page size.
+    n = (1 << 22) + 3
+    a = ti.ndarray(ti.i32, shape=(n))
+    assert (a.to_numpy() == 0).all()
+    a.fill(7)
+    assert (a.to_numpy() == 7).all()
+
+    b = ti.ndarray(ti.f32, shape=(n))
+    b.fill(0.5)
+    assert (b.to_numpy() == 0.5).all()
+
+
 @test_utils.test(arch=supported_archs_taichi_ndarray)
 def test_ndarray_rw_cache():
     a = ti.Vector.ndarray(3, ti.f32, ())
@@ -1054,3 +1069,49 @@ def test_ndarray_oob_clamp():
     assert test_mat_arr(x3, 1, -1) == 2
     assert test_mat_arr(x3, 2, 0) == 3
     assert test_mat_arr(x3, 1, 2) == 3
+
+
+@pytest.mark.parametrize("shape_specialization", ["innermost", "all"])
+@test_utils.test(arch=get_host_arch_list())
+def test_ndarray_shape_specialization(shape_specialization):
+    impl.current_cfg().ndarray_shape_specialization = shape_specialization
+
+    @ti.kernel
+    def fill(x: ti.types.ndarray(dtype=ti.math.vec2, ndim=2)):
+        for i, j in ti.ndrange(x.shape[0], x.shape[1]):
+            x[i, j] = [i * x.shape[1] + j, x.shape[0]]
+
+    # Instances specialized on one shape must not be reused for another.
+    shapes = [(3, 4), (5, 4), (5, 8)]
+    for shape in shapes:
+        x = ti.Vector.ndarray(2, ti.f32, shape=shape)
+        fill(x)
+        a = x.to_numpy()
+        np.testing.assert_allclose(a[..., 0], np.arange(shape[0] * shape[1]).reshape(shape))
+        np.testing.assert_allclose(a[..., 1], shape[0])
+    num_instances = 2 if shape_specialization == "innermost" else 3
+    assert len(fill._primal.mapper.mapping) == num_instances
+
+    for shape in shapes:
+        b = np.zeros(shape + (2,), dtype=np.float32)
+        fill(b)
+        np.testing.assert_allclose(b[..., 0], np.arange(shape[0] * shape[1]).reshape(shape))
+        np.testing.assert_allclose(b[..., 1], shape[0])
+
+
+@test_utils.test(arch=get_host_arch_list(), debug=True, ndarray_shape_specialization="all")
+def test_ndarray_shape_specialization_out_of_bound():
+    @ti.kernel
+    def read(x: ti.types.ndarray(), i: ti.i32) -> ti.i32:
+        return x[i]
+
+    x = ti.ndarray(ti.i32, shape=4)
+    x[3] = 3
+    assert read(x, 3) == 3
+    with pytest.raises(AssertionError, match=r"Out of bound access"):
+        read(x, 4)
+
+    # A larger array gets an instance of its own.
+    y = ti.ndarray(ti.i32, shape=8)
+    y[7] = 7
+    assert read(y, 7) == 7
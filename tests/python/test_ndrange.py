@@ -338,3 +338,112 @@ def test_dimension_error():
                 pass
 
         func()
+
+
+@pytest.mark.parametrize("tile", [(4, 8), (3, 5), True])
+@test_utils.test()
+def test_tiled_2d(tile):
+    x = ti.field(ti.i32, shape=(20, 40))
+
+    @ti.kernel
+    def func():
+        ti.loop_config(tile=tile)
+        for i, j in ti.ndrange((2, 18), (1, 38)):
+            x[i, j] += i * 100 + j
+
+    func()
+    expected = np.zeros((20, 40), dtype=np.int32)
+    expected[2:18, 1:38] = np.arange(2, 18)[:, None] * 100 + np.arange(1, 38)
+    assert (x.to_numpy() == expected).all()
+
+
+@test_utils.test()
+def test_tiled_3d_ndarray():
+    @ti.kernel
+    def func(a: ti.types.ndarray(ndim=3)):
+        ti.loop_config(tile=True)
+        for i, j, k in ti.ndrange(a.shape[0], a.shape[1], a.shape[2]):
+            a[i, j, k] += i * 10000 + j * 100 + k
+
+    a = ti.ndarray(ti.i32, shape=(9, 17, 70))
+    func(a)
+    i, j, k = np.meshgrid(np.arange(9), np.arange(17), np.arange(70), indexing="ij")
+    assert (a.to_numpy() == i * 10000 + j * 100 + k).all()
+
+
+@test_utils.test(arch=ti.cpu)
+def test_tiled_sizes_error():
+    with pytest.raises(ti.TaichiSyntaxError, match=r"do not match the 2-D ndrange"):
+
+        @ti.kernel
+        def func():
+            ti.loop_config(tile=(4, 4, 4))
+            for i, j in ti.ndrange(8, 8):
+                pass
+
+        func()
+
+
+@pytest.mark.parametrize("serialize", [False, True])
+@test_utils.test(strength_reduction=True)
+def test_ndrange_strength_reduction(serialize):
+    x = ti.field(ti.i32, shape=(8, 7, 40))
+
+    @ti.kernel
+    def func(n: ti.i32):
+        ti.loop_config(serialize=serialize)
+        for i, j, k in ti.ndrange((-3, 5), (2, 9), n):
+            x[i + 3, j - 2, k] = i * 10000 + j * 100 + k
+
+    func(37)
+    i, j, k = np.meshgrid(np.arange(-3, 5), np.arange(2, 9), np.arange(40), indexing="ij")
+    expected = np.where(k < 37, i * 10000 + j * 100 + k, 0)
+    assert (x.to_numpy() == expected).all()
+
+
+@test_utils.test(strength_reduction=True)
+def test_struct_for_strength_reduction():
+    x = ti.field(ti.i32, shape=(3, 5, 7))
+
+    @ti.kernel
+    def func():
+        for i, j, k in x:
+            x[i, j, k] = i * 100 + j * 10 + k
+
+    func()
+    i, j, k = np.meshgrid(np.arange(3), np.arange(5), np.arange(7), indexing="ij")
+    assert (x.to_numpy() == i * 100 + j * 10 + k).all()
+
+
+@test_utils.test(strength_reduction=True)
+def test_ndarray_struct_for_strength_reduction():
+    @ti.kernel
+    def func(a: ti.types.ndarray(ndim=3)):
+        for i, j, k in a:
+            a[i, j, k] = i * 10000 + j * 100 + k
+
+    a = ti.ndarray(ti.i32, shape=(5, 17, 70))
+    func(a)
+    i, j, k = np.meshgrid(np.arange(5), np.arange(17), np.arange(70), indexing="ij")
+    assert (a.to_numpy() == i * 10000 + j * 100 + k).all()
+
+
+@test_utils.test(require=ti.extension.quant, arch=ti.cpu, strength_reduction=True)
+def test_quant_array_strength_reduction():
+    qi8 = ti.types.quant.int(8)
+    q = ti.field(dtype=qi8)
+    n = 1024
+    ti.root.dense(ti.i, n // 4).quant_array(ti.i, 4, max_num_bits=32).place(q)
+    x = ti.field(ti.i32, shape=(n // 7 + 1, 7))
+
+    @ti.kernel
+    def store(begin: ti.i32, end: ti.i32):
+        # The stores are grouped by words, so the loop does not run in order.
+        for i in range(begin, end):
+            q[i] = x[i // 7, i % 7]
+
+    i, j = np.meshgrid(np.arange(n // 7 + 1), np.arange(7), indexing="ij")
+    x.from_numpy(((i * 7 + j) % 100).astype(np.int32))
+    store(3, n - 5)
+    for i in range(n):
+        assert q[i] == (i % 100 if 3 <= i < n - 5 else 0)
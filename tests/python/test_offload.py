@@ -82,3 +82,34 @@ def test_reduce_merged():
         assert b.grad[i] == 1
     for i in range(16):
         assert a.grad[i] == 1
+
+
+@test_utils.test(fuse_range_for_tasks=True)
+def test_fuse_range_for_tasks():
+    n = 64
+    a = ti.field(ti.i32, shape=n)
+    b = ti.field(ti.i32, shape=n)
+    c = ti.field(ti.i32, shape=n)
+    total = ti.field(ti.i32, shape=())
+
+    @ti.kernel
+    def compute():
+        for i in range(n):
+            a[i] = i
+        # Fusible: reads a at the index written by the same iteration.
+        for i in range(n):
+            b[i] = a[i] * 2
+        # Dense struct-fors are demoted to range-fors and fused as well.
+        for i in b:
+            b[i] += 1
+        # Not fusible: reads b written by other iterations.
+        for i in range(n):
+            c[i] = b[(i + 1) % n]
+        for i in range(n):
+            total[None] += c[i]
+
+    compute()
+    for i in range(n):
+        assert b[i] == i * 2 + 1
+        assert c[i] == (i + 1) % n * 2 + 1
+    assert total[None] == n * n
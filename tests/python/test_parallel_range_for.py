@@ -1,3 +1,5 @@
+import numpy as np
+
 import taichi as ti
 from tests import test_utils
 
@@ -87,3 +89,109 @@ def test_loop_config_block_dim_adaptive():
     val_np = val.to_numpy()
     for i in range(n):
         assert val_np[i] == i
+
+
+def _test_block_range_for():
+    n = 1000
+    x = ti.field(ti.f32, shape=n, needs_grad=True)
+    y = ti.field(ti.f32, shape=n, needs_grad=True)
+    x.from_numpy(np.arange(n, dtype=np.float32))
+
+    @ti.kernel
+    def elementwise():
+        for i in range(n):
+            y[i] = x[i] * 2 + 1
+
+    @ti.kernel
+    def stencil():
+        for i in range(1, n - 1):
+            y[i] = x[i - 1] + x[i] + x[i + 1]
+
+    @ti.kernel
+    def skip_odd():
+        for i in range(n):
+            if i % 2 == 1:
+                continue
+            y[i] = x[i]
+
+    @ti.kernel
+    def mirror():
+        for i in range(n):
+            y[n - 1 - i] = x[i]
+
+    @ti.kernel
+    def square():
+        for i in range(n):
+            y[i] = x[i] * x[i]
+
+    x_np = x.to_numpy()
+    elementwise()
+    np.testing.assert_allclose(y.to_numpy(), x_np * 2 + 1)
+
+    y.fill(0)
+    stencil()
+    expected = np.zeros(n, dtype=np.float32)
+    expected[1:-1] = x_np[:-2] + x_np[1:-1] + x_np[2:]
+    np.testing.assert_allclose(y.to_numpy(), expected)
+
+    y.fill(-1)
+    skip_odd()
+    expected = np.where(np.arange(n) % 2 == 0, x_np, -1)
+    np.testing.assert_allclose(y.to_numpy(), expected)
+
+    mirror()
+    np.testing.assert_allclose(y.to_numpy(), x_np[::-1])
+
+    # The adjoint kernel runs the loop reversed.
+    y.grad.fill(1)
+    x.grad.fill(0)
+    square.grad()
+    np.testing.assert_allclose(x.grad.to_numpy(), x_np * 2)
+
+
+@test_utils.test(arch=ti.cpu, simd_width=1)
+def test_block_range_for_no_simd():
+    _test_block_range_for()
+
+
+@test_utils.test(arch=ti.cpu, simd_width=8)
+def test_block_range_for_simd8():
+    _test_block_range_for()
+
+
+@test_utils.test(arch=ti.cpu, simd_width=16, max_vector_width=16)
+def test_block_range_for_simd16():
+    _test_block_range_for()
+
+
+@test_utils.test(arch=ti.cpu, make_cpu_multithreading_loop=False)
+def test_block_range_for_single_block():
+    _test_block_range_for()
+
+
+@test_utils.test(arch=ti.cpu, cpu_launch_autotune=True, make_cpu_multithreading_loop=False)
+def test_parallel_for_launch_autotune():
+    n = 10000
+    x = ti.field(ti.i32, shape=n)
+    y = ti.field(ti.i32)
+    ti.root.pointer(ti.i, 16).dense(ti.i, 64).place(y)
+
+    @ti.kernel
+    def fill():
+        for i in range(n):
+            x[i] += i
+        for i in range(1000):
+            y[i] = 0
+        for i in y:
+            y[i] += i
+
+    # Every launch runs with another block size or number of threads until all
+    # candidates are timed.
+    for _ in range(30):
+        fill()
+    x_np = x.to_numpy()
+    y_np = y.to_numpy()
+    for i in range(n):
+        assert x_np[i] == 30 * i
+    for i in range(1000):
+        assert y_np[i] == i
@@ -1,3 +1,4 @@
+import pytest
 import taichi as ti
 from tests import test_utils
 
@@ -125,3 +126,76 @@ def test_quant_array_struct_for():
     activate()
     assign()
     verify()
+
+
+def _test_quant_array_range_for_store(bits):
+    qi = ti.types.quant.int(bits)
+    x = ti.field(dtype=qi)
+    y = ti.field(dtype=qi)
+    n = 1024
+    k = 32 // bits
+    ti.root.dense(ti.i, n // k).quant_array(ti.i, k, max_num_bits=32).place(x)
+    ti.root.dense(ti.i, n // k).quant_array(ti.i, k, max_num_bits=32).place(y)
+
+    @ti.kernel
+    def fill(v: ti.i32):
+        for i in range(n):
+            x[i] = v
+
+    @ti.kernel
+    def store(begin: ti.i32, end: ti.i32):
+        # Also reads the other elements of the words being written. Whether
+        # x[i ^ 1] was written yet depends on the threads, but all the values
+        # of x are below 4.
+        for i in range(begin, end):
+            x[i] = i % 7 - 3
+            y[i] = ti.max(x[i ^ 1], 4)
+
+    # So that i ^ 1 < n.
+    assert n % 2 == 0
+    fill(1)
+    # Unaligned bounds, so that some words are only partially written.
+    store(3, n - 5)
+    for i in range(n):
+        if 3 <= i < n - 5:
+            assert x[i] == i % 7 - 3
+            assert y[i] == 4
+        else:
+            assert x[i] == 1
+            assert y[i] == 0
+
+
+@pytest.mark.parametrize("bits", [4, 8, 16])
+@test_utils.test(require=ti.extension.quant, arch=ti.cpu)
+def test_quant_array_range_for_store(bits):
+    _test_quant_array_range_for_store(bits)
+
+
+@pytest.mark.parametrize("bits", [4, 8, 16])
+@test_utils.test(require=ti.extension.quant, arch=ti.cpu, make_cpu_multithreading_loop=False)
+def test_quant_array_range_for_store_single_loop(bits):
+    _test_quant_array_range_for_store(bits)
+
+
+@test_utils.test(require=ti.extension.quant, arch=ti.cpu)
+def test_quant_array_range_for_atomic_add():
+    qi8 = ti.types.quant.int(8)
+    qfxt = ti.types.quant.fixed(bits=16, max_value=64)
+    x = ti.field(dtype=qi8)
+    y = ti.field(dtype=qfxt)
+    n = 1000
+    ti.root.dense(ti.i, n // 4 + 1).quant_array(ti.i, 4, max_num_bits=32).place(x)
+    ti.root.dense(ti.i, n // 2).quant_array(ti.i, 2, max_num_bits=32).place(y)
+
+    @ti.kernel
+    def add(begin: ti.i32, end: ti.i32):
+        for i in range(begin, end):
+            x[i] += i % 5
+            ti.atomic_add(y[i], 0.5 * (i % 3))
+
+    add(0, n)
+    add(1, n - 1)
+    for i in range(n):
+        times = 2 if 1 <= i < n - 1 else 1
+        assert x[i] == times * (i % 5)
+        assert y[i] == times * 0.5 * (i % 3)
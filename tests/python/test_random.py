@@ -169,3 +169,102 @@ def test_randn():
         moments = [0.0, 1.0, 0.0, 3.0]
         for i in range(4):
             assert (X ** (i + 1)).mean() == test_utils.approx(moments[i], abs=3e-2)
+
+
+def _gen_counter_based(num_threads):
+    ti.init(arch=ti.cpu, counter_based_rng=True, cpu_max_num_threads=num_threads)
+    n = 4096
+    x = ti.field(ti.f32, shape=(n, 4))
+    y = ti.field(ti.i32)
+    ti.root.pointer(ti.i, n // 16).dense(ti.i, 16).place(y)
+
+    @ti.kernel
+    def gen():
+        for i in range(n):
+            for j in range(4):
+                x[i, j] = ti.random()
+
+    @ti.kernel
+    def activate():
+        for i in range(n):
+            if i % 3 == 0:
+                y[i] = 1
+
+    @ti.kernel
+    def gen_sparse():
+        for i in y:
+            y[i] = ti.random(ti.i32)
+
+    results = []
+    for _ in range(2):
+        gen()
+        results.append(x.to_numpy())
+    activate()
+    gen_sparse()
+    results.append(y.to_numpy())
+    ti.reset()
+    return results
+
+
+@test_utils.test(arch=ti.cpu)
+def test_random_counter_based_thread_count_independent():
+    import numpy as np
+
+    serial = _gen_counter_based(1)
+    parallel = _gen_counter_based(8)
+    for a, b in zip(serial, parallel):
+        assert np.array_equal(a, b)
+    # The launches and the calls within an iteration draw different numbers.
+    assert not np.array_equal(serial[0], serial[1])
+    assert len(np.unique(serial[0])) > serial[0].size * 0.99
+
+
+def _gen_counter_based_graph(parallel_dispatch):
+    ti.init(arch=ti.cpu, counter_based_rng=True, cpu_graph_parallel_dispatch=parallel_dispatch)
+    n = 4096
+
+    @ti.kernel
+    def gen(x: ti.types.ndarray(dtype=ti.f32, ndim=1)):
+        for i in range(n):
+            x[i] = ti.random()
+
+    g_builder = ti.graph.GraphBuilder()
+    for name in "abc":
+        g_builder.dispatch(gen, ti.graph.Arg(ti.graph.ArgKind.NDARRAY, name, ti.f32, ndim=1))
+    g = g_builder.compile()
+    arrs = {name: ti.ndarray(ti.f32, shape=(n,)) for name in "abc"}
+    g.run(arrs)
+    results = [arr.to_numpy() for arr in arrs.values()]
+    ti.reset()
+    return results
+
+
+@test_utils.test(arch=ti.cpu)
+def test_random_counter_based_graph_parallel_dispatch():
+    import numpy as np
+
+    # The independent dispatches run concurrently, but draw the numbers of
+    # their position in the graph.
+    sequential = _gen_counter_based_graph(False)
+    parallel = _gen_counter_based_graph(True)
+    for a, b in zip(sequential, parallel):
+        assert np.array_equal(a, b)
+    assert not np.array_equal(sequential[0], sequential[1])
+
+
+@test_utils.test(arch=[ti.cpu, ti.cuda], counter_based_rng=True)
+def test_random_counter_based_dist():
+    n = 1024
+    x = ti.field(ti.f64, shape=(n, n))
+
+    @ti.kernel
+    def fill():
+        for i in range(n):
+            for j in range(n):
+                x[i, j] = ti.random(ti.f64) * ti.random()
+
+    fill()
+    X = x.to_numpy()
+    # The moments of the product of two independent uniform numbers.
+    for i in range(1, 4):
+        assert (X**i).mean() == test_utils.approx(1 / (i + 1) ** 2, rel=1e-2)
@@ -163,3 +163,80 @@ def test_reduction_ndarray():
     n = 1024
     x = np.ones(n, dtype=np.int32)
     assert reduce(x) == -n
+
+
+def _test_reduction_histogram():
+    n = 100000
+    num_bins = 37
+    x = ti.field(ti.i32, shape=n)
+    hist = ti.field(ti.i32, shape=num_bins)
+    hist_min = ti.field(ti.f32, shape=num_bins)
+
+    @ti.kernel
+    def fill():
+        for i in x:
+            x[i] = (i * 7 + i // 3) % num_bins
+
+    @ti.kernel
+    def histogram(begin: ti.i32, end: ti.i32):
+        for i in range(begin, end):
+            hist[x[i]] += 1
+            ti.atomic_sub(hist[x[i]], 2)
+            ti.atomic_min(hist_min[x[i]], -i * 0.5)
+
+    fill()
+    hist_min.fill(1)
+    hist[3] = 100
+    histogram(5, n)
+    x_np = x.to_numpy()[5:]
+    expected = -np.bincount(x_np, minlength=num_bins)
+    expected[3] += 100
+    assert (hist.to_numpy() == expected).all()
+    for b in range(num_bins):
+        indices = np.nonzero(x_np == b)[0] + 5
+        assert hist_min[b] == (-indices.max() * 0.5 if len(indices) else 1)
+
+
+@test_utils.test(arch=ti.cpu)
+def test_reduction_histogram():
+    _test_reduction_histogram()
+
+
+@test_utils.test(arch=ti.cpu, thread_local_array_max_bytes=0)
+def test_reduction_histogram_global_atomics():
+    _test_reduction_histogram()
+
+
+@test_utils.test(arch=ti.cpu)
+def test_reduction_scatter_add_2d():
+    n = 20000
+    grid = ti.field(ti.f32, shape=(8, 16))
+    pos = ti.Vector.field(2, ti.f32, shape=n)
+
+    @ti.kernel
+    def init():
+        for p in pos:
+            pos[p] = [ti.random(), ti.random()]
+
+    @ti.kernel
+    def p2g():
+        for p in pos:
+            base = ti.cast(pos[p] * ti.Vector([8, 16]), ti.i32)
+            for offset in ti.static(ti.grouped(ti.ndrange(2, 2))):
+                I = ti.min(base + offset, ti.Vector([7, 15]))
+                grid[I] += 0.25
+
+    init()
+    p2g()
+    assert grid.to_numpy().sum() == approx(n)
+    pos_np = pos.to_numpy()
+    base = (pos_np * np.array([8, 16])).astype(np.int32)
+    expected = np.zeros((8, 16))
+    for di in range(2):
+        for dj in range(2):
+            np.add.at(
+                expected,
+                (np.minimum(base[:, 0] + di, 7), np.minimum(base[:, 1] + dj, 15)),
+                0.25,
+            )
+    assert grid.to_numpy() == approx(expected)
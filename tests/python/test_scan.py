@@ -3,7 +3,7 @@ import taichi as ti
 from tests import test_utils
 
 
-@test_utils.test(arch=[ti.cuda, ti.vulkan], exclude=[(ti.vulkan, "Darwin")])
+@test_utils.test(arch=[ti.cpu, ti.cuda, ti.vulkan], exclude=[(ti.vulkan, "Darwin")])
 def test_scan():
     def test_scan_for_dtype(dtype, N):
         arr = ti.field(dtype, N)
@@ -36,7 +36,7 @@ def test_scan():
 @pytest.mark.parametrize("dtype", [ti.i32])
 @pytest.mark.parametrize("N", [512, 1024, 4096])
 @pytest.mark.parametrize("offset", [0, -1, 1, 256, -256, -23333, 23333])
-@test_utils.test(arch=[ti.cuda, ti.vulkan], exclude=[(ti.vulkan, "Darwin")])
+@test_utils.test(arch=[ti.cpu, ti.cuda, ti.vulkan], exclude=[(ti.vulkan, "Darwin")])
 def test_scan_with_offset(dtype, N, offset):
     arr = ti.field(dtype, N, offset=offset)
     arr_aux = ti.field(dtype, N, offset=offset)
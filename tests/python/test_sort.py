@@ -1,3 +1,4 @@
+import numpy as np
 import pytest
 import taichi as ti
 from tests import test_utils
@@ -58,3 +59,41 @@ def test_sort_with_offset(dtype, N, offset):
         if i < N - 1:
             assert keys_host[i] <= keys_host[i + 1]
         assert keys_host[i] == values_host[i]
+
+
+@pytest.mark.parametrize("dtype", [ti.i32, ti.u32, ti.f32])
+@test_utils.test(arch=ti.cpu)
+def test_sort_signed_keys(dtype):
+    N = 100001
+    keys = ti.field(dtype, N)
+    values = ti.field(ti.i32, N)
+
+    if dtype == ti.u32:
+        keys_np = np.random.randint(0, 2**32, N, dtype=np.uint32)
+    elif dtype == ti.i32:
+        keys_np = np.random.randint(-(2**31), 2**31, N, dtype=np.int32)
+    else:
+        keys_np = np.random.uniform(-1e6, 1e6, N).astype(np.float32)
+    keys.from_numpy(keys_np)
+    values.from_numpy(np.arange(N, dtype=np.int32))
+
+    ti.algorithms.parallel_sort(keys, values)
+
+    order = np.argsort(keys_np, kind="stable")
+    np.testing.assert_array_equal(keys.to_numpy(), keys_np[order])
+    np.testing.assert_array_equal(values.to_numpy(), order)
+
+
+@test_utils.test(arch=ti.cpu)
+def test_sort_reuses_scratch():
+    from taichi.algorithms._algorithms import _get_cpu_radix_sort_scratch
+
+    # Sorting fields of different lengths shares one scratch, which only grows.
+    for N in [1000, 100, 3000, 2000]:
+        keys = ti.field(ti.i32, N)
+        keys_np = np.random.randint(-1000, 1000, N, dtype=np.int32)
+        keys.from_numpy(keys_np)
+        ti.algorithms.parallel_sort(keys)
+        np.testing.assert_array_equal(keys.to_numpy(), np.sort(keys_np))
+    keys_tmp, _ = _get_cpu_radix_sort_scratch(2000, ti.i32, None)
+    assert keys_tmp.shape == (4096,)
@@ -0,0 +1,48 @@
+import pytest
+from taichi.lang import impl
+
+import taichi as ti
+from tests import test_utils
+
+
+def _test_pinned_range_for():
+    n = 1 << 16
+    x = ti.field(ti.i32, shape=n)
+    thread_ids = ti.field(ti.i32, shape=n)
+
+    @ti.kernel
+    def sweep():
+        for i in range(n):
+            x[i] += i
+            thread_ids[i] = impl.call_internal("linear_thread_idx")
+
+    for _ in range(3):
+        sweep()
+    x_np = x.to_numpy()
+    thread_ids_np = thread_ids.to_numpy()
+    for i in range(n):
+        assert x_np[i] == 3 * i
+    assert thread_ids_np.min() >= 0
+    assert thread_ids_np.max() < 4
+
+
+@test_utils.test(arch=ti.cpu, cpu_max_num_threads=4, cpu_thread_affinity="compact")
+def test_thread_affinity_compact():
+    _test_pinned_range_for()
+
+
+@test_utils.test(arch=ti.cpu, cpu_max_num_threads=4, cpu_thread_affinity="scatter")
+def test_thread_affinity_scatter():
+    _test_pinned_range_for()
+
+
+@test_utils.test(arch=ti.cpu, cpu_max_num_threads=4, cpu_thread_affinity="0")
+def test_thread_affinity_cpu_list():
+    # All threads share CPU 0.
+    _test_pinned_range_for()
+
+
+@test_utils.test(arch=ti.cpu)
+def test_thread_affinity_invalid():
+    with pytest.raises(RuntimeError, match="Invalid thread affinity"):
+        ti.init(arch=ti.cpu, cpu_thread_affinity="0-")